@@ -0,0 +1,163 @@
+// AFJSONModelSchema.h
+// Copyright (c) 2011–2016 Alamofire Software Foundation ( http://alamofire.org/ )
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The JSON values that a property of a model can be decoded from.
+
+ - `AFJSONModelPropertyTypeString`: A string, decoded as an `NSString`.
+ - `AFJSONModelPropertyTypeNumber`: A number, decoded as an `NSNumber`, or as the scalar type of the property.
+ - `AFJSONModelPropertyTypeBoolean`: `true` or `false`, decoded as an `NSNumber`, or as the scalar type of the property.
+ - `AFJSONModelPropertyTypeURL`: A string, decoded as an `NSURL`.
+ - `AFJSONModelPropertyTypeModel`: An object, decoded as an instance of a model class.
+ - `AFJSONModelPropertyTypeModelArray`: An array of objects, decoded as an `NSArray` of instances of a model class.
+ */
+typedef NS_ENUM(NSUInteger, AFJSONModelPropertyType) {
+    AFJSONModelPropertyTypeString = 0,
+    AFJSONModelPropertyTypeNumber = 1,
+    AFJSONModelPropertyTypeBoolean = 2,
+    AFJSONModelPropertyTypeURL = 3,
+    AFJSONModelPropertyTypeModel = 4,
+    AFJSONModelPropertyTypeModelArray = 5,
+};
+
+/**
+ `AFJSONModelProperty` describes how a property of a model is decoded from the value at a key path of a JSON object.
+ */
+@interface AFJSONModelProperty : NSObject
+
+/**
+ The name of the property, which is set through its setter, or with key-value coding if it is not declared with `@property`.
+ */
+@property (readonly, nonatomic, copy) NSString *name;
+
+/**
+ The key path of the value in the JSON object, whose keys are separated by `.`.
+ */
+@property (readonly, nonatomic, copy) NSString *JSONKeyPath;
+
+/**
+ The JSON value that the property is decoded from.
+ */
+@property (readonly, nonatomic, assign) AFJSONModelPropertyType type;
+
+/**
+ The model class of properties of type `AFJSONModelPropertyTypeModel` or `AFJSONModelPropertyTypeModelArray`, which must have a registered schema when decoded.
+ */
+@property (readonly, nonatomic, strong, nullable) Class modelClass;
+
+/**
+ The value the property is set to when a model is created, which is kept if the JSON object has no value or `null` at the key path.
+ */
+@property (readonly, nonatomic, strong, nullable) id defaultValue;
+
+/**
+ Creates and returns a property decoded from the specified type of value.
+
+ @param name The name of the property.
+ @param JSONKeyPath The key path of the value in the JSON object.
+ @param type The JSON value that the property is decoded from. This must not be `AFJSONModelPropertyTypeModel` or `AFJSONModelPropertyTypeModelArray`.
+ */
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                            type:(AFJSONModelPropertyType)type;
+
+/**
+ Creates and returns a property decoded from the specified type of value, with a default value.
+
+ @param name The name of the property.
+ @param JSONKeyPath The key path of the value in the JSON object.
+ @param type The JSON value that the property is decoded from. This must not be `AFJSONModelPropertyTypeModel` or `AFJSONModelPropertyTypeModelArray`.
+ @param defaultValue The value of the property of new models. Scalar properties take an `NSNumber`.
+ */
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                            type:(AFJSONModelPropertyType)type
+                    defaultValue:(nullable id)defaultValue;
+
+/**
+ Creates and returns a property decoded from an object, as an instance of the specified model class.
+
+ @param name The name of the property.
+ @param JSONKeyPath The key path of the object in the JSON object.
+ @param modelClass The model class.
+ */
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                      modelClass:(Class)modelClass;
+
+/**
+ Creates and returns a property decoded from an array of objects, as an array of instances of the specified model class.
+
+ @param name The name of the property.
+ @param JSONKeyPath The key path of the array in the JSON object.
+ @param modelClass The model class of the elements of the array.
+ */
++ (instancetype)arrayPropertyWithName:(NSString *)name
+                          JSONKeyPath:(NSString *)JSONKeyPath
+                           modelClass:(Class)modelClass;
+
+@end
+
+/**
+ `AFJSONModelSchema` declares how instances of a model class are decoded from JSON objects. Schemas are registered once for each model class, and are immutable once created.
+ */
+@interface AFJSONModelSchema : NSObject
+
+/**
+ The model class, whose instances are created with `init`.
+ */
+@property (readonly, nonatomic, strong) Class modelClass;
+
+/**
+ The properties of the model that are decoded.
+ */
+@property (readonly, nonatomic, copy) NSArray <AFJSONModelProperty *> *properties;
+
+/**
+ Creates and returns a schema for the specified model class.
+
+ @param modelClass The model class.
+ @param properties The properties of the model that are decoded.
+ */
++ (instancetype)schemaWithModelClass:(Class)modelClass
+                          properties:(NSArray <AFJSONModelProperty *> *)properties;
+
+/**
+ Registers the specified schema for its model class, replacing any schema registered for it before.
+
+ @param schema The schema.
+ */
++ (void)registerSchema:(AFJSONModelSchema *)schema;
+
+/**
+ Returns the schema registered for the specified model class, if any.
+
+ @param modelClass The model class.
+ */
++ (nullable AFJSONModelSchema *)registeredSchemaForModelClass:(Class)modelClass;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -27,6 +27,7 @@
 #ifndef _AFNETWORKING_
     #define _AFNETWORKING_
 
+    #import "AFJSONModelSchema.h"
     #import "AFURLRequestSerialization.h"
     #import "AFURLResponseSerialization.h"
     #import "AFSecurityPolicy.h"
@@ -87,6 +87,7 @@ typedef NS_ENUM(NSUInteger, AFHTTPRequestQueryStringSerializationStyle) {
 };
 
 @protocol AFMultipartFormData;
+@class AFBandwidthShaper;
 
 /**
  `AFHTTPRequestSerializer` conforms to the `AFURLRequestSerialization` & `AFURLResponseSerialization` protocols, offering a concrete base implementation of query string / URL form-encoded parameter serialization and default request headers, as well as response status code and content type validation.
@@ -218,6 +219,35 @@ forHTTPHeaderField:(NSString *)field;
  */
 - (void)setQueryStringSerializationWithBlock:(nullable NSString * (^)(NSURLRequest *request, id parameters, NSError * __autoreleasing *error))block;
 
+///-------------------------------------
+/// @name Configuring Upload Bandwidth
+///-------------------------------------
+
+/**
+ The bandwidth shaper that the body streams of multipart form requests created by the serializer draw from, unless a shaper has been set for the host of the request. `nil` by default.
+
+ Because every request created by the serializer draws from the same shaper, setting this property on the `requestSerializer` of a session manager caps the total bandwidth of all concurrent multipart uploads made with that manager.
+ */
+@property (nonatomic, strong, nullable) AFBandwidthShaper *uploadBandwidthShaper;
+
+/**
+ Sets the bandwidth shaper that the body streams of multipart form requests to the specified host draw from, instead of `uploadBandwidthShaper`.
+
+ @param shaper The bandwidth shaper, or `nil` to remove the shaper for the host.
+ @param host The host, which is matched case-insensitively.
+ */
+- (void)setUploadBandwidthShaper:(nullable AFBandwidthShaper *)shaper
+                         forHost:(NSString *)host;
+
+/**
+ Returns the bandwidth shaper used for multipart form requests to the specified host, which is `uploadBandwidthShaper` unless a shaper has been set for the host.
+
+ @param host The host.
+
+ @return The bandwidth shaper, or `nil` if uploads to the host are not shaped.
+ */
+- (nullable AFBandwidthShaper *)uploadBandwidthShaperForHost:(nullable NSString *)host;
+
 ///-------------------------------
 /// @name Creating Request Objects
 ///-------------------------------
@@ -239,6 +269,25 @@ forHTTPHeaderField:(NSString *)field;
                                 parameters:(nullable id)parameters
                                      error:(NSError * _Nullable __autoreleasing *)error;
 
+/**
+ Creates an `NSMutableURLRequest` object with the specified HTTP method and a URL string resolved against the specified base URL.
+
+ The resulting request is identical to passing `[[NSURL URLWithString:URLString relativeToURL:baseURL] absoluteString]` to `requestWithMethod:URLString:parameters:error:`. When parameters are encoded in the URL, the path and the query string are composed and resolved against `baseURL` in a single step, rather than resolving, printing, and parsing the URL once for the path and again for the query.
+
+ @param method The HTTP method for the request, such as `GET`, `POST`, `PUT`, or `DELETE`. This parameter must not be `nil`.
+ @param URLString The URL string used to create the request URL, either absolute or relative to `baseURL`.
+ @param baseURL The URL that `URLString` is resolved against, or `nil` if `URLString` is absolute.
+ @param parameters The parameters to be either set as a query string for `GET` requests, or the request HTTP body.
+ @param error The error that occurred while constructing the request.
+
+ @return An `NSMutableURLRequest` object.
+ */
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                 URLString:(NSString *)URLString
+                             relativeToURL:(nullable NSURL *)baseURL
+                                parameters:(nullable id)parameters
+                                     error:(NSError * _Nullable __autoreleasing *)error;
+
 /**
  Creates an `NSMutableURLRequest` object with the specified HTTP method and URLString, and constructs a `multipart/form-data` HTTP body, using the specified parameters and multipart form data block. See http://www.w3.org/TR/html4/interact/forms.html#h-17.13.4.2
 
@@ -273,6 +322,34 @@ forHTTPHeaderField:(NSString *)field;
                              writingStreamContentsToFile:(NSURL *)fileURL
                                        completionHandler:(nullable void (^)(NSError * _Nullable error))handler;
 
+/**
+ Creates an `NSMutableURLRequest` by removing the `HTTPBodyStream` from a request, and asynchronously writing its contents into the specified file using buffers of the specified size, invoking the progress block as data is written and the completion handler when finished.
+
+ @param request The multipart form request. The `HTTPBodyStream` property of `request` must not be `nil`.
+ @param fileURL The file URL to write multipart form contents to.
+ @param bufferSize The size of each of the two buffers used to copy the contents, rounded up to a multiple of the page size. Pass `0` to use the default size of 1 MB.
+ @param progress A block object to be executed on the main queue as the contents are written to the file.
+ @param handler A handler block to execute.
+
+ @discussion The body is read into one buffer while the previous one is being written to the file, and file-backed parts of a multipart form body are read directly into these buffers. Larger buffers result in fewer, larger reads and writes, which is considerably faster when spooling large files.
+ */
+- (NSMutableURLRequest *)requestWithMultipartFormRequest:(NSURLRequest *)request
+                             writingStreamContentsToFile:(NSURL *)fileURL
+                                              bufferSize:(NSUInteger)bufferSize
+                                                progress:(nullable void (^)(NSProgress *spoolProgress))progress
+                                       completionHandler:(nullable void (^)(NSError * _Nullable error))handler;
+
+/**
+ Asynchronously computes the SHA-256 digest of the body of a multipart form request, invoking the completion handler on the main queue when finished.
+
+ @param request The multipart form request. The `HTTPBodyStream` property of `request` must not be `nil`, and the stream is left untouched. If the stream doesn't conform to `NSCopying`, as a plain `NSInputStream` doesn't, the handler receives an error.
+ @param handler A handler block to execute, which takes the digest, or the error that occurred while reading the body.
+
+ @discussion Use this method when the digest has to be sent in a header, which requires reading the whole body once before uploading it, so that it is read twice in total. Reading and hashing overlap, and the body is read at full speed, without drawing from the bandwidth shapers of the request. When the digest can be sent after the upload instead, use `AFMultipartFormData -computeSHA256DigestWhileStreamingWithCompletionHandler:`, which hashes the body as it is sent.
+ */
+- (void)computeSHA256DigestOfMultipartFormRequest:(NSURLRequest *)request
+                                completionHandler:(void (^)(NSData * _Nullable digest, NSError * _Nullable error))handler;
+
 @end
 
 #pragma mark -
@@ -363,16 +440,57 @@ forHTTPHeaderField:(NSString *)field;
                          body:(NSData *)body;
 
 /**
- Throttles request bandwidth by limiting the packet size and adding a delay for each chunk read from the upload stream.
+ Throttles request bandwidth by limiting the packet size and the average rate at which packets are read from the upload stream to one packet per `delay`.
 
  When uploading over a 3G or EDGE connection, requests may fail with "request body stream exhausted". Setting a maximum packet size and delay according to the recommended values (`kAFUploadStream3GSuggestedPacketSize` and `kAFUploadStream3GSuggestedDelay`) lowers the risk of the input stream exceeding its allocated bandwidth. Unfortunately, there is no definite way to distinguish between a 3G, EDGE, or LTE connection over `NSURLConnection`. As such, it is not recommended that you throttle bandwidth based solely on network reachability. Instead, you should consider checking for the "request body stream exhausted" in a failure block, and then retrying the request with throttled bandwidth.
 
  @param numberOfBytes Maximum packet size, in number of bytes. The default packet size for an input stream is 16kb.
  @param delay Duration of delay each time a packet is read. By default, no delay is set.
+
+ @discussion The delay is enforced by a bandwidth shaper private to the upload stream, so that no thread is put to sleep while waiting. Use `AFHTTPRequestSerializer -uploadBandwidthShaper` to limit the bandwidth of several uploads as a whole.
  */
 - (void)throttleBandwidthWithPacketSize:(NSUInteger)numberOfBytes
                                   delay:(NSTimeInterval)delay;
 
+/**
+ Computes the SHA-256 digest of the multipart form body as it is read from the upload stream, so that the body is hashed while it is being sent, without being read a second time.
+
+ @param handler A block object to be executed on the main queue every time the whole body has been read from the upload stream, which takes the digest of the body as an argument.
+
+ @discussion `NSURLSession` sends request headers before the body and does not support request trailers, so the digest is only available once the body has been sent, for example to confirm an upload with a subsequent request. Use `AFHTTPRequestSerializer -computeSHA256DigestOfMultipartFormRequest:completionHandler:` to compute a digest to be sent in a header.
+ */
+- (void)computeSHA256DigestWhileStreamingWithCompletionHandler:(void (^)(NSData *digest))handler;
+
+@end
+
+#pragma mark -
+
+/**
+ `AFBandwidthShaper` is a thread-safe token bucket that limits the rate at which the body streams of multipart form requests are read, and so the rate at which they are uploaded.
+
+ Tokens accumulate at `bytesPerSecond`, up to `burstSize`, and every byte read from a body stream consumes one token. Body streams never sleep while waiting for tokens: when the bucket is empty, a stream reports that it has no bytes available and notifies its client once tokens have accumulated again. Each stream drawing from the shaper takes at most an equal share of the burst at a time, so that concurrent uploads share the bandwidth fairly.
+ */
+@interface AFBandwidthShaper : NSObject
+
+/**
+ Creates and returns a bandwidth shaper with the specified rate and burst size.
+
+ @param bytesPerSecond The rate at which tokens accumulate, in bytes per second. `0` disables shaping.
+ @param burstSize The maximum number of tokens that can accumulate, in bytes. `0` uses one second worth of tokens.
+ */
+- (instancetype)initWithBytesPerSecond:(NSUInteger)bytesPerSecond
+                             burstSize:(NSUInteger)burstSize NS_DESIGNATED_INITIALIZER;
+
+/**
+ The rate at which tokens accumulate, in bytes per second. Changes take effect immediately for all streams drawing from the shaper. `0` disables shaping.
+ */
+@property (atomic, assign) NSUInteger bytesPerSecond;
+
+/**
+ The maximum number of tokens that can accumulate, in bytes, which limits the size of the burst that can be read after a period of inactivity. `0` uses one second worth of tokens.
+ */
+@property (atomic, assign) NSUInteger burstSize;
+
 @end
 
 #pragma mark -
@@ -387,6 +505,20 @@ forHTTPHeaderField:(NSString *)field;
  */
 @property (nonatomic, assign) NSJSONWritingOptions writingOptions;
 
+/**
+ Whether the JSON encoding of the parameters is streamed through the request's `HTTPBodyStream`, rather than being set as its `HTTPBody`. `NO` by default.
+
+ When enabled, the body is encoded in fixed-size chunks as it is read, in a single walk over the parameters, so that the memory needed to send large payloads stays bounded. No `Content-Length` is set, so the body is sent with chunked transfer encoding, and parameters that can't be encoded as JSON fail the body stream, and with it the task, rather than the serialization of the request. The parameters must not be mutated until the request has been sent.
+ */
+@property (nonatomic, assign) BOOL streamsHTTPBody;
+
+/**
+ Whether a streamed body is sized before the request is returned, for servers that don't accept chunked request bodies. `NO` by default. Only used when `streamsHTTPBody` is enabled.
+
+ When enabled, the parameters are encoded once with the output discarded while serializing the request, which reports invalid parameters synchronously and sets `Content-Length` to the exact length of the encoding. The body is then encoded a second time as it is read.
+ */
+@property (nonatomic, assign) BOOL computesStreamedContentLength;
+
 /**
  Creates and returns a JSON serializer with specified reading and writing options.
 
@@ -428,6 +560,191 @@ forHTTPHeaderField:(NSString *)field;
 
 #pragma mark -
 
+/**
+ `AFMessagePackRequestSerializer` is a subclass of `AFHTTPRequestSerializer` that encodes parameters as MessagePack, setting the `Content-Type` of the encoded request to `application/msgpack`.
+
+ Parameters are encoded directly from the following Foundation objects:
+
+ - `NSDictionary` as a map, and `NSArray` as an array
+ - `NSString` as a string, and `NSData` as binary data
+ - `NSNumber` as an integer, a floating point number, or a boolean
+ - `NSNull` as nil
+ - `NSDate` as a timestamp extension
+
+ Map entries are ordered by the bytewise order of their encoded keys, so that equal parameters always encode to the same bytes.
+ */
+@interface AFMessagePackRequestSerializer : AFHTTPRequestSerializer
+
+@end
+
+#pragma mark -
+
+/**
+ `AFCBORRequestSerializer` is a subclass of `AFHTTPRequestSerializer` that encodes parameters as CBOR, as described in RFC 7049, setting the `Content-Type` of the encoded request to `application/cbor`.
+
+ Parameters are encoded directly from the following Foundation objects:
+
+ - `NSDictionary` as a map, and `NSArray` as an array
+ - `NSString` as a text string, and `NSData` as a byte string
+ - `NSNumber` as an integer, a floating point number, or a boolean
+ - `NSNull` as null
+ - `NSDate` as an epoch-based date and time, with tag 1
+
+ Map entries are ordered by the bytewise order of their encoded keys, so that equal parameters always encode to the same bytes.
+ */
+@interface AFCBORRequestSerializer : AFHTTPRequestSerializer
+
+@end
+
+#pragma mark -
+
+@class AFJSONEncoder;
+
+/**
+ The `AFJSONEncoding` protocol is adopted by models that write their own members when they are encoded as JSON objects by `AFJSONModelRequestSerializer`.
+ */
+@protocol AFJSONEncoding <NSObject>
+
+/**
+ Writes the members of the receiver's JSON object to the specified encoder.
+
+ @param encoder The encoder, which is only valid for the duration of the call.
+ */
+- (void)encodeWithJSONEncoder:(AFJSONEncoder *)encoder;
+
+@end
+
+/**
+ `AFJSONEncoder` writes the members of a JSON object straight into the JSON encoding of a request body. Members are written in the order they are encoded, and members encoded with a `nil` value are left out.
+
+ Once a value can't be encoded, e.g. because it is a non-finite number, the encoder ignores any further members, and the request fails to serialize.
+ */
+@interface AFJSONEncoder : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Writes a member whose value is an `NSString`, an `NSNumber`, `NSNull`, an `NSArray` or `NSDictionary` of such values, or a model that can be encoded by `AFJSONModelRequestSerializer`.
+
+ @param object The value of the member.
+ @param key The key of the member.
+ */
+- (void)encodeObject:(nullable id)object forKey:(NSString *)key;
+
+/**
+ Writes a member whose value is a string.
+
+ @param string The value of the member.
+ @param key The key of the member.
+ */
+- (void)encodeString:(nullable NSString *)string forKey:(NSString *)key;
+
+/**
+ Writes a member whose value is an integer.
+
+ @param value The value of the member.
+ @param key The key of the member.
+ */
+- (void)encodeInteger:(NSInteger)value forKey:(NSString *)key;
+
+/**
+ Writes a member whose value is a floating point number, which must be finite.
+
+ @param value The value of the member.
+ @param key The key of the member.
+ */
+- (void)encodeDouble:(double)value forKey:(NSString *)key;
+
+/**
+ Writes a member whose value is `true` or `false`.
+
+ @param value The value of the member.
+ @param key The key of the member.
+ */
+- (void)encodeBool:(BOOL)value forKey:(NSString *)key;
+
+@end
+
+/**
+ `AFJSONModelRequestSerializer` is a subclass of `AFHTTPRequestSerializer` that encodes model objects as JSON, writing their members straight into the request body, without first converting them into dictionaries, setting the `Content-Type` of the encoded request to `application/json`.
+
+ Parameters may be models, or arrays and dictionaries containing models alongside other JSON values. A model is encoded as a JSON object by its own `-encodeWithJSONEncoder:` method if it conforms to `AFJSONEncoding`, and otherwise from the `AFJSONModelSchema` registered for its class, or the nearest of its superclasses, whose properties are read through their getters and written at their JSON key paths. Properties whose value is `nil` are left out, as are the objects along a key path when every property below them is `nil`.
+
+ Members are written in the order they are encoded, or in the order of the properties of the schema, without whitespace, and with `/` escaped, as by `NSJSONSerialization`.
+ */
+@interface AFJSONModelRequestSerializer : AFHTTPRequestSerializer
+
+@end
+
+#pragma mark -
+
+/**
+ The content codings that `AFCompressingRequestSerializer` can compress request bodies with.
+
+ - `AFHTTPBodyContentEncodingGzip`: The `gzip` content coding, as described in RFC 1952.
+ - `AFHTTPBodyContentEncodingDeflate`: The `deflate` content coding, which is the zlib format described in RFC 1950.
+ */
+typedef NS_ENUM(NSUInteger, AFHTTPBodyContentEncoding) {
+    AFHTTPBodyContentEncodingGzip = 0,
+    AFHTTPBodyContentEncodingDeflate = 1,
+};
+
+/**
+ `AFCompressingRequestSerializer` is a subclass of `AFHTTPRequestSerializer` that compresses the bodies of the requests produced by another request serializer, and sets their `Content-Encoding` header accordingly.
+
+ Bodies set as `HTTPBody` are compressed when the request is serialized, with large bodies split into chunks that are compressed concurrently. Bodies set as `HTTPBodyStream`, such as those of multipart form requests, are compressed as they are read, in which case the `Content-Length` header is removed.
+
+ @warning Only use this serializer with servers that accept compressed request bodies.
+ */
+@interface AFCompressingRequestSerializer : AFHTTPRequestSerializer
+
+/**
+ The request serializer whose request bodies are compressed. An `AFHTTPRequestSerializer` by default.
+
+ When the request serializer is an `AFHTTPRequestSerializer`, requests created by the compressing serializer take their cache policy, timeout interval, other request properties and headers from it. Request properties changed on the compressing serializer, and headers set on it, take precedence.
+ */
+@property (readonly, nonatomic, strong) id <AFURLRequestSerialization> requestSerializer;
+
+/**
+ The content coding used to compress request bodies. `AFHTTPBodyContentEncodingGzip` by default.
+ */
+@property (nonatomic, assign) AFHTTPBodyContentEncoding contentEncoding;
+
+/**
+ The zlib compression level, from `0` for no compression to `9` for the best compression. `-1`, zlib's default level, by default.
+ */
+@property (nonatomic, assign) NSInteger compressionLevel;
+
+/**
+ The length, in bytes, below which request bodies are not compressed. Streamed bodies are only skipped if their `Content-Length` is known. `1024` by default.
+ */
+@property (nonatomic, assign) NSUInteger minimumBodyLength;
+
+/**
+ The length, in bytes, from which `HTTPBody` request bodies are split into chunks of 1 MB that are compressed concurrently, and joined into a single valid stream. `4194304` (4 MB) by default. Set to `NSUIntegerMax` to always compress bodies on a single thread.
+ */
+@property (nonatomic, assign) NSUInteger parallelCompressionThreshold;
+
+/**
+ Creates and returns a compressing serializer that compresses the request bodies produced by the specified request serializer using gzip.
+
+ @param requestSerializer The request serializer whose request bodies are compressed.
+ */
++ (instancetype)serializerWithRequestSerializer:(id <AFURLRequestSerialization>)requestSerializer;
+
+/**
+ Creates and returns a compressing serializer that compresses the request bodies produced by the specified request serializer using the specified content coding.
+
+ @param requestSerializer The request serializer whose request bodies are compressed.
+ @param contentEncoding The content coding.
+ */
++ (instancetype)serializerWithRequestSerializer:(id <AFURLRequestSerialization>)requestSerializer
+                                contentEncoding:(AFHTTPBodyContentEncoding)contentEncoding;
+
+@end
+
+#pragma mark -
+
 ///----------------
 /// @name Constants
 ///----------------
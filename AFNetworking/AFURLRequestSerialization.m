@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 
 #import "AFURLRequestSerialization.h"
+#import "AFJSONModelSchema.h"
 
 #if TARGET_OS_IOS || TARGET_OS_WATCH || TARGET_OS_TV
 #import <MobileCoreServices/MobileCoreServices.h>
@@ -27,11 +28,134 @@
 #import <CoreServices/CoreServices.h>
 #endif
 
+#import <fcntl.h>
+#import <objc/runtime.h>
+#import <pthread.h>
+#import <unistd.h>
+#import <zlib.h>
+#import <CommonCrypto/CommonDigest.h>
+
 NSString * const AFURLRequestSerializationErrorDomain = @"com.alamofire.error.serialization.request";
 NSString * const AFNetworkingOperationFailingURLRequestErrorKey = @"com.alamofire.serialization.request.error.response";
 
 typedef NSString * (^AFQueryStringSerializationBlock)(NSURLRequest *request, id parameters, NSError *__autoreleasing *error);
 
+static NSString * const kAFCharactersGeneralDelimitersToEncode = @":#[]@"; // does not include "?" or "/" due to RFC 3986 - Section 3.4
+static NSString * const kAFCharactersSubDelimitersToEncode = @"!$&'()*+,;=";
+
+static NSCharacterSet * AFPercentEscapeAllowedCharacterSet(void) {
+    static NSCharacterSet *_allowedCharacterSet = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableCharacterSet *mutableCharacterSet = [[NSCharacterSet URLQueryAllowedCharacterSet] mutableCopy];
+        [mutableCharacterSet removeCharactersInString:[kAFCharactersGeneralDelimitersToEncode stringByAppendingString:kAFCharactersSubDelimitersToEncode]];
+        _allowedCharacterSet = [mutableCharacterSet copy];
+    });
+
+    return _allowedCharacterSet;
+}
+
+/**
+ Returns a table indexed by UTF-8 code unit, where a non-zero entry means the byte can be copied to the output unescaped. Only ASCII bytes are ever allowed, since `URLQueryAllowedCharacterSet` contains no characters outside of that range, and any other byte is part of a multi-byte sequence that `stringByAddingPercentEncodingWithAllowedCharacters:` escapes byte by byte.
+ */
+static const uint8_t * AFPercentEscapeAllowedByteTable(void) {
+    static uint8_t _allowedByteTable[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSCharacterSet *allowedCharacterSet = AFPercentEscapeAllowedCharacterSet();
+        for (unichar character = 0; character < 128; character++) {
+            _allowedByteTable[character] = [allowedCharacterSet characterIsMember:character] ? 1 : 0;
+        }
+    });
+
+    return _allowedByteTable;
+}
+
+/**
+ Returns the UTF-8 representation of `string`, either borrowed from the string itself, copied into `stackBuffer`, or copied into a newly allocated `*heapBuffer` that the caller must free. Returns `NULL` if the string can not be represented as UTF-8, e.g. because it contains an unpaired surrogate.
+ */
+static const uint8_t * AFUTF8BytesFromString(NSString *string, uint8_t *stackBuffer, size_t stackBufferLength, uint8_t **heapBuffer, size_t *numberOfBytes) {
+    *heapBuffer = NULL;
+    *numberOfBytes = 0;
+
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    CFIndex length = cfString ? CFStringGetLength(cfString) : 0;
+    if (length == 0) {
+        return stackBuffer;
+    }
+
+    // Strings backed by an ASCII-compatible buffer can be scanned in place, as long as there's no embedded NUL
+    const uint8_t *bytes = (const uint8_t *)CFStringGetCStringPtr(cfString, kCFStringEncodingUTF8);
+    if (bytes && strlen((const char *)bytes) == (size_t)length) {
+        *numberOfBytes = (size_t)length;
+        return bytes;
+    }
+
+    CFIndex usedBufferLength = 0;
+    CFIndex convertedLength = CFStringGetBytes(cfString, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false, NULL, 0, &usedBufferLength);
+    if (convertedLength != length) {
+        return NULL;
+    }
+
+    uint8_t *buffer = stackBuffer;
+    if ((size_t)usedBufferLength > stackBufferLength) {
+        buffer = malloc((size_t)usedBufferLength);
+        if (!buffer) {
+            return NULL;
+        }
+        *heapBuffer = buffer;
+    }
+
+    CFStringGetBytes(cfString, CFRangeMake(0, length), kCFStringEncodingUTF8, 0, false, buffer, usedBufferLength, NULL);
+    *numberOfBytes = (size_t)usedBufferLength;
+
+    return buffer;
+}
+
+static size_t AFPercentEscapeAllowedPrefixLength(const uint8_t *bytes, size_t numberOfBytes) {
+    const uint8_t *allowed = AFPercentEscapeAllowedByteTable();
+
+    size_t index = 0;
+    while (index < numberOfBytes && allowed[bytes[index]]) {
+        index++;
+    }
+
+    return index;
+}
+
+/**
+ Writes the percent-escaped form of `bytes` into `escaped`, which must have room for `numberOfBytes * 3` bytes, and returns the number of bytes written. Runs of allowed bytes are copied with `memcpy`, and every other byte is written as an uppercase `%XX` triplet.
+ */
+static size_t AFPercentEscapeBytes(const uint8_t *bytes, size_t numberOfBytes, uint8_t *escaped) {
+    static const char kAFHexDigits[] = "0123456789ABCDEF";
+    const uint8_t *allowed = AFPercentEscapeAllowedByteTable();
+
+    size_t index = 0;
+    size_t escapedLength = 0;
+    while (index < numberOfBytes) {
+        size_t runStart = index;
+        while (index < numberOfBytes && allowed[bytes[index]]) {
+            index++;
+        }
+
+        if (index > runStart) {
+            memcpy(escaped + escapedLength, bytes + runStart, index - runStart);
+            escapedLength += index - runStart;
+        }
+
+        while (index < numberOfBytes && !allowed[bytes[index]]) {
+            uint8_t byte = bytes[index++];
+            escaped[escapedLength++] = '%';
+            escaped[escapedLength++] = (uint8_t)kAFHexDigits[byte >> 4];
+            escaped[escapedLength++] = (uint8_t)kAFHexDigits[byte & 0x0F];
+        }
+    }
+
+    return escapedLength;
+}
+
+FOUNDATION_EXPORT NSString * AFPercentEscapedStringFromStringInBatches(NSString *string);
+
 /**
  Returns a percent-escaped string following RFC 3986 for a query string key or value.
  RFC 3986 states that the following characters are "reserved" characters.
@@ -41,15 +165,46 @@ typedef NSString * (^AFQueryStringSerializationBlock)(NSURLRequest *request, id
  In RFC 3986 - Section 3.4, it states that the "?" and "/" characters should not be escaped to allow
  query strings to include a URL. Therefore, all "reserved" characters with the exception of "?" and "/"
  should be percent-escaped in the query string.
+
+ The string is escaped in a single pass over its UTF-8 representation, which is byte-for-byte what `stringByAddingPercentEncodingWithAllowedCharacters:` produces for the same character set. Strings that can not be represented as UTF-8, such as ones containing unpaired surrogates, are escaped by `AFPercentEscapedStringFromStringInBatches` instead.
     - parameter string: The string to be percent-escaped.
     - returns: The percent-escaped string.
  */
 NSString * AFPercentEscapedStringFromString(NSString *string) {
-    static NSString * const kAFCharactersGeneralDelimitersToEncode = @":#[]@"; // does not include "?" or "/" due to RFC 3986 - Section 3.4
-    static NSString * const kAFCharactersSubDelimitersToEncode = @"!$&'()*+,;=";
+    uint8_t stackBuffer[1024];
+    uint8_t *heapBuffer = NULL;
+    size_t numberOfBytes = 0;
+    const uint8_t *bytes = AFUTF8BytesFromString(string, stackBuffer, sizeof(stackBuffer), &heapBuffer, &numberOfBytes);
+    if (!bytes) {
+        return AFPercentEscapedStringFromStringInBatches(string);
+    }
+
+    if (numberOfBytes == 0) {
+        return @"";
+    }
+
+    if (AFPercentEscapeAllowedPrefixLength(bytes, numberOfBytes) == numberOfBytes) {
+        free(heapBuffer);
+        return [string copy];
+    }
+
+    uint8_t *escaped = malloc(numberOfBytes * 3);
+    if (!escaped) {
+        free(heapBuffer);
+        return AFPercentEscapedStringFromStringInBatches(string);
+    }
 
-    NSMutableCharacterSet * allowedCharacterSet = [[NSCharacterSet URLQueryAllowedCharacterSet] mutableCopy];
-    [allowedCharacterSet removeCharactersInString:[kAFCharactersGeneralDelimitersToEncode stringByAppendingString:kAFCharactersSubDelimitersToEncode]];
+    size_t escapedLength = AFPercentEscapeBytes(bytes, numberOfBytes, escaped);
+    free(heapBuffer);
+
+    return [[NSString alloc] initWithBytesNoCopy:escaped length:escapedLength encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
+
+/**
+ Percent-escapes `string` by walking it in batches of composed character sequences, and handing each batch to `stringByAddingPercentEncodingWithAllowedCharacters:`.
+ */
+NSString * AFPercentEscapedStringFromStringInBatches(NSString *string) {
+    NSCharacterSet *allowedCharacterSet = AFPercentEscapeAllowedCharacterSet();
 
 	// FIXME: https://github.com/AFNetworking/AFNetworking/pull/3028
     // return [string stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacterSet];
@@ -116,15 +271,190 @@ NSString * AFPercentEscapedStringFromString(NSString *string) {
 FOUNDATION_EXPORT NSArray * AFQueryStringPairsFromDictionary(NSDictionary *dictionary);
 FOUNDATION_EXPORT NSArray * AFQueryStringPairsFromKeyAndValue(NSString *key, id value);
 
-NSString * AFQueryStringFromParameters(NSDictionary *parameters) {
+static NSString * AFQueryStringFromQueryStringPairs(NSArray *pairs) {
     NSMutableArray *mutablePairs = [NSMutableArray array];
-    for (AFQueryStringPair *pair in AFQueryStringPairsFromDictionary(parameters)) {
+    for (AFQueryStringPair *pair in pairs) {
         [mutablePairs addObject:[pair URLEncodedStringValue]];
     }
 
     return [mutablePairs componentsJoinedByString:@"&"];
 }
 
+/**
+ A growable buffer of bytes, which the query string builder and the JSON, MessagePack and CBOR encoders write their output into. The bytes are owned by the buffer until they are handed off, e.g. to `-[NSData initWithBytesNoCopy:length:freeWhenDone:]`, and must otherwise be released with `free()`.
+ */
+typedef struct {
+    uint8_t *bytes;
+    size_t length;
+    size_t capacity;
+} AFByteBuffer;
+
+static BOOL AFByteBufferReserve(AFByteBuffer *buffer, size_t additionalLength) {
+    if (buffer->capacity - buffer->length >= additionalLength) {
+        return YES;
+    }
+
+    if (additionalLength > SIZE_MAX - buffer->length) {
+        return NO;
+    }
+
+    size_t capacity = MAX(buffer->capacity, (size_t)256);
+    while (capacity - buffer->length < additionalLength) {
+        capacity = capacity > SIZE_MAX / 2 ? buffer->length + additionalLength : capacity * 2;
+    }
+
+    uint8_t *bytes = realloc(buffer->bytes, capacity);
+    if (!bytes) {
+        return NO;
+    }
+
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+
+    return YES;
+}
+
+static BOOL AFByteBufferAppendBytes(AFByteBuffer *buffer, const void *bytes, size_t length) {
+    if (!AFByteBufferReserve(buffer, length)) {
+        return NO;
+    }
+
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+
+    return YES;
+}
+
+static BOOL AFByteBufferAppendPercentEscapedString(AFByteBuffer *buffer, NSString *string) {
+    uint8_t stackBuffer[256];
+    uint8_t *heapBuffer = NULL;
+    size_t numberOfBytes = 0;
+    const uint8_t *bytes = AFUTF8BytesFromString(string, stackBuffer, sizeof(stackBuffer), &heapBuffer, &numberOfBytes);
+    if (!bytes) {
+        return NO;
+    }
+
+    BOOL success = AFByteBufferReserve(buffer, numberOfBytes * 3);
+    if (success) {
+        buffer->length += AFPercentEscapeBytes(bytes, numberOfBytes, buffer->bytes + buffer->length);
+    }
+
+    free(heapBuffer);
+
+    return success;
+}
+
+static NSArray * AFQueryStringSortedArrayFromArray(NSArray *array) {
+    if (array.count < 2) {
+        return array;
+    }
+
+    return [array sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(id obj1, id obj2) {
+        return [[obj1 description] compare:[obj2 description]];
+    }];
+}
+
+/**
+ Appends the pairs for `value` to `query`, following the same ordering and bracket conventions as `AFQueryStringPairsFromKeyAndValue`. `keyPrefix` holds the already percent-escaped key of `value`, and is extended in place for each level of nesting, then truncated back once that level has been written.
+ */
+static BOOL AFQueryStringAppendKeyAndValue(AFByteBuffer *query, BOOL *hasPairs, AFByteBuffer *keyPrefix, BOOL hasKey, id value) {
+    static const char kAFEscapedNestedKeyOpen[] = "%5B";
+    static const char kAFEscapedNestedKeyClose[] = "%5D";
+    static const char kAFEscapedArrayKeySuffix[] = "%5B%5D";
+    static const char kAFEscapedNilKey[] = "%28null%29";
+
+    size_t keyPrefixLength = keyPrefix->length;
+
+    if ([value isKindOfClass:[NSDictionary class]]) {
+        NSDictionary *dictionary = value;
+        for (id nestedKey in AFQueryStringSortedArrayFromArray(dictionary.allKeys)) {
+            id nestedValue = dictionary[nestedKey];
+            if (!nestedValue) {
+                continue;
+            }
+
+            BOOL success = YES;
+            if (hasKey) {
+                success = AFByteBufferAppendBytes(keyPrefix, kAFEscapedNestedKeyOpen, sizeof(kAFEscapedNestedKeyOpen) - 1) &&
+                          AFByteBufferAppendPercentEscapedString(keyPrefix, [nestedKey description]) &&
+                          AFByteBufferAppendBytes(keyPrefix, kAFEscapedNestedKeyClose, sizeof(kAFEscapedNestedKeyClose) - 1);
+            } else {
+                success = AFByteBufferAppendPercentEscapedString(keyPrefix, [nestedKey description]);
+            }
+
+            if (!success || !AFQueryStringAppendKeyAndValue(query, hasPairs, keyPrefix, YES, nestedValue)) {
+                return NO;
+            }
+
+            keyPrefix->length = keyPrefixLength;
+        }
+    } else if ([value isKindOfClass:[NSArray class]]) {
+        NSArray *array = value;
+        // A nil key is formatted as "(null)", exactly as `stringWithFormat:` would
+        if (!hasKey && !AFByteBufferAppendBytes(keyPrefix, kAFEscapedNilKey, sizeof(kAFEscapedNilKey) - 1)) {
+            return NO;
+        }
+
+        if (!AFByteBufferAppendBytes(keyPrefix, kAFEscapedArrayKeySuffix, sizeof(kAFEscapedArrayKeySuffix) - 1)) {
+            return NO;
+        }
+
+        for (id nestedValue in array) {
+            if (!AFQueryStringAppendKeyAndValue(query, hasPairs, keyPrefix, YES, nestedValue)) {
+                return NO;
+            }
+        }
+
+        keyPrefix->length = keyPrefixLength;
+    } else if ([value isKindOfClass:[NSSet class]]) {
+        NSSet *set = value;
+        for (id obj in AFQueryStringSortedArrayFromArray(set.allObjects)) {
+            if (!AFQueryStringAppendKeyAndValue(query, hasPairs, keyPrefix, hasKey, obj)) {
+                return NO;
+            }
+        }
+    } else {
+        if (*hasPairs && !AFByteBufferAppendBytes(query, "&", 1)) {
+            return NO;
+        }
+        *hasPairs = YES;
+
+        if (keyPrefix->length > 0 && !AFByteBufferAppendBytes(query, keyPrefix->bytes, keyPrefix->length)) {
+            return NO;
+        }
+
+        if (value && ![value isEqual:[NSNull null]]) {
+            if (!AFByteBufferAppendBytes(query, "=", 1) ||
+                !AFByteBufferAppendPercentEscapedString(query, [value description])) {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+NSString * AFQueryStringFromParameters(NSDictionary *parameters) {
+    AFByteBuffer query = {NULL, 0, 0};
+    AFByteBuffer keyPrefix = {NULL, 0, 0};
+    BOOL hasPairs = NO;
+
+    BOOL success = AFQueryStringAppendKeyAndValue(&query, &hasPairs, &keyPrefix, NO, parameters);
+    free(keyPrefix.bytes);
+
+    if (!success) {
+        free(query.bytes);
+        return AFQueryStringFromQueryStringPairs(AFQueryStringPairsFromDictionary(parameters));
+    }
+
+    if (query.length == 0) {
+        free(query.bytes);
+        return @"";
+    }
+
+    return [[NSString alloc] initWithBytesNoCopy:query.bytes length:query.length encoding:NSASCIIStringEncoding freeWhenDone:YES];
+}
+
 NSArray * AFQueryStringPairsFromDictionary(NSDictionary *dictionary) {
     return AFQueryStringPairsFromKeyAndValue(nil, dictionary);
 }
@@ -163,6 +493,8 @@ NSArray * AFQueryStringPairsFromKeyAndValue(NSString *key, id value) {
 #pragma mark -
 
 @interface AFStreamingMultipartFormData : NSObject <AFMultipartFormData>
+@property (nonatomic, strong) AFBandwidthShaper *bandwidthShaper;
+
 - (instancetype)initWithURLRequest:(NSMutableURLRequest *)urlRequest
                     stringEncoding:(NSStringEncoding)encoding;
 
@@ -183,12 +515,205 @@ static NSArray * AFHTTPRequestSerializerObservedKeyPaths() {
 
 static void *AFHTTPRequestSerializerObserverContext = &AFHTTPRequestSerializerObserverContext;
 
+/**
+ Returns whether instances of `cls` use one of the built-in implementations of `requestBySerializingRequest:withParameters:error:`, all of which return a newly created `NSMutableURLRequest` that is not referenced anywhere else.
+ */
+static BOOL AFRequestSerializerClassReturnsMutableCopies(Class cls) {
+    SEL selector = @selector(requestBySerializingRequest:withParameters:error:);
+    IMP implementation = [cls instanceMethodForSelector:selector];
+
+    return implementation == [AFHTTPRequestSerializer instanceMethodForSelector:selector] ||
+           implementation == [AFJSONRequestSerializer instanceMethodForSelector:selector] ||
+           implementation == [AFPropertyListRequestSerializer instanceMethodForSelector:selector];
+}
+
+static NSUInteger const AFMultipartFormSpoolDefaultBufferSize = 1024 * 1024;
+
+static void AFSHA256Update(CC_SHA256_CTX *context, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        CC_LONG chunkLength = (CC_LONG)MIN(length, (size_t)UINT32_MAX);
+        CC_SHA256_Update(context, bytes, chunkLength);
+        bytes += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+/**
+ Reads the contents of `inputStream` into two page-aligned buffers in turn, handing each filled buffer to `consumer` on a serial queue, so that the next buffer is filled from the stream while the previous one is being consumed. `consumer` returns `0`, or an `errno` value to stop reading, which is returned in `consumerErrorCode`. Returns the error of the stream, if any.
+ */
+static NSError * AFConsumeInputStreamContents(NSInputStream *inputStream, size_t bufferSize, const char *label, int (^consumer)(const uint8_t *bytes, size_t length), int *consumerErrorCode) {
+    void *buffers[2] = {NULL, NULL};
+    for (NSUInteger idx = 0; idx < 2; idx++) {
+        if (posix_memalign(&buffers[idx], (size_t)getpagesize(), bufferSize) != 0) {
+            free(buffers[0]);
+            return [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+        }
+    }
+
+    dispatch_queue_t consumerQueue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
+    dispatch_semaphore_t availableBuffers = dispatch_semaphore_create(2);
+    __block int errorCode = 0;
+    NSError *error = nil;
+
+    [inputStream open];
+
+    for (NSUInteger bufferIndex = 0; ; bufferIndex = (bufferIndex + 1) % 2) {
+        dispatch_semaphore_wait(availableBuffers, DISPATCH_TIME_FOREVER);
+        if (errorCode != 0) {
+            dispatch_semaphore_signal(availableBuffers);
+            break;
+        }
+
+        uint8_t *buffer = buffers[bufferIndex];
+        size_t length = 0;
+        BOOL reachedEnd = NO;
+        while (length < bufferSize) {
+            NSInteger numberOfBytesRead = [inputStream read:buffer + length maxLength:bufferSize - length];
+            if (numberOfBytesRead < 0) {
+                error = inputStream.streamError ?: [NSError errorWithDomain:NSPOSIXErrorDomain code:EIO userInfo:nil];
+                break;
+            } else if (numberOfBytesRead == 0) {
+                reachedEnd = YES;
+                break;
+            }
+
+            length += (size_t)numberOfBytesRead;
+        }
+
+        if (error || length == 0) {
+            dispatch_semaphore_signal(availableBuffers);
+            break;
+        }
+
+        dispatch_async(consumerQueue, ^{
+            if (errorCode == 0) {
+                errorCode = consumer(buffer, length);
+            }
+
+            dispatch_semaphore_signal(availableBuffers);
+        });
+
+        if (reachedEnd) {
+            break;
+        }
+    }
+
+    // Wait for the buffer still being consumed, if any, before releasing the buffers
+    dispatch_sync(consumerQueue, ^{});
+
+    [inputStream close];
+
+    free(buffers[0]);
+    free(buffers[1]);
+
+    if (consumerErrorCode) {
+        *consumerErrorCode = errorCode;
+    }
+
+    return error;
+}
+
+/**
+ Copies the contents of `inputStream` into the file at `fileURL`, writing one buffer while the next one is read from the stream. Returns the first error encountered, if any.
+ */
+static NSError * AFWriteInputStreamContentsToFile(NSInputStream *inputStream, NSURL *fileURL, size_t bufferSize, int64_t expectedLength, void (^progressHandler)(int64_t numberOfBytesWritten)) {
+    int fileDescriptor = open([fileURL fileSystemRepresentation], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+        return [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSURLErrorKey: fileURL}];
+    }
+
+#ifdef F_NOCACHE
+    // The spooled file is written once and only read back by the upload task, so there is no point in filling the buffer cache with it
+    fcntl(fileDescriptor, F_NOCACHE, 1);
+#endif
+#ifdef F_PREALLOCATE
+    if (expectedLength > 0) {
+        fstore_t store = {.fst_flags = F_ALLOCATEALL, .fst_posmode = F_PEOFPOSMODE, .fst_offset = 0, .fst_length = (off_t)expectedLength};
+        fcntl(fileDescriptor, F_PREALLOCATE, &store);
+    }
+#endif
+
+    __block int64_t totalNumberOfBytesWritten = 0;
+    int writeErrorCode = 0;
+    NSError *error = AFConsumeInputStreamContents(inputStream, bufferSize, "com.alamofire.networking.multipart.spool", ^int(const uint8_t *bytes, size_t length) {
+        size_t offset = 0;
+        while (offset < length) {
+            ssize_t numberOfBytesWritten = write(fileDescriptor, bytes + offset, length - offset);
+            if (numberOfBytesWritten >= 0) {
+                offset += (size_t)numberOfBytesWritten;
+            } else if (errno != EINTR) {
+                return errno;
+            }
+        }
+
+        totalNumberOfBytesWritten += (int64_t)length;
+        if (progressHandler) {
+            progressHandler(totalNumberOfBytesWritten);
+        }
+
+        return 0;
+    }, &writeErrorCode);
+
+    if (!error && writeErrorCode != 0) {
+        error = [NSError errorWithDomain:NSPOSIXErrorDomain code:writeErrorCode userInfo:@{NSURLErrorKey: fileURL}];
+    }
+
+    if (close(fileDescriptor) != 0 && !error) {
+        error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSURLErrorKey: fileURL}];
+    }
+
+    return error;
+}
+
+static NSInputStream * AFBodyStreamCopyForDigest(NSInputStream *bodyStream);
+
+/**
+ Computes the SHA-256 digest of the contents of `inputStream`, hashing one buffer while the next one is read from the stream.
+ */
+static NSData * AFSHA256DigestOfInputStreamContents(NSInputStream *inputStream, NSError * __autoreleasing *error) {
+    CC_SHA256_CTX *context = malloc(sizeof(CC_SHA256_CTX));
+    if (!context) {
+        return nil;
+    }
+
+    CC_SHA256_Init(context);
+    NSError *streamError = AFConsumeInputStreamContents(inputStream, AFMultipartFormSpoolDefaultBufferSize, "com.alamofire.networking.multipart.digest", ^int(const uint8_t *bytes, size_t length) {
+        AFSHA256Update(context, bytes, length);
+        return 0;
+    }, NULL);
+
+    NSMutableData *digest = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final([digest mutableBytes], context);
+    free(context);
+
+    if (streamError) {
+        if (error) {
+            *error = streamError;
+        }
+
+        return nil;
+    }
+
+    return digest;
+}
+
 @interface AFHTTPRequestSerializer ()
 @property (readwrite, nonatomic, strong) NSMutableSet *mutableObservedChangedKeyPaths;
-@property (readwrite, nonatomic, strong) NSMutableDictionary *mutableHTTPRequestHeaders;
+@property (readwrite, atomic, copy) NSDictionary *immutableHTTPRequestHeaders;
 @property (readwrite, nonatomic, strong) dispatch_queue_t requestHeaderModificationQueue;
+@property (readwrite, atomic, copy) NSDictionary *hostUploadBandwidthShapers;
+@property (readwrite, atomic, copy) NSURLRequest *requestPrototype;
+@property (readwrite, nonatomic, assign) BOOL serializedRequestsAreMutableCopies;
+@property (readwrite, nonatomic, assign) BOOL usesBuiltInRequestConstruction;
 @property (readwrite, nonatomic, assign) AFHTTPRequestQueryStringSerializationStyle queryStringSerializationStyle;
 @property (readwrite, nonatomic, copy) AFQueryStringSerializationBlock queryStringSerialization;
+
+- (NSURLRequest *)currentRequestPrototype;
+
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                       URL:(NSURL *)url
+                                parameters:(id)parameters
+                                     error:(NSError *__autoreleasing *)error;
 @end
 
 @implementation AFHTTPRequestSerializer
@@ -205,8 +730,10 @@ static void *AFHTTPRequestSerializerObserverContext = &AFHTTPRequestSerializerOb
 
     self.stringEncoding = NSUTF8StringEncoding;
 
-    self.mutableHTTPRequestHeaders = [NSMutableDictionary dictionary];
-    self.requestHeaderModificationQueue = dispatch_queue_create("requestHeaderModificationQueue", DISPATCH_QUEUE_CONCURRENT);
+    self.immutableHTTPRequestHeaders = @{};
+    self.requestHeaderModificationQueue = dispatch_queue_create("requestHeaderModificationQueue", DISPATCH_QUEUE_SERIAL);
+    self.serializedRequestsAreMutableCopies = AFRequestSerializerClassReturnsMutableCopies([self class]);
+    self.usesBuiltInRequestConstruction = self.serializedRequestsAreMutableCopies && [[self class] instanceMethodForSelector:@selector(requestWithMethod:URLString:parameters:error:)] == [AFHTTPRequestSerializer instanceMethodForSelector:@selector(requestWithMethod:URLString:parameters:error:)];
 
     // Accept-Language HTTP Header; see http://www.w3.org/Protocols/rfc2616/rfc2616-sec14.html#sec14.4
     NSMutableArray *acceptLanguagesComponents = [NSMutableArray array];
@@ -301,28 +828,32 @@ static void *AFHTTPRequestSerializerObserverContext = &AFHTTPRequestSerializerOb
 
 #pragma mark -
 
+// Headers are kept as an immutable snapshot, which readers take without hopping onto `requestHeaderModificationQueue`.
+// Writers are serialized on that queue, and publish a modified copy of the snapshot with an atomic store.
+
 - (NSDictionary *)HTTPRequestHeaders {
-    NSDictionary __block *value;
+    return self.immutableHTTPRequestHeaders;
+}
+
+- (void)modifyHTTPRequestHeadersUsingBlock:(void (^)(NSMutableDictionary *mutableHTTPRequestHeaders))block {
     dispatch_sync(self.requestHeaderModificationQueue, ^{
-        value = [NSDictionary dictionaryWithDictionary:self.mutableHTTPRequestHeaders];
+        NSMutableDictionary *mutableHTTPRequestHeaders = [self.immutableHTTPRequestHeaders mutableCopy];
+        block(mutableHTTPRequestHeaders);
+        self.immutableHTTPRequestHeaders = mutableHTTPRequestHeaders;
+        self.requestPrototype = nil;
     });
-    return value;
 }
 
 - (void)setValue:(NSString *)value
 forHTTPHeaderField:(NSString *)field
 {
-    dispatch_barrier_async(self.requestHeaderModificationQueue, ^{
-        [self.mutableHTTPRequestHeaders setValue:value forKey:field];
-    });
+    [self modifyHTTPRequestHeadersUsingBlock:^(NSMutableDictionary *mutableHTTPRequestHeaders) {
+        [mutableHTTPRequestHeaders setValue:value forKey:field];
+    }];
 }
 
 - (NSString *)valueForHTTPHeaderField:(NSString *)field {
-    NSString __block *value;
-    dispatch_sync(self.requestHeaderModificationQueue, ^{
-        value = [self.mutableHTTPRequestHeaders valueForKey:field];
-    });
-    return value;
+    return [self.immutableHTTPRequestHeaders valueForKey:field];
 }
 
 - (void)setAuthorizationHeaderFieldWithUsername:(NSString *)username
@@ -334,9 +865,9 @@ forHTTPHeaderField:(NSString *)field
 }
 
 - (void)clearAuthorizationHeader {
-    dispatch_barrier_async(self.requestHeaderModificationQueue, ^{
-        [self.mutableHTTPRequestHeaders removeObjectForKey:@"Authorization"];
-    });
+    [self modifyHTTPRequestHeadersUsingBlock:^(NSMutableDictionary *mutableHTTPRequestHeaders) {
+        [mutableHTTPRequestHeaders removeObjectForKey:@"Authorization"];
+    }];
 }
 
 #pragma mark -
@@ -352,30 +883,128 @@ forHTTPHeaderField:(NSString *)field
 
 #pragma mark -
 
-- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
-                                 URLString:(NSString *)URLString
-                                parameters:(id)parameters
-                                     error:(NSError *__autoreleasing *)error
+- (void)setUploadBandwidthShaper:(AFBandwidthShaper *)shaper
+                         forHost:(NSString *)host
 {
-    NSParameterAssert(method);
-    NSParameterAssert(URLString);
-
-    NSURL *url = [NSURL URLWithString:URLString];
+    NSParameterAssert(host);
 
+    dispatch_sync(self.requestHeaderModificationQueue, ^{
+        NSMutableDictionary *mutableHostUploadBandwidthShapers = [NSMutableDictionary dictionaryWithDictionary:self.hostUploadBandwidthShapers];
+        [mutableHostUploadBandwidthShapers setValue:shaper forKey:[host lowercaseString]];
+        self.hostUploadBandwidthShapers = mutableHostUploadBandwidthShapers;
+    });
+}
+
+- (AFBandwidthShaper *)uploadBandwidthShaperForHost:(NSString *)host {
+    AFBandwidthShaper *shaper = host ? self.hostUploadBandwidthShapers[[host lowercaseString]] : nil;
+
+    return shaper ?: self.uploadBandwidthShaper;
+}
+
+#pragma mark -
+
+/**
+ Returns a request with the changed observed properties and the default headers already applied, which `requestWithMethod:URLString:parameters:error:` copies instead of applying them one by one. The prototype is built lazily on `requestHeaderModificationQueue`, and discarded on that same queue whenever an observed property or a header changes.
+ */
+- (NSURLRequest *)currentRequestPrototype {
+    NSURLRequest __block *prototype = self.requestPrototype;
+    if (prototype) {
+        return prototype;
+    }
+
+    dispatch_sync(self.requestHeaderModificationQueue, ^{
+        if (!self.requestPrototype) {
+            NSMutableURLRequest *mutablePrototype = [[NSMutableURLRequest alloc] init];
+            for (NSString *keyPath in AFHTTPRequestSerializerObservedKeyPaths()) {
+                if ([self.mutableObservedChangedKeyPaths containsObject:keyPath]) {
+                    [mutablePrototype setValue:[self valueForKeyPath:keyPath] forKey:keyPath];
+                }
+            }
+
+            [self.immutableHTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+                [mutablePrototype setValue:value forHTTPHeaderField:field];
+            }];
+
+            self.requestPrototype = mutablePrototype;
+        }
+
+        prototype = self.requestPrototype;
+    });
+
+    return prototype;
+}
+
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                 URLString:(NSString *)URLString
+                                parameters:(id)parameters
+                                     error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(method);
+    NSParameterAssert(URLString);
+
+    NSURL *url = [NSURL URLWithString:URLString];
+
+    return [self requestWithMethod:method URL:url parameters:parameters error:error];
+}
+
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                       URL:(NSURL *)url
+                                parameters:(id)parameters
+                                     error:(NSError *__autoreleasing *)error
+{
     NSParameterAssert(url);
 
-    NSMutableURLRequest *mutableRequest = [[NSMutableURLRequest alloc] initWithURL:url];
+    NSMutableURLRequest *mutableRequest = [[self currentRequestPrototype] mutableCopy];
+    mutableRequest.URL = url;
     mutableRequest.HTTPMethod = method;
 
-    for (NSString *keyPath in AFHTTPRequestSerializerObservedKeyPaths()) {
-        if ([self.mutableObservedChangedKeyPaths containsObject:keyPath]) {
-            [mutableRequest setValue:[self valueForKeyPath:keyPath] forKey:keyPath];
+    NSURLRequest *serializedRequest = [self requestBySerializingRequest:mutableRequest withParameters:parameters error:error];
+    if (self.serializedRequestsAreMutableCopies) {
+        return (NSMutableURLRequest *)serializedRequest;
+    }
+
+	return [serializedRequest mutableCopy];
+}
+
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                 URLString:(NSString *)URLString
+                             relativeToURL:(NSURL *)baseURL
+                                parameters:(id)parameters
+                                     error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(method);
+    NSParameterAssert(URLString);
+
+    // Subclasses that customize request construction get the URL string they have always been passed
+    if (!self.usesBuiltInRequestConstruction) {
+        return [self requestWithMethod:method URLString:[[NSURL URLWithString:URLString relativeToURL:baseURL] absoluteString] parameters:parameters error:error];
+    }
+
+    if (parameters && !self.queryStringSerialization && [self.HTTPMethodsEncodingParametersInURI containsObject:[method uppercaseString]]) {
+        NSString *query = nil;
+        switch (self.queryStringSerializationStyle) {
+            case AFHTTPRequestQueryStringDefaultStyle:
+                query = AFQueryStringFromParameters(parameters);
+                break;
+        }
+
+        // URL strings with a fragment, or with an empty query, have the query appended in ways that can't be composed up front
+        NSRange queryDelimiterRange = [URLString rangeOfString:@"?"];
+        if (query.length > 0 && URLString.length > 0 && [URLString rangeOfString:@"#"].location == NSNotFound && NSMaxRange(queryDelimiterRange) != URLString.length) {
+            NSString *composedURLString = [URLString stringByAppendingFormat:queryDelimiterRange.location == NSNotFound ? @"?%@" : @"&%@", query];
+            NSURL *url = [[NSURL URLWithString:composedURLString relativeToURL:baseURL] absoluteURL];
+            if (url) {
+                return [self requestWithMethod:method URL:url parameters:nil error:error];
+            }
         }
     }
 
-    mutableRequest = [[self requestBySerializingRequest:mutableRequest withParameters:parameters error:error] mutableCopy];
+    NSURL *url = [[NSURL URLWithString:URLString relativeToURL:baseURL] absoluteURL];
+    if (!url) {
+        return [self requestWithMethod:method URLString:[[NSURL URLWithString:URLString relativeToURL:baseURL] absoluteString] parameters:parameters error:error];
+    }
 
-	return mutableRequest;
+    return [self requestWithMethod:method URL:url parameters:parameters error:error];
 }
 
 - (NSMutableURLRequest *)multipartFormRequestWithMethod:(NSString *)method
@@ -390,6 +1019,7 @@ forHTTPHeaderField:(NSString *)field
     NSMutableURLRequest *mutableRequest = [self requestWithMethod:method URLString:URLString parameters:nil error:error];
 
     __block AFStreamingMultipartFormData *formData = [[AFStreamingMultipartFormData alloc] initWithURLRequest:mutableRequest stringEncoding:NSUTF8StringEncoding];
+    formData.bandwidthShaper = [self uploadBandwidthShaperForHost:mutableRequest.URL.host];
 
     if (parameters) {
         for (AFQueryStringPair *pair in AFQueryStringPairsFromDictionary(parameters)) {
@@ -418,43 +1048,40 @@ forHTTPHeaderField:(NSString *)field
 - (NSMutableURLRequest *)requestWithMultipartFormRequest:(NSURLRequest *)request
                              writingStreamContentsToFile:(NSURL *)fileURL
                                        completionHandler:(void (^)(NSError *error))handler
+{
+    return [self requestWithMultipartFormRequest:request writingStreamContentsToFile:fileURL bufferSize:AFMultipartFormSpoolDefaultBufferSize progress:nil completionHandler:handler];
+}
+
+- (NSMutableURLRequest *)requestWithMultipartFormRequest:(NSURLRequest *)request
+                             writingStreamContentsToFile:(NSURL *)fileURL
+                                              bufferSize:(NSUInteger)bufferSize
+                                                progress:(void (^)(NSProgress *spoolProgress))progress
+                                       completionHandler:(void (^)(NSError *error))handler
 {
     NSParameterAssert(request.HTTPBodyStream);
     NSParameterAssert([fileURL isFileURL]);
 
     NSInputStream *inputStream = request.HTTPBodyStream;
-    NSOutputStream *outputStream = [[NSOutputStream alloc] initWithURL:fileURL append:NO];
-    __block NSError *error = nil;
+    int64_t expectedLength = [[request valueForHTTPHeaderField:@"Content-Length"] longLongValue];
+
+    size_t pageSize = (size_t)getpagesize();
+    size_t alignedBufferSize = bufferSize > 0 ? (size_t)bufferSize : AFMultipartFormSpoolDefaultBufferSize;
+    alignedBufferSize = ((alignedBufferSize + pageSize - 1) / pageSize) * pageSize;
+
+    void (^progressHandler)(int64_t) = nil;
+    if (progress) {
+        NSProgress *spoolProgress = [[NSProgress alloc] initWithParent:nil userInfo:nil];
+        spoolProgress.totalUnitCount = expectedLength > 0 ? expectedLength : -1;
+        progressHandler = ^(int64_t numberOfBytesWritten) {
+            spoolProgress.completedUnitCount = numberOfBytesWritten;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                progress(spoolProgress);
+            });
+        };
+    }
 
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        [inputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
-        [outputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
-
-        [inputStream open];
-        [outputStream open];
-
-        while ([inputStream hasBytesAvailable] && [outputStream hasSpaceAvailable]) {
-            uint8_t buffer[1024];
-
-            NSInteger bytesRead = [inputStream read:buffer maxLength:1024];
-            if (inputStream.streamError || bytesRead < 0) {
-                error = inputStream.streamError;
-                break;
-            }
-
-            NSInteger bytesWritten = [outputStream write:buffer maxLength:(NSUInteger)bytesRead];
-            if (outputStream.streamError || bytesWritten < 0) {
-                error = outputStream.streamError;
-                break;
-            }
-
-            if (bytesRead == 0 && bytesWritten == 0) {
-                break;
-            }
-        }
-
-        [outputStream close];
-        [inputStream close];
+        NSError *error = AFWriteInputStreamContentsToFile(inputStream, fileURL, alignedBufferSize, expectedLength, progressHandler);
 
         if (handler) {
             dispatch_async(dispatch_get_main_queue(), ^{
@@ -469,6 +1096,34 @@ forHTTPHeaderField:(NSString *)field
     return mutableRequest;
 }
 
+- (void)computeSHA256DigestOfMultipartFormRequest:(NSURLRequest *)request
+                                completionHandler:(void (^)(NSData *digest, NSError *error))handler
+{
+    NSParameterAssert(request.HTTPBodyStream);
+    NSParameterAssert(handler);
+
+    // Read a copy of the body, leaving the stream of the request untouched for the upload itself
+    NSInputStream *inputStream = AFBodyStreamCopyForDigest(request.HTTPBodyStream);
+    if (!inputStream) {
+        NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The request body stream can't be copied, so it can't be read ahead of the upload.", @"AFNetworking", nil)};
+        NSError *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorRequestBodyStreamExhausted userInfo:userInfo];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            handler(nil, error);
+        });
+
+        return;
+    }
+
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSError *error = nil;
+        NSData *digest = AFSHA256DigestOfInputStreamContents(inputStream, &error);
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            handler(digest, error);
+        });
+    });
+}
+
 #pragma mark - AFURLRequestSerialization
 
 - (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
@@ -541,11 +1196,15 @@ forHTTPHeaderField:(NSString *)field
                        context:(void *)context
 {
     if (context == AFHTTPRequestSerializerObserverContext) {
-        if ([change[NSKeyValueChangeNewKey] isEqual:[NSNull null]]) {
-            [self.mutableObservedChangedKeyPaths removeObject:keyPath];
-        } else {
-            [self.mutableObservedChangedKeyPaths addObject:keyPath];
-        }
+        dispatch_sync(self.requestHeaderModificationQueue, ^{
+            if ([change[NSKeyValueChangeNewKey] isEqual:[NSNull null]]) {
+                [self.mutableObservedChangedKeyPaths removeObject:keyPath];
+            } else {
+                [self.mutableObservedChangedKeyPaths addObject:keyPath];
+            }
+
+            self.requestPrototype = nil;
+        });
     }
 }
 
@@ -561,16 +1220,15 @@ forHTTPHeaderField:(NSString *)field
         return nil;
     }
 
-    self.mutableHTTPRequestHeaders = [[decoder decodeObjectOfClass:[NSDictionary class] forKey:NSStringFromSelector(@selector(mutableHTTPRequestHeaders))] mutableCopy];
+    // Archived under the key of the former mutable header storage, to remain compatible with existing archives
+    self.immutableHTTPRequestHeaders = [decoder decodeObjectOfClass:[NSDictionary class] forKey:@"mutableHTTPRequestHeaders"] ?: @{};
     self.queryStringSerializationStyle = (AFHTTPRequestQueryStringSerializationStyle)[[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(queryStringSerializationStyle))] unsignedIntegerValue];
 
     return self;
 }
 
 - (void)encodeWithCoder:(NSCoder *)coder {
-    dispatch_sync(self.requestHeaderModificationQueue, ^{
-        [coder encodeObject:self.mutableHTTPRequestHeaders forKey:NSStringFromSelector(@selector(mutableHTTPRequestHeaders))];
-    });
+    [coder encodeObject:self.immutableHTTPRequestHeaders forKey:@"mutableHTTPRequestHeaders"];
     [coder encodeInteger:self.queryStringSerializationStyle forKey:NSStringFromSelector(@selector(queryStringSerializationStyle))];
 }
 
@@ -578,11 +1236,11 @@ forHTTPHeaderField:(NSString *)field
 
 - (instancetype)copyWithZone:(NSZone *)zone {
     AFHTTPRequestSerializer *serializer = [[[self class] allocWithZone:zone] init];
-    dispatch_sync(self.requestHeaderModificationQueue, ^{
-        serializer.mutableHTTPRequestHeaders = [self.mutableHTTPRequestHeaders mutableCopyWithZone:zone];
-    });
+    serializer.immutableHTTPRequestHeaders = self.immutableHTTPRequestHeaders;
     serializer.queryStringSerializationStyle = self.queryStringSerializationStyle;
     serializer.queryStringSerialization = self.queryStringSerialization;
+    serializer.uploadBandwidthShaper = self.uploadBandwidthShaper;
+    serializer.hostUploadBandwidthShapers = self.hostUploadBandwidthShapers;
 
     return serializer;
 }
@@ -609,19 +1267,323 @@ static inline NSString * AFMultipartFormFinalBoundary(NSString *boundary) {
     return [NSString stringWithFormat:@"%@--%@--%@", kAFMultipartFormCRLF, boundary, kAFMultipartFormCRLF];
 }
 
-static inline NSString * AFContentTypeForPathExtension(NSString *extension) {
+typedef struct {
+    const char *pathExtension;
+    const char *contentType;
+} AFContentTypeTableEntry;
+
+/**
+ Content types of common file extensions, matching the preferred MIME types of the platform. The table must stay sorted by extension, since it is binary searched.
+ */
+static const AFContentTypeTableEntry AFContentTypeTable[] = {
+    {"3gp", "video/3gpp"},
+    {"bmp", "image/bmp"},
+    {"css", "text/css"},
+    {"doc", "application/msword"},
+    {"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+    {"gif", "image/gif"},
+    {"gz", "application/x-gzip"},
+    {"heic", "image/heic"},
+    {"htm", "text/html"},
+    {"html", "text/html"},
+    {"jpeg", "image/jpeg"},
+    {"jpg", "image/jpeg"},
+    {"json", "application/json"},
+    {"m4v", "video/x-m4v"},
+    {"mov", "video/quicktime"},
+    {"mp3", "audio/mpeg"},
+    {"mp4", "video/mp4"},
+    {"pdf", "application/pdf"},
+    {"png", "image/png"},
+    {"ppt", "application/vnd.ms-powerpoint"},
+    {"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+    {"rtf", "text/rtf"},
+    {"svg", "image/svg+xml"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+    {"txt", "text/plain"},
+    {"xls", "application/vnd.ms-excel"},
+    {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+    {"xml", "application/xml"},
+    {"zip", "application/zip"},
+};
+
+static int AFContentTypeTableEntryCompare(const void *key, const void *entry) {
+    return strcmp((const char *)key, ((const AFContentTypeTableEntry *)entry)->pathExtension);
+}
+
+FOUNDATION_EXPORT NSString * AFBuiltInContentTypeForPathExtension(NSString *extension);
+
+/**
+ Returns the content type of `extension` from the built-in table, or `nil` if the extension is not in the table.
+ */
+NSString * AFBuiltInContentTypeForPathExtension(NSString *extension) {
+    const char *key = [[extension lowercaseString] UTF8String];
+    if (!key) {
+        return nil;
+    }
+
+    const AFContentTypeTableEntry *entry = bsearch(key, AFContentTypeTable, sizeof(AFContentTypeTable) / sizeof(AFContentTypeTable[0]), sizeof(AFContentTypeTableEntry), AFContentTypeTableEntryCompare);
+
+    return entry ? @(entry->contentType) : nil;
+}
+
+static NSString * AFUncachedContentTypeForPathExtension(NSString *extension) {
     NSString *UTI = (__bridge_transfer NSString *)UTTypeCreatePreferredIdentifierForTag(kUTTagClassFilenameExtension, (__bridge CFStringRef)extension, NULL);
     NSString *contentType = (__bridge_transfer NSString *)UTTypeCopyPreferredTagWithClass((__bridge CFStringRef)UTI, kUTTagClassMIMEType);
-    if (!contentType) {
+    if (contentType) {
+        return contentType;
+    }
+
+    return AFBuiltInContentTypeForPathExtension(extension) ?: @"application/octet-stream";
+}
+
+#define AF_CONTENT_TYPE_CACHE_SIZE 128
+
+/**
+ Direct-mapped cache of content types, indexed by the hash of the lowercased extension. A slot holds the extension that was looked up last among those that map to it, and is only accessed with `AFContentTypeCacheMutex` held, which is never held during a platform lookup.
+ */
+static NSString *AFContentTypeCachePathExtensions[AF_CONTENT_TYPE_CACHE_SIZE];
+static NSString *AFContentTypeCacheContentTypes[AF_CONTENT_TYPE_CACHE_SIZE];
+static pthread_mutex_t AFContentTypeCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static NSString * AFContentTypeForPathExtension(NSString *extension) {
+    if (!extension) {
         return @"application/octet-stream";
-    } else {
+    }
+
+    NSString *pathExtension = [extension lowercaseString];
+    NSUInteger slot = [pathExtension hash] % AF_CONTENT_TYPE_CACHE_SIZE;
+
+    NSString *contentType = nil;
+    pthread_mutex_lock(&AFContentTypeCacheMutex);
+    if ([AFContentTypeCachePathExtensions[slot] isEqualToString:pathExtension]) {
+        contentType = AFContentTypeCacheContentTypes[slot];
+    }
+    pthread_mutex_unlock(&AFContentTypeCacheMutex);
+
+    if (contentType) {
         return contentType;
     }
+
+    contentType = [AFUncachedContentTypeForPathExtension(pathExtension) copy];
+
+    pthread_mutex_lock(&AFContentTypeCacheMutex);
+    AFContentTypeCachePathExtensions[slot] = [pathExtension copy];
+    AFContentTypeCacheContentTypes[slot] = contentType;
+    pthread_mutex_unlock(&AFContentTypeCacheMutex);
+
+    return contentType;
 }
 
 NSUInteger const kAFUploadStream3GSuggestedPacketSize = 1024 * 16;
 NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 
+@interface AFBandwidthShaper () {
+    NSUInteger _bytesPerSecond;
+    NSUInteger _burstSize;
+    double _numberOfAvailableBytes;
+    NSTimeInterval _lastRefillTime;
+    NSUInteger _numberOfConsumers;
+    NSUInteger _wakeUpGeneration;
+    BOOL _wakeUpScheduled;
+}
+@property (readwrite, nonatomic, strong) NSLock *lock;
+@property (readwrite, nonatomic, strong) NSMutableArray *waiters;
+@property (readwrite, nonatomic, strong) dispatch_queue_t wakeUpQueue;
+
+- (void)addConsumer;
+- (void)removeConsumer;
+- (BOOL)hasAvailableBytes;
+- (NSUInteger)consumeBytesUpToLength:(NSUInteger)length;
+- (void)refundBytes:(NSUInteger)length;
+- (void)notifyWhenBytesAvailable:(dispatch_block_t)block;
+@end
+
+@implementation AFBandwidthShaper
+
+- (instancetype)init {
+    return [self initWithBytesPerSecond:0 burstSize:0];
+}
+
+- (instancetype)initWithBytesPerSecond:(NSUInteger)bytesPerSecond
+                             burstSize:(NSUInteger)burstSize
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _bytesPerSecond = bytesPerSecond;
+    _burstSize = burstSize;
+    _numberOfAvailableBytes = (double)[self effectiveBurstSize];
+    _lastRefillTime = [[NSProcessInfo processInfo] systemUptime];
+
+    self.lock = [[NSLock alloc] init];
+    self.waiters = [NSMutableArray array];
+    self.wakeUpQueue = dispatch_queue_create("com.alamofire.networking.bandwidth-shaper", DISPATCH_QUEUE_SERIAL);
+
+    return self;
+}
+
+- (NSUInteger)bytesPerSecond {
+    [self.lock lock];
+    NSUInteger bytesPerSecond = _bytesPerSecond;
+    [self.lock unlock];
+
+    return bytesPerSecond;
+}
+
+- (void)setBytesPerSecond:(NSUInteger)bytesPerSecond {
+    [self.lock lock];
+    [self refillAvailableBytes];
+    _bytesPerSecond = bytesPerSecond;
+    _numberOfAvailableBytes = MIN(_numberOfAvailableBytes, (double)[self effectiveBurstSize]);
+    [self rescheduleWakeUp];
+    [self.lock unlock];
+}
+
+- (NSUInteger)burstSize {
+    [self.lock lock];
+    NSUInteger burstSize = _burstSize;
+    [self.lock unlock];
+
+    return burstSize;
+}
+
+- (void)setBurstSize:(NSUInteger)burstSize {
+    [self.lock lock];
+    [self refillAvailableBytes];
+    _burstSize = burstSize;
+    _numberOfAvailableBytes = MIN(_numberOfAvailableBytes, (double)[self effectiveBurstSize]);
+    [self rescheduleWakeUp];
+    [self.lock unlock];
+}
+
+#pragma mark -
+
+// The following methods must be called with `lock` held.
+
+- (NSUInteger)effectiveBurstSize {
+    return _burstSize > 0 ? _burstSize : MAX(_bytesPerSecond, (NSUInteger)1);
+}
+
+- (NSUInteger)fairShare {
+    return MAX([self effectiveBurstSize] / MAX(_numberOfConsumers, (NSUInteger)1), (NSUInteger)1);
+}
+
+- (void)refillAvailableBytes {
+    NSTimeInterval now = [[NSProcessInfo processInfo] systemUptime];
+    if (_bytesPerSecond > 0) {
+        _numberOfAvailableBytes = MIN(_numberOfAvailableBytes + (now - _lastRefillTime) * (double)_bytesPerSecond, (double)[self effectiveBurstSize]);
+    }
+
+    _lastRefillTime = now;
+}
+
+- (void)rescheduleWakeUp {
+    _wakeUpGeneration++;
+    _wakeUpScheduled = NO;
+    [self scheduleWakeUpIfNeeded];
+}
+
+- (void)scheduleWakeUpIfNeeded {
+    if (_wakeUpScheduled || [self.waiters count] == 0) {
+        return;
+    }
+
+    // Wait until there are enough tokens for every waiting stream to take its share, so that they are served in turn
+    NSTimeInterval delay = 0.0;
+    if (_bytesPerSecond > 0) {
+        [self refillAvailableBytes];
+        double numberOfNeededBytes = MIN((double)[self fairShare] * (double)[self.waiters count], (double)[self effectiveBurstSize]);
+        delay = MAX((numberOfNeededBytes - _numberOfAvailableBytes) / (double)_bytesPerSecond, 0.0);
+    }
+
+    _wakeUpScheduled = YES;
+    NSUInteger generation = _wakeUpGeneration;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.wakeUpQueue, ^{
+        [self wakeUpWaitersForGeneration:generation];
+    });
+}
+
+#pragma mark -
+
+- (void)wakeUpWaitersForGeneration:(NSUInteger)generation {
+    [self.lock lock];
+    if (generation != _wakeUpGeneration) {
+        [self.lock unlock];
+        return;
+    }
+
+    _wakeUpScheduled = NO;
+    NSArray *waiters = [self.waiters copy];
+    [self.waiters removeAllObjects];
+    [self.lock unlock];
+
+    for (dispatch_block_t waiter in waiters) {
+        waiter();
+    }
+}
+
+- (void)addConsumer {
+    [self.lock lock];
+    _numberOfConsumers++;
+    [self.lock unlock];
+}
+
+- (void)removeConsumer {
+    [self.lock lock];
+    if (_numberOfConsumers > 0) {
+        _numberOfConsumers--;
+    }
+    [self.lock unlock];
+}
+
+- (BOOL)hasAvailableBytes {
+    [self.lock lock];
+    [self refillAvailableBytes];
+    BOOL hasAvailableBytes = _bytesPerSecond == 0 || _numberOfAvailableBytes >= 1.0;
+    [self.lock unlock];
+
+    return hasAvailableBytes;
+}
+
+- (NSUInteger)consumeBytesUpToLength:(NSUInteger)length {
+    [self.lock lock];
+    if (_bytesPerSecond == 0) {
+        [self.lock unlock];
+        return length;
+    }
+
+    [self refillAvailableBytes];
+    NSUInteger numberOfGrantedBytes = MIN(MIN(length, [self fairShare]), (NSUInteger)_numberOfAvailableBytes);
+    _numberOfAvailableBytes -= (double)numberOfGrantedBytes;
+    [self.lock unlock];
+
+    return numberOfGrantedBytes;
+}
+
+- (void)refundBytes:(NSUInteger)length {
+    [self.lock lock];
+    if (_bytesPerSecond > 0) {
+        [self refillAvailableBytes];
+        _numberOfAvailableBytes = MIN(_numberOfAvailableBytes + (double)length, (double)[self effectiveBurstSize]);
+    }
+    [self.lock unlock];
+}
+
+- (void)notifyWhenBytesAvailable:(dispatch_block_t)block {
+    [self.lock lock];
+    [self.waiters addObject:[block copy]];
+    [self scheduleWakeUpIfNeeded];
+    [self.lock unlock];
+}
+
+@end
+
+#pragma mark -
+
 @interface AFHTTPBodyPart : NSObject
 @property (nonatomic, assign) NSStringEncoding stringEncoding;
 @property (nonatomic, strong) NSDictionary *headers;
@@ -635,6 +1597,7 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 
 @property (readonly, nonatomic, assign, getter = hasBytesAvailable) BOOL bytesAvailable;
 @property (readonly, nonatomic, assign) unsigned long long contentLength;
+@property (readonly, nonatomic, strong) NSError *error;
 
 - (NSInteger)read:(uint8_t *)buffer
         maxLength:(NSUInteger)length;
@@ -642,7 +1605,9 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 
 @interface AFMultipartBodyStream : NSInputStream <NSStreamDelegate>
 @property (nonatomic, assign) NSUInteger numberOfBytesInPacket;
-@property (nonatomic, assign) NSTimeInterval delay;
+@property (nonatomic, strong) AFBandwidthShaper *bandwidthShaper;
+@property (nonatomic, strong) AFBandwidthShaper *throttleBandwidthShaper;
+@property (nonatomic, copy) void (^digestCompletionHandler)(NSData *digest);
 @property (nonatomic, strong) NSInputStream *inputStream;
 @property (readonly, nonatomic, assign) unsigned long long contentLength;
 @property (readonly, nonatomic, assign, getter = isEmpty) BOOL empty;
@@ -652,6 +1617,26 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 - (void)appendHTTPBodyPart:(AFHTTPBodyPart *)bodyPart;
 @end
 
+/**
+ Returns a copy of `bodyStream` for computing a digest ahead of the upload, or `nil` if it can't be copied. Multipart body streams are copied without their digest completion handler, and without any bandwidth shaping, so that the copy is read at full speed and doesn't take tokens from the shapers of actual uploads.
+ */
+static NSInputStream * AFBodyStreamCopyForDigest(NSInputStream *bodyStream) {
+    if (![bodyStream conformsToProtocol:@protocol(NSCopying)]) {
+        return nil;
+    }
+
+    NSInputStream *bodyStreamCopy = [(id <NSCopying>)bodyStream copyWithZone:nil];
+    if ([bodyStreamCopy isKindOfClass:[AFMultipartBodyStream class]]) {
+        AFMultipartBodyStream *multipartBodyStreamCopy = (AFMultipartBodyStream *)bodyStreamCopy;
+        multipartBodyStreamCopy.digestCompletionHandler = nil;
+        multipartBodyStreamCopy.bandwidthShaper = nil;
+        multipartBodyStreamCopy.throttleBandwidthShaper = nil;
+        multipartBodyStreamCopy.numberOfBytesInPacket = NSIntegerMax;
+    }
+
+    return bodyStreamCopy;
+}
+
 #pragma mark -
 
 @interface AFStreamingMultipartFormData ()
@@ -684,6 +1669,14 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
     _request = [request mutableCopy];
 }
 
+- (AFBandwidthShaper *)bandwidthShaper {
+    return self.bodyStream.bandwidthShaper;
+}
+
+- (void)setBandwidthShaper:(AFBandwidthShaper *)bandwidthShaper {
+    self.bodyStream.bandwidthShaper = bandwidthShaper;
+}
+
 - (BOOL)appendPartWithFileURL:(NSURL *)fileURL
                          name:(NSString *)name
                         error:(NSError * __autoreleasing *)error
@@ -811,11 +1804,15 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
     [self.bodyStream appendHTTPBodyPart:bodyPart];
 }
 
+- (void)computeSHA256DigestWhileStreamingWithCompletionHandler:(void (^)(NSData *digest))handler {
+    self.bodyStream.digestCompletionHandler = handler;
+}
+
 - (void)throttleBandwidthWithPacketSize:(NSUInteger)numberOfBytes
                                   delay:(NSTimeInterval)delay
 {
     self.bodyStream.numberOfBytesInPacket = numberOfBytes;
-    self.bodyStream.delay = delay;
+    self.bodyStream.throttleBandwidthShaper = delay > 0.0f ? [[AFBandwidthShaper alloc] initWithBytesPerSecond:(NSUInteger)ceil((double)numberOfBytes / delay) burstSize:numberOfBytes] : nil;
 }
 
 - (NSMutableURLRequest *)requestByFinalizingMultipartFormData {
@@ -842,7 +1839,18 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 @property (readwrite, copy) NSError *streamError;
 @end
 
-@interface AFMultipartBodyStream () <NSCopying>
+@interface AFMultipartBodyStream () <NSCopying> {
+    CFReadStreamClientCallBack _clientCallback;
+    CFStreamClientContext _clientContext;
+    CFOptionFlags _clientFlags;
+    CFRunLoopRef _clientRunLoop;
+    NSMutableSet *_clientRunLoopModes;
+    NSArray *_activeBandwidthShapers;
+    BOOL _waitingForBandwidth;
+    BOOL _reachedEnd;
+    CC_SHA256_CTX _digestContext;
+    BOOL _digesting;
+}
 @property (readwrite, nonatomic, assign) NSStringEncoding stringEncoding;
 @property (readwrite, nonatomic, strong) NSMutableArray *HTTPBodyParts;
 @property (readwrite, nonatomic, strong) NSEnumerator *HTTPBodyPartEnumerator;
@@ -871,6 +1879,18 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
     return self;
 }
 
+- (void)dealloc {
+    for (AFBandwidthShaper *shaper in _activeBandwidthShapers) {
+        [shaper removeConsumer];
+    }
+
+    [self _setCFClientFlags:0 callback:NULL context:NULL];
+
+    if (_clientRunLoop) {
+        CFRelease(_clientRunLoop);
+    }
+}
+
 - (void)setInitialAndFinalBoundaries {
     if ([self.HTTPBodyParts count] > 0) {
         for (AFHTTPBodyPart *bodyPart in self.HTTPBodyParts) {
@@ -896,33 +1916,47 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 - (NSInteger)read:(uint8_t *)buffer
         maxLength:(NSUInteger)length
 {
-    if ([self streamStatus] == NSStreamStatusClosed) {
+    if ([self streamStatus] == NSStreamStatusClosed || _reachedEnd) {
+        [self postClientEvent:kCFStreamEventEndEncountered];
         return 0;
+    } else if ([self streamStatus] == NSStreamStatusError) {
+        return -1;
     }
 
+    NSUInteger maxLength = [self waitForBandwidthUpToLength:MIN(length, self.numberOfBytesInPacket)];
     NSInteger totalNumberOfBytesRead = 0;
 
-    while ((NSUInteger)totalNumberOfBytesRead < MIN(length, self.numberOfBytesInPacket)) {
+    while ((NSUInteger)totalNumberOfBytesRead < maxLength) {
         if (!self.currentHTTPBodyPart || ![self.currentHTTPBodyPart hasBytesAvailable]) {
             if (!(self.currentHTTPBodyPart = [self.HTTPBodyPartEnumerator nextObject])) {
+                _reachedEnd = YES;
                 break;
             }
         } else {
-            NSUInteger maxLength = MIN(length, self.numberOfBytesInPacket) - (NSUInteger)totalNumberOfBytesRead;
-            NSInteger numberOfBytesRead = [self.currentHTTPBodyPart read:&buffer[totalNumberOfBytesRead] maxLength:maxLength];
+            NSInteger numberOfBytesRead = [self.currentHTTPBodyPart read:&buffer[totalNumberOfBytesRead] maxLength:maxLength - (NSUInteger)totalNumberOfBytesRead];
             if (numberOfBytesRead == -1) {
-                self.streamError = self.currentHTTPBodyPart.inputStream.streamError;
-                break;
+                self.streamError = self.currentHTTPBodyPart.error;
+                self.streamStatus = NSStreamStatusError;
+                [self postClientEvent:kCFStreamEventErrorOccurred];
+                return -1;
             } else {
                 totalNumberOfBytesRead += numberOfBytesRead;
-
-                if (self.delay > 0.0f) {
-                    [NSThread sleepForTimeInterval:self.delay];
-                }
             }
         }
     }
 
+    [self.bandwidthShaper refundBytes:maxLength - (NSUInteger)totalNumberOfBytesRead];
+    [self.throttleBandwidthShaper refundBytes:maxLength - (NSUInteger)totalNumberOfBytesRead];
+
+    if (_digesting) {
+        AFSHA256Update(&_digestContext, buffer, (size_t)totalNumberOfBytesRead);
+        if (_reachedEnd) {
+            [self finishDigest];
+        }
+    }
+
+    [self notifyClientOfAvailableBytes];
+
     return totalNumberOfBytesRead;
 }
 
@@ -933,12 +1967,25 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 }
 
 - (BOOL)hasBytesAvailable {
-    return [self streamStatus] == NSStreamStatusOpen;
-}
-
-#pragma mark - NSStream
+    if ([self streamStatus] != NSStreamStatusOpen) {
+        return NO;
+    }
 
-- (void)open {
+    // Only clients that are notified of new bytes are told to wait, while all others keep reading and wait in `read:maxLength:`
+    if (_clientCallback && !_reachedEnd) {
+        AFBandwidthShaper *exhaustedShaper = [self exhaustedBandwidthShaper];
+        if (exhaustedShaper) {
+            [self notifyClientWhenBytesAvailableFromShaper:exhaustedShaper];
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - NSStream
+
+- (void)open {
     if (self.streamStatus == NSStreamStatusOpen) {
         return;
     }
@@ -947,10 +1994,35 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 
     [self setInitialAndFinalBoundaries];
     self.HTTPBodyPartEnumerator = [self.HTTPBodyParts objectEnumerator];
+    _reachedEnd = NO;
+
+    _digesting = self.digestCompletionHandler != nil;
+    if (_digesting) {
+        CC_SHA256_Init(&_digestContext);
+    }
+
+    NSMutableArray *activeBandwidthShapers = [NSMutableArray array];
+    if (self.bandwidthShaper) {
+        [activeBandwidthShapers addObject:self.bandwidthShaper];
+    }
+    if (self.throttleBandwidthShaper) {
+        [activeBandwidthShapers addObject:self.throttleBandwidthShaper];
+    }
+    [activeBandwidthShapers makeObjectsPerformSelector:@selector(addConsumer)];
+    _activeBandwidthShapers = activeBandwidthShapers;
+
+    [self postClientEvent:kCFStreamEventOpenCompleted];
+    [self notifyClientOfAvailableBytes];
 }
 
 - (void)close {
     self.streamStatus = NSStreamStatusClosed;
+    _digesting = NO;
+
+    for (AFBandwidthShaper *shaper in _activeBandwidthShapers) {
+        [shaper removeConsumer];
+    }
+    _activeBandwidthShapers = nil;
 }
 
 - (id)propertyForKey:(__unused NSString *)key {
@@ -980,26 +2052,179 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
     return length;
 }
 
+#pragma mark - Digest
+
+- (void)finishDigest {
+    NSMutableData *digest = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final([digest mutableBytes], &_digestContext);
+    _digesting = NO;
+
+    void (^handler)(NSData *) = self.digestCompletionHandler;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        handler(digest);
+    });
+}
+
+#pragma mark - Bandwidth Shaping
+
+/**
+ Takes up to `length` bytes from the bandwidth shapers of the stream, waiting for the shapers to refill if none are available. The stream is only ever read in that case if its client ignored `hasBytesAvailable`, or reads it synchronously.
+ */
+- (NSUInteger)waitForBandwidthUpToLength:(NSUInteger)length {
+    if (length == 0 || (!self.bandwidthShaper && !self.throttleBandwidthShaper)) {
+        return length;
+    }
+
+    while (YES) {
+        AFBandwidthShaper *refusingShaper = nil;
+        NSUInteger numberOfGrantedBytes = self.bandwidthShaper ? [self.bandwidthShaper consumeBytesUpToLength:length] : length;
+        if (numberOfGrantedBytes == 0) {
+            refusingShaper = self.bandwidthShaper;
+        } else if (self.throttleBandwidthShaper) {
+            NSUInteger numberOfThrottledBytes = [self.throttleBandwidthShaper consumeBytesUpToLength:numberOfGrantedBytes];
+            [self.bandwidthShaper refundBytes:numberOfGrantedBytes - numberOfThrottledBytes];
+            numberOfGrantedBytes = numberOfThrottledBytes;
+            if (numberOfGrantedBytes == 0) {
+                refusingShaper = self.throttleBandwidthShaper;
+            }
+        }
+
+        if (numberOfGrantedBytes > 0) {
+            return numberOfGrantedBytes;
+        }
+
+        // Wait on the shaper that refused, even if it has refilled in the meantime, rather than retrying right away
+        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+        [refusingShaper notifyWhenBytesAvailable:^{
+            dispatch_semaphore_signal(semaphore);
+        }];
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    }
+}
+
+- (AFBandwidthShaper *)exhaustedBandwidthShaper {
+    if (self.bandwidthShaper && ![self.bandwidthShaper hasAvailableBytes]) {
+        return self.bandwidthShaper;
+    } else if (self.throttleBandwidthShaper && ![self.throttleBandwidthShaper hasAvailableBytes]) {
+        return self.throttleBandwidthShaper;
+    }
+
+    return nil;
+}
+
+- (void)notifyClientWhenBytesAvailableFromShaper:(AFBandwidthShaper *)shaper {
+    if (_waitingForBandwidth || !_clientRunLoop) {
+        return;
+    }
+
+    _waitingForBandwidth = YES;
+
+    id runLoop = (__bridge id)_clientRunLoop;
+    NSArray *modes = [_clientRunLoopModes allObjects];
+    __weak __typeof(self)weakSelf = self;
+    [shaper notifyWhenBytesAvailable:^{
+        CFRunLoopPerformBlock((__bridge CFRunLoopRef)runLoop, (__bridge CFTypeRef)modes, ^{
+            __strong __typeof(weakSelf)strongSelf = weakSelf;
+            if (strongSelf) {
+                strongSelf->_waitingForBandwidth = NO;
+                [strongSelf notifyClientOfAvailableBytes];
+            }
+        });
+        CFRunLoopWakeUp((__bridge CFRunLoopRef)runLoop);
+    }];
+}
+
+- (void)notifyClientOfAvailableBytes {
+    if (_clientCallback && [self hasBytesAvailable]) {
+        [self postClientEvent:kCFStreamEventHasBytesAvailable];
+    }
+}
+
+- (void)postClientEvent:(CFStreamEventType)event {
+    if (!_clientCallback || !_clientRunLoop || !(_clientFlags & event)) {
+        return;
+    }
+
+    CFRunLoopRef runLoop = _clientRunLoop;
+    CFRunLoopPerformBlock(runLoop, (__bridge CFTypeRef)[_clientRunLoopModes allObjects], ^{
+        if (self->_clientCallback && (self->_clientFlags & event)) {
+            self->_clientCallback((__bridge CFReadStreamRef)self, event, self->_clientContext.info);
+        }
+    });
+    CFRunLoopWakeUp(runLoop);
+}
+
 #pragma mark - Undocumented CFReadStream Bridged Methods
 
-- (void)_scheduleInCFRunLoop:(__unused CFRunLoopRef)aRunLoop
-                     forMode:(__unused CFStringRef)aMode
-{}
+// Client events are posted to a single run loop, in every mode that the stream is scheduled in on it
+- (void)_scheduleInCFRunLoop:(CFRunLoopRef)aRunLoop
+                     forMode:(CFStringRef)aMode
+{
+    if (!_clientRunLoop || !CFEqual(_clientRunLoop, aRunLoop)) {
+        if (_clientRunLoop) {
+            CFRelease(_clientRunLoop);
+        }
 
-- (void)_unscheduleFromCFRunLoop:(__unused CFRunLoopRef)aRunLoop
-                         forMode:(__unused CFStringRef)aMode
-{}
+        _clientRunLoop = (CFRunLoopRef)CFRetain(aRunLoop);
+        _clientRunLoopModes = [NSMutableSet set];
+    }
 
-- (BOOL)_setCFClientFlags:(__unused CFOptionFlags)inFlags
-                 callback:(__unused CFReadStreamClientCallBack)inCallback
-                  context:(__unused CFStreamClientContext *)inContext {
-    return NO;
+    [_clientRunLoopModes addObject:[(__bridge NSString *)aMode copy]];
+
+    [self notifyClientOfAvailableBytes];
+}
+
+- (void)_unscheduleFromCFRunLoop:(CFRunLoopRef)aRunLoop
+                         forMode:(CFStringRef)aMode
+{
+    if (!_clientRunLoop || !CFEqual(_clientRunLoop, aRunLoop)) {
+        return;
+    }
+
+    [_clientRunLoopModes removeObject:(__bridge NSString *)aMode];
+    if ([_clientRunLoopModes count] == 0) {
+        CFRelease(_clientRunLoop);
+        _clientRunLoop = NULL;
+        _clientRunLoopModes = nil;
+    }
+}
+
+- (BOOL)_setCFClientFlags:(CFOptionFlags)inFlags
+                 callback:(CFReadStreamClientCallBack)inCallback
+                  context:(CFStreamClientContext *)inContext {
+    // Unshaped streams never have to wait for bytes, so clients keep reading them synchronously
+    if (inCallback && !self.bandwidthShaper && !self.throttleBandwidthShaper) {
+        return NO;
+    }
+
+    if (_clientContext.info && _clientContext.release) {
+        _clientContext.release(_clientContext.info);
+    }
+
+    memset(&_clientContext, 0, sizeof(_clientContext));
+    _clientCallback = inCallback;
+    _clientFlags = inFlags;
+
+    if (inCallback && inContext) {
+        memcpy(&_clientContext, inContext, sizeof(_clientContext));
+        if (_clientContext.info && _clientContext.retain) {
+            _clientContext.retain(_clientContext.info);
+        }
+    }
+
+    return YES;
 }
 
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(NSZone *)zone {
     AFMultipartBodyStream *bodyStreamCopy = [[[self class] allocWithZone:zone] initWithStringEncoding:self.stringEncoding];
+    bodyStreamCopy.numberOfBytesInPacket = self.numberOfBytesInPacket;
+    bodyStreamCopy.bandwidthShaper = self.bandwidthShaper;
+    bodyStreamCopy.digestCompletionHandler = self.digestCompletionHandler;
+    if (self.throttleBandwidthShaper) {
+        bodyStreamCopy.throttleBandwidthShaper = [[AFBandwidthShaper alloc] initWithBytesPerSecond:self.throttleBandwidthShaper.bytesPerSecond burstSize:self.throttleBandwidthShaper.burstSize];
+    }
 
     for (AFHTTPBodyPart *bodyPart in self.HTTPBodyParts) {
         [bodyStreamCopy appendHTTPBodyPart:[bodyPart copy]];
@@ -1015,18 +2240,23 @@ NSTimeInterval const kAFUploadStream3GSuggestedDelay = 0.2;
 #pragma mark -
 
 typedef enum {
-    AFEncapsulationBoundaryPhase = 1,
-    AFHeaderPhase                = 2,
-    AFBodyPhase                  = 3,
-    AFFinalBoundaryPhase         = 4,
+    AFPreamblePhase              = 1,
+    AFBodyPhase                  = 2,
+    AFFinalBoundaryPhase         = 3,
+    AFCompletedPhase             = 4,
 } AFHTTPBodyPartReadPhase;
 
 @interface AFHTTPBodyPart () <NSCopying> {
     AFHTTPBodyPartReadPhase _phase;
     NSInputStream *_inputStream;
+    int _fileDescriptor;
     unsigned long long _phaseReadOffset;
+    NSData *_preambleData;
+    NSData *_closingBoundaryData;
 }
 
+@property (readwrite, nonatomic, strong) NSError *error;
+
 - (BOOL)transitionToNextPhase;
 - (NSInteger)readData:(NSData *)data
            intoBuffer:(uint8_t *)buffer
@@ -1041,12 +2271,18 @@ typedef enum {
         return nil;
     }
 
-    [self transitionToNextPhase];
+    _phase = AFPreamblePhase;
+    _fileDescriptor = -1;
 
     return self;
 }
 
 - (void)dealloc {
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+        _fileDescriptor = -1;
+    }
+
     if (_inputStream) {
         [_inputStream close];
         _inputStream = nil;
@@ -1072,89 +2308,141 @@ typedef enum {
 - (NSString *)stringForHeaders {
     NSMutableString *headerString = [NSMutableString string];
     for (NSString *field in [self.headers allKeys]) {
-        [headerString appendString:[NSString stringWithFormat:@"%@: %@%@", field, [self.headers valueForKey:field], kAFMultipartFormCRLF]];
+        [headerString appendFormat:@"%@: %@%@", field, [self.headers valueForKey:field], kAFMultipartFormCRLF];
     }
     [headerString appendString:kAFMultipartFormCRLF];
 
     return [NSString stringWithString:headerString];
 }
 
-- (unsigned long long)contentLength {
-    unsigned long long length = 0;
+#pragma mark -
 
-    NSData *encapsulationBoundaryData = [([self hasInitialBoundary] ? AFMultipartFormInitialBoundary(self.boundary) : AFMultipartFormEncapsulationBoundary(self.boundary)) dataUsingEncoding:self.stringEncoding];
-    length += [encapsulationBoundaryData length];
+// The encapsulation boundary and headers of a part are encoded once into a single buffer, which is read as is until any of the properties it depends on change.
 
-    NSData *headersData = [[self stringForHeaders] dataUsingEncoding:self.stringEncoding];
-    length += [headersData length];
+- (void)setStringEncoding:(NSStringEncoding)stringEncoding {
+    if (stringEncoding != _stringEncoding) {
+        _stringEncoding = stringEncoding;
+        _preambleData = nil;
+        _closingBoundaryData = nil;
+    }
+}
 
-    length += _bodyContentLength;
+- (void)setHeaders:(NSDictionary *)headers {
+    _headers = headers;
+    _preambleData = nil;
+}
 
-    NSData *closingBoundaryData = ([self hasFinalBoundary] ? [AFMultipartFormFinalBoundary(self.boundary) dataUsingEncoding:self.stringEncoding] : [NSData data]);
-    length += [closingBoundaryData length];
+- (void)setBoundary:(NSString *)boundary {
+    _boundary = [boundary copy];
+    _preambleData = nil;
+    _closingBoundaryData = nil;
+}
 
-    return length;
+- (void)setHasInitialBoundary:(BOOL)hasInitialBoundary {
+    if (hasInitialBoundary != _hasInitialBoundary) {
+        _hasInitialBoundary = hasInitialBoundary;
+        _preambleData = nil;
+    }
 }
 
-- (BOOL)hasBytesAvailable {
-    // Allows `read:maxLength:` to be called again if `AFMultipartFormFinalBoundary` doesn't fit into the available buffer
-    if (_phase == AFFinalBoundaryPhase) {
-        return YES;
+- (void)setHasFinalBoundary:(BOOL)hasFinalBoundary {
+    if (hasFinalBoundary != _hasFinalBoundary) {
+        _hasFinalBoundary = hasFinalBoundary;
+        _closingBoundaryData = nil;
     }
+}
 
-    switch (self.inputStream.streamStatus) {
-        case NSStreamStatusNotOpen:
-        case NSStreamStatusOpening:
-        case NSStreamStatusOpen:
-        case NSStreamStatusReading:
-        case NSStreamStatusWriting:
-            return YES;
-        case NSStreamStatusAtEnd:
-        case NSStreamStatusClosed:
-        case NSStreamStatusError:
-        default:
-            return NO;
+- (NSData *)preambleData {
+    if (!_preambleData) {
+        NSMutableData *mutablePreambleData = [NSMutableData dataWithData:[([self hasInitialBoundary] ? AFMultipartFormInitialBoundary(self.boundary) : AFMultipartFormEncapsulationBoundary(self.boundary)) dataUsingEncoding:self.stringEncoding]];
+        [mutablePreambleData appendData:[[self stringForHeaders] dataUsingEncoding:self.stringEncoding]];
+        _preambleData = [mutablePreambleData copy];
     }
+
+    return _preambleData;
+}
+
+- (NSData *)closingBoundaryData {
+    if (!_closingBoundaryData) {
+        _closingBoundaryData = ([self hasFinalBoundary] ? [AFMultipartFormFinalBoundary(self.boundary) dataUsingEncoding:self.stringEncoding] : [NSData data]);
+    }
+
+    return _closingBoundaryData;
+}
+
+- (unsigned long long)contentLength {
+    return [[self preambleData] length] + _bodyContentLength + [[self closingBoundaryData] length];
 }
 
+- (BOOL)hasBytesAvailable {
+    return _phase != AFCompletedPhase && !self.error;
+}
+
+// Parts are read synchronously on whichever thread is reading the multipart body stream, which for `NSURLSession` is its own networking thread.
+// Data bodies are copied directly, file bodies are read with POSIX `read(2)`, and stream bodies are opened without being scheduled on any run loop, so that reading never has to wait on the main thread.
+
 - (NSInteger)read:(uint8_t *)buffer
         maxLength:(NSUInteger)length
 {
     NSInteger totalNumberOfBytesRead = 0;
 
-    if (_phase == AFEncapsulationBoundaryPhase) {
-        NSData *encapsulationBoundaryData = [([self hasInitialBoundary] ? AFMultipartFormInitialBoundary(self.boundary) : AFMultipartFormEncapsulationBoundary(self.boundary)) dataUsingEncoding:self.stringEncoding];
-        totalNumberOfBytesRead += [self readData:encapsulationBoundaryData intoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
-    }
-
-    if (_phase == AFHeaderPhase) {
-        NSData *headersData = [[self stringForHeaders] dataUsingEncoding:self.stringEncoding];
-        totalNumberOfBytesRead += [self readData:headersData intoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
+    if (_phase == AFPreamblePhase) {
+        totalNumberOfBytesRead += [self readData:[self preambleData] intoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
+        if (self.error) {
+            return -1;
+        }
     }
 
-    if (_phase == AFBodyPhase) {
-        NSInteger numberOfBytesRead = 0;
-
-        numberOfBytesRead = [self.inputStream read:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
+    if (_phase == AFBodyPhase && (NSUInteger)totalNumberOfBytesRead < length) {
+        NSInteger numberOfBytesRead = [self readBodyIntoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
         if (numberOfBytesRead == -1) {
             return -1;
-        } else {
-            totalNumberOfBytesRead += numberOfBytesRead;
-
-            if ([self.inputStream streamStatus] >= NSStreamStatusAtEnd) {
-                [self transitionToNextPhase];
-            }
         }
+
+        totalNumberOfBytesRead += numberOfBytesRead;
     }
 
     if (_phase == AFFinalBoundaryPhase) {
-        NSData *closingBoundaryData = ([self hasFinalBoundary] ? [AFMultipartFormFinalBoundary(self.boundary) dataUsingEncoding:self.stringEncoding] : [NSData data]);
-        totalNumberOfBytesRead += [self readData:closingBoundaryData intoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
+        totalNumberOfBytesRead += [self readData:[self closingBoundaryData] intoBuffer:&buffer[totalNumberOfBytesRead] maxLength:(length - (NSUInteger)totalNumberOfBytesRead)];
     }
 
     return totalNumberOfBytesRead;
 }
 
+- (NSInteger)readBodyIntoBuffer:(uint8_t *)buffer
+                      maxLength:(NSUInteger)length
+{
+    if ([self.body isKindOfClass:[NSURL class]]) {
+        ssize_t numberOfBytesRead = 0;
+        do {
+            numberOfBytesRead = read(_fileDescriptor, buffer, MIN(length, (NSUInteger)SSIZE_MAX));
+        } while (numberOfBytesRead < 0 && errno == EINTR);
+
+        if (numberOfBytesRead < 0) {
+            self.error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSURLErrorKey: self.body}];
+            return -1;
+        } else if (numberOfBytesRead == 0) {
+            [self transitionToNextPhase];
+        }
+
+        return (NSInteger)numberOfBytesRead;
+    } else if ([self.body isKindOfClass:[NSInputStream class]]) {
+        NSInteger numberOfBytesRead = [self.inputStream read:buffer maxLength:length];
+        if (numberOfBytesRead < 0) {
+            self.error = self.inputStream.streamError ?: [NSError errorWithDomain:NSPOSIXErrorDomain code:EIO userInfo:nil];
+            return -1;
+        } else if (numberOfBytesRead == 0 || [self.inputStream streamStatus] >= NSStreamStatusAtEnd) {
+            [self transitionToNextPhase];
+        }
+
+        return numberOfBytesRead;
+    }
+
+    NSData *data = [self.body isKindOfClass:[NSData class]] ? self.body : [NSData data];
+
+    return [self readData:data intoBuffer:buffer maxLength:length];
+}
+
 - (NSInteger)readData:(NSData *)data
            intoBuffer:(uint8_t *)buffer
             maxLength:(NSUInteger)length
@@ -1172,29 +2460,35 @@ typedef enum {
 }
 
 - (BOOL)transitionToNextPhase {
-    if (![[NSThread currentThread] isMainThread]) {
-        dispatch_sync(dispatch_get_main_queue(), ^{
-            [self transitionToNextPhase];
-        });
-        return YES;
-    }
-
     switch (_phase) {
-        case AFEncapsulationBoundaryPhase:
-            _phase = AFHeaderPhase;
-            break;
-        case AFHeaderPhase:
-            [self.inputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSRunLoopCommonModes];
-            [self.inputStream open];
+        case AFPreamblePhase:
+            if ([self.body isKindOfClass:[NSURL class]]) {
+                do {
+                    _fileDescriptor = open([self.body fileSystemRepresentation], O_RDONLY | O_CLOEXEC);
+                } while (_fileDescriptor < 0 && errno == EINTR);
+
+                if (_fileDescriptor < 0) {
+                    self.error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSURLErrorKey: self.body}];
+                    return NO;
+                }
+            } else if ([self.body isKindOfClass:[NSInputStream class]]) {
+                [self.inputStream open];
+            }
             _phase = AFBodyPhase;
             break;
         case AFBodyPhase:
-            [self.inputStream close];
+            if (_fileDescriptor >= 0) {
+                close(_fileDescriptor);
+                _fileDescriptor = -1;
+            } else if ([self.body isKindOfClass:[NSInputStream class]]) {
+                [self.inputStream close];
+            }
             _phase = AFFinalBoundaryPhase;
             break;
         case AFFinalBoundaryPhase:
+        case AFCompletedPhase:
         default:
-            _phase = AFEncapsulationBoundaryPhase;
+            _phase = AFCompletedPhase;
             break;
     }
     _phaseReadOffset = 0;
@@ -1220,150 +2514,2486 @@ typedef enum {
 
 #pragma mark -
 
-@implementation AFJSONRequestSerializer
+static NSJSONWritingOptions const AFJSONWritingSortedKeys = (NSJSONWritingOptions)(1UL << 1);
+static NSJSONWritingOptions const AFJSONWritingFragmentsAllowed = (NSJSONWritingOptions)(1UL << 2);
+static NSJSONWritingOptions const AFJSONWritingWithoutEscapingSlashes = (NSJSONWritingOptions)(1UL << 3);
 
-+ (instancetype)serializer {
-    return [self serializerWithWritingOptions:(NSJSONWritingOptions)0];
-}
+static CFIndex const AFJSONStreamWriterStringChunkLength = 512;
 
-+ (instancetype)serializerWithWritingOptions:(NSJSONWritingOptions)writingOptions
-{
-    AFJSONRequestSerializer *serializer = [[self alloc] init];
-    serializer.writingOptions = writingOptions;
+/**
+ Formats `value` with the shortest precision that reads back as the same value, returning the number of characters written to `buffer`.
+ */
+static int AFJSONFormatDouble(char *buffer, size_t length, double value) {
+    int numberOfCharacters = 0;
+    for (int precision = 15; precision <= 17; precision++) {
+        numberOfCharacters = snprintf(buffer, length, "%.*g", precision, value);
+        if (strtod(buffer, NULL) == value) {
+            break;
+        }
+    }
 
-    return serializer;
+    return numberOfCharacters;
 }
 
-#pragma mark - AFURLRequestSerialization
-
-- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
-                               withParameters:(id)parameters
-                                        error:(NSError *__autoreleasing *)error
-{
-    NSParameterAssert(request);
+@interface AFJSONStreamWriterFrame : NSObject
+@property (nonatomic, strong) id container;
+@property (nonatomic, strong) NSArray *keys;
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSUInteger index;
+@property (nonatomic, assign, getter = isDictionary) BOOL dictionary;
+@property (nonatomic, assign) BOOL hasPendingValue;
+@end
 
-    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
-        return [super requestBySerializingRequest:request withParameters:parameters error:error];
-    }
+@implementation AFJSONStreamWriterFrame
+@end
 
-    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+/**
+ `AFJSONStreamWriter` encodes a JSON object incrementally, validating each value as it is reached, so that arbitrarily large objects can be written in chunks of a fixed size. Encoding state is kept as an explicit stack of containers, and any output that doesn't fit into the caller's buffer is carried over to the next call, which bounds the working memory by the size of a single token.
+ */
+@interface AFJSONStreamWriter : NSObject {
+    id _rootObject;
+    BOOL _prettyPrinted;
+    BOOL _sortsKeys;
+    BOOL _escapesSlashes;
+    BOOL _allowsFragments;
+    BOOL _started;
+    BOOL _finished;
+
+    NSMutableArray *_frames;
+    NSUInteger _depth;
+
+    NSString *_string;
+    CFIndex _stringLength;
+    CFIndex _stringIndex;
+    CFStringInlineBuffer _stringBuffer;
+
+    uint8_t *_output;
+    NSUInteger _outputLength;
+    NSUInteger _outputCapacity;
+    NSMutableData *_overflow;
+    NSUInteger _overflowOffset;
+}
 
-    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
-        if (![request valueForHTTPHeaderField:field]) {
-            [mutableRequest setValue:value forHTTPHeaderField:field];
-        }
-    }];
+@property (readonly, nonatomic, strong) NSError *error;
 
-    if (parameters) {
-        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
-            [mutableRequest setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
-        }
+- (instancetype)initWithJSONObject:(id)JSONObject
+                           options:(NSJSONWritingOptions)options;
 
-        if (![NSJSONSerialization isValidJSONObject:parameters]) {
-            if (error) {
-                NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The `parameters` argument is not valid JSON.", @"AFNetworking", nil)};
-                *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
-            }
-            return nil;
-        }
+/**
+ Writes up to `length` bytes of the encoded object into `buffer`. Returns the number of bytes written, `0` once the whole object has been written, or `-1` if the object can't be encoded as JSON, in which case `error` is set.
+ */
+- (NSInteger)write:(uint8_t *)buffer
+         maxLength:(NSUInteger)length;
 
-        NSData *jsonData = [NSJSONSerialization dataWithJSONObject:parameters options:self.writingOptions error:error];
-        
-        if (!jsonData) {
-            return nil;
-        }
-        
-        [mutableRequest setHTTPBody:jsonData];
-    }
+/**
+ Encodes the object without keeping its output, returning whether it is valid JSON and, if so, the exact number of bytes it encodes to.
+ */
++ (BOOL)getLength:(unsigned long long *)length
+     ofJSONObject:(id)JSONObject
+          options:(NSJSONWritingOptions)options
+            error:(NSError * __autoreleasing *)error;
+@end
 
-    return mutableRequest;
-}
+@interface AFJSONStreamWriter ()
+@property (readwrite, nonatomic, strong) NSError *error;
+@end
 
-#pragma mark - NSSecureCoding
+@implementation AFJSONStreamWriter
 
-- (instancetype)initWithCoder:(NSCoder *)decoder {
-    self = [super initWithCoder:decoder];
+- (instancetype)initWithJSONObject:(id)JSONObject
+                           options:(NSJSONWritingOptions)options
+{
+    self = [super init];
     if (!self) {
         return nil;
     }
 
-    self.writingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(writingOptions))] unsignedIntegerValue];
+    _rootObject = JSONObject;
+    _prettyPrinted = (options & NSJSONWritingPrettyPrinted) != 0;
+    _sortsKeys = (options & AFJSONWritingSortedKeys) != 0;
+    _escapesSlashes = (options & AFJSONWritingWithoutEscapingSlashes) == 0;
+    _allowsFragments = (options & AFJSONWritingFragmentsAllowed) != 0;
+    _frames = [NSMutableArray array];
+    _overflow = [NSMutableData data];
 
     return self;
 }
 
-- (void)encodeWithCoder:(NSCoder *)coder {
-    [super encodeWithCoder:coder];
++ (BOOL)getLength:(unsigned long long *)length
+     ofJSONObject:(id)JSONObject
+          options:(NSJSONWritingOptions)options
+            error:(NSError * __autoreleasing *)error
+{
+    AFJSONStreamWriter *writer = [[self alloc] initWithJSONObject:JSONObject options:options];
 
-    [coder encodeInteger:self.writingOptions forKey:NSStringFromSelector(@selector(writingOptions))];
-}
+    uint8_t buffer[16384];
+    unsigned long long totalNumberOfBytesWritten = 0;
+    NSInteger numberOfBytesWritten = 0;
+    while ((numberOfBytesWritten = [writer write:buffer maxLength:sizeof(buffer)]) > 0) {
+        totalNumberOfBytesWritten += (unsigned long long)numberOfBytesWritten;
+    }
 
-#pragma mark - NSCopying
+    if (numberOfBytesWritten < 0) {
+        if (error) {
+            *error = writer.error;
+        }
 
-- (instancetype)copyWithZone:(NSZone *)zone {
-    AFJSONRequestSerializer *serializer = [super copyWithZone:zone];
-    serializer.writingOptions = self.writingOptions;
+        return NO;
+    }
 
-    return serializer;
+    if (length) {
+        *length = totalNumberOfBytesWritten;
+    }
+
+    return YES;
 }
 
-@end
+- (NSInteger)write:(uint8_t *)buffer
+         maxLength:(NSUInteger)length
+{
+    if (self.error) {
+        return -1;
+    }
 
-#pragma mark -
+    _output = buffer;
+    _outputLength = 0;
+    _outputCapacity = length;
 
-@implementation AFPropertyListRequestSerializer
+    if (_overflowOffset < [_overflow length]) {
+        NSUInteger numberOfBytes = MIN(length, [_overflow length] - _overflowOffset);
+        [_overflow getBytes:buffer range:NSMakeRange(_overflowOffset, numberOfBytes)];
+        _overflowOffset += numberOfBytes;
+        _outputLength = numberOfBytes;
 
-+ (instancetype)serializer {
-    return [self serializerWithFormat:NSPropertyListXMLFormat_v1_0 writeOptions:0];
-}
+        if (_overflowOffset == [_overflow length]) {
+            [_overflow setLength:0];
+            _overflowOffset = 0;
+        }
+    }
 
-+ (instancetype)serializerWithFormat:(NSPropertyListFormat)format
-                        writeOptions:(NSPropertyListWriteOptions)writeOptions
-{
-    AFPropertyListRequestSerializer *serializer = [[self alloc] init];
+    while (_outputLength < _outputCapacity && [_overflow length] == 0 && !_finished) {
+        if (![self step]) {
+            _output = NULL;
+            return -1;
+        }
+    }
+
+    _output = NULL;
+
+    return (NSInteger)_outputLength;
+}
+
+#pragma mark -
+
+- (void)emitBytes:(const void *)bytes
+           length:(NSUInteger)length
+{
+    NSUInteger numberOfBytes = MIN(_outputCapacity - _outputLength, length);
+    if (numberOfBytes > 0) {
+        memcpy(_output + _outputLength, bytes, numberOfBytes);
+        _outputLength += numberOfBytes;
+    }
+
+    if (numberOfBytes < length) {
+        [_overflow appendBytes:(const uint8_t *)bytes + numberOfBytes length:length - numberOfBytes];
+    }
+}
+
+- (void)emitNewlineWithIndentationLevel:(NSUInteger)level {
+    static const char kAFIndentation[] = "                                ";
+
+    [self emitBytes:"\n" length:1];
+    for (NSUInteger remaining = level * 2; remaining > 0; ) {
+        NSUInteger numberOfBytes = MIN(remaining, sizeof(kAFIndentation) - 1);
+        [self emitBytes:kAFIndentation length:numberOfBytes];
+        remaining -= numberOfBytes;
+    }
+}
+
+- (BOOL)failWithReason:(NSString *)reason {
+    NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: reason};
+    self.error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+
+    return NO;
+}
+
+#pragma mark -
+
+- (BOOL)step {
+    if (_string) {
+        return [self writeStringChunk];
+    }
+
+    if (!_started) {
+        _started = YES;
+        if (!_allowsFragments && !([_rootObject isKindOfClass:[NSArray class]] || [_rootObject isKindOfClass:[NSDictionary class]])) {
+            return [self failWithReason:NSLocalizedStringFromTable(@"Invalid top-level type in JSON write.", @"AFNetworking", nil)];
+        }
+
+        return [self beginValue:_rootObject];
+    }
+
+    if (_depth == 0) {
+        _finished = YES;
+        return YES;
+    }
+
+    AFJSONStreamWriterFrame *frame = _frames[_depth - 1];
+    if (frame.hasPendingValue) {
+        frame.hasPendingValue = NO;
+        if (_prettyPrinted) {
+            [self emitBytes:" : " length:3];
+        } else {
+            [self emitBytes:":" length:1];
+        }
+
+        return [self beginValue:[(NSDictionary *)frame.container objectForKey:frame.keys[frame.index - 1]]];
+    }
+
+    if (frame.index < frame.count) {
+        if (frame.index > 0) {
+            [self emitBytes:"," length:1];
+        }
+
+        if (_prettyPrinted) {
+            [self emitNewlineWithIndentationLevel:_depth];
+        }
+
+        if ([frame isDictionary]) {
+            id key = frame.keys[frame.index++];
+            if (![key isKindOfClass:[NSString class]]) {
+                return [self failWithReason:NSLocalizedStringFromTable(@"Invalid (non-string) key in JSON dictionary.", @"AFNetworking", nil)];
+            }
+
+            frame.hasPendingValue = YES;
+            [self beginString:key];
+
+            return YES;
+        }
+
+        return [self beginValue:[(NSArray *)frame.container objectAtIndex:frame.index++]];
+    }
+
+    _depth--;
+    if (_prettyPrinted && frame.count > 0) {
+        [self emitNewlineWithIndentationLevel:_depth];
+    }
+    [self emitBytes:([frame isDictionary] ? "}" : "]") length:1];
+
+    frame.container = nil;
+    frame.keys = nil;
+
+    return YES;
+}
+
+- (BOOL)beginValue:(id)value {
+    if ([value isKindOfClass:[NSString class]]) {
+        [self beginString:value];
+        return YES;
+    } else if ([value isKindOfClass:[NSNumber class]]) {
+        return [self writeNumber:value];
+    } else if ([value isKindOfClass:[NSNull class]]) {
+        [self emitBytes:"null" length:4];
+        return YES;
+    } else if ([value isKindOfClass:[NSArray class]] || [value isKindOfClass:[NSDictionary class]]) {
+        AFJSONStreamWriterFrame *frame = nil;
+        if (_depth < [_frames count]) {
+            frame = _frames[_depth];
+        } else {
+            frame = [[AFJSONStreamWriterFrame alloc] init];
+            [_frames addObject:frame];
+        }
+        _depth++;
+
+        frame.container = value;
+        frame.index = 0;
+        frame.hasPendingValue = NO;
+        frame.dictionary = [value isKindOfClass:[NSDictionary class]];
+
+        if ([frame isDictionary]) {
+            NSArray *keys = [(NSDictionary *)value allKeys];
+            if (_sortsKeys) {
+                for (id key in keys) {
+                    if (![key isKindOfClass:[NSString class]]) {
+                        return [self failWithReason:NSLocalizedStringFromTable(@"Invalid (non-string) key in JSON dictionary.", @"AFNetworking", nil)];
+                    }
+                }
+
+                keys = [keys sortedArrayUsingSelector:@selector(compare:)];
+            }
+
+            frame.keys = keys;
+            frame.count = [keys count];
+            [self emitBytes:"{" length:1];
+        } else {
+            frame.keys = nil;
+            frame.count = [(NSArray *)value count];
+            [self emitBytes:"[" length:1];
+        }
+
+        return YES;
+    }
+
+    return [self failWithReason:[NSString stringWithFormat:NSLocalizedStringFromTable(@"Invalid type in JSON write (%@).", @"AFNetworking", nil), NSStringFromClass([value class])]];
+}
+
+- (BOOL)writeNumber:(NSNumber *)number {
+    char buffer[64];
+    int length = 0;
+
+    if ((__bridge CFBooleanRef)number == kCFBooleanTrue) {
+        [self emitBytes:"true" length:4];
+        return YES;
+    } else if ((__bridge CFBooleanRef)number == kCFBooleanFalse) {
+        [self emitBytes:"false" length:5];
+        return YES;
+    } else if ([number isKindOfClass:[NSDecimalNumber class]]) {
+        if ([number isEqualToNumber:[NSDecimalNumber notANumber]]) {
+            return [self failWithReason:NSLocalizedStringFromTable(@"Invalid number value (NaN) in JSON write.", @"AFNetworking", nil)];
+        }
+
+        NSData *data = [[number description] dataUsingEncoding:NSUTF8StringEncoding];
+        [self emitBytes:[data bytes] length:[data length]];
+        return YES;
+    } else if (CFNumberIsFloatType((__bridge CFNumberRef)number)) {
+        double value = [number doubleValue];
+        if (!isfinite(value)) {
+            return [self failWithReason:NSLocalizedStringFromTable(@"Invalid number value (infinite or NaN) in JSON write.", @"AFNetworking", nil)];
+        }
+
+        length = AFJSONFormatDouble(buffer, sizeof(buffer), value);
+    } else if (strcmp([number objCType], @encode(unsigned long long)) == 0 || strcmp([number objCType], @encode(unsigned long)) == 0) {
+        length = snprintf(buffer, sizeof(buffer), "%llu", [number unsignedLongLongValue]);
+    } else {
+        length = snprintf(buffer, sizeof(buffer), "%lld", [number longLongValue]);
+    }
+
+    [self emitBytes:buffer length:(NSUInteger)length];
+
+    return YES;
+}
+
+- (void)beginString:(NSString *)string {
+    [self emitBytes:"\"" length:1];
+
+    _string = string;
+    _stringLength = CFStringGetLength((__bridge CFStringRef)string);
+    _stringIndex = 0;
+    CFStringInitInlineBuffer((__bridge CFStringRef)string, &_stringBuffer, CFRangeMake(0, _stringLength));
+}
+
+- (BOOL)writeStringChunk {
+    static const char kAFHexDigits[] = "0123456789abcdef";
+
+    // Every UTF-16 code unit encodes to at most 6 bytes, and a surrogate pair may extend the chunk by one unit
+    uint8_t buffer[(512 + 1) * 6];
+    NSUInteger length = 0;
+
+    CFIndex end = MIN(_stringIndex + AFJSONStreamWriterStringChunkLength, _stringLength);
+    while (_stringIndex < end) {
+        UniChar character = CFStringGetCharacterFromInlineBuffer(&_stringBuffer, _stringIndex++);
+        if (character < 0x80) {
+            switch (character) {
+                case '"':
+                    buffer[length++] = '\\';
+                    buffer[length++] = '"';
+                    break;
+                case '\\':
+                    buffer[length++] = '\\';
+                    buffer[length++] = '\\';
+                    break;
+                case '/':
+                    if (_escapesSlashes) {
+                        buffer[length++] = '\\';
+                    }
+                    buffer[length++] = '/';
+                    break;
+                case '\b':
+                    buffer[length++] = '\\';
+                    buffer[length++] = 'b';
+                    break;
+                case '\f':
+                    buffer[length++] = '\\';
+                    buffer[length++] = 'f';
+                    break;
+                case '\n':
+                    buffer[length++] = '\\';
+                    buffer[length++] = 'n';
+                    break;
+                case '\r':
+                    buffer[length++] = '\\';
+                    buffer[length++] = 'r';
+                    break;
+                case '\t':
+                    buffer[length++] = '\\';
+                    buffer[length++] = 't';
+                    break;
+                default:
+                    if (character < 0x20) {
+                        buffer[length++] = '\\';
+                        buffer[length++] = 'u';
+                        buffer[length++] = '0';
+                        buffer[length++] = '0';
+                        buffer[length++] = (uint8_t)kAFHexDigits[character >> 4];
+                        buffer[length++] = (uint8_t)kAFHexDigits[character & 0x0F];
+                    } else {
+                        buffer[length++] = (uint8_t)character;
+                    }
+                    break;
+            }
+        } else if (character < 0x800) {
+            buffer[length++] = (uint8_t)(0xC0 | (character >> 6));
+            buffer[length++] = (uint8_t)(0x80 | (character & 0x3F));
+        } else if (CFStringIsSurrogateHighCharacter(character)) {
+            UniChar lowCharacter = _stringIndex < _stringLength ? CFStringGetCharacterFromInlineBuffer(&_stringBuffer, _stringIndex) : 0;
+            if (!CFStringIsSurrogateLowCharacter(lowCharacter)) {
+                return [self failWithReason:NSLocalizedStringFromTable(@"Unable to convert string to UTF-8 in JSON write.", @"AFNetworking", nil)];
+            }
+
+            _stringIndex++;
+            UTF32Char codePoint = CFStringGetLongCharacterForSurrogatePair(character, lowCharacter);
+            buffer[length++] = (uint8_t)(0xF0 | (codePoint >> 18));
+            buffer[length++] = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+            buffer[length++] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+            buffer[length++] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        } else if (CFStringIsSurrogateLowCharacter(character)) {
+            return [self failWithReason:NSLocalizedStringFromTable(@"Unable to convert string to UTF-8 in JSON write.", @"AFNetworking", nil)];
+        } else {
+            buffer[length++] = (uint8_t)(0xE0 | (character >> 12));
+            buffer[length++] = (uint8_t)(0x80 | ((character >> 6) & 0x3F));
+            buffer[length++] = (uint8_t)(0x80 | (character & 0x3F));
+        }
+    }
+
+    [self emitBytes:buffer length:length];
+
+    if (_stringIndex >= _stringLength) {
+        [self emitBytes:"\"" length:1];
+        _string = nil;
+    }
+
+    return YES;
+}
+
+@end
+
+#pragma mark -
+
+static unsigned long long const AFJSONBodyStreamUnknownContentLength = ULLONG_MAX;
+
+/**
+ `AFJSONBodyStream` is an input stream that produces the JSON encoding of an object on demand, so that the encoded body never has to be held in memory in its entirety. The content length is either unknown, in which case the body is sent chunked, or computed up front, in which case the stream fails if the object encodes to a different length by the time it's read, e.g. because it was mutated in the meantime.
+ */
+@interface AFJSONBodyStream : NSInputStream <NSCopying>
+@property (readonly, nonatomic, strong) id JSONObject;
+@property (readonly, nonatomic, assign) NSJSONWritingOptions writingOptions;
+@property (readonly, nonatomic, assign) unsigned long long contentLength;
+
+- (instancetype)initWithJSONObject:(id)JSONObject
+                    writingOptions:(NSJSONWritingOptions)writingOptions
+                     contentLength:(unsigned long long)contentLength;
+@end
+
+@interface AFJSONBodyStream ()
+@property (readwrite, nonatomic, strong) id JSONObject;
+@property (readwrite, nonatomic, assign) NSJSONWritingOptions writingOptions;
+@property (readwrite, nonatomic, assign) unsigned long long contentLength;
+@property (readwrite, nonatomic, assign) unsigned long long numberOfBytesRead;
+@property (readwrite, nonatomic, strong) AFJSONStreamWriter *writer;
+@end
+
+@implementation AFJSONBodyStream
+#if (defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && __IPHONE_OS_VERSION_MAX_ALLOWED >= 80000) || (defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 1100)
+@synthesize delegate;
+#endif
+@synthesize streamStatus;
+@synthesize streamError;
+
+- (instancetype)initWithJSONObject:(id)JSONObject
+                    writingOptions:(NSJSONWritingOptions)writingOptions
+                     contentLength:(unsigned long long)contentLength
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.JSONObject = JSONObject;
+    self.writingOptions = writingOptions;
+    self.contentLength = contentLength;
+
+    return self;
+}
+
+#pragma mark - NSInputStream
+
+- (NSInteger)read:(uint8_t *)buffer
+        maxLength:(NSUInteger)length
+{
+    if ([self streamStatus] != NSStreamStatusOpen) {
+        return [self streamStatus] == NSStreamStatusError ? -1 : 0;
+    }
+
+    NSInteger numberOfBytesRead = [self.writer write:buffer maxLength:length];
+    if (numberOfBytesRead < 0) {
+        self.streamError = self.writer.error;
+        self.streamStatus = NSStreamStatusError;
+        return -1;
+    }
+
+    self.numberOfBytesRead += (unsigned long long)numberOfBytesRead;
+
+    if (self.contentLength == AFJSONBodyStreamUnknownContentLength) {
+        if (numberOfBytesRead == 0) {
+            self.streamStatus = NSStreamStatusAtEnd;
+        }
+
+        return numberOfBytesRead;
+    }
+
+    if (self.numberOfBytesRead > self.contentLength || (numberOfBytesRead == 0 && self.numberOfBytesRead != self.contentLength)) {
+        NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The JSON body changed length while it was being streamed.", @"AFNetworking", nil)};
+        self.streamError = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+        self.streamStatus = NSStreamStatusError;
+        return -1;
+    }
+
+    if (self.numberOfBytesRead == self.contentLength) {
+        self.streamStatus = NSStreamStatusAtEnd;
+    }
+
+    return numberOfBytesRead;
+}
+
+- (BOOL)getBuffer:(__unused uint8_t **)buffer
+           length:(__unused NSUInteger *)len
+{
+    return NO;
+}
+
+- (BOOL)hasBytesAvailable {
+    return [self streamStatus] == NSStreamStatusOpen;
+}
+
+#pragma mark - NSStream
+
+- (void)open {
+    if (self.streamStatus == NSStreamStatusOpen) {
+        return;
+    }
+
+    self.writer = [[AFJSONStreamWriter alloc] initWithJSONObject:self.JSONObject options:self.writingOptions];
+    self.numberOfBytesRead = 0;
+    self.streamStatus = self.contentLength > 0 ? NSStreamStatusOpen : NSStreamStatusAtEnd;
+}
+
+- (void)close {
+    self.writer = nil;
+    self.streamStatus = NSStreamStatusClosed;
+}
+
+- (id)propertyForKey:(__unused NSString *)key {
+    return nil;
+}
+
+- (BOOL)setProperty:(__unused id)property
+             forKey:(__unused NSString *)key
+{
+    return NO;
+}
+
+- (void)scheduleInRunLoop:(__unused NSRunLoop *)aRunLoop
+                  forMode:(__unused NSString *)mode
+{}
+
+- (void)removeFromRunLoop:(__unused NSRunLoop *)aRunLoop
+                  forMode:(__unused NSString *)mode
+{}
+
+#pragma mark - Undocumented CFReadStream Bridged Methods
+
+- (void)_scheduleInCFRunLoop:(__unused CFRunLoopRef)aRunLoop
+                     forMode:(__unused CFStringRef)aMode
+{}
+
+- (void)_unscheduleFromCFRunLoop:(__unused CFRunLoopRef)aRunLoop
+                         forMode:(__unused CFStringRef)aMode
+{}
+
+- (BOOL)_setCFClientFlags:(__unused CFOptionFlags)inFlags
+                 callback:(__unused CFReadStreamClientCallBack)inCallback
+                  context:(__unused CFStreamClientContext *)inContext {
+    return NO;
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    return [[[self class] allocWithZone:zone] initWithJSONObject:self.JSONObject writingOptions:self.writingOptions contentLength:self.contentLength];
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFJSONRequestSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithWritingOptions:(NSJSONWritingOptions)0];
+}
+
++ (instancetype)serializerWithWritingOptions:(NSJSONWritingOptions)writingOptions
+{
+    AFJSONRequestSerializer *serializer = [[self alloc] init];
+    serializer.writingOptions = writingOptions;
+
+    return serializer;
+}
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+
+    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+        if (![request valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+
+    if (parameters) {
+        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
+            [mutableRequest setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+        }
+
+        if (self.streamsHTTPBody) {
+            unsigned long long contentLength = AFJSONBodyStreamUnknownContentLength;
+            NSError *writingError = nil;
+            BOOL isValidJSONObject = YES;
+            if (self.computesStreamedContentLength) {
+                isValidJSONObject = [AFJSONStreamWriter getLength:&contentLength ofJSONObject:parameters options:self.writingOptions error:&writingError];
+            } else if ((self.writingOptions & AFJSONWritingFragmentsAllowed) == 0) {
+                isValidJSONObject = [parameters isKindOfClass:[NSArray class]] || [parameters isKindOfClass:[NSDictionary class]];
+            }
+
+            if (!isValidJSONObject) {
+                if (error) {
+                    NSMutableDictionary *mutableUserInfo = [@{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The `parameters` argument is not valid JSON.", @"AFNetworking", nil)} mutableCopy];
+                    if (writingError) {
+                        mutableUserInfo[NSUnderlyingErrorKey] = writingError;
+                    }
+                    *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:mutableUserInfo];
+                }
+                return nil;
+            }
+
+            [mutableRequest setHTTPBodyStream:[[AFJSONBodyStream alloc] initWithJSONObject:parameters writingOptions:self.writingOptions contentLength:contentLength]];
+            if (contentLength != AFJSONBodyStreamUnknownContentLength) {
+                [mutableRequest setValue:[NSString stringWithFormat:@"%llu", contentLength] forHTTPHeaderField:@"Content-Length"];
+            }
+
+            return mutableRequest;
+        }
+
+        if (![NSJSONSerialization isValidJSONObject:parameters]) {
+            if (error) {
+                NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The `parameters` argument is not valid JSON.", @"AFNetworking", nil)};
+                *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+            }
+            return nil;
+        }
+
+        NSData *jsonData = [NSJSONSerialization dataWithJSONObject:parameters options:self.writingOptions error:error];
+        
+        if (!jsonData) {
+            return nil;
+        }
+        
+        [mutableRequest setHTTPBody:jsonData];
+    }
+
+    return mutableRequest;
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    self.writingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(writingOptions))] unsignedIntegerValue];
+    self.streamsHTTPBody = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(streamsHTTPBody))] boolValue];
+    self.computesStreamedContentLength = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(computesStreamedContentLength))] boolValue];
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeInteger:self.writingOptions forKey:NSStringFromSelector(@selector(writingOptions))];
+    [coder encodeObject:@(self.streamsHTTPBody) forKey:NSStringFromSelector(@selector(streamsHTTPBody))];
+    [coder encodeObject:@(self.computesStreamedContentLength) forKey:NSStringFromSelector(@selector(computesStreamedContentLength))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFJSONRequestSerializer *serializer = [super copyWithZone:zone];
+    serializer.writingOptions = self.writingOptions;
+    serializer.streamsHTTPBody = self.streamsHTTPBody;
+    serializer.computesStreamedContentLength = self.computesStreamedContentLength;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFPropertyListRequestSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithFormat:NSPropertyListXMLFormat_v1_0 writeOptions:0];
+}
+
++ (instancetype)serializerWithFormat:(NSPropertyListFormat)format
+                        writeOptions:(NSPropertyListWriteOptions)writeOptions
+{
+    AFPropertyListRequestSerializer *serializer = [[self alloc] init];
     serializer.format = format;
     serializer.writeOptions = writeOptions;
 
-    return serializer;
+    return serializer;
+}
+
+#pragma mark - AFURLRequestSerializer
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+
+    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+        if (![request valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+
+    if (parameters) {
+        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
+            [mutableRequest setValue:@"application/x-plist" forHTTPHeaderField:@"Content-Type"];
+        }
+
+        NSData *plistData = [NSPropertyListSerialization dataWithPropertyList:parameters format:self.format options:self.writeOptions error:error];
+        
+        if (!plistData) {
+            return nil;
+        }
+        
+        [mutableRequest setHTTPBody:plistData];
+    }
+
+    return mutableRequest;
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    self.format = (NSPropertyListFormat)[[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(format))] unsignedIntegerValue];
+    self.writeOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(writeOptions))] unsignedIntegerValue];
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeInteger:self.format forKey:NSStringFromSelector(@selector(format))];
+    [coder encodeObject:@(self.writeOptions) forKey:NSStringFromSelector(@selector(writeOptions))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFPropertyListRequestSerializer *serializer = [super copyWithZone:zone];
+    serializer.format = self.format;
+    serializer.writeOptions = self.writeOptions;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+typedef NS_ENUM(NSUInteger, AFBinaryObjectFormat) {
+    AFBinaryObjectFormatMessagePack,
+    AFBinaryObjectFormatCBOR,
+};
+
+static NSUInteger const AFBinaryObjectMaximumDepth = 512;
+
+static BOOL AFBinaryObjectAppendBigEndian(AFByteBuffer *buffer, uint64_t value, size_t width) {
+    uint8_t bytes[8];
+    for (size_t idx = 0; idx < width; idx++) {
+        bytes[idx] = (uint8_t)(value >> (8 * (width - 1 - idx)));
+    }
+
+    return AFByteBufferAppendBytes(buffer, bytes, width);
+}
+
+static BOOL AFBinaryObjectAppendTypeAndBigEndian(AFByteBuffer *buffer, uint8_t type, uint64_t value, size_t width) {
+    return AFByteBufferAppendBytes(buffer, &type, 1) && AFBinaryObjectAppendBigEndian(buffer, value, width);
+}
+
+/**
+ Appends the initial byte of a CBOR data item of `majorType`, followed by `argument` in the shortest encoding possible.
+ */
+static BOOL AFCBORAppendHead(AFByteBuffer *buffer, uint8_t majorType, uint64_t argument) {
+    uint8_t initialByte = (uint8_t)(majorType << 5);
+    if (argument < 24) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(initialByte | argument), 0, 0);
+    } else if (argument <= UINT8_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(initialByte | 24), argument, 1);
+    } else if (argument <= UINT16_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(initialByte | 25), argument, 2);
+    } else if (argument <= UINT32_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(initialByte | 26), argument, 4);
+    } else {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(initialByte | 27), argument, 8);
+    }
+}
+
+/**
+ Appends the type and length of a MessagePack string, binary, array or map. `fixType` is used for lengths below `fixLimit`, and `type8` may be `0` for families without an 8-bit length.
+ */
+static BOOL AFMessagePackAppendLengthHead(AFByteBuffer *buffer, uint64_t length, uint8_t fixType, uint64_t fixLimit, uint8_t type8, uint8_t type16, uint8_t type32) {
+    if (length < fixLimit) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(fixType | length), 0, 0);
+    } else if (type8 != 0 && length <= UINT8_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, type8, length, 1);
+    } else if (length <= UINT16_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, type16, length, 2);
+    } else if (length <= UINT32_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, type32, length, 4);
+    }
+
+    return NO;
+}
+
+static BOOL AFBinaryObjectAppendUnsignedInteger(AFByteBuffer *buffer, AFBinaryObjectFormat format, uint64_t value) {
+    if (format == AFBinaryObjectFormatCBOR) {
+        return AFCBORAppendHead(buffer, 0, value);
+    }
+
+    if (value <= 0x7f) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)value, 0, 0);
+    } else if (value <= UINT8_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xcc, value, 1);
+    } else if (value <= UINT16_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xcd, value, 2);
+    } else if (value <= UINT32_MAX) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xce, value, 4);
+    } else {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xcf, value, 8);
+    }
+}
+
+static BOOL AFBinaryObjectAppendNegativeInteger(AFByteBuffer *buffer, AFBinaryObjectFormat format, int64_t value) {
+    if (format == AFBinaryObjectFormatCBOR) {
+        return AFCBORAppendHead(buffer, 1, (uint64_t)(-1 - value));
+    }
+
+    // Truncating the two's complement representation keeps the sign for each width
+    if (value >= -32) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)value, 0, 0);
+    } else if (value >= INT8_MIN) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd0, (uint64_t)value, 1);
+    } else if (value >= INT16_MIN) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd1, (uint64_t)value, 2);
+    } else if (value >= INT32_MIN) {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd2, (uint64_t)value, 4);
+    } else {
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd3, (uint64_t)value, 8);
+    }
+}
+
+static BOOL AFBinaryObjectAppendNumber(AFByteBuffer *buffer, AFBinaryObjectFormat format, NSNumber *number) {
+    BOOL isCBOR = format == AFBinaryObjectFormatCBOR;
+
+    if (number == (__bridge NSNumber *)kCFBooleanTrue || number == (__bridge NSNumber *)kCFBooleanFalse) {
+        uint8_t type = (uint8_t)([number boolValue] ? (isCBOR ? 0xf5 : 0xc3) : (isCBOR ? 0xf4 : 0xc2));
+        return AFByteBufferAppendBytes(buffer, &type, 1);
+    }
+
+    const char *objCType = [number objCType];
+    if (strcmp(objCType, @encode(float)) == 0) {
+        float value = [number floatValue];
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(isCBOR ? 0xfa : 0xca), bits, sizeof(bits));
+    } else if (strcmp(objCType, @encode(double)) == 0) {
+        double value = [number doubleValue];
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, (uint8_t)(isCBOR ? 0xfb : 0xcb), bits, sizeof(bits));
+    } else if (strcmp(objCType, @encode(unsigned long long)) == 0 || strcmp(objCType, @encode(unsigned long)) == 0) {
+        return AFBinaryObjectAppendUnsignedInteger(buffer, format, [number unsignedLongLongValue]);
+    }
+
+    long long value = [number longLongValue];
+    if (value < 0) {
+        return AFBinaryObjectAppendNegativeInteger(buffer, format, value);
+    }
+
+    return AFBinaryObjectAppendUnsignedInteger(buffer, format, (uint64_t)value);
+}
+
+static BOOL AFBinaryObjectAppendDate(AFByteBuffer *buffer, AFBinaryObjectFormat format, NSDate *date) {
+    NSTimeInterval timeInterval = [date timeIntervalSince1970];
+    double seconds = floor(timeInterval);
+    // Seconds must fit in a signed 64-bit integer
+    if (!isfinite(timeInterval) || fabs(seconds) >= 9.2e18) {
+        return NO;
+    }
+
+    if (format == AFBinaryObjectFormatCBOR) {
+        if (!AFCBORAppendHead(buffer, 6, 1)) {
+            return NO;
+        }
+
+        if (seconds == timeInterval) {
+            return AFBinaryObjectAppendNumber(buffer, format, @((long long)seconds));
+        }
+
+        return AFBinaryObjectAppendNumber(buffer, format, @(timeInterval));
+    }
+
+    // The timestamp extension type -1, in the smallest of its 32, 64 and 96-bit formats
+    int64_t secondsValue = (int64_t)seconds;
+    uint32_t nanoseconds = (uint32_t)MIN((timeInterval - seconds) * 1e9, 999999999.0);
+    if (secondsValue >= 0 && (secondsValue >> 34) == 0) {
+        uint64_t value = ((uint64_t)nanoseconds << 34) | (uint64_t)secondsValue;
+        if ((value >> 32) == 0) {
+            return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd6, 0xff, 1) && AFBinaryObjectAppendBigEndian(buffer, value, 4);
+        }
+
+        return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xd7, 0xff, 1) && AFBinaryObjectAppendBigEndian(buffer, value, 8);
+    }
+
+    return AFBinaryObjectAppendTypeAndBigEndian(buffer, 0xc7, 12, 1) &&
+           AFBinaryObjectAppendBigEndian(buffer, 0xff, 1) &&
+           AFBinaryObjectAppendBigEndian(buffer, nanoseconds, 4) &&
+           AFBinaryObjectAppendBigEndian(buffer, (uint64_t)secondsValue, 8);
+}
+
+typedef struct {
+    size_t offset;
+    size_t keyLength;
+    size_t length;
+    const uint8_t *bytes;
+} AFBinaryObjectMapEntry;
+
+static int AFBinaryObjectMapEntryCompare(const void *entry, const void *otherEntry) {
+    const AFBinaryObjectMapEntry *lhs = entry;
+    const AFBinaryObjectMapEntry *rhs = otherEntry;
+    int result = memcmp(lhs->bytes, rhs->bytes, MIN(lhs->keyLength, rhs->keyLength));
+    if (result != 0) {
+        return result;
+    }
+
+    return lhs->keyLength < rhs->keyLength ? -1 : (lhs->keyLength > rhs->keyLength ? 1 : 0);
+}
+
+static BOOL AFBinaryObjectAppend(AFByteBuffer *buffer, AFBinaryObjectFormat format, id object, NSUInteger depth);
+
+/**
+ Appends the keys and values of `dictionary`, ordered by the bytewise lexicographic order of their encoded keys, as in the deterministic encoding of RFC 8949, so that equal dictionaries always encode to the same bytes. The entries are encoded in enumeration order and then moved into place, which copies the encoding of the map once more unless it is already sorted.
+ */
+static BOOL AFBinaryObjectAppendSortedMapEntries(AFByteBuffer *buffer, AFBinaryObjectFormat format, NSDictionary *dictionary, NSUInteger depth) {
+    NSUInteger count = dictionary.count;
+    if (count == 0) {
+        return YES;
+    }
+
+    AFBinaryObjectMapEntry *entries = malloc(count * sizeof(AFBinaryObjectMapEntry));
+    if (!entries) {
+        return NO;
+    }
+
+    size_t start = buffer->length;
+    __block NSUInteger numberOfEntries = 0;
+    __block BOOL success = YES;
+    [dictionary enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+        if (numberOfEntries == count) {
+            success = NO;
+            *stop = YES;
+            return;
+        }
+
+        AFBinaryObjectMapEntry *entry = &entries[numberOfEntries++];
+        entry->offset = buffer->length - start;
+        if (!AFBinaryObjectAppend(buffer, format, key, depth + 1)) {
+            success = NO;
+            *stop = YES;
+            return;
+        }
+
+        entry->keyLength = buffer->length - start - entry->offset;
+        if (!AFBinaryObjectAppend(buffer, format, value, depth + 1)) {
+            success = NO;
+            *stop = YES;
+            return;
+        }
+
+        entry->length = buffer->length - start - entry->offset;
+    }];
+
+    if (!success || numberOfEntries != count) {
+        free(entries);
+        return NO;
+    }
+
+    // The buffer is no longer reallocated from here on
+    BOOL isSorted = YES;
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        entries[idx].bytes = buffer->bytes + start + entries[idx].offset;
+        if (idx > 0 && isSorted && AFBinaryObjectMapEntryCompare(&entries[idx - 1], &entries[idx]) > 0) {
+            isSorted = NO;
+        }
+    }
+
+    if (!isSorted) {
+        size_t length = buffer->length - start;
+        uint8_t *unsortedBytes = malloc(length);
+        if (!unsortedBytes) {
+            free(entries);
+            return NO;
+        }
+
+        memcpy(unsortedBytes, buffer->bytes + start, length);
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            entries[idx].bytes = unsortedBytes + entries[idx].offset;
+        }
+
+        qsort(entries, count, sizeof(AFBinaryObjectMapEntry), AFBinaryObjectMapEntryCompare);
+
+        uint8_t *destination = buffer->bytes + start;
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            memcpy(destination, entries[idx].bytes, entries[idx].length);
+            destination += entries[idx].length;
+        }
+
+        free(unsortedBytes);
+    }
+
+    free(entries);
+
+    return YES;
+}
+
+static BOOL AFBinaryObjectAppend(AFByteBuffer *buffer, AFBinaryObjectFormat format, id object, NSUInteger depth) {
+    BOOL isCBOR = format == AFBinaryObjectFormatCBOR;
+    if (depth > AFBinaryObjectMaximumDepth) {
+        return NO;
+    }
+
+    if ([object isKindOfClass:[NSString class]]) {
+        uint8_t stackBuffer[256];
+        uint8_t *heapBuffer = NULL;
+        size_t numberOfBytes = 0;
+        const uint8_t *bytes = AFUTF8BytesFromString(object, stackBuffer, sizeof(stackBuffer), &heapBuffer, &numberOfBytes);
+        if (!bytes) {
+            return NO;
+        }
+
+        BOOL success = (isCBOR ? AFCBORAppendHead(buffer, 3, numberOfBytes) : AFMessagePackAppendLengthHead(buffer, numberOfBytes, 0xa0, 32, 0xd9, 0xda, 0xdb)) &&
+                       AFByteBufferAppendBytes(buffer, bytes, numberOfBytes);
+        free(heapBuffer);
+
+        return success;
+    } else if ([object isKindOfClass:[NSNumber class]]) {
+        return AFBinaryObjectAppendNumber(buffer, format, object);
+    } else if ([object isKindOfClass:[NSDictionary class]]) {
+        NSDictionary *dictionary = object;
+        if (!(isCBOR ? AFCBORAppendHead(buffer, 5, dictionary.count) : AFMessagePackAppendLengthHead(buffer, dictionary.count, 0x80, 16, 0, 0xde, 0xdf))) {
+            return NO;
+        }
+
+        return AFBinaryObjectAppendSortedMapEntries(buffer, format, dictionary, depth);
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        NSArray *array = object;
+        if (!(isCBOR ? AFCBORAppendHead(buffer, 4, array.count) : AFMessagePackAppendLengthHead(buffer, array.count, 0x90, 16, 0, 0xdc, 0xdd))) {
+            return NO;
+        }
+
+        for (id element in array) {
+            if (!AFBinaryObjectAppend(buffer, format, element, depth + 1)) {
+                return NO;
+            }
+        }
+
+        return YES;
+    } else if ([object isKindOfClass:[NSNull class]]) {
+        uint8_t type = (uint8_t)(isCBOR ? 0xf6 : 0xc0);
+        return AFByteBufferAppendBytes(buffer, &type, 1);
+    } else if ([object isKindOfClass:[NSData class]]) {
+        NSData *data = object;
+        return (isCBOR ? AFCBORAppendHead(buffer, 2, data.length) : AFMessagePackAppendLengthHead(buffer, data.length, 0, 0, 0xc4, 0xc5, 0xc6)) &&
+               AFByteBufferAppendBytes(buffer, data.bytes, data.length);
+    } else if ([object isKindOfClass:[NSDate class]]) {
+        return AFBinaryObjectAppendDate(buffer, format, object);
+    }
+
+    return NO;
+}
+
+/**
+ Returns the MessagePack or CBOR encoding of `object`, or `nil` if `object` contains objects that can not be encoded, or is nested too deeply.
+ */
+static NSData * AFBinaryObjectDataFromObject(id object, AFBinaryObjectFormat format) {
+    AFByteBuffer buffer = {NULL, 0, 0};
+    if (!AFBinaryObjectAppend(&buffer, format, object, 0)) {
+        free(buffer.bytes);
+        return nil;
+    }
+
+    return [NSData dataWithBytesNoCopy:buffer.bytes length:buffer.length freeWhenDone:YES];
+}
+
+static NSURLRequest * AFRequestBySettingBinaryObjectBody(AFHTTPRequestSerializer *serializer, NSURLRequest *request, id parameters, AFBinaryObjectFormat format, NSError * __autoreleasing *error) {
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+
+    [serializer.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+        if (![request valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+
+    if (parameters) {
+        BOOL isCBOR = format == AFBinaryObjectFormatCBOR;
+        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
+            [mutableRequest setValue:isCBOR ? @"application/cbor" : @"application/msgpack" forHTTPHeaderField:@"Content-Type"];
+        }
+
+        NSData *data = AFBinaryObjectDataFromObject(parameters, format);
+        if (!data) {
+            if (error) {
+                NSString *failureReason = isCBOR ? NSLocalizedStringFromTable(@"The `parameters` argument can not be encoded as CBOR.", @"AFNetworking", nil) : NSLocalizedStringFromTable(@"The `parameters` argument can not be encoded as MessagePack.", @"AFNetworking", nil);
+                *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:@{NSLocalizedFailureReasonErrorKey: failureReason}];
+            }
+            return nil;
+        }
+
+        [mutableRequest setHTTPBody:data];
+    }
+
+    return mutableRequest;
+}
+
+@implementation AFMessagePackRequestSerializer
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+
+    return AFRequestBySettingBinaryObjectBody(self, request, parameters, AFBinaryObjectFormatMessagePack, error);
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFCBORRequestSerializer
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+
+    return AFRequestBySettingBinaryObjectBody(self, request, parameters, AFBinaryObjectFormatCBOR, error);
+}
+
+@end
+
+#pragma mark -
+
+static NSUInteger const AFJSONEncoderMaximumDepth = 512;
+
+#define AFJSONEncoderKeyCacheSize 64
+
+/**
+ Appends `string` to `buffer` as a quoted JSON string, escaping quotes, backslashes, slashes and control characters as `NSJSONSerialization` does.
+ */
+static BOOL AFJSONAppendQuotedString(AFByteBuffer *buffer, NSString *string) {
+    static const char kAFHexDigits[] = "0123456789abcdef";
+
+    uint8_t stackBuffer[256];
+    uint8_t *heapBuffer = NULL;
+    size_t numberOfBytes = 0;
+    const uint8_t *bytes = AFUTF8BytesFromString(string, stackBuffer, sizeof(stackBuffer), &heapBuffer, &numberOfBytes);
+
+    // Every byte is escaped to at most 6 bytes, and multi-byte sequences are copied as they are
+    if (!bytes || !AFByteBufferReserve(buffer, numberOfBytes * 6 + 2)) {
+        free(heapBuffer);
+        return NO;
+    }
+
+    uint8_t *output = buffer->bytes + buffer->length;
+    *output++ = '"';
+    for (size_t idx = 0; idx < numberOfBytes; idx++) {
+        uint8_t byte = bytes[idx];
+        if (byte >= 0x20 && byte != '"' && byte != '\\' && byte != '/') {
+            *output++ = byte;
+            continue;
+        }
+
+        *output++ = '\\';
+        switch (byte) {
+            case '"':
+            case '\\':
+            case '/':
+                *output++ = byte;
+                break;
+            case '\b':
+                *output++ = 'b';
+                break;
+            case '\f':
+                *output++ = 'f';
+                break;
+            case '\n':
+                *output++ = 'n';
+                break;
+            case '\r':
+                *output++ = 'r';
+                break;
+            case '\t':
+                *output++ = 't';
+                break;
+            default:
+                *output++ = 'u';
+                *output++ = '0';
+                *output++ = '0';
+                *output++ = (uint8_t)kAFHexDigits[byte >> 4];
+                *output++ = (uint8_t)kAFHexDigits[byte & 0x0F];
+                break;
+        }
+    }
+    *output++ = '"';
+    buffer->length = (size_t)(output - buffer->bytes);
+
+    free(heapBuffer);
+
+    return YES;
+}
+
+/**
+ Returns `key` quoted and followed by `:`, as it's written in front of the value of a member.
+ */
+static NSData * AFJSONMemberKeyData(NSString *key) {
+    AFByteBuffer buffer = {NULL, 0, 0};
+    if (!AFJSONAppendQuotedString(&buffer, key) || !AFByteBufferAppendBytes(&buffer, ":", 1)) {
+        free(buffer.bytes);
+        return nil;
+    }
+
+    return [NSData dataWithBytesNoCopy:buffer.bytes length:buffer.length freeWhenDone:YES];
+}
+
+/**
+ `AFJSONEncodingPlan` is a node of the tree that the key paths of the properties of a schema are compiled into for encoding the instances of a model class, with each child writing either a property, through the getter resolved for the class, or the object nested at its key. The root of a model class that conforms to `AFJSONEncoding` has no children, and is only marked as being encoded by the model itself.
+ */
+@interface AFJSONEncodingPlan : NSObject
+@property (nonatomic, strong) NSData *keyData;
+@property (nonatomic, strong) AFJSONModelProperty *property;
+@property (nonatomic, assign) SEL getter;
+@property (nonatomic, assign) IMP getterImplementation;
+@property (nonatomic, assign) char typeEncoding;
+@property (nonatomic, strong) NSMutableArray <AFJSONEncodingPlan *> *children;
+@property (nonatomic, assign, getter = isEncodedByModel) BOOL encodedByModel;
+
++ (instancetype)planForModelClass:(Class)modelClass;
+- (AFJSONEncodingPlan *)nestedChildWithKeyData:(NSData *)keyData;
+- (void)resolveGetterOfModelClass:(Class)modelClass;
+@end
+
+@implementation AFJSONEncodingPlan
+
++ (instancetype)planForModelClass:(Class)modelClass {
+    AFJSONEncodingPlan *plan = [[self alloc] init];
+    if ([modelClass conformsToProtocol:@protocol(AFJSONEncoding)]) {
+        plan.encodedByModel = YES;
+        return plan;
+    }
+
+    AFJSONModelSchema *schema = nil;
+    for (Class schemaClass = modelClass; schemaClass && !schema; schemaClass = class_getSuperclass(schemaClass)) {
+        schema = [AFJSONModelSchema registeredSchemaForModelClass:schemaClass];
+    }
+
+    if (!schema) {
+        return nil;
+    }
+
+    plan.children = [NSMutableArray array];
+    for (AFJSONModelProperty *property in schema.properties) {
+        NSArray <NSString *> *components = [property.JSONKeyPath componentsSeparatedByString:@"."];
+        AFJSONEncodingPlan *node = plan;
+        for (NSUInteger idx = 0; idx < [components count]; idx++) {
+            BOOL isLastComponent = idx + 1 == [components count];
+            NSData *keyData = AFJSONMemberKeyData(components[idx]);
+            if (!keyData) {
+                return nil;
+            }
+
+            AFJSONEncodingPlan *child = isLastComponent ? nil : [node nestedChildWithKeyData:keyData];
+            if (!child) {
+                child = [[AFJSONEncodingPlan alloc] init];
+                child.keyData = keyData;
+                if (isLastComponent) {
+                    child.property = property;
+                    [child resolveGetterOfModelClass:modelClass];
+                } else {
+                    child.children = [NSMutableArray array];
+                }
+
+                [node.children addObject:child];
+            }
+
+            node = child;
+        }
+    }
+
+    return plan;
+}
+
+- (AFJSONEncodingPlan *)nestedChildWithKeyData:(NSData *)keyData {
+    for (AFJSONEncodingPlan *child in self.children) {
+        if (child.children && [child.keyData isEqualToData:keyData]) {
+            return child;
+        }
+    }
+
+    return nil;
+}
+
+- (void)resolveGetterOfModelClass:(Class)modelClass {
+    objc_property_t runtimeProperty = class_getProperty(modelClass, [self.property.name UTF8String]);
+    if (!runtimeProperty) {
+        return;
+    }
+
+    char *typeEncoding = property_copyAttributeValue(runtimeProperty, "T");
+    char *getterName = property_copyAttributeValue(runtimeProperty, "G");
+
+    if (typeEncoding && typeEncoding[0] != '\0' && strchr("@cCBsSiIlLqQfd", typeEncoding[0])) {
+        SEL getter = getterName ? sel_registerName(getterName) : NSSelectorFromString(self.property.name);
+        Method method = class_getInstanceMethod(modelClass, getter);
+        if (method) {
+            self.getter = getter;
+            self.getterImplementation = method_getImplementation(method);
+            self.typeEncoding = typeEncoding[0];
+        }
+    }
+
+    free(typeEncoding);
+    free(getterName);
+}
+
+@end
+
+#pragma mark -
+
+@interface AFJSONEncoder ()
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ Returns the JSON encoding of `object`, which must be an array, a dictionary or a model, or `nil` if it can't be encoded, in which case `failureReason` is set to the reason, if known.
+ */
++ (NSData *)dataWithJSONObject:(id)object
+                 failureReason:(NSString * __autoreleasing *)failureReason;
+@end
+
+static BOOL AFJSONEncoderAppendValue(AFJSONEncoder *encoder, id value);
+static BOOL AFJSONEncoderAppendObject(AFJSONEncoder *encoder, id object, AFJSONEncodingPlan *plan);
+
+@implementation AFJSONEncoder {
+    AFByteBuffer _buffer;
+    BOOL _hasMembers;
+    NSUInteger _depth;
+    BOOL _failed;
+    NSString *_failureReason;
+
+    NSMapTable *_plans;
+    Class _lastModelClass;
+    AFJSONEncodingPlan *_lastPlan;
+
+    NSString *_cachedKeys[AFJSONEncoderKeyCacheSize];
+    NSData *_cachedKeyData[AFJSONEncoderKeyCacheSize];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    if (!AFByteBufferReserve(&_buffer, capacity)) {
+        return nil;
+    }
+
+    _plans = [NSMapTable strongToStrongObjectsMapTable];
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_buffer.bytes);
+}
+
++ (NSData *)dataWithJSONObject:(id)object
+                 failureReason:(NSString * __autoreleasing *)failureReason
+{
+    if ([object isKindOfClass:[NSString class]] || [object isKindOfClass:[NSNumber class]] || [object isKindOfClass:[NSNull class]]) {
+        *failureReason = NSLocalizedStringFromTable(@"Invalid top-level type in JSON write.", @"AFNetworking", nil);
+        return nil;
+    }
+
+    AFJSONEncoder *encoder = [[self alloc] initWithCapacity:4096];
+    if (!encoder) {
+        return nil;
+    }
+
+    if (!AFJSONEncoderAppendValue(encoder, object)) {
+        *failureReason = encoder->_failureReason;
+        return nil;
+    }
+
+    NSData *data = [NSData dataWithBytesNoCopy:encoder->_buffer.bytes length:encoder->_buffer.length freeWhenDone:YES];
+    encoder->_buffer = (AFByteBuffer){NULL, 0, 0};
+
+    return data;
+}
+
+#pragma mark -
+
+static BOOL AFJSONEncoderFail(AFJSONEncoder *encoder, NSString *failureReason) {
+    if (!encoder->_failed) {
+        encoder->_failed = YES;
+        encoder->_failureReason = failureReason;
+    }
+
+    return NO;
+}
+
+static BOOL AFJSONEncoderAppendBytes(AFJSONEncoder *encoder, const void *bytes, size_t length) {
+    return AFByteBufferAppendBytes(&encoder->_buffer, bytes, length) || AFJSONEncoderFail(encoder, nil);
+}
+
+static BOOL AFJSONEncoderAppendKeyData(AFJSONEncoder *encoder, NSData *keyData) {
+    if (encoder->_hasMembers && !AFJSONEncoderAppendBytes(encoder, ",", 1)) {
+        return NO;
+    }
+    encoder->_hasMembers = YES;
+
+    return AFJSONEncoderAppendBytes(encoder, [keyData bytes], [keyData length]);
+}
+
+static BOOL AFJSONEncoderAppendKey(AFJSONEncoder *encoder, NSString *key) {
+    if (![key isKindOfClass:[NSString class]]) {
+        return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Invalid (non-string) key in JSON dictionary.", @"AFNetworking", nil));
+    }
+
+    // Keys are mostly constant strings, so their encoding is cached by address. Copies are cached, so that a mutable key never matches.
+    NSUInteger slot = (NSUInteger)(((uintptr_t)(__bridge void *)key >> 4) % AFJSONEncoderKeyCacheSize);
+    NSData *keyData = encoder->_cachedKeys[slot] == key ? encoder->_cachedKeyData[slot] : nil;
+    if (!keyData) {
+        keyData = AFJSONMemberKeyData(key);
+        if (!keyData) {
+            return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Unable to convert string to UTF-8 in JSON write.", @"AFNetworking", nil));
+        }
+
+        encoder->_cachedKeys[slot] = [key copy];
+        encoder->_cachedKeyData[slot] = keyData;
+    }
+
+    return AFJSONEncoderAppendKeyData(encoder, keyData);
+}
+
+static BOOL AFJSONEncoderAppendString(AFJSONEncoder *encoder, NSString *string) {
+    return AFJSONAppendQuotedString(&encoder->_buffer, string) || AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Unable to convert string to UTF-8 in JSON write.", @"AFNetworking", nil));
+}
+
+static BOOL AFJSONEncoderAppendBool(AFJSONEncoder *encoder, BOOL value) {
+    return value ? AFJSONEncoderAppendBytes(encoder, "true", 4) : AFJSONEncoderAppendBytes(encoder, "false", 5);
+}
+
+static BOOL AFJSONEncoderAppendMagnitude(AFJSONEncoder *encoder, unsigned long long magnitude, BOOL isNegative) {
+    char buffer[24];
+    size_t idx = sizeof(buffer);
+    do {
+        buffer[--idx] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (isNegative) {
+        buffer[--idx] = '-';
+    }
+
+    return AFJSONEncoderAppendBytes(encoder, buffer + idx, sizeof(buffer) - idx);
+}
+
+static BOOL AFJSONEncoderAppendInteger(AFJSONEncoder *encoder, long long value) {
+    // Negating the unsigned value is well defined for `LLONG_MIN` as well
+    return AFJSONEncoderAppendMagnitude(encoder, value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value, value < 0);
+}
+
+static BOOL AFJSONEncoderAppendDouble(AFJSONEncoder *encoder, double value) {
+    if (!isfinite(value)) {
+        return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Invalid number value (infinite or NaN) in JSON write.", @"AFNetworking", nil));
+    }
+
+    // Integral values below 10^15 print the same as with `%.15g`, without going through `snprintf`
+    if (value == floor(value) && fabs(value) < 1e15 && !(value == 0 && signbit(value))) {
+        return AFJSONEncoderAppendInteger(encoder, (long long)value);
+    }
+
+    char buffer[64];
+    int length = AFJSONFormatDouble(buffer, sizeof(buffer), value);
+
+    return AFJSONEncoderAppendBytes(encoder, buffer, (size_t)length);
+}
+
+static BOOL AFJSONEncoderAppendNumber(AFJSONEncoder *encoder, NSNumber *number) {
+    if ((__bridge CFBooleanRef)number == kCFBooleanTrue || (__bridge CFBooleanRef)number == kCFBooleanFalse) {
+        return AFJSONEncoderAppendBool(encoder, (__bridge CFBooleanRef)number == kCFBooleanTrue);
+    } else if ([number isKindOfClass:[NSDecimalNumber class]]) {
+        if ([number isEqualToNumber:[NSDecimalNumber notANumber]]) {
+            return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Invalid number value (NaN) in JSON write.", @"AFNetworking", nil));
+        }
+
+        NSData *data = [[number description] dataUsingEncoding:NSUTF8StringEncoding];
+        return AFJSONEncoderAppendBytes(encoder, [data bytes], [data length]);
+    } else if (CFNumberIsFloatType((__bridge CFNumberRef)number)) {
+        return AFJSONEncoderAppendDouble(encoder, [number doubleValue]);
+    } else if (strcmp([number objCType], @encode(unsigned long long)) == 0 || strcmp([number objCType], @encode(unsigned long)) == 0) {
+        return AFJSONEncoderAppendMagnitude(encoder, [number unsignedLongLongValue], NO);
+    }
+
+    return AFJSONEncoderAppendInteger(encoder, [number longLongValue]);
+}
+
+static AFJSONEncodingPlan * AFJSONEncoderPlanForModelClass(AFJSONEncoder *encoder, Class modelClass) {
+    if (modelClass == encoder->_lastModelClass) {
+        return encoder->_lastPlan;
+    }
+
+    AFJSONEncodingPlan *plan = [encoder->_plans objectForKey:modelClass];
+    if (!plan) {
+        plan = [AFJSONEncodingPlan planForModelClass:modelClass];
+        if (!plan) {
+            return nil;
+        }
+
+        [encoder->_plans setObject:plan forKey:modelClass];
+    }
+
+    encoder->_lastModelClass = modelClass;
+    encoder->_lastPlan = plan;
+
+    return plan;
+}
+
+static BOOL AFJSONEncoderAppendScalarProperty(AFJSONEncoder *encoder, AFJSONEncodingPlan *node, id model) {
+    SEL getter = node.getter;
+    IMP implementation = node.getterImplementation;
+    BOOL isBoolean = node.property.type == AFJSONModelPropertyTypeBoolean;
+
+    if (node.typeEncoding == 'f' || node.typeEncoding == 'd') {
+        double value = node.typeEncoding == 'f' ? ((float (*)(id, SEL))implementation)(model, getter) : ((double (*)(id, SEL))implementation)(model, getter);
+        if (!AFJSONEncoderAppendKeyData(encoder, node.keyData)) {
+            return NO;
+        }
+
+        return isBoolean ? AFJSONEncoderAppendBool(encoder, value != 0) : AFJSONEncoderAppendDouble(encoder, value);
+    }
+
+    long long signedValue = 0;
+    unsigned long long unsignedValue = 0;
+    BOOL isUnsigned = NO;
+    switch (node.typeEncoding) {
+        case 'c':
+            signedValue = ((char (*)(id, SEL))implementation)(model, getter);
+            break;
+        case 's':
+            signedValue = ((short (*)(id, SEL))implementation)(model, getter);
+            break;
+        case 'i':
+            signedValue = ((int (*)(id, SEL))implementation)(model, getter);
+            break;
+        case 'l':
+            signedValue = ((long (*)(id, SEL))implementation)(model, getter);
+            break;
+        case 'q':
+            signedValue = ((long long (*)(id, SEL))implementation)(model, getter);
+            break;
+        case 'C':
+            unsignedValue = ((unsigned char (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        case 'B':
+            unsignedValue = ((bool (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        case 'S':
+            unsignedValue = ((unsigned short (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        case 'I':
+            unsignedValue = ((unsigned int (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        case 'L':
+            unsignedValue = ((unsigned long (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        case 'Q':
+            unsignedValue = ((unsigned long long (*)(id, SEL))implementation)(model, getter);
+            isUnsigned = YES;
+            break;
+        default:
+            break;
+    }
+
+    if (!AFJSONEncoderAppendKeyData(encoder, node.keyData)) {
+        return NO;
+    }
+
+    if (isBoolean) {
+        return AFJSONEncoderAppendBool(encoder, isUnsigned ? unsignedValue != 0 : signedValue != 0);
+    }
+
+    return isUnsigned ? AFJSONEncoderAppendMagnitude(encoder, unsignedValue, NO) : AFJSONEncoderAppendInteger(encoder, signedValue);
+}
+
+static BOOL AFJSONEncoderAppendProperty(AFJSONEncoder *encoder, AFJSONEncodingPlan *node, id model) {
+    if (node.getterImplementation && node.typeEncoding != '@') {
+        return AFJSONEncoderAppendScalarProperty(encoder, node, model);
+    }
+
+    AFJSONModelProperty *property = node.property;
+    id value = node.getterImplementation ? ((id (*)(id, SEL))node.getterImplementation)(model, node.getter) : [model valueForKey:property.name];
+    if (!value) {
+        return YES;
+    }
+
+    if ([value isKindOfClass:[NSNull class]]) {
+        return AFJSONEncoderAppendKeyData(encoder, node.keyData) && AFJSONEncoderAppendBytes(encoder, "null", 4);
+    }
+
+    AFJSONEncodingPlan *plan = nil;
+    BOOL isValid = NO;
+    switch (property.type) {
+        case AFJSONModelPropertyTypeString:
+            isValid = [value isKindOfClass:[NSString class]];
+            break;
+        case AFJSONModelPropertyTypeNumber:
+        case AFJSONModelPropertyTypeBoolean:
+            isValid = [value isKindOfClass:[NSNumber class]];
+            break;
+        case AFJSONModelPropertyTypeURL:
+            isValid = [value isKindOfClass:[NSURL class]];
+            break;
+        case AFJSONModelPropertyTypeModel:
+            plan = AFJSONEncoderPlanForModelClass(encoder, [value class]);
+            isValid = plan != nil;
+            break;
+        case AFJSONModelPropertyTypeModelArray:
+            isValid = [value isKindOfClass:[NSArray class]];
+            break;
+    }
+
+    if (!isValid) {
+        return AFJSONEncoderFail(encoder, [NSString stringWithFormat:NSLocalizedStringFromTable(@"Invalid value of type %@ for the property %@ in JSON write.", @"AFNetworking", nil), NSStringFromClass([value class]), property.name]);
+    }
+
+    if (!AFJSONEncoderAppendKeyData(encoder, node.keyData)) {
+        return NO;
+    }
+
+    switch (property.type) {
+        case AFJSONModelPropertyTypeString:
+            return AFJSONEncoderAppendString(encoder, value);
+        case AFJSONModelPropertyTypeBoolean:
+            return AFJSONEncoderAppendBool(encoder, [(NSNumber *)value boolValue]);
+        case AFJSONModelPropertyTypeURL:
+            return AFJSONEncoderAppendString(encoder, [(NSURL *)value absoluteString]);
+        case AFJSONModelPropertyTypeModel:
+            return AFJSONEncoderAppendObject(encoder, value, plan);
+        case AFJSONModelPropertyTypeNumber:
+        case AFJSONModelPropertyTypeModelArray:
+            return AFJSONEncoderAppendValue(encoder, value);
+    }
+
+    return NO;
+}
+
+static BOOL AFJSONEncoderAppendMembers(AFJSONEncoder *encoder, id object, AFJSONEncodingPlan *plan) {
+    if (!plan) {
+        NSDictionary *dictionary = object;
+        for (id key in dictionary) {
+            if (!AFJSONEncoderAppendKey(encoder, key) || !AFJSONEncoderAppendValue(encoder, [dictionary objectForKey:key])) {
+                return NO;
+            }
+        }
+
+        return YES;
+    } else if ([plan isEncodedByModel]) {
+        [(id <AFJSONEncoding>)object encodeWithJSONEncoder:encoder];
+
+        return !encoder->_failed;
+    }
+
+    for (AFJSONEncodingPlan *child in plan.children) {
+        if (!child.children) {
+            if (!AFJSONEncoderAppendProperty(encoder, child, object)) {
+                return NO;
+            }
+
+            continue;
+        }
+
+        // The key of a nested object is taken back out if none of its members are written, since every property at or below it was `nil`.
+        size_t memberStart = encoder->_buffer.length;
+        BOOL hadMembers = encoder->_hasMembers;
+        if (!AFJSONEncoderAppendKeyData(encoder, child.keyData)) {
+            return NO;
+        }
+
+        size_t objectStart = encoder->_buffer.length;
+        if (!AFJSONEncoderAppendObject(encoder, object, child)) {
+            return NO;
+        }
+
+        if (encoder->_buffer.length == objectStart + 2) {
+            encoder->_buffer.length = memberStart;
+            encoder->_hasMembers = hadMembers;
+        }
+    }
+
+    return YES;
+}
+
+/**
+ Appends a JSON object with the members of `object`, which is a dictionary if `plan` is `nil`, and otherwise a model whose members are written according to `plan`.
+ */
+static BOOL AFJSONEncoderAppendObject(AFJSONEncoder *encoder, id object, AFJSONEncodingPlan *plan) {
+    if (encoder->_depth >= AFJSONEncoderMaximumDepth) {
+        return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Too many nested objects in JSON write.", @"AFNetworking", nil));
+    }
+
+    if (!AFJSONEncoderAppendBytes(encoder, "{", 1)) {
+        return NO;
+    }
+
+    BOOL hadMembers = encoder->_hasMembers;
+    encoder->_hasMembers = NO;
+    encoder->_depth++;
+
+    BOOL success = AFJSONEncoderAppendMembers(encoder, object, plan);
+
+    encoder->_depth--;
+    encoder->_hasMembers = hadMembers;
+
+    return success && AFJSONEncoderAppendBytes(encoder, "}", 1);
+}
+
+static BOOL AFJSONEncoderAppendArray(AFJSONEncoder *encoder, NSArray *array) {
+    if (encoder->_depth >= AFJSONEncoderMaximumDepth) {
+        return AFJSONEncoderFail(encoder, NSLocalizedStringFromTable(@"Too many nested objects in JSON write.", @"AFNetworking", nil));
+    }
+
+    if (!AFJSONEncoderAppendBytes(encoder, "[", 1)) {
+        return NO;
+    }
+
+    encoder->_depth++;
+
+    BOOL success = YES;
+    BOOL hasElements = NO;
+    for (id element in array) {
+        if ((hasElements && !AFJSONEncoderAppendBytes(encoder, ",", 1)) || !AFJSONEncoderAppendValue(encoder, element)) {
+            success = NO;
+            break;
+        }
+        hasElements = YES;
+    }
+
+    encoder->_depth--;
+
+    return success && AFJSONEncoderAppendBytes(encoder, "]", 1);
+}
+
+static BOOL AFJSONEncoderAppendValue(AFJSONEncoder *encoder, id value) {
+    if ([value isKindOfClass:[NSString class]]) {
+        return AFJSONEncoderAppendString(encoder, value);
+    } else if ([value isKindOfClass:[NSNumber class]]) {
+        return AFJSONEncoderAppendNumber(encoder, value);
+    } else if ([value isKindOfClass:[NSArray class]]) {
+        return AFJSONEncoderAppendArray(encoder, value);
+    } else if ([value isKindOfClass:[NSDictionary class]]) {
+        return AFJSONEncoderAppendObject(encoder, value, nil);
+    } else if ([value isKindOfClass:[NSNull class]]) {
+        return AFJSONEncoderAppendBytes(encoder, "null", 4);
+    }
+
+    AFJSONEncodingPlan *plan = value ? AFJSONEncoderPlanForModelClass(encoder, [value class]) : nil;
+    if (!plan) {
+        return AFJSONEncoderFail(encoder, [NSString stringWithFormat:NSLocalizedStringFromTable(@"Invalid type in JSON write (%@).", @"AFNetworking", nil), NSStringFromClass([value class])]);
+    }
+
+    return AFJSONEncoderAppendObject(encoder, value, plan);
+}
+
+#pragma mark -
+
+- (void)encodeObject:(id)object
+              forKey:(NSString *)key
+{
+    if (object && !_failed && AFJSONEncoderAppendKey(self, key)) {
+        AFJSONEncoderAppendValue(self, object);
+    }
+}
+
+- (void)encodeString:(NSString *)string
+              forKey:(NSString *)key
+{
+    if (string && !_failed && AFJSONEncoderAppendKey(self, key)) {
+        AFJSONEncoderAppendString(self, string);
+    }
+}
+
+- (void)encodeInteger:(NSInteger)value
+               forKey:(NSString *)key
+{
+    if (!_failed && AFJSONEncoderAppendKey(self, key)) {
+        AFJSONEncoderAppendInteger(self, value);
+    }
+}
+
+- (void)encodeDouble:(double)value
+              forKey:(NSString *)key
+{
+    if (!_failed && AFJSONEncoderAppendKey(self, key)) {
+        AFJSONEncoderAppendDouble(self, value);
+    }
+}
+
+- (void)encodeBool:(BOOL)value
+            forKey:(NSString *)key
+{
+    if (!_failed && AFJSONEncoderAppendKey(self, key)) {
+        AFJSONEncoderAppendBool(self, value);
+    }
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFJSONModelRequestSerializer
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
+        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    }
+
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+
+    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
+        if (![request valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+
+    if (parameters) {
+        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
+            [mutableRequest setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
+        }
+
+        NSString *failureReason = nil;
+        NSData *data = [AFJSONEncoder dataWithJSONObject:parameters failureReason:&failureReason];
+        if (!data) {
+            if (error) {
+                NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: failureReason ?: NSLocalizedStringFromTable(@"The `parameters` argument is not valid JSON.", @"AFNetworking", nil)};
+                *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+            }
+            return nil;
+        }
+
+        [mutableRequest setHTTPBody:data];
+    }
+
+    return mutableRequest;
+}
+
+@end
+
+#pragma mark -
+
+static NSUInteger const AFCompressionChunkLength = 1024 * 1024;
+static NSUInteger const AFCompressionDictionaryLength = 32 * 1024;
+static NSUInteger const AFCompressedBodyStreamBufferLength = 64 * 1024;
+
+static int AFWindowBitsForContentEncoding(AFHTTPBodyContentEncoding contentEncoding) {
+    // Adding 16 to the window bits makes zlib write a gzip header and trailer instead of a zlib one
+    return contentEncoding == AFHTTPBodyContentEncodingGzip ? MAX_WBITS + 16 : MAX_WBITS;
+}
+
+static NSString * AFContentEncodingName(AFHTTPBodyContentEncoding contentEncoding) {
+    return contentEncoding == AFHTTPBodyContentEncodingGzip ? @"gzip" : @"deflate";
+}
+
+static NSData * AFCompressedDataFromData(NSData *data, AFHTTPBodyContentEncoding contentEncoding, int level) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, AFWindowBitsForContentEncoding(contentEncoding), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+
+    NSMutableData *compressedData = [NSMutableData dataWithLength:MAX((NSUInteger)deflateBound(&stream, (uLong)[data length]), (NSUInteger)64)];
+    const uint8_t *bytes = [data bytes];
+    NSUInteger numberOfRemainingBytes = [data length];
+    int status = Z_OK;
+
+    while (status == Z_OK) {
+        if (stream.avail_in == 0 && numberOfRemainingBytes > 0) {
+            uInt numberOfInputBytes = (uInt)MIN(numberOfRemainingBytes, (NSUInteger)UINT_MAX);
+            stream.next_in = (Bytef *)bytes;
+            stream.avail_in = numberOfInputBytes;
+            bytes += numberOfInputBytes;
+            numberOfRemainingBytes -= numberOfInputBytes;
+        }
+
+        if ((NSUInteger)stream.total_out >= [compressedData length]) {
+            [compressedData setLength:[compressedData length] * 2];
+        }
+
+        stream.next_out = (Bytef *)[compressedData mutableBytes] + stream.total_out;
+        stream.avail_out = (uInt)MIN([compressedData length] - (NSUInteger)stream.total_out, (NSUInteger)UINT_MAX);
+
+        status = deflate(&stream, numberOfRemainingBytes == 0 ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    [compressedData setLength:(NSUInteger)stream.total_out];
+    deflateEnd(&stream);
+
+    return status == Z_STREAM_END ? compressedData : nil;
+}
+
+/**
+ Compresses a chunk of a larger body into raw deflate data, primed with the end of the previous chunk so that the ratio barely suffers from the split. All chunks but the last end with a sync flush, which ends them on a byte boundary without marking the final block, so that the chunks can simply be concatenated.
+ */
+static NSData * AFCompressedChunk(const uint8_t *bytes, NSUInteger length, const uint8_t *dictionary, NSUInteger dictionaryLength, int level, BOOL isLastChunk) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return nil;
+    }
+
+    if (dictionaryLength > 0) {
+        deflateSetDictionary(&stream, dictionary, (uInt)dictionaryLength);
+    }
+
+    // Leave room for the empty stored block written by the sync flush
+    NSMutableData *compressedChunk = [NSMutableData dataWithLength:(NSUInteger)deflateBound(&stream, (uLong)length) + 16];
+    stream.next_in = (Bytef *)bytes;
+    stream.avail_in = (uInt)length;
+    stream.next_out = [compressedChunk mutableBytes];
+    stream.avail_out = (uInt)[compressedChunk length];
+
+    int status = deflate(&stream, isLastChunk ? Z_FINISH : Z_SYNC_FLUSH);
+    BOOL succeeded = stream.avail_in == 0 && stream.avail_out > 0 && status == (isLastChunk ? Z_STREAM_END : Z_OK);
+
+    [compressedChunk setLength:(NSUInteger)stream.total_out];
+    deflateEnd(&stream);
+
+    return succeeded ? compressedChunk : nil;
+}
+
+static NSData * AFConcurrentlyCompressedDataFromData(NSData *data, AFHTTPBodyContentEncoding contentEncoding, int level) {
+    const uint8_t *bytes = [data bytes];
+    NSUInteger length = [data length];
+    size_t numberOfChunks = (length + AFCompressionChunkLength - 1) / AFCompressionChunkLength;
+
+    void **compressedChunks = calloc(numberOfChunks, sizeof(void *));
+    uLong *checksums = calloc(numberOfChunks, sizeof(uLong));
+    if (!compressedChunks || !checksums) {
+        free(compressedChunks);
+        free(checksums);
+        return nil;
+    }
+
+    dispatch_apply(numberOfChunks, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t idx) {
+        NSUInteger offset = idx * AFCompressionChunkLength;
+        NSUInteger chunkLength = MIN(AFCompressionChunkLength, length - offset);
+        NSUInteger dictionaryLength = MIN(offset, AFCompressionDictionaryLength);
+
+        NSData *compressedChunk = AFCompressedChunk(bytes + offset, chunkLength, bytes + offset - dictionaryLength, dictionaryLength, level, idx == numberOfChunks - 1);
+        compressedChunks[idx] = compressedChunk ? (void *)CFBridgingRetain(compressedChunk) : NULL;
+
+        if (contentEncoding == AFHTTPBodyContentEncodingGzip) {
+            checksums[idx] = crc32(crc32(0L, Z_NULL, 0), bytes + offset, (uInt)chunkLength);
+        } else {
+            checksums[idx] = adler32(adler32(0L, Z_NULL, 0), bytes + offset, (uInt)chunkLength);
+        }
+    });
+
+    NSMutableData *compressedData = [NSMutableData data];
+    if (contentEncoding == AFHTTPBodyContentEncodingGzip) {
+        uint8_t header[10] = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, (uint8_t)(level == Z_BEST_COMPRESSION ? 2 : (level == Z_BEST_SPEED ? 4 : 0)), 0xff};
+        [compressedData appendBytes:header length:sizeof(header)];
+    } else {
+        unsigned int compressionLevelFlag = level == Z_DEFAULT_COMPRESSION ? 2 : (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3)));
+        unsigned int header = (0x78 << 8) | (compressionLevelFlag << 6);
+        header += 31 - (header % 31);
+        uint8_t headerBytes[2] = {(uint8_t)(header >> 8), (uint8_t)(header & 0xff)};
+        [compressedData appendBytes:headerBytes length:sizeof(headerBytes)];
+    }
+
+    BOOL succeeded = YES;
+    uLong checksum = 0;
+    for (size_t idx = 0; idx < numberOfChunks; idx++) {
+        NSData *compressedChunk = compressedChunks[idx] ? CFBridgingRelease(compressedChunks[idx]) : nil;
+        succeeded = succeeded && compressedChunk != nil;
+        [compressedData appendData:compressedChunk];
+
+        NSUInteger chunkLength = MIN(AFCompressionChunkLength, length - idx * AFCompressionChunkLength);
+        if (idx == 0) {
+            checksum = checksums[idx];
+        } else if (contentEncoding == AFHTTPBodyContentEncodingGzip) {
+            checksum = crc32_combine(checksum, checksums[idx], (z_off_t)chunkLength);
+        } else {
+            checksum = adler32_combine(checksum, checksums[idx], (z_off_t)chunkLength);
+        }
+    }
+
+    free(compressedChunks);
+    free(checksums);
+
+    if (!succeeded) {
+        return nil;
+    }
+
+    if (contentEncoding == AFHTTPBodyContentEncodingGzip) {
+        uint32_t trailer[2] = {CFSwapInt32HostToLittle((uint32_t)checksum), CFSwapInt32HostToLittle((uint32_t)length)};
+        [compressedData appendBytes:trailer length:sizeof(trailer)];
+    } else {
+        uint32_t trailer = CFSwapInt32HostToBig((uint32_t)checksum);
+        [compressedData appendBytes:&trailer length:sizeof(trailer)];
+    }
+
+    return compressedData;
 }
 
-#pragma mark - AFURLRequestSerializer
+#pragma mark -
 
-- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
-                               withParameters:(id)parameters
-                                        error:(NSError *__autoreleasing *)error
+/**
+ An input stream that compresses the contents of another input stream as they are read.
+ */
+@interface AFCompressedBodyStream : NSInputStream <NSCopying>
+@property (readonly, nonatomic, strong) NSInputStream *inputStream;
+@property (readonly, nonatomic, assign) AFHTTPBodyContentEncoding contentEncoding;
+@property (readonly, nonatomic, assign) int compressionLevel;
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream
+                    contentEncoding:(AFHTTPBodyContentEncoding)contentEncoding
+                   compressionLevel:(int)compressionLevel;
+@end
+
+@interface AFCompressedBodyStream () {
+    z_stream _stream;
+    BOOL _deflating;
+    BOOL _inputStreamAtEnd;
+    uint8_t *_inputBuffer;
+}
+@property (readwrite, nonatomic, strong) NSInputStream *inputStream;
+@property (readwrite, nonatomic, assign) AFHTTPBodyContentEncoding contentEncoding;
+@property (readwrite, nonatomic, assign) int compressionLevel;
+@end
+
+@implementation AFCompressedBodyStream
+#if (defined(__IPHONE_OS_VERSION_MAX_ALLOWED) && __IPHONE_OS_VERSION_MAX_ALLOWED >= 80000) || (defined(__MAC_OS_X_VERSION_MAX_ALLOWED) && __MAC_OS_X_VERSION_MAX_ALLOWED >= 1100)
+@synthesize delegate;
+#endif
+@synthesize streamStatus;
+@synthesize streamError;
+
+- (instancetype)initWithInputStream:(NSInputStream *)inputStream
+                    contentEncoding:(AFHTTPBodyContentEncoding)contentEncoding
+                   compressionLevel:(int)compressionLevel
 {
-    NSParameterAssert(request);
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
 
-    if ([self.HTTPMethodsEncodingParametersInURI containsObject:[[request HTTPMethod] uppercaseString]]) {
-        return [super requestBySerializingRequest:request withParameters:parameters error:error];
+    self.inputStream = inputStream;
+    self.contentEncoding = contentEncoding;
+    self.compressionLevel = compressionLevel;
+
+    return self;
+}
+
+- (void)dealloc {
+    [self endDeflating];
+}
+
+- (void)endDeflating {
+    if (_deflating) {
+        deflateEnd(&_stream);
+        _deflating = NO;
     }
 
-    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+    free(_inputBuffer);
+    _inputBuffer = NULL;
+}
 
-    [self.HTTPRequestHeaders enumerateKeysAndObjectsUsingBlock:^(id field, id value, BOOL * __unused stop) {
-        if (![request valueForHTTPHeaderField:field]) {
-            [mutableRequest setValue:value forHTTPHeaderField:field];
+- (NSInteger)failWithError:(NSError *)error {
+    self.streamError = error ?: [NSError errorWithDomain:NSPOSIXErrorDomain code:EIO userInfo:nil];
+    self.streamStatus = NSStreamStatusError;
+
+    return -1;
+}
+
+#pragma mark - NSInputStream
+
+- (NSInteger)read:(uint8_t *)buffer
+        maxLength:(NSUInteger)length
+{
+    if ([self streamStatus] != NSStreamStatusOpen) {
+        return [self streamStatus] == NSStreamStatusError ? -1 : 0;
+    }
+
+    uInt maxLength = (uInt)MIN(length, (NSUInteger)UINT_MAX);
+    _stream.next_out = buffer;
+    _stream.avail_out = maxLength;
+
+    while (_stream.avail_out > 0) {
+        if (_stream.avail_in == 0 && !_inputStreamAtEnd) {
+            // Return what has been compressed so far rather than wait for more input
+            if (_stream.avail_out < maxLength) {
+                break;
+            }
+
+            NSInteger numberOfBytesRead = [self.inputStream read:_inputBuffer maxLength:AFCompressedBodyStreamBufferLength];
+            if (numberOfBytesRead < 0) {
+                return [self failWithError:self.inputStream.streamError];
+            }
+
+            _inputStreamAtEnd = numberOfBytesRead == 0;
+            _stream.next_in = _inputBuffer;
+            _stream.avail_in = (uInt)numberOfBytesRead;
         }
-    }];
 
-    if (parameters) {
-        if (![mutableRequest valueForHTTPHeaderField:@"Content-Type"]) {
-            [mutableRequest setValue:@"application/x-plist" forHTTPHeaderField:@"Content-Type"];
+        int status = deflate(&_stream, _inputStreamAtEnd ? Z_FINISH : Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            self.streamStatus = NSStreamStatusAtEnd;
+            break;
+        } else if (status != Z_OK && status != Z_BUF_ERROR) {
+            return [self failWithError:[NSError errorWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:@{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The request body could not be compressed.", @"AFNetworking", nil)}]];
         }
+    }
+
+    return (NSInteger)(maxLength - _stream.avail_out);
+}
+
+- (BOOL)getBuffer:(__unused uint8_t **)buffer
+           length:(__unused NSUInteger *)len
+{
+    return NO;
+}
+
+- (BOOL)hasBytesAvailable {
+    return [self streamStatus] == NSStreamStatusOpen;
+}
+
+#pragma mark - NSStream
+
+- (void)open {
+    if (self.streamStatus == NSStreamStatusOpen) {
+        return;
+    }
+
+    [self endDeflating];
+    memset(&_stream, 0, sizeof(_stream));
+    _inputStreamAtEnd = NO;
+    _inputBuffer = malloc(AFCompressedBodyStreamBufferLength);
+
+    if (!_inputBuffer || deflateInit2(&_stream, self.compressionLevel, Z_DEFLATED, AFWindowBitsForContentEncoding(self.contentEncoding), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        [self failWithError:[NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil]];
+        return;
+    }
+
+    _deflating = YES;
+    [self.inputStream open];
+    self.streamStatus = NSStreamStatusOpen;
+}
+
+- (void)close {
+    [self.inputStream close];
+    [self endDeflating];
+    self.streamStatus = NSStreamStatusClosed;
+}
+
+- (id)propertyForKey:(__unused NSString *)key {
+    return nil;
+}
+
+- (BOOL)setProperty:(__unused id)property
+             forKey:(__unused NSString *)key
+{
+    return NO;
+}
+
+- (void)scheduleInRunLoop:(__unused NSRunLoop *)aRunLoop
+                  forMode:(__unused NSString *)mode
+{}
+
+- (void)removeFromRunLoop:(__unused NSRunLoop *)aRunLoop
+                  forMode:(__unused NSString *)mode
+{}
+
+#pragma mark - Undocumented CFReadStream Bridged Methods
+
+- (void)_scheduleInCFRunLoop:(__unused CFRunLoopRef)aRunLoop
+                     forMode:(__unused CFStringRef)aMode
+{}
+
+- (void)_unscheduleFromCFRunLoop:(__unused CFRunLoopRef)aRunLoop
+                         forMode:(__unused CFStringRef)aMode
+{}
+
+- (BOOL)_setCFClientFlags:(__unused CFOptionFlags)inFlags
+                 callback:(__unused CFReadStreamClientCallBack)inCallback
+                  context:(__unused CFStreamClientContext *)inContext {
+    return NO;
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    NSInputStream *inputStream = [self.inputStream conformsToProtocol:@protocol(NSCopying)] ? [(id <NSCopying>)self.inputStream copyWithZone:zone] : self.inputStream;
+
+    return [[[self class] allocWithZone:zone] initWithInputStream:inputStream contentEncoding:self.contentEncoding compressionLevel:self.compressionLevel];
+}
+
+@end
+
+#pragma mark -
+
+@interface AFCompressingRequestSerializer ()
+@property (readwrite, nonatomic, strong) id <AFURLRequestSerialization> requestSerializer;
+@property (readwrite, nonatomic, copy) NSDictionary *defaultHTTPRequestHeaders;
+@end
+
+@implementation AFCompressingRequestSerializer
+
++ (instancetype)serializerWithRequestSerializer:(id<AFURLRequestSerialization>)requestSerializer {
+    return [self serializerWithRequestSerializer:requestSerializer contentEncoding:AFHTTPBodyContentEncodingGzip];
+}
+
++ (instancetype)serializerWithRequestSerializer:(id<AFURLRequestSerialization>)requestSerializer
+                                contentEncoding:(AFHTTPBodyContentEncoding)contentEncoding
+{
+    AFCompressingRequestSerializer *serializer = [[self alloc] init];
+    serializer.requestSerializer = requestSerializer;
+    serializer.contentEncoding = contentEncoding;
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    // The default headers of the compressing serializer, such as `User-Agent`, don't replace those of the wrapped serializer
+    self.defaultHTTPRequestHeaders = self.HTTPRequestHeaders;
+
+    self.requestSerializer = [AFHTTPRequestSerializer serializer];
+    self.contentEncoding = AFHTTPBodyContentEncodingGzip;
+    self.compressionLevel = Z_DEFAULT_COMPRESSION;
+    self.minimumBodyLength = 1024;
+    self.parallelCompressionThreshold = 4 * AFCompressionChunkLength;
+
+    return self;
+}
+
+- (NSURLRequest *)requestByCompressingBodyOfRequest:(NSURLRequest *)request
+                                              error:(NSError *__autoreleasing *)error
+{
+    if ([request valueForHTTPHeaderField:@"Content-Encoding"]) {
+        return request;
+    }
+
+    int level = (int)MAX(MIN(self.compressionLevel, (NSInteger)Z_BEST_COMPRESSION), (NSInteger)Z_DEFAULT_COMPRESSION);
+    NSMutableURLRequest *mutableRequest = [request mutableCopy];
+
+    if ([request HTTPBody]) {
+        NSData *body = [request HTTPBody];
+        if ([body length] < self.minimumBodyLength) {
+            return request;
+        }
+
+        NSData *compressedBody = [body length] >= self.parallelCompressionThreshold ? AFConcurrentlyCompressedDataFromData(body, self.contentEncoding, level) : AFCompressedDataFromData(body, self.contentEncoding, level);
+        if (!compressedBody) {
+            if (error) {
+                NSDictionary *userInfo = @{NSLocalizedFailureReasonErrorKey: NSLocalizedStringFromTable(@"The request body could not be compressed.", @"AFNetworking", nil)};
+                *error = [[NSError alloc] initWithDomain:AFURLRequestSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+            }
 
-        NSData *plistData = [NSPropertyListSerialization dataWithPropertyList:parameters format:self.format options:self.writeOptions error:error];
-        
-        if (!plistData) {
             return nil;
         }
-        
-        [mutableRequest setHTTPBody:plistData];
+
+        [mutableRequest setHTTPBody:compressedBody];
+        if ([request valueForHTTPHeaderField:@"Content-Length"]) {
+            [mutableRequest setValue:[NSString stringWithFormat:@"%lu", (unsigned long)[compressedBody length]] forHTTPHeaderField:@"Content-Length"];
+        }
+    } else if ([request HTTPBodyStream]) {
+        NSString *contentLength = [request valueForHTTPHeaderField:@"Content-Length"];
+        if (contentLength && (unsigned long long)[contentLength longLongValue] < self.minimumBodyLength) {
+            return request;
+        }
+
+        [mutableRequest setHTTPBodyStream:[[AFCompressedBodyStream alloc] initWithInputStream:[request HTTPBodyStream] contentEncoding:self.contentEncoding compressionLevel:level]];
+        [mutableRequest setValue:nil forHTTPHeaderField:@"Content-Length"];
+    } else {
+        return request;
     }
 
+    [mutableRequest setValue:AFContentEncodingName(self.contentEncoding) forHTTPHeaderField:@"Content-Encoding"];
+
     return mutableRequest;
 }
 
+#pragma mark - AFHTTPRequestSerializer
+
+- (NSMutableURLRequest *)requestWithMethod:(NSString *)method
+                                       URL:(NSURL *)url
+                                parameters:(id)parameters
+                                     error:(NSError *__autoreleasing *)error
+{
+    if (![self.requestSerializer isKindOfClass:[AFHTTPRequestSerializer class]]) {
+        return [super requestWithMethod:method URL:url parameters:parameters error:error];
+    }
+
+    NSParameterAssert(url);
+
+    // Requests start out with the cache policy, timeout interval and other request properties of the wrapped serializer, over which those set on the compressing serializer itself are applied
+    NSMutableURLRequest *mutableRequest = [[(AFHTTPRequestSerializer *)self.requestSerializer currentRequestPrototype] mutableCopy];
+    NSURLRequest *prototype = [self currentRequestPrototype];
+
+    NSSet __block *changedKeyPaths = nil;
+    dispatch_sync(self.requestHeaderModificationQueue, ^{
+        changedKeyPaths = [self.mutableObservedChangedKeyPaths copy];
+    });
+    for (NSString *keyPath in AFHTTPRequestSerializerObservedKeyPaths()) {
+        if ([changedKeyPaths containsObject:keyPath]) {
+            [mutableRequest setValue:[prototype valueForKey:keyPath] forKey:keyPath];
+        }
+    }
+
+    NSDictionary *defaultHTTPRequestHeaders = self.defaultHTTPRequestHeaders;
+    [[prototype allHTTPHeaderFields] enumerateKeysAndObjectsUsingBlock:^(NSString *field, NSString *value, BOOL * __unused stop) {
+        if (![value isEqualToString:defaultHTTPRequestHeaders[field]] || ![mutableRequest valueForHTTPHeaderField:field]) {
+            [mutableRequest setValue:value forHTTPHeaderField:field];
+        }
+    }];
+
+    mutableRequest.URL = url;
+    mutableRequest.HTTPMethod = method;
+
+    return [[self requestBySerializingRequest:mutableRequest withParameters:parameters error:error] mutableCopy];
+}
+
+- (NSMutableURLRequest *)multipartFormRequestWithMethod:(NSString *)method
+                                              URLString:(NSString *)URLString
+                                             parameters:(NSDictionary *)parameters
+                              constructingBodyWithBlock:(void (^)(id <AFMultipartFormData> formData))block
+                                                  error:(NSError *__autoreleasing *)error
+{
+    NSMutableURLRequest *request = [super multipartFormRequestWithMethod:method URLString:URLString parameters:parameters constructingBodyWithBlock:block error:error];
+    if (!request) {
+        return nil;
+    }
+
+    return [[self requestByCompressingBodyOfRequest:request error:error] mutableCopy];
+}
+
+#pragma mark - AFURLRequestSerialization
+
+- (NSURLRequest *)requestBySerializingRequest:(NSURLRequest *)request
+                               withParameters:(id)parameters
+                                        error:(NSError *__autoreleasing *)error
+{
+    NSParameterAssert(request);
+
+    NSURLRequest *serializedRequest = [self.requestSerializer requestBySerializingRequest:request withParameters:parameters error:error];
+    if (!serializedRequest) {
+        return nil;
+    }
+
+    return [self requestByCompressingBodyOfRequest:serializedRequest error:error];
+}
+
 #pragma mark - NSSecureCoding
 
 - (instancetype)initWithCoder:(NSCoder *)decoder {
@@ -1372,8 +5002,11 @@ typedef enum {
         return nil;
     }
 
-    self.format = (NSPropertyListFormat)[[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(format))] unsignedIntegerValue];
-    self.writeOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(writeOptions))] unsignedIntegerValue];
+    self.requestSerializer = [decoder decodeObjectOfClass:[NSObject class] forKey:NSStringFromSelector(@selector(requestSerializer))] ?: [AFHTTPRequestSerializer serializer];
+    self.contentEncoding = (AFHTTPBodyContentEncoding)[[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(contentEncoding))] unsignedIntegerValue];
+    self.compressionLevel = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(compressionLevel))] integerValue];
+    self.minimumBodyLength = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(minimumBodyLength))] unsignedIntegerValue];
+    self.parallelCompressionThreshold = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(parallelCompressionThreshold))] unsignedIntegerValue];
 
     return self;
 }
@@ -1381,16 +5014,22 @@ typedef enum {
 - (void)encodeWithCoder:(NSCoder *)coder {
     [super encodeWithCoder:coder];
 
-    [coder encodeInteger:self.format forKey:NSStringFromSelector(@selector(format))];
-    [coder encodeObject:@(self.writeOptions) forKey:NSStringFromSelector(@selector(writeOptions))];
+    [coder encodeObject:self.requestSerializer forKey:NSStringFromSelector(@selector(requestSerializer))];
+    [coder encodeObject:@(self.contentEncoding) forKey:NSStringFromSelector(@selector(contentEncoding))];
+    [coder encodeObject:@(self.compressionLevel) forKey:NSStringFromSelector(@selector(compressionLevel))];
+    [coder encodeObject:@(self.minimumBodyLength) forKey:NSStringFromSelector(@selector(minimumBodyLength))];
+    [coder encodeObject:@(self.parallelCompressionThreshold) forKey:NSStringFromSelector(@selector(parallelCompressionThreshold))];
 }
 
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(NSZone *)zone {
-    AFPropertyListRequestSerializer *serializer = [super copyWithZone:zone];
-    serializer.format = self.format;
-    serializer.writeOptions = self.writeOptions;
+    AFCompressingRequestSerializer *serializer = [super copyWithZone:zone];
+    serializer.requestSerializer = [self.requestSerializer copyWithZone:zone];
+    serializer.contentEncoding = self.contentEncoding;
+    serializer.compressionLevel = self.compressionLevel;
+    serializer.minimumBodyLength = self.minimumBodyLength;
+    serializer.parallelCompressionThreshold = self.parallelCompressionThreshold;
 
     return serializer;
 }
@@ -22,6 +22,8 @@
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
 
+#import "AFJSONModelSchema.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 /**
@@ -48,6 +50,55 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+/**
+ The `AFURLResponseIncrementalParser` protocol is adopted by an object that decodes the data of a single response as it is received, rather than once all of it has been received.
+
+ An incremental parser is sent `appendData:` with each chunk of data in order, then `responseObjectByFinishingWithError:` once, from the same serial queue.
+ */
+@protocol AFURLResponseIncrementalParser <NSObject>
+
+/**
+ Decodes the next chunk of the response data.
+
+ @param data The next chunk of the response data.
+
+ @return `NO` if the data received so far can not be decoded, in which case the error is reported by `responseObjectByFinishingWithError:`, and the remaining data does not need to be appended.
+ */
+- (BOOL)appendData:(NSData *)data;
+
+/**
+ Finishes decoding the response data, once all of it has been appended.
+
+ @param error The error that occurred while attempting to decode the response data.
+
+ @return The object decoded from the response data.
+ */
+- (nullable id)responseObjectByFinishingWithError:(NSError * _Nullable __autoreleasing *)error;
+
+@end
+
+/**
+ The `AFURLResponseIncrementalSerialization` protocol is adopted by response serializers that can decode response data as it is received, so that decoding overlaps with the transfer, and the whole response data never has to be held in memory.
+
+ `AFURLSessionManager` asks its response serializer for an incremental parser when a data task receives its first chunk of data. When a parser is returned, the response data is no longer accumulated, and `AFNetworkingTaskDidCompleteResponseDataKey` is absent from the user info of `AFNetworkingTaskDidCompleteNotification`.
+ */
+@protocol AFURLResponseIncrementalSerialization <AFURLResponseSerialization>
+
+/**
+ Returns a new incremental parser for the data of the specified response, or `nil` if the response data should be accumulated and decoded with `responseObjectForResponse:data:error:` instead, such as when the response is not valid.
+
+ @param response The response to be processed.
+ @param data The first chunk of the response data, used to validate the response. It is not appended to the returned parser.
+
+ @return A new incremental parser, or `nil`.
+ */
+- (nullable id <AFURLResponseIncrementalParser>)incrementalParserForResponse:(nullable NSURLResponse *)response
+                                                                        data:(NSData *)data;
+
+@end
+
+#pragma mark -
+
 /**
  `AFHTTPResponseSerializer` conforms to the `AFURLRequestSerialization` & `AFURLResponseSerialization` protocols, offering a concrete base implementation of query string / URL form-encoded parameter serialization and default request headers, as well as response status code and content type validation.
 
@@ -99,6 +150,16 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+/**
+ The implementations that `AFJSONResponseSerializer` can parse response data with.
+
+ - `AFJSONParserBackendFoundation`: `NSJSONSerialization`.
+ - `AFJSONParserBackendVectorized`: A parser that first indexes the structural characters of the data 64 bytes at a time, using SSE2, AVX2, or NEON instructions where available, then builds the same objects as `NSJSONSerialization` from that index. Data not encoded as UTF-8 is parsed with `NSJSONSerialization`.
+ */
+typedef NS_ENUM(NSUInteger, AFJSONParserBackend) {
+    AFJSONParserBackendFoundation = 0,
+    AFJSONParserBackendVectorized = 1,
+};
 
 /**
  `AFJSONResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes JSON responses.
@@ -111,7 +172,7 @@ NS_ASSUME_NONNULL_BEGIN
 
  In RFC 7159 - Section 8.1, it states that JSON text is required to be encoded in UTF-8, UTF-16, or UTF-32, and the default encoding is UTF-8. NSJSONSerialization provides support for all the encodings listed in the specification, and recommends UTF-8 for efficiency. Using an unsupported encoding will result in serialization error. See the `NSJSONSerialization` documentation for more details.
  */
-@interface AFJSONResponseSerializer : AFHTTPResponseSerializer
+@interface AFJSONResponseSerializer : AFHTTPResponseSerializer <AFURLResponseIncrementalSerialization>
 
 - (instancetype)init;
 
@@ -125,6 +186,46 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, assign) BOOL removesKeysWithNullValues;
 
+/**
+ Whether valid responses encoded as UTF-8 are parsed incrementally, as their data is received, instead of once all of it has been received. `NO` by default.
+
+ When enabled, the response object produces the same objects as `NSJSONSerialization`, and is ready almost as soon as the last chunk of data arrives, without the whole response data being retained. Responses in other encodings are still accumulated and parsed with `NSJSONSerialization`.
+ */
+@property (nonatomic, assign) BOOL parsesIncrementally;
+
+/**
+ The implementation used to parse response data that is not parsed incrementally. `AFJSONParserBackendFoundation` by default.
+ */
+@property (nonatomic, assign) AFJSONParserBackend parserBackend;
+
+/**
+ Whether dictionary keys that repeat across responses, or within a response, share a single immutable string instance, instead of each occurrence being decoded into a string of its own. `NO` by default.
+
+ When enabled, keys are interned in a table that belongs to the serializer, and is shared by all of the responses it parses, concurrently or not, until it holds `maximumInternedKeyCount` keys, after which keys not in the table are decoded as usual. Keys longer than 64 bytes are never interned. Keys are interned by the parsers of `AFJSONParserBackendVectorized`, `parsesIncrementally`, `parsesTopLevelArraysConcurrently`, and `projectedKeyPaths`; responses parsed with `NSJSONSerialization` are unaffected.
+ */
+@property (nonatomic, assign) BOOL internsKeys;
+
+/**
+ The maximum number of keys interned by the serializer when `internsKeys` is enabled. `2048` by default. Values above `1048576` are taken as `1048576`. Memory for the keys is allocated as they are interned, not up front. Setting this discards any keys interned so far.
+ */
+@property (nonatomic, assign) NSUInteger maximumInternedKeyCount;
+
+/**
+ Whether the elements of large top-level arrays are parsed concurrently, on as many threads as there are active processors, instead of on the thread calling `responseObjectForResponse:data:error:`. `NO` by default.
+
+ When enabled, the structural characters of a response encoded as UTF-8 are indexed first, whatever the `parserBackend`, which finds the boundaries of the elements of a top-level array. The elements are then split into ranges, which are parsed concurrently, and joined in order into the same array that would otherwise be returned. Responses under 64KB, and those that are not arrays, are parsed on the calling thread. Responses that are parsed incrementally, or with `projectedKeyPaths`, are not affected.
+ */
+@property (nonatomic, assign) BOOL parsesTopLevelArraysConcurrently;
+
+/**
+ The key paths to project the response JSON onto, if any. `nil` by default.
+
+ When set, the response object is a dictionary with an entry for each key path that matches the response JSON, instead of the whole decoded JSON. A key path is a sequence of dictionary keys separated by `.`, each of which may be followed by array subscripts, like `data.items[0].id`, or the wildcard subscript `[*]`, like `data.items[*].id`. Components with malformed subscripts are matched as dictionary keys. The value of a key path containing a wildcard is an array of every value it matches, in document order, which is empty if there are none; other key paths are only present in the response object if they match a value.
+
+ Subtrees of UTF-8 encoded responses that no key path reaches are skipped while the data is tokenized, whatever the `parserBackend`, without creating any objects for them, but are still validated as fully as they would be when parsed. As when parsing the whole response, only the last value of a duplicate key is projected. Responses in other encodings are decoded with `NSJSONSerialization` before being projected. Responses are never parsed incrementally while key paths are projected.
+ */
+@property (nonatomic, copy, nullable) NSSet <NSString *> *projectedKeyPaths;
+
 /**
  Creates and returns a JSON serializer with specified reading and writing options.
 
@@ -136,6 +237,274 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+/**
+ `AFJSONModelResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates JSON responses, and decodes them directly into instances of a model class, using its registered `AFJSONModelSchema`, without creating dictionaries or arrays for the JSON objects and arrays it contains.
+
+ The keys of each JSON object are matched against the key paths of the schema as they are read, and values are type checked against the properties they are decoded into, failing with an error on a mismatch. Values at key paths that are not in the schema are skipped without creating any objects, but are still validated as fully as parsing them would, so that invalid JSON is rejected. Responses that are not encoded as UTF-8 are converted to UTF-8 before being decoded.
+
+ By default, `AFJSONModelResponseSerializer` accepts the same MIME types as `AFJSONResponseSerializer`.
+ */
+@interface AFJSONModelResponseSerializer : AFHTTPResponseSerializer
+
+- (instancetype)init;
+
+/**
+ The model class that responses are decoded into. The response object is an instance of it when the value at `rootKeyPath` is an object, or an array of instances of it when the value is an array of objects.
+ */
+@property (nonatomic, strong, nullable) Class modelClass;
+
+/**
+ The key path of the value decoded into models in the response JSON, whose keys are separated by `.`, or `nil` for the response JSON itself. `nil` by default.
+ */
+@property (nonatomic, copy, nullable) NSString *rootKeyPath;
+
+/**
+ Creates and returns a serializer that decodes responses into instances of the specified model class.
+
+ @param modelClass The model class.
+ @param rootKeyPath The key path of the value decoded into models in the response JSON, if any.
+ */
++ (instancetype)serializerWithModelClass:(Class)modelClass
+                             rootKeyPath:(nullable NSString *)rootKeyPath;
+
+@end
+
+#pragma mark -
+
+/**
+ `AFJSONLinesResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes newline-delimited JSON responses, also known as NDJSON or JSON Lines, in which every line holds a single JSON value. The response object is an array of the values of the lines, in order, skipping lines that are empty.
+
+ By default, `AFJSONLinesResponseSerializer` accepts the following MIME types:
+
+ - `application/x-ndjson`
+ - `application/ndjson`
+ - `application/jsonl`
+ - `application/x-jsonlines`
+
+ Lines are separated by `\n`, optionally preceded by `\r`, and must be encoded as UTF-8. Valid responses are always parsed incrementally: each line is split from the chunks of data as they are received, and decoded as soon as it is complete, so that only the line being received is buffered.
+ */
+@interface AFJSONLinesResponseSerializer : AFHTTPResponseSerializer <AFURLResponseIncrementalSerialization>
+
+- (instancetype)init;
+
+/**
+ Options for reading the JSON value of each line. For possible values, see the `NSJSONSerialization` documentation section "NSJSONReadingOptions". `NSJSONReadingAllowFragments` is always included. `0` by default.
+ */
+@property (nonatomic, assign) NSJSONReadingOptions readingOptions;
+
+/**
+ Whether to remove keys with `NSNull` values from the JSON value of each line. `NO` by default.
+ */
+@property (nonatomic, assign) BOOL removesKeysWithNullValues;
+
+/**
+ The maximum length of a line, in bytes. Once a line is longer, decoding fails with an `NSURLErrorCannotDecodeContentData` error. `16777216` by default.
+ */
+@property (nonatomic, assign) NSUInteger maximumLineLength;
+
+/**
+ Creates and returns a JSON Lines serializer with the specified reading options.
+
+ @param readingOptions The JSON reading options of each line.
+ */
++ (instancetype)serializerWithReadingOptions:(NSJSONReadingOptions)readingOptions;
+
+/**
+ Returns a new incremental parser for the data of the specified response, which hands the values of the lines to a block in batches, as they are decoded, instead of keeping them for the response object, which is `nil`. Returns `nil` if the response is not valid.
+
+ The values decoded from each appended chunk of data are delivered once the chunk has been decoded, or as soon as there are `batchSize` of them. `responseObjectByFinishingWithError:` delivers the values of the last line, then waits until every batch has been handled, and must therefore not be sent on `queue`. Likewise, `appendData:` waits while 4 batches are waiting to be handled, so that records are not decoded faster than `recordsHandler` handles them. Once a line can't be decoded, the values of the lines before it are still delivered, and the error is returned by `responseObjectByFinishingWithError:`.
+
+ @param response The response to be processed.
+ @param data The first chunk of the response data, used to validate the response. It is not appended to the returned parser.
+ @param batchSize The maximum number of values handed to `recordsHandler` at once. `0` means no limit.
+ @param queue The queue on which `recordsHandler` is executed. If `NULL`, the main queue is used.
+ @param recordsHandler A block object to be executed with each batch of values. This block has no return value and takes a single argument: the values of consecutive lines, in order.
+ */
+- (nullable id <AFURLResponseIncrementalParser>)recordParserForResponse:(nullable NSURLResponse *)response
+                                                                   data:(NSData *)data
+                                                              batchSize:(NSUInteger)batchSize
+                                                                  queue:(nullable dispatch_queue_t)queue
+                                                         recordsHandler:(void (^)(NSArray *records))recordsHandler;
+
+@end
+
+#pragma mark -
+
+/**
+ `AFServerSentEvent` is a single event of a server-sent events stream, as dispatched by a blank line after one or more fields.
+ */
+@interface AFServerSentEvent : NSObject
+
+/**
+ The type of the event, as set by its `event` field, or `message` if it has none.
+ */
+@property (readonly, nonatomic, copy) NSString *type;
+
+/**
+ The data of the event: the values of its `data` fields, joined by line feeds.
+ */
+@property (readonly, nonatomic, copy) NSString *data;
+
+/**
+ The last event ID of the stream when the event was dispatched, as set by the most recent `id` field, if any.
+ */
+@property (readonly, nonatomic, copy, nullable) NSString *identifier;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Initializes an event with the specified type, data and identifier.
+
+ @param type The type of the event.
+ @param data The data of the event.
+ @param identifier The last event ID of the stream, if any.
+ */
+- (instancetype)initWithType:(NSString *)type
+                        data:(NSString *)data
+                  identifier:(nullable NSString *)identifier NS_DESIGNATED_INITIALIZER;
+
+@end
+
+/**
+ The `AFServerSentEventsParser` protocol is adopted by the incremental parsers of `AFServerSentEventsResponseSerializer`, which keep track of the state of the stream needed to reconnect to it. Both properties are set as the fields are parsed, and should be read once the parser has finished.
+ */
+@protocol AFServerSentEventsParser <AFURLResponseIncrementalParser>
+
+/**
+ The last event ID of the stream, to be sent in the `Last-Event-ID` header field when reconnecting to it.
+ */
+@property (readonly, nonatomic, copy, nullable) NSString *lastEventIdentifier;
+
+/**
+ The reconnection time set by the last `retry` field of the stream, in seconds, or a negative value if the stream has not set one.
+ */
+@property (readonly, nonatomic, assign) NSTimeInterval reconnectionInterval;
+
+@end
+
+/**
+ `AFServerSentEventsResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes server-sent events streams, as specified by the HTML Living Standard. The response object is an array of the `AFServerSentEvent` objects dispatched by the stream, in order. An event that is not terminated by a blank line before the stream ends is discarded.
+
+ By default, `AFServerSentEventsResponseSerializer` accepts the `text/event-stream` MIME type, with the `200` status code only.
+
+ Lines may end with a carriage return, a line feed or both. Lines that are not valid UTF-8 are ignored.
+ */
+@interface AFServerSentEventsResponseSerializer : AFHTTPResponseSerializer <AFURLResponseIncrementalSerialization>
+
+- (instancetype)init;
+
+/**
+ The maximum length of a line, in bytes. Once a line is longer, parsing fails with an `NSURLErrorCannotDecodeContentData` error. `16777216` by default.
+ */
+@property (nonatomic, assign) NSUInteger maximumLineLength;
+
+/**
+ Returns a new incremental parser for the data of the specified response, which hands each event to a block as soon as it is dispatched, instead of keeping it for the response object, which is `nil`. Returns `nil` if the response is not valid.
+
+ `responseObjectByFinishingWithError:` waits until every event has been handled, and must therefore not be sent on `queue`. Likewise, `appendData:` waits while 64 events are waiting to be handled, so that events are not parsed faster than `eventHandler` handles them.
+
+ @param response The response to be processed.
+ @param data The first chunk of the response data, used to validate the response. It is not appended to the returned parser.
+ @param lastEventIdentifier The last event ID of a previous connection to the stream, if any, which events keep until the stream sets another one.
+ @param queue The queue on which `eventHandler` is executed. If `NULL`, the main queue is used.
+ @param eventHandler A block object to be executed with each event. This block has no return value and takes a single argument: the event.
+ */
+- (nullable id <AFServerSentEventsParser>)eventParserForResponse:(nullable NSURLResponse *)response
+                                                            data:(NSData *)data
+                                             lastEventIdentifier:(nullable NSString *)lastEventIdentifier
+                                                           queue:(nullable dispatch_queue_t)queue
+                                                    eventHandler:(void (^)(AFServerSentEvent *event))eventHandler;
+
+@end
+
+#pragma mark -
+
+@class AFXMLStreamingParser;
+
+/**
+ The `AFXMLStreamingParserDelegate` protocol is adopted by objects that handle the SAX events of an XML document as it is streamed through an `AFXMLStreamingParser`. Its methods mirror those of `NSXMLParserDelegate`, with namespaces processed.
+ */
+@protocol AFXMLStreamingParserDelegate <NSObject>
+
+@optional
+
+- (void)streamingParserDidStartDocument:(AFXMLStreamingParser *)parser;
+
+- (void)streamingParserDidEndDocument:(AFXMLStreamingParser *)parser;
+
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+        didStartElement:(NSString *)elementName
+           namespaceURI:(nullable NSString *)namespaceURI
+          qualifiedName:(NSString *)qualifiedName
+             attributes:(NSDictionary <NSString *, NSString *> *)attributes;
+
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+          didEndElement:(NSString *)elementName
+           namespaceURI:(nullable NSString *)namespaceURI
+          qualifiedName:(NSString *)qualifiedName;
+
+/**
+ Sent with the character data of an element, including whitespace, which may be split across several messages.
+ */
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+        foundCharacters:(NSString *)string;
+
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+             foundCDATA:(NSData *)CDATABlock;
+
+/**
+ Sent once, when the document is found not to be well-formed, after which no other message is sent. The error is in the `NSXMLParserErrorDomain` domain.
+ */
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+     parseErrorOccurred:(NSError *)parseError;
+
+@end
+
+/**
+ `AFXMLStreamingParser` is an incremental parser that pushes each chunk of an XML document into a libxml2 push parser as it is appended, and sends the resulting SAX events to its delegate on the same queue, without keeping the chunks. External entities are not loaded.
+ */
+@interface AFXMLStreamingParser : NSObject <AFURLResponseIncrementalParser>
+
+/**
+ The response whose data is parsed, if any.
+ */
+@property (readonly, nonatomic, strong, nullable) NSURLResponse *response;
+
+/**
+ The delegate to which the SAX events of the document are sent. It is retained until the parser is deallocated.
+ */
+@property (readonly, nonatomic, strong) id <AFXMLStreamingParserDelegate> delegate;
+
+/**
+ The line number of the document being parsed.
+ */
+@property (readonly, nonatomic, assign) NSInteger lineNumber;
+
+/**
+ The column number of the document being parsed.
+ */
+@property (readonly, nonatomic, assign) NSInteger columnNumber;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Initializes a parser for the data of the specified response, which sends SAX events to the specified delegate.
+
+ @param response The response whose data is parsed, if any.
+ @param delegate The delegate of the parser.
+ */
+- (nullable instancetype)initWithResponse:(nullable NSURLResponse *)response
+                                 delegate:(id <AFXMLStreamingParserDelegate>)delegate NS_DESIGNATED_INITIALIZER;
+
+/**
+ Stops parsing the document, so that the parser fails with the `NSXMLParserDelegateAbortedParseError` error. Must be sent from a delegate method.
+ */
+- (void)abortParsing;
+
+@end
+
+#pragma mark -
+
 /**
  `AFXMLParserResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes XML responses as an `NSXMLParser` objects.
 
@@ -144,7 +513,14 @@ NS_ASSUME_NONNULL_BEGIN
  - `application/xml`
  - `text/xml`
  */
-@interface AFXMLParserResponseSerializer : AFHTTPResponseSerializer
+@interface AFXMLParserResponseSerializer : AFHTTPResponseSerializer <AFURLResponseIncrementalSerialization>
+
+/**
+ The delegate to which responses are streamed, if any. When set, each response is parsed by an `AFXMLStreamingParser` sending its SAX events to the delegate, instead of being wrapped in an `NSXMLParser`, and the response object is `nil`. Incremental parsers are only created when set, so that the data of a task is parsed on a background queue as it is received, and is never buffered. `nil` by default.
+
+ Every task that uses the serializer has its own background queue, and the same delegate receives the events of all of them, so it may be called concurrently, for different parsers, when several tasks are running at once. A delegate that keeps state must tell the parsers apart and synchronize its access to that state.
+ */
+@property (nonatomic, weak, nullable) id <AFXMLStreamingParserDelegate> streamingDelegate;
 
 @end
 
@@ -216,6 +592,42 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
+/**
+ `AFMessagePackResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes MessagePack responses directly into Foundation objects.
+
+ Maps are decoded as `NSDictionary` objects, arrays as `NSArray` objects, strings as `NSString` objects, binary data as `NSData` objects, integers, floating point numbers and booleans as `NSNumber` objects, nil as `NSNull`, and timestamps as `NSDate` objects. Responses containing other extension types are rejected.
+
+ By default, `AFMessagePackResponseSerializer` accepts the following MIME types:
+
+ - `application/msgpack`
+ - `application/x-msgpack`
+ - `application/vnd.msgpack`
+ */
+@interface AFMessagePackResponseSerializer : AFHTTPResponseSerializer
+
+- (instancetype)init;
+
+@end
+
+#pragma mark -
+
+/**
+ `AFCBORResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes CBOR responses, as described in RFC 7049, directly into Foundation objects.
+
+ Maps are decoded as `NSDictionary` objects, arrays as `NSArray` objects, text strings as `NSString` objects, byte strings as `NSData` objects, integers, floating point numbers and booleans as `NSNumber` objects, and null and undefined as `NSNull`. Numbers tagged as epoch-based dates are decoded as `NSDate` objects, and other tags are ignored.
+
+ By default, `AFCBORResponseSerializer` accepts the following MIME types:
+
+ - `application/cbor`
+ */
+@interface AFCBORResponseSerializer : AFHTTPResponseSerializer
+
+- (instancetype)init;
+
+@end
+
+#pragma mark -
+
 /**
  `AFImageResponseSerializer` is a subclass of `AFHTTPResponseSerializer` that validates and decodes image responses.
 
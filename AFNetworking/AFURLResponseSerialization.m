@@ -22,6 +22,19 @@
 #import "AFURLResponseSerialization.h"
 
 #import <TargetConditionals.h>
+#import <objc/message.h>
+#import <objc/runtime.h>
+#import <xlocale.h>
+#import <libxml/parser.h>
+#import <libxml/SAX2.h>
+
+#if defined(__AVX2__)
+#import <immintrin.h>
+#elif defined(__SSE2__)
+#import <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#import <arm_neon.h>
+#endif
 
 #if TARGET_OS_IOS
 #import <UIKit/UIKit.h>
@@ -60,26 +73,73 @@ static BOOL AFErrorOrUnderlyingErrorHasCodeInDomain(NSError *error, NSInteger co
     return NO;
 }
 
+// Containers created with `NSJSONReadingMutableContainers` are modified in place. Immutable containers are only copied when a key with a null value is removed from them or their descendants.
 static id AFJSONObjectByRemovingKeysWithNullValues(id JSONObject, NSJSONReadingOptions readingOptions) {
+    BOOL mutableContainers = (readingOptions & NSJSONReadingMutableContainers) != 0;
+
     if ([JSONObject isKindOfClass:[NSArray class]]) {
-        NSMutableArray *mutableArray = [NSMutableArray arrayWithCapacity:[(NSArray *)JSONObject count]];
-        for (id value in (NSArray *)JSONObject) {
-            [mutableArray addObject:AFJSONObjectByRemovingKeysWithNullValues(value, readingOptions)];
+        NSArray *array = (NSArray *)JSONObject;
+        NSMutableArray *mutableArray = nil;
+        for (NSUInteger idx = 0; idx < array.count; idx++) {
+            id value = array[idx];
+            id strippedValue = AFJSONObjectByRemovingKeysWithNullValues(value, readingOptions);
+            if (strippedValue != value) {
+                if (!mutableArray) {
+                    mutableArray = [array mutableCopy];
+                }
+
+                mutableArray[idx] = strippedValue;
+            }
         }
 
-        return (readingOptions & NSJSONReadingMutableContainers) ? mutableArray : [NSArray arrayWithArray:mutableArray];
+        return mutableArray ? [mutableArray copy] : array;
     } else if ([JSONObject isKindOfClass:[NSDictionary class]]) {
-        NSMutableDictionary *mutableDictionary = [NSMutableDictionary dictionaryWithDictionary:JSONObject];
-        for (id <NSCopying> key in [(NSDictionary *)JSONObject allKeys]) {
-            id value = (NSDictionary *)JSONObject[key];
-            if (!value || [value isEqual:[NSNull null]]) {
-                [mutableDictionary removeObjectForKey:key];
+        NSDictionary *dictionary = (NSDictionary *)JSONObject;
+        NSMutableArray *keysWithNullValues = nil;
+        NSMutableDictionary *strippedValues = nil;
+        for (id <NSCopying> key in dictionary) {
+            id value = dictionary[key];
+            if ([value isEqual:[NSNull null]]) {
+                if (!keysWithNullValues) {
+                    keysWithNullValues = [NSMutableArray array];
+                }
+
+                [keysWithNullValues addObject:key];
             } else if ([value isKindOfClass:[NSArray class]] || [value isKindOfClass:[NSDictionary class]]) {
-                mutableDictionary[key] = AFJSONObjectByRemovingKeysWithNullValues(value, readingOptions);
+                id strippedValue = AFJSONObjectByRemovingKeysWithNullValues(value, readingOptions);
+                if (strippedValue != value) {
+                    if (!strippedValues) {
+                        strippedValues = [NSMutableDictionary dictionary];
+                    }
+
+                    strippedValues[key] = strippedValue;
+                }
             }
         }
 
-        return (readingOptions & NSJSONReadingMutableContainers) ? mutableDictionary : [NSDictionary dictionaryWithDictionary:mutableDictionary];
+        if (!keysWithNullValues && !strippedValues) {
+            return dictionary;
+        }
+
+        NSMutableDictionary *mutableDictionary = mutableContainers ? (NSMutableDictionary *)dictionary : [dictionary mutableCopy];
+        if (keysWithNullValues) {
+            [mutableDictionary removeObjectsForKeys:keysWithNullValues];
+        }
+
+        if (strippedValues) {
+            [mutableDictionary addEntriesFromDictionary:strippedValues];
+        }
+
+        return mutableContainers ? mutableDictionary : [mutableDictionary copy];
+    }
+
+    return JSONObject;
+}
+
+static id AFJSONObjectWithJSONSerialization(NSData *data, NSJSONReadingOptions readingOptions, BOOL removesKeysWithNullValues, NSError * __autoreleasing *error) {
+    id JSONObject = [NSJSONSerialization JSONObjectWithData:data options:readingOptions error:error];
+    if (JSONObject && removesKeysWithNullValues) {
+        return AFJSONObjectByRemovingKeysWithNullValues(JSONObject, readingOptions);
     }
 
     return JSONObject;
@@ -204,245 +264,4476 @@ static id AFJSONObjectByRemovingKeysWithNullValues(id JSONObject, NSJSONReadingO
 
 #pragma mark -
 
-@implementation AFJSONResponseSerializer
+typedef struct {
+    uint8_t *bytes;
+    size_t length;
+    size_t capacity;
+} AFJSONByteBuffer;
 
-+ (instancetype)serializer {
-    return [self serializerWithReadingOptions:(NSJSONReadingOptions)0];
-}
+static BOOL AFJSONByteBufferReserve(AFJSONByteBuffer *buffer, size_t additionalLength) {
+    if (additionalLength <= buffer->capacity - buffer->length) {
+        return YES;
+    }
 
-+ (instancetype)serializerWithReadingOptions:(NSJSONReadingOptions)readingOptions {
-    AFJSONResponseSerializer *serializer = [[self alloc] init];
-    serializer.readingOptions = readingOptions;
+    size_t capacity = MAX(MAX(buffer->capacity * 2, buffer->length + additionalLength), (size_t)64);
+    uint8_t *bytes = realloc(buffer->bytes, capacity);
+    if (!bytes) {
+        return NO;
+    }
 
-    return serializer;
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+
+    return YES;
 }
 
-- (instancetype)init {
-    self = [super init];
-    if (!self) {
-        return nil;
+static BOOL AFJSONByteBufferAppendBytes(AFJSONByteBuffer *buffer, const uint8_t *bytes, size_t length) {
+    if (length == 0) {
+        return YES;
     }
 
-    self.acceptableContentTypes = [NSSet setWithObjects:@"application/json", @"text/json", @"text/javascript", nil];
+    if (!AFJSONByteBufferReserve(buffer, length)) {
+        return NO;
+    }
 
-    return self;
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+
+    return YES;
 }
 
-#pragma mark - AFURLResponseSerialization
+// Like `NSJSONSerialization`, detects UTF-16 and UTF-32 from a byte order mark, or from the zero bytes of the first four bytes, which are ASCII.
+static BOOL AFJSONBytesAreUTF8(const uint8_t *bytes, size_t length) {
+    if (length >= 2 && ((bytes[0] == 0xFE && bytes[1] == 0xFF) || (bytes[0] == 0xFF && bytes[1] == 0xFE))) {
+        return NO;
+    }
 
-- (id)responseObjectForResponse:(NSURLResponse *)response
-                           data:(NSData *)data
-                          error:(NSError *__autoreleasing *)error
-{
-    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
-        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
-            return nil;
+    for (size_t idx = 0; idx < MIN(length, (size_t)4); idx++) {
+        if (bytes[idx] == 0) {
+            return NO;
         }
     }
 
-    // Workaround for behavior of Rails to return a single space for `head :ok` (a workaround for a bug in Safari), which is not interpreted as valid input by NSJSONSerialization.
-    // See https://github.com/rails/rails/issues/1742
-    BOOL isSpace = [data isEqualToData:[NSData dataWithBytes:" " length:1]];
-    
-    if (data.length == 0 || isSpace) {
-        return nil;
+    return YES;
+}
+
+static inline BOOL AFJSONIsWhitespace(uint8_t c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline BOOL AFJSONIsNumberByte(uint8_t c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+static BOOL AFJSONReadHexQuad(const uint8_t *bytes, size_t length, uint32_t *value) {
+    if (length < 4) {
+        return NO;
     }
-    
-    NSError *serializationError = nil;
-    
-    id responseObject = [NSJSONSerialization JSONObjectWithData:data options:self.readingOptions error:&serializationError];
 
-    if (!responseObject)
-    {
-        if (error) {
-            *error = AFErrorWithUnderlyingError(serializationError, *error);
+    uint32_t result = 0;
+    for (size_t idx = 0; idx < 4; idx++) {
+        uint8_t c = bytes[idx];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = (uint32_t)(c - 'A' + 10);
+        } else {
+            return NO;
         }
-        return nil;
+
+        result = (result << 4) | digit;
     }
-    
-    if (self.removesKeysWithNullValues) {
-        return AFJSONObjectByRemovingKeysWithNullValues(responseObject, self.readingOptions);
+
+    *value = result;
+
+    return YES;
+}
+
+static size_t AFJSONEncodeUTF8(uint32_t codePoint, uint8_t *bytes) {
+    if (codePoint < 0x80) {
+        bytes[0] = (uint8_t)codePoint;
+        return 1;
+    } else if (codePoint < 0x800) {
+        bytes[0] = (uint8_t)(0xC0 | (codePoint >> 6));
+        bytes[1] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        return 2;
+    } else if (codePoint < 0x10000) {
+        bytes[0] = (uint8_t)(0xE0 | (codePoint >> 12));
+        bytes[1] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+        bytes[2] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        return 3;
     }
 
-    return responseObject;
+    bytes[0] = (uint8_t)(0xF0 | (codePoint >> 18));
+    bytes[1] = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+    bytes[2] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+    bytes[3] = (uint8_t)(0x80 | (codePoint & 0x3F));
+    return 4;
 }
 
-#pragma mark - NSSecureCoding
+// Escape sequences never decode to more bytes than they occupy, so `unescapedBytes` needs no more than `length` bytes.
+static BOOL AFJSONUnescapeStringBytes(const uint8_t *bytes, size_t length, uint8_t *unescapedBytes, size_t *unescapedLength) {
+    size_t idx = 0;
+    size_t outputLength = 0;
+    while (idx < length) {
+        uint8_t c = bytes[idx++];
+        if (c != '\\') {
+            unescapedBytes[outputLength++] = c;
+            continue;
+        }
 
-- (instancetype)initWithCoder:(NSCoder *)decoder {
-    self = [super initWithCoder:decoder];
-    if (!self) {
-        return nil;
+        if (idx == length) {
+            return NO;
+        }
+
+        uint8_t escape = bytes[idx++];
+        switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                unescapedBytes[outputLength++] = escape;
+                break;
+            case 'b':
+                unescapedBytes[outputLength++] = '\b';
+                break;
+            case 'f':
+                unescapedBytes[outputLength++] = '\f';
+                break;
+            case 'n':
+                unescapedBytes[outputLength++] = '\n';
+                break;
+            case 'r':
+                unescapedBytes[outputLength++] = '\r';
+                break;
+            case 't':
+                unescapedBytes[outputLength++] = '\t';
+                break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!AFJSONReadHexQuad(bytes + idx, length - idx, &codePoint)) {
+                    return NO;
+                }
+                idx += 4;
+
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    uint32_t lowSurrogate = 0;
+                    if (length - idx < 6 || bytes[idx] != '\\' || bytes[idx + 1] != 'u' || !AFJSONReadHexQuad(bytes + idx + 2, length - idx - 2, &lowSurrogate) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+                        return NO;
+                    }
+                    idx += 6;
+
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    return NO;
+                }
+
+                outputLength += AFJSONEncodeUTF8(codePoint, unescapedBytes + outputLength);
+                break;
+            }
+            default:
+                return NO;
+        }
     }
 
-    self.readingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(readingOptions))] unsignedIntegerValue];
-    self.removesKeysWithNullValues = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))] boolValue];
+    *unescapedLength = outputLength;
 
-    return self;
+    return YES;
 }
 
-- (void)encodeWithCoder:(NSCoder *)coder {
-    [super encodeWithCoder:coder];
+static BOOL AFJSONNumberBytesAreValid(const uint8_t *bytes, size_t length, BOOL *isInteger) {
+    size_t idx = 0;
+    if (idx < length && bytes[idx] == '-') {
+        idx++;
+    }
 
-    [coder encodeObject:@(self.readingOptions) forKey:NSStringFromSelector(@selector(readingOptions))];
-    [coder encodeObject:@(self.removesKeysWithNullValues) forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))];
-}
+    if (idx == length) {
+        return NO;
+    } else if (bytes[idx] == '0') {
+        idx++;
+    } else if (bytes[idx] >= '1' && bytes[idx] <= '9') {
+        while (idx < length && bytes[idx] >= '0' && bytes[idx] <= '9') {
+            idx++;
+        }
+    } else {
+        return NO;
+    }
 
-#pragma mark - NSCopying
+    *isInteger = YES;
 
-- (instancetype)copyWithZone:(NSZone *)zone {
-    AFJSONResponseSerializer *serializer = [super copyWithZone:zone];
-    serializer.readingOptions = self.readingOptions;
-    serializer.removesKeysWithNullValues = self.removesKeysWithNullValues;
+    if (idx < length && bytes[idx] == '.') {
+        idx++;
+        size_t fractionStart = idx;
+        while (idx < length && bytes[idx] >= '0' && bytes[idx] <= '9') {
+            idx++;
+        }
 
-    return serializer;
-}
+        if (idx == fractionStart) {
+            return NO;
+        }
 
-@end
+        *isInteger = NO;
+    }
 
-#pragma mark -
+    if (idx < length && (bytes[idx] == 'e' || bytes[idx] == 'E')) {
+        idx++;
+        if (idx < length && (bytes[idx] == '+' || bytes[idx] == '-')) {
+            idx++;
+        }
 
-@implementation AFXMLParserResponseSerializer
+        size_t exponentStart = idx;
+        while (idx < length && bytes[idx] >= '0' && bytes[idx] <= '9') {
+            idx++;
+        }
 
-+ (instancetype)serializer {
-    AFXMLParserResponseSerializer *serializer = [[self alloc] init];
+        if (idx == exponentStart) {
+            return NO;
+        }
 
-    return serializer;
+        *isInteger = NO;
+    }
+
+    return idx == length;
 }
 
-- (instancetype)init {
-    self = [super init];
-    if (!self) {
+static NSNumber * AFJSONNumberFromBytes(const uint8_t *bytes, size_t length) {
+    BOOL isInteger = NO;
+    if (!AFJSONNumberBytesAreValid(bytes, length, &isInteger)) {
         return nil;
     }
 
-    self.acceptableContentTypes = [[NSSet alloc] initWithObjects:@"application/xml", @"text/xml", nil];
+    if (isInteger) {
+        BOOL isNegative = bytes[0] == '-';
+        unsigned long long magnitude = 0;
+        BOOL overflows = NO;
+        for (size_t idx = isNegative ? 1 : 0; idx < length; idx++) {
+            unsigned long long digit = (unsigned long long)(bytes[idx] - '0');
+            if (magnitude > (ULLONG_MAX - digit) / 10) {
+                overflows = YES;
+                break;
+            }
 
-    return self;
+            magnitude = magnitude * 10 + digit;
+        }
+
+        if (!overflows) {
+            if (!isNegative) {
+                return magnitude <= (unsigned long long)LLONG_MAX ? @((long long)magnitude) : @(magnitude);
+            } else if (magnitude <= (unsigned long long)LLONG_MAX) {
+                return @(-(long long)magnitude);
+            } else if (magnitude == (unsigned long long)LLONG_MAX + 1) {
+                return @(LLONG_MIN);
+            }
+        }
+    }
+
+    char stackBuffer[64];
+    char *buffer = length < sizeof(stackBuffer) ? stackBuffer : malloc(length + 1);
+    if (!buffer) {
+        return nil;
+    }
+
+    memcpy(buffer, bytes, length);
+    buffer[length] = '\0';
+
+    // A `NULL` locale is the C locale, so the decimal separator is always '.'.
+    double value = strtod_l(buffer, NULL, NULL);
+
+    if (buffer != stackBuffer) {
+        free(buffer);
+    }
+
+    if (isinf(value) || isnan(value)) {
+        return nil;
+    }
+
+    return @(value);
 }
 
-#pragma mark - AFURLResponseSerialization
+static NSError * AFJSONParsingError(NSString *reason, unsigned long long offset) {
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError userInfo:@{NSDebugDescriptionKey: [NSString stringWithFormat:@"%@ around character %llu.", reason, offset]}];
+}
 
-- (id)responseObjectForResponse:(NSHTTPURLResponse *)response
-                           data:(NSData *)data
-                          error:(NSError *__autoreleasing *)error
-{
-    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
-        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+static NSString * AFJSONStringWithBytes(const uint8_t *bytes, size_t length, BOOL hasEscapes, BOOL mutable, AFJSONByteBuffer *scratch) {
+    if (hasEscapes) {
+        size_t unescapedLength = 0;
+        if (!AFJSONByteBufferReserve(scratch, length) || !AFJSONUnescapeStringBytes(bytes, length, scratch->bytes, &unescapedLength)) {
             return nil;
         }
+
+        bytes = scratch->bytes;
+        length = unescapedLength;
     }
 
-    return [[NSXMLParser alloc] initWithData:data];
+    return [[(mutable ? [NSMutableString class] : [NSString class]) alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
 }
 
-@end
+static id AFJSONLiteralValue(const char *literal) {
+    switch (literal[0]) {
+        case 't':
+            return (__bridge NSNumber *)kCFBooleanTrue;
+        case 'f':
+            return (__bridge NSNumber *)kCFBooleanFalse;
+        default:
+            return [NSNull null];
+    }
+}
+
+static const char * AFJSONLiteralStartingWithByte(uint8_t c) {
+    switch (c) {
+        case 't':
+            return "true";
+        case 'f':
+            return "false";
+        case 'n':
+            return "null";
+        default:
+            return NULL;
+    }
+}
 
 #pragma mark -
 
-#ifdef __MAC_OS_X_VERSION_MIN_REQUIRED
+// Keys longer than this are rarely repeated, and are never interned.
+static size_t const AFJSONInternedKeyMaximumLength = 64;
 
-@implementation AFXMLDocumentResponseSerializer
+typedef struct {
+    uint64_t hash;
+    size_t length;
+    uint8_t *bytes;
+    void *string;
+} AFJSONInternedKey;
 
-+ (instancetype)serializer {
-    return [self serializerWithXMLDocumentOptions:0];
+static inline uint64_t AFJSONKeyHash(const uint8_t *bytes, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t idx = 0; idx < length; idx++) {
+        hash = (hash ^ bytes[idx]) * 0x100000001b3ULL;
+    }
+
+    return hash;
 }
 
-+ (instancetype)serializerWithXMLDocumentOptions:(NSUInteger)mask {
-    AFXMLDocumentResponseSerializer *serializer = [[self alloc] init];
-    serializer.options = mask;
+/**
+ `AFJSONKeyTable` is a thread-safe set of immutable key strings, which is added to until it holds its maximum number of keys. Its keys are never removed or moved while it exists, so they can be referenced without locking once they have been looked up.
 
-    return serializer;
+ The table of slots starts small and grows as keys are added, so a large maximum costs nothing until that many keys are seen. Each key is allocated on its own, so growing the table does not move it.
+ */
+@interface AFJSONKeyTable : NSObject
+
+- (instancetype)initWithMaximumKeyCount:(NSUInteger)maximumKeyCount;
+
+@end
+
+// Any larger maximum is taken as this one, which bounds the size of the table of slots.
+static NSUInteger const AFJSONKeyTableMaximumKeyCount = 1 << 20;
+
+@implementation AFJSONKeyTable {
+    NSLock *_lock;
+    AFJSONInternedKey **_keys;
+    NSUInteger _capacity;
+    NSUInteger _count;
+    NSUInteger _maximumCount;
 }
 
-- (instancetype)init {
+- (instancetype)initWithMaximumKeyCount:(NSUInteger)maximumKeyCount {
     self = [super init];
     if (!self) {
         return nil;
     }
 
-    self.acceptableContentTypes = [[NSSet alloc] initWithObjects:@"application/xml", @"text/xml", nil];
+    _lock = [[NSLock alloc] init];
+    _maximumCount = MIN(maximumKeyCount, AFJSONKeyTableMaximumKeyCount);
 
     return self;
 }
 
-#pragma mark - AFURLResponseSerialization
-
-- (id)responseObjectForResponse:(NSURLResponse *)response
-                           data:(NSData *)data
-                          error:(NSError *__autoreleasing *)error
-{
-    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
-        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
-            return nil;
+- (void)dealloc {
+    for (NSUInteger idx = 0; idx < _capacity; idx++) {
+        if (_keys[idx]) {
+            CFRelease(_keys[idx]->string);
+            free(_keys[idx]->bytes);
+            free(_keys[idx]);
         }
     }
 
-    NSError *serializationError = nil;
-    NSXMLDocument *document = [[NSXMLDocument alloc] initWithData:data options:self.options error:&serializationError];
+    free(_keys);
+}
 
-    if (!document)
-    {
-        if (error) {
-            *error = AFErrorWithUnderlyingError(serializationError, *error);
+// Doubles the number of slots, keeping the table at most half full so that probe sequences stay short.
+static BOOL AFJSONKeyTableGrow(AFJSONKeyTable *table) {
+    NSUInteger capacity = MAX(table->_capacity * 2, (NSUInteger)16);
+    AFJSONInternedKey **keys = calloc(capacity, sizeof(AFJSONInternedKey *));
+    if (!keys) {
+        return NO;
+    }
+
+    for (NSUInteger idx = 0; idx < table->_capacity; idx++) {
+        AFJSONInternedKey *key = table->_keys[idx];
+        if (key) {
+            NSUInteger newIndex = (NSUInteger)key->hash & (capacity - 1);
+            while (keys[newIndex]) {
+                newIndex = (newIndex + 1) & (capacity - 1);
+            }
+
+            keys[newIndex] = key;
         }
-        return nil;
     }
-    
-    return document;
+
+    free(table->_keys);
+    table->_keys = keys;
+    table->_capacity = capacity;
+
+    return YES;
 }
 
-#pragma mark - NSSecureCoding
+// Returns the key with the specified UTF-8 bytes, adding it if the table is not full, or `NULL` if the table is full or the bytes are not valid UTF-8.
+static const AFJSONInternedKey * AFJSONKeyTableInternedKey(AFJSONKeyTable *table, const uint8_t *bytes, size_t length, uint64_t hash) {
+    if (table->_maximumCount == 0) {
+        return NULL;
+    }
 
-- (instancetype)initWithCoder:(NSCoder *)decoder {
-    self = [super initWithCoder:decoder];
-    if (!self) {
-        return nil;
+    const AFJSONInternedKey *internedKey = NULL;
+
+    [table->_lock lock];
+
+    NSUInteger idx = (NSUInteger)hash & (table->_capacity - 1);
+    while (table->_capacity > 0 && table->_keys[idx]) {
+        AFJSONInternedKey *key = table->_keys[idx];
+        if (key->hash == hash && key->length == length && memcmp(key->bytes, bytes, length) == 0) {
+            internedKey = key;
+            break;
+        }
+
+        idx = (idx + 1) & (table->_capacity - 1);
     }
 
-    self.options = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(options))] unsignedIntegerValue];
+    if (!internedKey && table->_count < table->_maximumCount && ((table->_count + 1) * 2 <= table->_capacity || AFJSONKeyTableGrow(table))) {
+        idx = (NSUInteger)hash & (table->_capacity - 1);
+        while (table->_keys[idx]) {
+            idx = (idx + 1) & (table->_capacity - 1);
+        }
 
-    return self;
-}
+        NSString *string = [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+        uint8_t *keyBytes = malloc(MAX(length, (size_t)1));
+        AFJSONInternedKey *key = malloc(sizeof(AFJSONInternedKey));
+        if (string && keyBytes && key) {
+            memcpy(keyBytes, bytes, length);
+            *key = (AFJSONInternedKey){hash, length, keyBytes, (void *)CFBridgingRetain(string)};
+            table->_keys[idx] = key;
+            table->_count++;
+            internedKey = key;
+        } else {
+            free(keyBytes);
+            free(key);
+        }
+    }
 
-- (void)encodeWithCoder:(NSCoder *)coder {
-    [super encodeWithCoder:coder];
+    [table->_lock unlock];
 
-    [coder encodeObject:@(self.options) forKey:NSStringFromSelector(@selector(options))];
+    return internedKey;
 }
 
-#pragma mark - NSCopying
+@end
 
-- (instancetype)copyWithZone:(NSZone *)zone {
-    AFXMLDocumentResponseSerializer *serializer = [super copyWithZone:zone];
-    serializer.options = self.options;
+#pragma mark -
 
-    return serializer;
-}
+typedef struct {
+    BOOL isObject;
+    NSUInteger valuesStart;
+    NSUInteger keysStart;
+} AFJSONObjectBuilderFrame;
+
+/**
+ `AFJSONObjectBuilder` assembles the containers of a JSON document from the keys and values it is given in document order, creating the same classes as `NSJSONSerialization` for the specified reading options.
+
+ The keys and values of open containers are kept on flat stacks until the container is closed, so no intermediate mutable containers are created. When removing keys with null values, those keys are left out of the dictionary when it is created, with the same result as `AFJSONObjectByRemovingKeysWithNullValues`.
+
+ When given a key table, keys are looked up in a small cache of the keys last used from it, and then in the table itself, before a new string is created for them.
+ */
+@interface AFJSONObjectBuilder : NSObject
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable;
 
 @end
 
-#endif
+#define AFJSONObjectBuilderKeyCacheSize 256
 
-#pragma mark -
+@implementation AFJSONObjectBuilder {
+    NSJSONReadingOptions _readingOptions;
+    BOOL _removesKeysWithNullValues;
 
-@implementation AFPropertyListResponseSerializer
+    AFJSONKeyTable *_keyTable;
+    const AFJSONInternedKey *_keyCache[AFJSONObjectBuilderKeyCacheSize];
 
-+ (instancetype)serializer {
-    return [self serializerWithFormat:NSPropertyListXMLFormat_v1_0 readOptions:0];
-}
+    AFJSONObjectBuilderFrame *_frames;
+    NSUInteger _frameCount;
+    NSUInteger _frameCapacity;
 
-+ (instancetype)serializerWithFormat:(NSPropertyListFormat)format
-                         readOptions:(NSPropertyListReadOptions)readOptions
-{
-    AFPropertyListResponseSerializer *serializer = [[self alloc] init];
-    serializer.format = format;
-    serializer.readOptions = readOptions;
+    __strong id *_values;
+    NSUInteger _valueCount;
+    NSUInteger _valueCapacity;
 
-    return serializer;
+    __strong id <NSCopying> *_keys;
+    NSUInteger _keyCount;
+    NSUInteger _keyCapacity;
 }
 
-- (instancetype)init {
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _readingOptions = readingOptions;
+    _removesKeysWithNullValues = removesKeysWithNullValues;
+    _keyTable = keyTable;
+
+    return self;
+}
+
+- (void)dealloc {
+    for (NSUInteger idx = 0; idx < _valueCount; idx++) {
+        _values[idx] = nil;
+    }
+
+    for (NSUInteger idx = 0; idx < _keyCount; idx++) {
+        _keys[idx] = nil;
+    }
+
+    free(_values);
+    free(_keys);
+    free(_frames);
+}
+
+// Releases any values and keys left on the stacks by a failed parse, so that the builder can be reused.
+static void AFJSONObjectBuilderReset(AFJSONObjectBuilder *builder) {
+    for (NSUInteger idx = 0; idx < builder->_valueCount; idx++) {
+        builder->_values[idx] = nil;
+    }
+
+    for (NSUInteger idx = 0; idx < builder->_keyCount; idx++) {
+        builder->_keys[idx] = nil;
+    }
+
+    builder->_valueCount = 0;
+    builder->_keyCount = 0;
+    builder->_frameCount = 0;
+}
+
+static inline NSUInteger AFJSONObjectBuilderDepth(AFJSONObjectBuilder *builder) {
+    return builder->_frameCount;
+}
+
+static inline BOOL AFJSONObjectBuilderIsInObject(AFJSONObjectBuilder *builder) {
+    return builder->_frameCount > 0 && builder->_frames[builder->_frameCount - 1].isObject;
+}
+
+static BOOL AFJSONObjectBuilderOpenContainer(AFJSONObjectBuilder *builder, BOOL isObject) {
+    if (builder->_frameCount == builder->_frameCapacity) {
+        NSUInteger capacity = MAX(builder->_frameCapacity * 2, (NSUInteger)16);
+        AFJSONObjectBuilderFrame *frames = realloc(builder->_frames, capacity * sizeof(AFJSONObjectBuilderFrame));
+        if (!frames) {
+            return NO;
+        }
+
+        builder->_frames = frames;
+        builder->_frameCapacity = capacity;
+    }
+
+    builder->_frames[builder->_frameCount++] = (AFJSONObjectBuilderFrame){isObject, builder->_valueCount, builder->_keyCount};
+
+    return YES;
+}
+
+static BOOL AFJSONObjectBuilderReserveValues(AFJSONObjectBuilder *builder, NSUInteger additionalCount) {
+    if (additionalCount <= builder->_valueCapacity - builder->_valueCount) {
+        return YES;
+    }
+
+    NSUInteger capacity = MAX(MAX(builder->_valueCapacity * 2, builder->_valueCount + additionalCount), (NSUInteger)32);
+    __strong id *values = (__strong id *)realloc((void *)builder->_values, capacity * sizeof(id));
+    if (!values) {
+        return NO;
+    }
+
+    memset((void *)(values + builder->_valueCapacity), 0, (capacity - builder->_valueCapacity) * sizeof(id));
+    builder->_values = values;
+    builder->_valueCapacity = capacity;
+
+    return YES;
+}
+
+static BOOL AFJSONObjectBuilderReserveKeys(AFJSONObjectBuilder *builder, NSUInteger additionalCount) {
+    if (additionalCount <= builder->_keyCapacity - builder->_keyCount) {
+        return YES;
+    }
+
+    NSUInteger capacity = MAX(MAX(builder->_keyCapacity * 2, builder->_keyCount + additionalCount), (NSUInteger)32);
+    __strong id <NSCopying> *keys = (__strong id <NSCopying> *)realloc((void *)builder->_keys, capacity * sizeof(id));
+    if (!keys) {
+        return NO;
+    }
+
+    memset((void *)(keys + builder->_keyCapacity), 0, (capacity - builder->_keyCapacity) * sizeof(id));
+    builder->_keys = keys;
+    builder->_keyCapacity = capacity;
+
+    return YES;
+}
+
+static BOOL AFJSONObjectBuilderAddValue(AFJSONObjectBuilder *builder, id value) {
+    if (!AFJSONObjectBuilderReserveValues(builder, 1)) {
+        return NO;
+    }
+
+    builder->_values[builder->_valueCount++] = value;
+
+    return YES;
+}
+
+static NSString * AFJSONObjectBuilderKeyWithBytes(AFJSONObjectBuilder *builder, const uint8_t *bytes, size_t length, BOOL hasEscapes, AFJSONByteBuffer *scratch) {
+    if (!builder->_keyTable || length > AFJSONInternedKeyMaximumLength) {
+        return AFJSONStringWithBytes(bytes, length, hasEscapes, NO, scratch);
+    }
+
+    if (hasEscapes) {
+        size_t unescapedLength = 0;
+        if (!AFJSONByteBufferReserve(scratch, length) || !AFJSONUnescapeStringBytes(bytes, length, scratch->bytes, &unescapedLength)) {
+            return nil;
+        }
+
+        bytes = scratch->bytes;
+        length = unescapedLength;
+    }
+
+    uint64_t hash = AFJSONKeyHash(bytes, length);
+    const AFJSONInternedKey **cachedKey = &builder->_keyCache[hash & (AFJSONObjectBuilderKeyCacheSize - 1)];
+    if (*cachedKey && (*cachedKey)->hash == hash && (*cachedKey)->length == length && memcmp((*cachedKey)->bytes, bytes, length) == 0) {
+        return (__bridge NSString *)(*cachedKey)->string;
+    }
+
+    const AFJSONInternedKey *internedKey = AFJSONKeyTableInternedKey(builder->_keyTable, bytes, length, hash);
+    if (!internedKey) {
+        return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+    }
+
+    *cachedKey = internedKey;
+
+    return (__bridge NSString *)internedKey->string;
+}
+
+static BOOL AFJSONObjectBuilderAddKey(AFJSONObjectBuilder *builder, NSString *key) {
+    if (!AFJSONObjectBuilderReserveKeys(builder, 1)) {
+        return NO;
+    }
+
+    builder->_keys[builder->_keyCount++] = key;
+
+    return YES;
+}
+
+// Applies the entries in order, so that the last value for a duplicate key wins, and a null value removes any earlier value for its key when removing keys with null values.
+static NSDictionary * AFJSONDictionaryByApplyingEntries(__strong id *values, __strong id <NSCopying> *keys, NSUInteger count, BOOL mutableContainers, BOOL removesKeysWithNullValues) {
+    NSMutableDictionary *mutableDictionary = [NSMutableDictionary dictionaryWithCapacity:count];
+    for (NSUInteger idx = 0; idx < count; idx++) {
+        if (removesKeysWithNullValues && values[idx] == [NSNull null]) {
+            [mutableDictionary removeObjectForKey:keys[idx]];
+        } else {
+            mutableDictionary[keys[idx]] = values[idx];
+        }
+    }
+
+    return mutableContainers ? mutableDictionary : [NSDictionary dictionaryWithDictionary:mutableDictionary];
+}
+
+static NSDictionary * AFJSONObjectBuilderDictionaryWithEntriesOfFrame(AFJSONObjectBuilder *builder, AFJSONObjectBuilderFrame frame) {
+    NSUInteger count = builder->_valueCount - frame.valuesStart;
+    BOOL mutableContainers = (builder->_readingOptions & NSJSONReadingMutableContainers) != 0;
+    id null = [NSNull null];
+
+    NSUInteger nullCount = 0;
+    if (builder->_removesKeysWithNullValues) {
+        for (NSUInteger idx = 0; idx < count; idx++) {
+            if (builder->_values[frame.valuesStart + idx] == null) {
+                nullCount++;
+            }
+        }
+    }
+
+    NSUInteger entryCount = count - nullCount;
+    if (nullCount > 0 && !(AFJSONObjectBuilderReserveValues(builder, entryCount) && AFJSONObjectBuilderReserveKeys(builder, entryCount))) {
+        return nil;
+    }
+
+    __strong id *values = builder->_values + frame.valuesStart;
+    __strong id <NSCopying> *keys = builder->_keys + frame.keysStart;
+    __strong id *entryValues = values;
+    __strong id <NSCopying> *entryKeys = keys;
+
+    if (nullCount > 0) {
+        // Copy the entries with non-null values past the top of the stacks, keeping the originals in case duplicate keys need to be resolved.
+        entryValues = builder->_values + builder->_valueCount;
+        entryKeys = builder->_keys + builder->_keyCount;
+        for (NSUInteger idx = 0, entryIndex = 0; idx < count; idx++) {
+            if (values[idx] != null) {
+                entryValues[entryIndex] = values[idx];
+                entryKeys[entryIndex] = keys[idx];
+                entryIndex++;
+            }
+        }
+    }
+
+    Class dictionaryClass = mutableContainers ? [NSMutableDictionary class] : [NSDictionary class];
+    NSDictionary *dictionary = [dictionaryClass dictionaryWithObjects:entryValues forKeys:entryKeys count:entryCount];
+
+    BOOL hasDuplicateKeys = dictionary.count < entryCount;
+    for (NSUInteger idx = 0; nullCount > 0 && idx < count && !hasDuplicateKeys; idx++) {
+        hasDuplicateKeys = values[idx] == null && dictionary[keys[idx]] != nil;
+    }
+
+    if (hasDuplicateKeys) {
+        dictionary = AFJSONDictionaryByApplyingEntries(values, keys, count, mutableContainers, builder->_removesKeysWithNullValues);
+    }
+
+    if (nullCount > 0) {
+        for (NSUInteger idx = 0; idx < entryCount; idx++) {
+            entryValues[idx] = nil;
+            entryKeys[idx] = nil;
+        }
+    }
+
+    return dictionary;
+}
+
+// Returns `nil` if memory could not be allocated.
+static id AFJSONObjectBuilderCloseContainer(AFJSONObjectBuilder *builder) {
+    AFJSONObjectBuilderFrame frame = builder->_frames[--builder->_frameCount];
+
+    id container = nil;
+    if (frame.isObject) {
+        container = AFJSONObjectBuilderDictionaryWithEntriesOfFrame(builder, frame);
+
+        for (NSUInteger idx = frame.keysStart; idx < builder->_keyCount; idx++) {
+            builder->_keys[idx] = nil;
+        }
+
+        builder->_keyCount = frame.keysStart;
+    } else {
+        Class arrayClass = (builder->_readingOptions & NSJSONReadingMutableContainers) ? [NSMutableArray class] : [NSArray class];
+        container = [arrayClass arrayWithObjects:builder->_values + frame.valuesStart count:builder->_valueCount - frame.valuesStart];
+    }
+
+    for (NSUInteger idx = frame.valuesStart; idx < builder->_valueCount; idx++) {
+        builder->_values[idx] = nil;
+    }
+
+    builder->_valueCount = frame.valuesStart;
+
+    return container;
+}
+
+@end
+
+#pragma mark -
+
+typedef NS_ENUM(NSUInteger, AFJSONParserState) {
+    AFJSONParserStateValue,
+    AFJSONParserStateArrayStart,
+    AFJSONParserStateObjectStart,
+    AFJSONParserStateKey,
+    AFJSONParserStateColon,
+    AFJSONParserStateAfterValue,
+    AFJSONParserStateString,
+    AFJSONParserStateNumber,
+    AFJSONParserStateLiteral,
+    AFJSONParserStateEnd,
+    AFJSONParserStateError,
+};
+
+/**
+ `AFJSONStreamParser` is a resumable JSON parser, which is fed consecutive chunks of UTF-8 encoded data, and builds the same objects as `NSJSONSerialization` as it goes.
+
+ Only the token that spans the end of a chunk is copied; everything else is decoded directly from the chunks.
+ */
+@interface AFJSONStreamParser : NSObject
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable;
+
+- (BOOL)parseBytes:(const uint8_t *)bytes
+            length:(NSUInteger)length;
+
+- (id)finishWithError:(NSError * __autoreleasing *)error;
+
+@end
+
+@implementation AFJSONStreamParser {
+    NSJSONReadingOptions _readingOptions;
+    AFJSONParserState _state;
+    AFJSONObjectBuilder *_builder;
+
+    AFJSONByteBuffer _token;
+    AFJSONByteBuffer _unescapedToken;
+    BOOL _stringIsKey;
+    BOOL _stringHasEscapes;
+    BOOL _stringEndsWithEscape;
+    const char *_literal;
+    NSUInteger _literalIndex;
+
+    const uint8_t *_chunkBytes;
+    unsigned long long _offset;
+
+    id _result;
+    NSError *_error;
+}
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _readingOptions = readingOptions;
+    _state = AFJSONParserStateValue;
+    _builder = [[AFJSONObjectBuilder alloc] initWithReadingOptions:readingOptions removesKeysWithNullValues:removesKeysWithNullValues keyTable:keyTable];
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_token.bytes);
+    free(_unescapedToken.bytes);
+}
+
+static void AFJSONStreamParserFail(AFJSONStreamParser *parser, const uint8_t *position, NSString *reason) {
+    unsigned long long offset = parser->_offset;
+    if (position && parser->_chunkBytes) {
+        offset += (unsigned long long)(position - parser->_chunkBytes);
+    }
+
+    parser->_state = AFJSONParserStateError;
+    parser->_error = AFJSONParsingError(reason, offset);
+}
+
+static BOOL AFJSONStreamParserPushValue(AFJSONStreamParser *parser, id value, const uint8_t *position) {
+    if (AFJSONObjectBuilderDepth(parser->_builder) == 0) {
+        parser->_result = value;
+        parser->_state = AFJSONParserStateEnd;
+
+        return YES;
+    }
+
+    if (!AFJSONObjectBuilderAddValue(parser->_builder, value)) {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        return NO;
+    }
+
+    parser->_state = AFJSONParserStateAfterValue;
+
+    return YES;
+}
+
+static BOOL AFJSONStreamParserOpenContainer(AFJSONStreamParser *parser, BOOL isObject, const uint8_t *position) {
+    if (!AFJSONObjectBuilderOpenContainer(parser->_builder, isObject)) {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        return NO;
+    }
+
+    parser->_state = isObject ? AFJSONParserStateObjectStart : AFJSONParserStateArrayStart;
+
+    return YES;
+}
+
+static BOOL AFJSONStreamParserCloseContainer(AFJSONStreamParser *parser, const uint8_t *position) {
+    id container = AFJSONObjectBuilderCloseContainer(parser->_builder);
+    if (!container) {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        return NO;
+    }
+
+    return AFJSONStreamParserPushValue(parser, container, position);
+}
+
+static BOOL AFJSONStreamParserPushString(AFJSONStreamParser *parser, const uint8_t *bytes, size_t length, const uint8_t *position) {
+    NSString *string = nil;
+    if (parser->_stringIsKey) {
+        string = AFJSONObjectBuilderKeyWithBytes(parser->_builder, bytes, length, parser->_stringHasEscapes, &parser->_unescapedToken);
+    } else {
+        string = AFJSONStringWithBytes(bytes, length, parser->_stringHasEscapes, (parser->_readingOptions & NSJSONReadingMutableLeaves) != 0, &parser->_unescapedToken);
+    }
+
+    if (!string) {
+        AFJSONStreamParserFail(parser, position, @"Unable to convert data to string");
+        return NO;
+    }
+
+    if (!parser->_stringIsKey) {
+        return AFJSONStreamParserPushValue(parser, string, position);
+    }
+
+    if (!AFJSONObjectBuilderAddKey(parser->_builder, string)) {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        return NO;
+    }
+
+    parser->_state = AFJSONParserStateColon;
+
+    return YES;
+}
+
+static void AFJSONStreamParserBeginString(AFJSONStreamParser *parser, BOOL isKey) {
+    parser->_state = AFJSONParserStateString;
+    parser->_stringIsKey = isKey;
+    parser->_stringHasEscapes = NO;
+    parser->_stringEndsWithEscape = NO;
+}
+
+static const uint8_t * AFJSONStreamParserScanString(AFJSONStreamParser *parser, const uint8_t *bytes, const uint8_t *end) {
+    const uint8_t *position = bytes;
+    BOOL escaped = parser->_stringEndsWithEscape;
+    while (position < end) {
+        uint8_t c = *position;
+        if (c < 0x20) {
+            AFJSONStreamParserFail(parser, position, @"Unescaped control character");
+            return end;
+        }
+
+        if (escaped) {
+            escaped = NO;
+        } else if (c == '"') {
+            break;
+        } else if (c == '\\') {
+            escaped = YES;
+            parser->_stringHasEscapes = YES;
+        }
+
+        position++;
+    }
+
+    if (position == end) {
+        parser->_stringEndsWithEscape = escaped;
+        if (!AFJSONByteBufferAppendBytes(&parser->_token, bytes, (size_t)(end - bytes))) {
+            AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        }
+
+        return end;
+    }
+
+    if (parser->_token.length == 0) {
+        AFJSONStreamParserPushString(parser, bytes, (size_t)(position - bytes), position);
+    } else if (AFJSONByteBufferAppendBytes(&parser->_token, bytes, (size_t)(position - bytes))) {
+        AFJSONStreamParserPushString(parser, parser->_token.bytes, parser->_token.length, position);
+        parser->_token.length = 0;
+    } else {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+    }
+
+    return position + 1;
+}
+
+static BOOL AFJSONStreamParserPushNumber(AFJSONStreamParser *parser, const uint8_t *bytes, size_t length, const uint8_t *position) {
+    NSNumber *number = AFJSONNumberFromBytes(bytes, length);
+    if (!number) {
+        AFJSONStreamParserFail(parser, position, @"Invalid number");
+        return NO;
+    }
+
+    return AFJSONStreamParserPushValue(parser, number, position);
+}
+
+static const uint8_t * AFJSONStreamParserScanNumber(AFJSONStreamParser *parser, const uint8_t *bytes, const uint8_t *end) {
+    const uint8_t *position = bytes;
+    while (position < end && AFJSONIsNumberByte(*position)) {
+        position++;
+    }
+
+    if (position == end) {
+        if (!AFJSONByteBufferAppendBytes(&parser->_token, bytes, (size_t)(end - bytes))) {
+            AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+        }
+
+        return end;
+    }
+
+    if (parser->_token.length == 0) {
+        AFJSONStreamParserPushNumber(parser, bytes, (size_t)(position - bytes), position);
+    } else if (AFJSONByteBufferAppendBytes(&parser->_token, bytes, (size_t)(position - bytes))) {
+        AFJSONStreamParserPushNumber(parser, parser->_token.bytes, parser->_token.length, position);
+        parser->_token.length = 0;
+    } else {
+        AFJSONStreamParserFail(parser, position, @"Unable to allocate memory");
+    }
+
+    return position;
+}
+
+static const uint8_t * AFJSONStreamParserScanLiteral(AFJSONStreamParser *parser, const uint8_t *bytes, const uint8_t *end) {
+    const uint8_t *position = bytes;
+    const char *literal = parser->_literal;
+    while (position < end && literal[parser->_literalIndex] != '\0') {
+        if (*position != (uint8_t)literal[parser->_literalIndex]) {
+            AFJSONStreamParserFail(parser, position, @"Invalid value");
+            return end;
+        }
+
+        parser->_literalIndex++;
+        position++;
+    }
+
+    if (literal[parser->_literalIndex] == '\0') {
+        AFJSONStreamParserPushValue(parser, AFJSONLiteralValue(literal), position);
+    }
+
+    return position;
+}
+
+static const uint8_t * AFJSONStreamParserScanValue(AFJSONStreamParser *parser, const uint8_t *position) {
+    uint8_t c = *position;
+    if (AFJSONObjectBuilderDepth(parser->_builder) == 0 && !(parser->_readingOptions & NSJSONReadingAllowFragments) && c != '[' && c != '{') {
+        AFJSONStreamParserFail(parser, position, @"JSON text did not start with array or object and option to allow fragments not set");
+        return position;
+    }
+
+    if (c == '{' || c == '[') {
+        AFJSONStreamParserOpenContainer(parser, c == '{', position);
+        return position + 1;
+    } else if (c == '"') {
+        AFJSONStreamParserBeginString(parser, NO);
+        return position + 1;
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        parser->_state = AFJSONParserStateNumber;
+        return position;
+    }
+
+    const char *literal = AFJSONLiteralStartingWithByte(c);
+    if (!literal) {
+        AFJSONStreamParserFail(parser, position, @"Invalid value");
+        return position;
+    }
+
+    parser->_state = AFJSONParserStateLiteral;
+    parser->_literal = literal;
+    parser->_literalIndex = 0;
+
+    return position;
+}
+
+static const uint8_t * AFJSONStreamParserScanStructure(AFJSONStreamParser *parser, const uint8_t *position) {
+    uint8_t c = *position;
+    switch (parser->_state) {
+        case AFJSONParserStateArrayStart:
+            if (c == ']') {
+                AFJSONStreamParserCloseContainer(parser, position);
+                return position + 1;
+            }
+            return AFJSONStreamParserScanValue(parser, position);
+        case AFJSONParserStateValue:
+            return AFJSONStreamParserScanValue(parser, position);
+        case AFJSONParserStateObjectStart:
+        case AFJSONParserStateKey:
+            if (c == '}' && parser->_state == AFJSONParserStateObjectStart) {
+                AFJSONStreamParserCloseContainer(parser, position);
+                return position + 1;
+            } else if (c == '"') {
+                AFJSONStreamParserBeginString(parser, YES);
+                return position + 1;
+            }
+
+            AFJSONStreamParserFail(parser, position, @"No string key for value in object");
+            return position;
+        case AFJSONParserStateColon:
+            if (c == ':') {
+                parser->_state = AFJSONParserStateValue;
+                return position + 1;
+            }
+
+            AFJSONStreamParserFail(parser, position, @"No ':' after key in object");
+            return position;
+        case AFJSONParserStateAfterValue: {
+            BOOL isObject = AFJSONObjectBuilderIsInObject(parser->_builder);
+            if (c == ',') {
+                parser->_state = isObject ? AFJSONParserStateKey : AFJSONParserStateValue;
+                return position + 1;
+            } else if (c == (isObject ? '}' : ']')) {
+                AFJSONStreamParserCloseContainer(parser, position);
+                return position + 1;
+            }
+
+            AFJSONStreamParserFail(parser, position, isObject ? @"Badly formed object" : @"Badly formed array");
+            return position;
+        }
+        default:
+            AFJSONStreamParserFail(parser, position, @"Garbage at end");
+            return position;
+    }
+}
+
+- (BOOL)parseBytes:(const uint8_t *)bytes
+            length:(NSUInteger)length
+{
+    const uint8_t *position = bytes;
+    const uint8_t *end = bytes + length;
+    _chunkBytes = bytes;
+
+    while (position < end && _state != AFJSONParserStateError) {
+        switch (_state) {
+            case AFJSONParserStateString:
+                position = AFJSONStreamParserScanString(self, position, end);
+                break;
+            case AFJSONParserStateNumber:
+                position = AFJSONStreamParserScanNumber(self, position, end);
+                break;
+            case AFJSONParserStateLiteral:
+                position = AFJSONStreamParserScanLiteral(self, position, end);
+                break;
+            default:
+                if (AFJSONIsWhitespace(*position)) {
+                    position++;
+                } else {
+                    position = AFJSONStreamParserScanStructure(self, position);
+                }
+                break;
+        }
+    }
+
+    _chunkBytes = NULL;
+    _offset += length;
+
+    return _state != AFJSONParserStateError;
+}
+
+- (id)finishWithError:(NSError * __autoreleasing *)error {
+    if (_state == AFJSONParserStateNumber && AFJSONObjectBuilderDepth(_builder) == 0) {
+        AFJSONStreamParserPushNumber(self, _token.bytes, _token.length, NULL);
+        _token.length = 0;
+    }
+
+    if (_state != AFJSONParserStateEnd && _state != AFJSONParserStateError) {
+        AFJSONStreamParserFail(self, NULL, _offset == 0 ? @"No value" : @"Unexpected end of file");
+    }
+
+    if (_state == AFJSONParserStateError) {
+        if (error) {
+            *error = _error;
+        }
+
+        return nil;
+    }
+
+    return _result;
+}
+
+@end
+
+#pragma mark - Structural Index
+
+// Parsing a whole document happens in two stages, as in simdjson. The first stage classifies 64 bytes at a time with vector instructions, and records the offset of every structural character, string quote, and scalar outside of strings. The second stage walks those offsets to build the object graph, without examining whitespace or the contents of strings byte by byte.
+
+typedef struct {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t structural;
+    uint64_t whitespace;
+    uint64_t control;
+} AFJSONBlockClassification;
+
+#if defined(__AVX2__)
+static inline uint64_t AFJSONMaskFromVector(__m256i vector) {
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(vector);
+}
+
+static inline AFJSONBlockClassification AFJSONClassifyBlock(const uint8_t *block) {
+    AFJSONBlockClassification classification = {0, 0, 0, 0, 0};
+    for (unsigned int offset = 0; offset < 64; offset += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(const void *)(block + offset));
+        __m256i structural = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}'))),
+                                             _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']'))),
+                                                             _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))));
+        __m256i whitespace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+
+        classification.quote |= AFJSONMaskFromVector(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'))) << offset;
+        classification.backslash |= AFJSONMaskFromVector(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'))) << offset;
+        classification.structural |= AFJSONMaskFromVector(structural) << offset;
+        classification.whitespace |= AFJSONMaskFromVector(whitespace) << offset;
+        classification.control |= AFJSONMaskFromVector(_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk)) << offset;
+    }
+
+    return classification;
+}
+#elif defined(__SSE2__)
+static inline uint64_t AFJSONMaskFromVector(__m128i vector) {
+    return (uint64_t)(uint32_t)_mm_movemask_epi8(vector);
+}
+
+static inline AFJSONBlockClassification AFJSONClassifyBlock(const uint8_t *block) {
+    AFJSONBlockClassification classification = {0, 0, 0, 0, 0};
+    for (unsigned int offset = 0; offset < 64; offset += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(const void *)(block + offset));
+        __m128i structural = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+                                          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']'))),
+                                                       _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))));
+        __m128i whitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                          _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+
+        classification.quote |= AFJSONMaskFromVector(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << offset;
+        classification.backslash |= AFJSONMaskFromVector(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << offset;
+        classification.structural |= AFJSONMaskFromVector(structural) << offset;
+        classification.whitespace |= AFJSONMaskFromVector(whitespace) << offset;
+        classification.control |= AFJSONMaskFromVector(_mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk)) << offset;
+    }
+
+    return classification;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static inline uint64_t AFJSONMaskFromVectors(uint8x16_t vector0, uint8x16_t vector1, uint8x16_t vector2, uint8x16_t vector3) {
+    static const uint8_t bitValues[16] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+    uint8x16_t bits = vld1q_u8(bitValues);
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(vector0, bits), vandq_u8(vector1, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(vector2, bits), vandq_u8(vector3, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static inline AFJSONBlockClassification AFJSONClassifyBlock(const uint8_t *block) {
+    uint8x16_t quote[4], backslash[4], structural[4], whitespace[4], control[4];
+    for (unsigned int idx = 0; idx < 4; idx++) {
+        uint8x16_t chunk = vld1q_u8(block + idx * 16);
+        quote[idx] = vceqq_u8(chunk, vdupq_n_u8('"'));
+        backslash[idx] = vceqq_u8(chunk, vdupq_n_u8('\\'));
+        structural[idx] = vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('{')), vceqq_u8(chunk, vdupq_n_u8('}'))),
+                                   vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('[')), vceqq_u8(chunk, vdupq_n_u8(']'))),
+                                            vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(':')), vceqq_u8(chunk, vdupq_n_u8(',')))));
+        whitespace[idx] = vorrq_u8(vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\t'))),
+                                   vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+        control[idx] = vcltq_u8(chunk, vdupq_n_u8(0x20));
+    }
+
+    AFJSONBlockClassification classification;
+    classification.quote = AFJSONMaskFromVectors(quote[0], quote[1], quote[2], quote[3]);
+    classification.backslash = AFJSONMaskFromVectors(backslash[0], backslash[1], backslash[2], backslash[3]);
+    classification.structural = AFJSONMaskFromVectors(structural[0], structural[1], structural[2], structural[3]);
+    classification.whitespace = AFJSONMaskFromVectors(whitespace[0], whitespace[1], whitespace[2], whitespace[3]);
+    classification.control = AFJSONMaskFromVectors(control[0], control[1], control[2], control[3]);
+
+    return classification;
+}
+#else
+static inline AFJSONBlockClassification AFJSONClassifyBlock(const uint8_t *block) {
+    AFJSONBlockClassification classification = {0, 0, 0, 0, 0};
+    for (unsigned int idx = 0; idx < 64; idx++) {
+        uint64_t bit = 1ULL << idx;
+        switch (block[idx]) {
+            case '"':
+                classification.quote |= bit;
+                break;
+            case '\\':
+                classification.backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                classification.structural |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                classification.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+
+        if (block[idx] < 0x20) {
+            classification.control |= bit;
+        }
+    }
+
+    return classification;
+}
+#endif
+
+// Bit i of the result is set if an odd number of bits at or below i are set, which for quotes means that byte i is within a string.
+static inline uint64_t AFJSONPrefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+// Backslashes are rare outside of text, so runs of them are resolved one at a time rather than with carry arithmetic.
+static inline uint64_t AFJSONEscapedMask(uint64_t backslash, uint64_t *escapesNextBlock) {
+    uint64_t escaped = *escapesNextBlock;
+    *escapesNextBlock = 0;
+
+    while (backslash) {
+        uint64_t bit = backslash & (~backslash + 1);
+        backslash ^= bit;
+
+        if (escaped & bit) {
+            continue;
+        }
+
+        if (bit == (1ULL << 63)) {
+            *escapesNextBlock = 1;
+        } else {
+            escaped |= bit << 1;
+        }
+    }
+
+    return escaped;
+}
+
+static BOOL AFJSONIndexStructuralCharacters(const uint8_t *bytes, size_t length, uint32_t *indexes, size_t *count, size_t *errorOffset) {
+    uint64_t inStringCarry = 0;
+    uint64_t escapedCarry = 0;
+    uint64_t scalarCarry = 0;
+    size_t indexCount = 0;
+
+    for (size_t offset = 0; offset < length; offset += 64) {
+        const uint8_t *block = bytes + offset;
+        uint8_t paddedBlock[64];
+        if (length - offset < 64) {
+            memset(paddedBlock, ' ', sizeof(paddedBlock));
+            memcpy(paddedBlock, block, length - offset);
+            block = paddedBlock;
+        }
+
+        AFJSONBlockClassification classification = AFJSONClassifyBlock(block);
+
+        uint64_t quote = classification.quote & ~AFJSONEscapedMask(classification.backslash, &escapedCarry);
+        uint64_t inString = AFJSONPrefixXor(quote) ^ inStringCarry;
+        inStringCarry = (inString >> 63) ? ~0ULL : 0;
+
+        uint64_t unescapedControl = classification.control & inString & ~quote;
+        if (unescapedControl) {
+            *errorOffset = offset + (size_t)__builtin_ctzll(unescapedControl);
+            return NO;
+        }
+
+        uint64_t scalar = ~(classification.structural | classification.whitespace | quote | inString);
+        uint64_t scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+        scalarCarry = scalar >> 63;
+
+        uint64_t bits = (classification.structural & ~inString) | quote | scalarStart;
+        while (bits) {
+            indexes[indexCount++] = (uint32_t)(offset + (size_t)__builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+
+    *count = indexCount;
+
+    if (inStringCarry) {
+        *errorOffset = length;
+        return NO;
+    }
+
+    return YES;
+}
+
+static inline BOOL AFJSONIsScalarByte(uint8_t c) {
+    switch (c) {
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+        case '"':
+            return NO;
+        default:
+            return !AFJSONIsWhitespace(c);
+    }
+}
+
+// Leaves `builder` empty, so that it can be reused for another value. `readingOptions` may only differ from those of the builder in allowing fragments.
+static id AFJSONObjectBuilderObjectWithStructuralIndexes(AFJSONObjectBuilder *builder, const uint8_t *bytes, size_t length, const uint32_t *indexes, size_t count, NSJSONReadingOptions readingOptions, AFJSONByteBuffer *scratch, NSError * __autoreleasing *error) {
+    BOOL mutableLeaves = (readingOptions & NSJSONReadingMutableLeaves) != 0;
+    AFJSONParserState state = AFJSONParserStateValue;
+    NSString *failureReason = nil;
+    size_t offset = length;
+    id result = nil;
+
+    for (size_t idx = 0; idx < count && !failureReason; idx++) {
+        offset = indexes[idx];
+        uint8_t c = bytes[offset];
+        id value = nil;
+
+        switch (state) {
+            case AFJSONParserStateAfterValue: {
+                BOOL isObject = AFJSONObjectBuilderIsInObject(builder);
+                if (c == ',') {
+                    state = isObject ? AFJSONParserStateKey : AFJSONParserStateValue;
+                } else if (c == (isObject ? '}' : ']')) {
+                    value = AFJSONObjectBuilderCloseContainer(builder);
+                    if (!value) {
+                        failureReason = @"Unable to allocate memory";
+                    }
+                } else {
+                    failureReason = isObject ? @"Badly formed object" : @"Badly formed array";
+                }
+                break;
+            }
+            case AFJSONParserStateColon:
+                if (c == ':') {
+                    state = AFJSONParserStateValue;
+                } else {
+                    failureReason = @"No ':' after key in object";
+                }
+                break;
+            case AFJSONParserStateObjectStart:
+            case AFJSONParserStateKey:
+                if (c == '}' && state == AFJSONParserStateObjectStart) {
+                    value = AFJSONObjectBuilderCloseContainer(builder);
+                    if (!value) {
+                        failureReason = @"Unable to allocate memory";
+                    }
+                } else if (c == '"') {
+                    size_t end = indexes[++idx];
+                    NSString *key = AFJSONObjectBuilderKeyWithBytes(builder, bytes + offset + 1, end - offset - 1, memchr(bytes + offset + 1, '\\', end - offset - 1) != NULL, scratch);
+                    if (!key) {
+                        failureReason = @"Unable to convert data to string";
+                    } else if (!AFJSONObjectBuilderAddKey(builder, key)) {
+                        failureReason = @"Unable to allocate memory";
+                    } else {
+                        state = AFJSONParserStateColon;
+                    }
+                } else {
+                    failureReason = @"No string key for value in object";
+                }
+                break;
+            case AFJSONParserStateArrayStart:
+            case AFJSONParserStateValue:
+                if (c == ']' && state == AFJSONParserStateArrayStart) {
+                    value = AFJSONObjectBuilderCloseContainer(builder);
+                    if (!value) {
+                        failureReason = @"Unable to allocate memory";
+                    }
+                } else if (AFJSONObjectBuilderDepth(builder) == 0 && !(readingOptions & NSJSONReadingAllowFragments) && c != '[' && c != '{') {
+                    failureReason = @"JSON text did not start with array or object and option to allow fragments not set";
+                } else if (c == '{' || c == '[') {
+                    if (AFJSONObjectBuilderOpenContainer(builder, c == '{')) {
+                        state = c == '{' ? AFJSONParserStateObjectStart : AFJSONParserStateArrayStart;
+                    } else {
+                        failureReason = @"Unable to allocate memory";
+                    }
+                } else if (c == '"') {
+                    size_t end = indexes[++idx];
+                    value = AFJSONStringWithBytes(bytes + offset + 1, end - offset - 1, memchr(bytes + offset + 1, '\\', end - offset - 1) != NULL, mutableLeaves, scratch);
+                    if (!value) {
+                        failureReason = @"Unable to convert data to string";
+                    }
+                } else {
+                    size_t end = offset;
+                    while (end < length && AFJSONIsScalarByte(bytes[end])) {
+                        end++;
+                    }
+
+                    const char *literal = AFJSONLiteralStartingWithByte(c);
+                    if (literal) {
+                        if (strlen(literal) == end - offset && memcmp(literal, bytes + offset, end - offset) == 0) {
+                            value = AFJSONLiteralValue(literal);
+                        }
+                    } else {
+                        value = AFJSONNumberFromBytes(bytes + offset, end - offset);
+                    }
+
+                    if (!value) {
+                        failureReason = @"Invalid value";
+                    }
+                }
+                break;
+            default:
+                failureReason = @"Garbage at end";
+                break;
+        }
+
+        if (value) {
+            if (AFJSONObjectBuilderDepth(builder) == 0) {
+                result = value;
+                state = AFJSONParserStateEnd;
+            } else if (AFJSONObjectBuilderAddValue(builder, value)) {
+                state = AFJSONParserStateAfterValue;
+            } else {
+                failureReason = @"Unable to allocate memory";
+            }
+        }
+    }
+
+    if (!failureReason && state != AFJSONParserStateEnd) {
+        failureReason = count == 0 ? @"No value" : @"Unexpected end of file";
+        offset = length;
+    }
+
+    if (failureReason) {
+        AFJSONObjectBuilderReset(builder);
+
+        if (error) {
+            *error = AFJSONParsingError(failureReason, offset);
+        }
+
+        return nil;
+    }
+
+    return result;
+}
+
+static id AFJSONObjectWithStructuralIndexes(const uint8_t *bytes, size_t length, const uint32_t *indexes, size_t count, NSJSONReadingOptions readingOptions, BOOL removesKeysWithNullValues, AFJSONKeyTable *keyTable, NSError * __autoreleasing *error) {
+    AFJSONObjectBuilder *builder = [[AFJSONObjectBuilder alloc] initWithReadingOptions:readingOptions removesKeysWithNullValues:removesKeysWithNullValues keyTable:keyTable];
+    AFJSONByteBuffer scratch = {NULL, 0, 0};
+    id result = AFJSONObjectBuilderObjectWithStructuralIndexes(builder, bytes, length, indexes, count, readingOptions, &scratch, error);
+    free(scratch.bytes);
+
+    return result;
+}
+
+// Top-level arrays shorter than this are not worth splitting across threads.
+static size_t const AFJSONConcurrentParsingMinimumLength = 1 << 16;
+
+typedef struct {
+    size_t start;
+    size_t end;
+} AFJSONIndexRange;
+
+// Splits the elements of a top-level array into ranges of about the same number of structural characters, and parses each range as an array of its own on a separate thread, by bracketing its structural characters with those of the top-level array. The whole array is parsed on the current thread if it cannot be split, which also reports any error in its structure.
+static id AFJSONObjectWithStructuralIndexesConcurrently(const uint8_t *bytes, size_t length, const uint32_t *indexes, size_t count, NSJSONReadingOptions readingOptions, BOOL removesKeysWithNullValues, AFJSONKeyTable *keyTable, NSError * __autoreleasing *error) {
+    size_t processorCount = (size_t)[[NSProcessInfo processInfo] activeProcessorCount];
+    if (length < AFJSONConcurrentParsingMinimumLength || processorCount < 2 || count < 2 || bytes[indexes[0]] != '[') {
+        return AFJSONObjectWithStructuralIndexes(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+    }
+
+    // More ranges than processors, so that threads finishing early can pick up the slack.
+    size_t maximumRangeCount = processorCount * 4;
+    size_t rangeLength = count / maximumRangeCount + 1;
+    AFJSONIndexRange *ranges = malloc(maximumRangeCount * sizeof(AFJSONIndexRange));
+    if (!ranges) {
+        return AFJSONObjectWithStructuralIndexes(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+    }
+
+    size_t rangeCount = 0;
+    size_t rangeStart = 1;
+    size_t closingIndex = 0;
+    NSUInteger depth = 1;
+    for (size_t idx = 1; idx < count && closingIndex == 0; idx++) {
+        switch (bytes[indexes[idx]]) {
+            case '"':
+                idx++;
+                break;
+            case '[':
+            case '{':
+                depth++;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0) {
+                    closingIndex = idx;
+                }
+                break;
+            case ',':
+                if (depth == 1 && idx - rangeStart >= rangeLength && rangeCount < maximumRangeCount - 1) {
+                    ranges[rangeCount++] = (AFJSONIndexRange){rangeStart, idx};
+                    rangeStart = idx + 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (rangeCount == 0 || closingIndex != count - 1 || bytes[indexes[closingIndex]] != ']' || rangeStart == closingIndex) {
+        free(ranges);
+        return AFJSONObjectWithStructuralIndexes(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+    }
+
+    ranges[rangeCount++] = (AFJSONIndexRange){rangeStart, closingIndex};
+
+    void **rangeObjects = calloc(rangeCount, sizeof(void *));
+    void **rangeErrors = calloc(rangeCount, sizeof(void *));
+    if (!rangeObjects || !rangeErrors) {
+        free(ranges);
+        free(rangeObjects);
+        free(rangeErrors);
+        return AFJSONObjectWithStructuralIndexes(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+    }
+
+    dispatch_apply(rangeCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t rangeIndex) {
+        @autoreleasepool {
+            AFJSONIndexRange range = ranges[rangeIndex];
+            size_t rangeIndexCount = range.end - range.start + 2;
+            uint32_t *rangeIndexes = malloc(rangeIndexCount * sizeof(uint32_t));
+            if (!rangeIndexes) {
+                return;
+            }
+
+            rangeIndexes[0] = indexes[0];
+            memcpy(rangeIndexes + 1, indexes + range.start, (range.end - range.start) * sizeof(uint32_t));
+            rangeIndexes[rangeIndexCount - 1] = indexes[closingIndex];
+
+            NSError *rangeError = nil;
+            NSArray *rangeObject = AFJSONObjectWithStructuralIndexes(bytes, length, rangeIndexes, rangeIndexCount, readingOptions, removesKeysWithNullValues, keyTable, &rangeError);
+            rangeObjects[rangeIndex] = rangeObject ? (void *)CFBridgingRetain(rangeObject) : NULL;
+            rangeErrors[rangeIndex] = rangeError ? (void *)CFBridgingRetain(rangeError) : NULL;
+
+            free(rangeIndexes);
+        }
+    });
+
+    NSMutableArray *mutableArray = [NSMutableArray array];
+    NSError *rangeError = nil;
+    BOOL succeeded = YES;
+    for (size_t idx = 0; idx < rangeCount; idx++) {
+        NSArray *rangeObject = rangeObjects[idx] ? CFBridgingRelease(rangeObjects[idx]) : nil;
+        NSError *currentRangeError = rangeErrors[idx] ? CFBridgingRelease(rangeErrors[idx]) : nil;
+        if (succeeded && !rangeObject) {
+            rangeError = currentRangeError ?: AFJSONParsingError(@"Unable to allocate memory", indexes[ranges[idx].start]);
+            succeeded = NO;
+        }
+
+        if (succeeded) {
+            [mutableArray addObjectsFromArray:rangeObject];
+        }
+    }
+
+    free(ranges);
+    free(rangeObjects);
+    free(rangeErrors);
+
+    if (!succeeded) {
+        if (error) {
+            *error = rangeError;
+        }
+
+        return nil;
+    }
+
+    return (readingOptions & NSJSONReadingMutableContainers) ? mutableArray : [mutableArray copy];
+}
+
+static id AFJSONObjectWithStructuralIndexOfData(NSData *data, NSJSONReadingOptions readingOptions, BOOL removesKeysWithNullValues, AFJSONKeyTable *keyTable, BOOL parsesTopLevelArraysConcurrently, NSError * __autoreleasing *error) {
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+
+    // Offsets are indexed as 32-bit integers, and only UTF-8 is indexed.
+    if (length >= UINT32_MAX || !AFJSONBytesAreUTF8(bytes, length)) {
+        return AFJSONObjectWithJSONSerialization(data, readingOptions, removesKeysWithNullValues, error);
+    }
+
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        bytes += 3;
+        length -= 3;
+    }
+
+    uint32_t *indexes = malloc(MAX(length, (size_t)1) * sizeof(uint32_t));
+    if (!indexes) {
+        return AFJSONObjectWithJSONSerialization(data, readingOptions, removesKeysWithNullValues, error);
+    }
+
+    id responseObject = nil;
+    size_t count = 0;
+    size_t errorOffset = 0;
+    if (AFJSONIndexStructuralCharacters(bytes, length, indexes, &count, &errorOffset)) {
+        if (parsesTopLevelArraysConcurrently) {
+            responseObject = AFJSONObjectWithStructuralIndexesConcurrently(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+        } else {
+            responseObject = AFJSONObjectWithStructuralIndexes(bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, error);
+        }
+    } else if (error) {
+        *error = AFJSONParsingError(errorOffset < length ? @"Unescaped control character" : @"Unterminated string", errorOffset);
+    }
+
+    free(indexes);
+
+    return responseObject;
+}
+
+#pragma mark - Key Path Projection
+
+/**
+ `AFJSONKeyPathNode` is a node of the tree that the projected key paths of an `AFJSONResponseSerializer` are compiled into, with one child for each dictionary key, array index, or array wildcard that follows it in any key path.
+ */
+@interface AFJSONKeyPathNode : NSObject
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, copy) NSData *keyData;
+@property (nonatomic, strong) NSMutableArray <NSString *> *keyPaths;
+@property (nonatomic, assign) BOOL collectsValues;
+@property (nonatomic, strong) NSMutableArray <AFJSONKeyPathNode *> *keyChildren;
+@property (nonatomic, strong) NSMutableDictionary <NSNumber *, AFJSONKeyPathNode *> *indexChildren;
+@property (nonatomic, strong) AFJSONKeyPathNode *wildcardChild;
+@end
+
+@implementation AFJSONKeyPathNode
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.keyPaths = [NSMutableArray array];
+    self.keyChildren = [NSMutableArray array];
+    self.indexChildren = [NSMutableDictionary dictionary];
+
+    return self;
+}
+
+- (AFJSONKeyPathNode *)childForKey:(NSString *)key {
+    for (AFJSONKeyPathNode *child in self.keyChildren) {
+        if ([child.key isEqualToString:key]) {
+            return child;
+        }
+    }
+
+    AFJSONKeyPathNode *child = [[AFJSONKeyPathNode alloc] init];
+    child.key = key;
+    child.keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+    [self.keyChildren addObject:child];
+
+    return child;
+}
+
+- (AFJSONKeyPathNode *)childForIndex:(NSUInteger)index {
+    AFJSONKeyPathNode *child = self.indexChildren[@(index)];
+    if (!child) {
+        child = [[AFJSONKeyPathNode alloc] init];
+        self.indexChildren[@(index)] = child;
+    }
+
+    return child;
+}
+
+- (AFJSONKeyPathNode *)wildcardChildCreatingIfNeeded {
+    if (!self.wildcardChild) {
+        self.wildcardChild = [[AFJSONKeyPathNode alloc] init];
+    }
+
+    return self.wildcardChild;
+}
+
+@end
+
+// Each component of a key path is a dictionary key, optionally followed by any number of array subscripts, which are either an index like `[0]` or the wildcard `[*]`. A component whose subscripts are malformed is taken as a key as a whole.
+static AFJSONKeyPathNode * AFJSONKeyPathTreeWithKeyPaths(NSSet <NSString *> *keyPaths) {
+    AFJSONKeyPathNode *root = [[AFJSONKeyPathNode alloc] init];
+    NSCharacterSet *decimalDigitCharacterSet = [NSCharacterSet decimalDigitCharacterSet];
+
+    for (NSString *keyPath in keyPaths) {
+        if (keyPath.length == 0) {
+            continue;
+        }
+
+        AFJSONKeyPathNode *node = root;
+        BOOL collectsValues = NO;
+        for (NSString *component in [keyPath componentsSeparatedByString:@"."]) {
+            NSString *key = component;
+            NSMutableArray *subscripts = [NSMutableArray array];
+
+            NSRange subscriptRange = [component rangeOfString:@"["];
+            if (subscriptRange.location != NSNotFound && [component hasSuffix:@"]"]) {
+                NSArray *subscriptStrings = [[component substringWithRange:NSMakeRange(subscriptRange.location + 1, component.length - subscriptRange.location - 2)] componentsSeparatedByString:@"]["];
+                for (NSString *subscriptString in subscriptStrings) {
+                    if ([subscriptString isEqualToString:@"*"]) {
+                        [subscripts addObject:[NSNull null]];
+                    } else if (subscriptString.length > 0 && [[subscriptString stringByTrimmingCharactersInSet:decimalDigitCharacterSet] length] == 0) {
+                        [subscripts addObject:@([subscriptString integerValue])];
+                    } else {
+                        subscripts = nil;
+                        break;
+                    }
+                }
+
+                if (subscripts) {
+                    key = [component substringToIndex:subscriptRange.location];
+                } else {
+                    subscripts = [NSMutableArray array];
+                }
+            }
+
+            if (key.length > 0 || subscripts.count == 0) {
+                node = [node childForKey:key];
+            }
+
+            for (id subscript in subscripts) {
+                if ([subscript isKindOfClass:[NSNumber class]]) {
+                    node = [node childForIndex:[subscript unsignedIntegerValue]];
+                } else {
+                    node = [node wildcardChildCreatingIfNeeded];
+                    collectsValues = YES;
+                }
+            }
+        }
+
+        [node.keyPaths addObject:keyPath];
+        node.collectsValues = collectsValues;
+    }
+
+    return root;
+}
+
+static void AFJSONKeyPathNodeAddValue(AFJSONKeyPathNode *node, id value, NSMutableDictionary *projection) {
+    for (NSString *keyPath in node.keyPaths) {
+        if (node.collectsValues) {
+            [projection[keyPath] addObject:value];
+        } else {
+            projection[keyPath] = value;
+        }
+    }
+}
+
+// Applies `block` to the node and each of its descendants.
+static void AFJSONKeyPathNodeEnumerate(AFJSONKeyPathNode *node, void (^block)(AFJSONKeyPathNode *)) {
+    block(node);
+
+    for (AFJSONKeyPathNode *child in node.keyChildren) {
+        AFJSONKeyPathNodeEnumerate(child, block);
+    }
+
+    for (AFJSONKeyPathNode *child in node.indexChildren.allValues) {
+        AFJSONKeyPathNodeEnumerate(child, block);
+    }
+
+    if (node.wildcardChild) {
+        AFJSONKeyPathNodeEnumerate(node.wildcardChild, block);
+    }
+}
+
+// Key paths with a wildcard always have an array of values, even when nothing matches them.
+static NSMutableDictionary * AFJSONEmptyProjection(AFJSONKeyPathNode *root) {
+    NSMutableDictionary *projection = [NSMutableDictionary dictionary];
+    AFJSONKeyPathNodeEnumerate(root, ^(AFJSONKeyPathNode *node) {
+        if (node.collectsValues) {
+            for (NSString *keyPath in node.keyPaths) {
+                projection[keyPath] = [NSMutableArray array];
+            }
+        }
+    });
+
+    return projection;
+}
+
+static NSDictionary * AFJSONProjectionByFinishing(NSMutableDictionary *projection, AFJSONKeyPathNode *root, NSJSONReadingOptions readingOptions) {
+    if (readingOptions & NSJSONReadingMutableContainers) {
+        return projection;
+    }
+
+    AFJSONKeyPathNodeEnumerate(root, ^(AFJSONKeyPathNode *node) {
+        if (node.collectsValues) {
+            for (NSString *keyPath in node.keyPaths) {
+                projection[keyPath] = [projection[keyPath] copy];
+            }
+        }
+    });
+
+    return [projection copy];
+}
+
+// Used for responses that are not indexed, once they have been decoded as a whole.
+static void AFJSONProjectObject(id object, AFJSONKeyPathNode *node, NSMutableDictionary *projection) {
+    if (node.keyPaths.count > 0) {
+        AFJSONKeyPathNodeAddValue(node, object, projection);
+    }
+
+    if ([object isKindOfClass:[NSDictionary class]]) {
+        for (AFJSONKeyPathNode *child in node.keyChildren) {
+            id value = [(NSDictionary *)object objectForKey:child.key];
+            if (value) {
+                AFJSONProjectObject(value, child, projection);
+            }
+        }
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        NSArray *array = (NSArray *)object;
+        for (NSUInteger idx = 0; idx < array.count; idx++) {
+            if (node.wildcardChild) {
+                AFJSONProjectObject(array[idx], node.wildcardChild, projection);
+            }
+
+            AFJSONKeyPathNode *child = node.indexChildren[@(idx)];
+            if (child) {
+                AFJSONProjectObject(array[idx], child, projection);
+            }
+        }
+    }
+}
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    const uint32_t *indexes;
+    size_t count;
+    NSJSONReadingOptions readingOptions;
+    BOOL removesKeysWithNullValues;
+    AFJSONKeyTable *__unsafe_unretained keyTable;
+    AFJSONByteBuffer *scratch;
+    AFJSONObjectBuilder *__unsafe_unretained builder;
+    AFJSONByteBuffer *containers;
+} AFJSONIndexedDocument;
+
+// Returns the position in the structural index after the value starting at `idx`, only matching brackets, or `SIZE_MAX` if there is no value there.
+static size_t AFJSONIndexedDocumentSkipValue(const AFJSONIndexedDocument *document, size_t idx) {
+    if (idx >= document->count) {
+        return SIZE_MAX;
+    }
+
+    uint8_t c = document->bytes[document->indexes[idx]];
+    if (c == '"') {
+        return idx + 2;
+    } else if (c != '{' && c != '[') {
+        return AFJSONIsScalarByte(c) ? idx + 1 : SIZE_MAX;
+    }
+
+    NSUInteger depth = 1;
+    for (idx++; idx < document->count; idx++) {
+        c = document->bytes[document->indexes[idx]];
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) {
+                return idx + 1;
+            }
+        } else if (c == '"') {
+            idx++;
+        }
+    }
+
+    return SIZE_MAX;
+}
+
+static inline uint8_t AFJSONIndexedDocumentByteAtIndex(const AFJSONIndexedDocument *document, size_t idx) {
+    return idx < document->count ? document->bytes[document->indexes[idx]] : 0;
+}
+
+static inline size_t AFJSONIndexedDocumentOffsetAtIndex(const AFJSONIndexedDocument *document, size_t idx) {
+    return idx < document->count ? document->indexes[idx] : document->length;
+}
+
+// Scalars run from their first byte to the next structural character or whitespace.
+static BOOL AFJSONIndexedDocumentScalarAtIndexIsValid(const AFJSONIndexedDocument *document, size_t idx) {
+    const uint8_t *bytes = document->bytes + document->indexes[idx];
+    size_t length = 0;
+    while (bytes + length < document->bytes + document->length && AFJSONIsScalarByte(bytes[length])) {
+        length++;
+    }
+
+    const char *literal = AFJSONLiteralStartingWithByte(bytes[0]);
+    if (literal) {
+        return strlen(literal) == length && memcmp(literal, bytes, length) == 0;
+    }
+
+    // Only numbers with a fraction or an exponent can be out of range.
+    BOOL isInteger = NO;
+    return AFJSONNumberBytesAreValid(bytes, length, &isInteger) && (isInteger || AFJSONNumberFromBytes(bytes, length) != nil);
+}
+
+static BOOL AFJSONIndexedDocumentStringAtIndexIsValid(const AFJSONIndexedDocument *document, size_t idx) {
+    const uint8_t *bytes = document->bytes + document->indexes[idx] + 1;
+    size_t length = document->indexes[idx + 1] - document->indexes[idx] - 1;
+    if (!memchr(bytes, '\\', length)) {
+        return YES;
+    }
+
+    size_t unescapedLength = 0;
+    return AFJSONByteBufferReserve(document->scratch, length) && AFJSONUnescapeStringBytes(bytes, length, document->scratch->bytes, &unescapedLength);
+}
+
+// Returns the position in the structural index after the value starting at `idx`, or `SIZE_MAX` if it is not a valid value, checking it as fully as parsing it would, but without creating any objects.
+static size_t AFJSONIndexedDocumentValidateValue(const AFJSONIndexedDocument *document, size_t idx, NSError * __autoreleasing *error) {
+    AFJSONByteBuffer *containers = document->containers;
+    containers->length = 0;
+
+    AFJSONParserState state = AFJSONParserStateValue;
+    NSString *failureReason = nil;
+    size_t offset = document->length;
+
+    for (; idx < document->count && state != AFJSONParserStateEnd && !failureReason; idx++) {
+        offset = document->indexes[idx];
+        uint8_t c = document->bytes[offset];
+        BOOL isObject = containers->length > 0 && containers->bytes[containers->length - 1] == '{';
+        BOOL endsValue = NO;
+
+        switch (state) {
+            case AFJSONParserStateAfterValue:
+                if (c == ',') {
+                    state = isObject ? AFJSONParserStateKey : AFJSONParserStateValue;
+                } else if (c == (isObject ? '}' : ']')) {
+                    containers->length--;
+                    endsValue = YES;
+                } else {
+                    failureReason = isObject ? @"Badly formed object" : @"Badly formed array";
+                }
+                break;
+            case AFJSONParserStateColon:
+                if (c == ':') {
+                    state = AFJSONParserStateValue;
+                } else {
+                    failureReason = @"No ':' after key in object";
+                }
+                break;
+            case AFJSONParserStateObjectStart:
+            case AFJSONParserStateKey:
+                if (c == '}' && state == AFJSONParserStateObjectStart) {
+                    containers->length--;
+                    endsValue = YES;
+                } else if (c == '"') {
+                    if (AFJSONIndexedDocumentStringAtIndexIsValid(document, idx++)) {
+                        state = AFJSONParserStateColon;
+                    } else {
+                        failureReason = @"Unable to convert data to string";
+                    }
+                } else {
+                    failureReason = @"No string key for value in object";
+                }
+                break;
+            case AFJSONParserStateArrayStart:
+            case AFJSONParserStateValue:
+                if (c == ']' && state == AFJSONParserStateArrayStart) {
+                    containers->length--;
+                    endsValue = YES;
+                } else if (c == '{' || c == '[') {
+                    if (AFJSONByteBufferAppendBytes(containers, &c, 1)) {
+                        state = c == '{' ? AFJSONParserStateObjectStart : AFJSONParserStateArrayStart;
+                    } else {
+                        failureReason = @"Unable to allocate memory";
+                    }
+                } else if (c == '"') {
+                    if (AFJSONIndexedDocumentStringAtIndexIsValid(document, idx++)) {
+                        endsValue = YES;
+                    } else {
+                        failureReason = @"Unable to convert data to string";
+                    }
+                } else if (AFJSONIndexedDocumentScalarAtIndexIsValid(document, idx)) {
+                    endsValue = YES;
+                } else {
+                    failureReason = @"Invalid value";
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (endsValue) {
+            state = containers->length == 0 ? AFJSONParserStateEnd : AFJSONParserStateAfterValue;
+        }
+    }
+
+    if (!failureReason && state != AFJSONParserStateEnd) {
+        failureReason = @"Unexpected end of file";
+        offset = document->length;
+    }
+
+    if (failureReason) {
+        *error = AFJSONParsingError(failureReason, offset);
+        return SIZE_MAX;
+    }
+
+    return idx;
+}
+
+// Only the last value for a duplicate key is projected, as only it would be kept when parsing the whole object. Any value that is not projected is still validated.
+static BOOL AFJSONProjectIndexedValue(const AFJSONIndexedDocument *document, AFJSONKeyPathNode *node, size_t *position, NSMutableDictionary *projection, NSError * __autoreleasing *error) {
+    size_t start = *position;
+    uint8_t c = AFJSONIndexedDocumentByteAtIndex(document, start);
+    BOOL projectsMembers = c == '{' && node.keyChildren.count > 0;
+    BOOL projectsElements = c == '[' && (node.wildcardChild || node.indexChildren.count > 0);
+
+    if (node.keyPaths.count > 0) {
+        size_t end = AFJSONIndexedDocumentSkipValue(document, start);
+        if (end == SIZE_MAX) {
+            *error = AFJSONParsingError(@"Invalid value", AFJSONIndexedDocumentOffsetAtIndex(document, start));
+            return NO;
+        }
+
+        id value = AFJSONObjectBuilderObjectWithStructuralIndexes(document->builder, document->bytes, document->length, document->indexes + start, end - start, document->readingOptions | NSJSONReadingAllowFragments, document->scratch, error);
+        if (!value) {
+            return NO;
+        }
+
+        AFJSONKeyPathNodeAddValue(node, value, projection);
+
+        if (!projectsMembers && !projectsElements) {
+            *position = end;
+            return YES;
+        }
+    } else if (!projectsMembers && !projectsElements) {
+        *position = AFJSONIndexedDocumentValidateValue(document, start, error);
+        return *position != SIZE_MAX;
+    }
+
+    size_t idx = start + 1;
+    if (projectsMembers) {
+        NSArray <AFJSONKeyPathNode *> *keyChildren = node.keyChildren;
+        NSUInteger childCount = keyChildren.count;
+        size_t *valuePositions = malloc(childCount * sizeof(size_t));
+        if (!valuePositions) {
+            *error = AFJSONParsingError(@"Unable to allocate memory", AFJSONIndexedDocumentOffsetAtIndex(document, start));
+            return NO;
+        }
+
+        for (NSUInteger childIndex = 0; childIndex < childCount; childIndex++) {
+            valuePositions[childIndex] = SIZE_MAX;
+        }
+
+        // Matching values are only bracket-matched until a later value for the same key replaces them, and are projected once the whole object has been read.
+        BOOL succeeded = YES;
+        while (succeeded && AFJSONIndexedDocumentByteAtIndex(document, idx) != '}') {
+            if (idx > start + 1) {
+                if (AFJSONIndexedDocumentByteAtIndex(document, idx) != ',') {
+                    *error = AFJSONParsingError(@"Badly formed object", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                    succeeded = NO;
+                    break;
+                }
+
+                idx++;
+            }
+
+            if (AFJSONIndexedDocumentByteAtIndex(document, idx) != '"' || AFJSONIndexedDocumentByteAtIndex(document, idx + 2) != ':') {
+                *error = AFJSONParsingError(@"Badly formed object", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                succeeded = NO;
+                break;
+            }
+
+            const uint8_t *keyBytes = document->bytes + document->indexes[idx] + 1;
+            size_t keyLength = document->indexes[idx + 1] - document->indexes[idx] - 1;
+            idx += 3;
+
+            NSUInteger matchIndex = NSNotFound;
+            if (memchr(keyBytes, '\\', keyLength)) {
+                NSString *key = AFJSONStringWithBytes(keyBytes, keyLength, YES, NO, document->scratch);
+                if (!key) {
+                    *error = AFJSONParsingError(@"Unable to convert data to string", AFJSONIndexedDocumentOffsetAtIndex(document, idx - 3));
+                    succeeded = NO;
+                    break;
+                }
+
+                for (NSUInteger childIndex = 0; childIndex < childCount; childIndex++) {
+                    if ([keyChildren[childIndex].key isEqualToString:key]) {
+                        matchIndex = childIndex;
+                        break;
+                    }
+                }
+            } else {
+                for (NSUInteger childIndex = 0; childIndex < childCount; childIndex++) {
+                    NSData *keyData = keyChildren[childIndex].keyData;
+                    if (keyData.length == keyLength && memcmp(keyData.bytes, keyBytes, keyLength) == 0) {
+                        matchIndex = childIndex;
+                        break;
+                    }
+                }
+            }
+
+            size_t valuePosition = idx;
+            if (matchIndex == NSNotFound) {
+                idx = AFJSONIndexedDocumentValidateValue(document, idx, error);
+            } else {
+                idx = AFJSONIndexedDocumentSkipValue(document, idx);
+                if (idx == SIZE_MAX) {
+                    *error = AFJSONParsingError(@"Invalid value", AFJSONIndexedDocumentOffsetAtIndex(document, valuePosition));
+                } else if (valuePositions[matchIndex] != SIZE_MAX && AFJSONIndexedDocumentValidateValue(document, valuePositions[matchIndex], error) == SIZE_MAX) {
+                    idx = SIZE_MAX;
+                }
+
+                valuePositions[matchIndex] = valuePosition;
+            }
+
+            succeeded = idx != SIZE_MAX;
+        }
+
+        for (NSUInteger childIndex = 0; succeeded && childIndex < childCount; childIndex++) {
+            size_t valuePosition = valuePositions[childIndex];
+            if (valuePosition == SIZE_MAX) {
+                continue;
+            } else if (document->removesKeysWithNullValues && AFJSONIndexedDocumentByteAtIndex(document, valuePosition) == 'n') {
+                succeeded = AFJSONIndexedDocumentValidateValue(document, valuePosition, error) != SIZE_MAX;
+            } else {
+                succeeded = AFJSONProjectIndexedValue(document, keyChildren[childIndex], &valuePosition, projection, error);
+            }
+        }
+
+        free(valuePositions);
+
+        if (!succeeded) {
+            return NO;
+        }
+    } else {
+        for (NSUInteger elementIndex = 0; AFJSONIndexedDocumentByteAtIndex(document, idx) != ']'; elementIndex++) {
+            if (elementIndex > 0) {
+                if (AFJSONIndexedDocumentByteAtIndex(document, idx) != ',') {
+                    *error = AFJSONParsingError(@"Badly formed array", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                    return NO;
+                }
+
+                idx++;
+            }
+
+            AFJSONKeyPathNode *child = node.indexChildren[@(elementIndex)];
+            size_t elementStart = idx;
+            if (node.wildcardChild && !AFJSONProjectIndexedValue(document, node.wildcardChild, &elementStart, projection, error)) {
+                return NO;
+            }
+
+            size_t elementEnd = elementStart;
+            elementStart = idx;
+            if (child && !AFJSONProjectIndexedValue(document, child, &elementStart, projection, error)) {
+                return NO;
+            } else if (!node.wildcardChild && !child) {
+                elementStart = AFJSONIndexedDocumentValidateValue(document, idx, error);
+                if (elementStart == SIZE_MAX) {
+                    return NO;
+                }
+            }
+
+            idx = node.wildcardChild ? elementEnd : elementStart;
+        }
+    }
+
+    *position = idx + 1;
+
+    return YES;
+}
+
+static NSDictionary * AFJSONProjectionOfData(NSData *data, NSSet <NSString *> *keyPaths, NSJSONReadingOptions readingOptions, BOOL removesKeysWithNullValues, AFJSONKeyTable *keyTable, NSError * __autoreleasing *error) {
+    AFJSONKeyPathNode *root = AFJSONKeyPathTreeWithKeyPaths(keyPaths);
+    NSMutableDictionary *projection = AFJSONEmptyProjection(root);
+
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+    uint32_t *indexes = NULL;
+    if (length < UINT32_MAX && AFJSONBytesAreUTF8(bytes, length)) {
+        if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+            bytes += 3;
+            length -= 3;
+        }
+
+        indexes = malloc(MAX(length, (size_t)1) * sizeof(uint32_t));
+    }
+
+    if (!indexes) {
+        id JSONObject = AFJSONObjectWithJSONSerialization(data, readingOptions, removesKeysWithNullValues, error);
+        if (!JSONObject) {
+            return nil;
+        }
+
+        AFJSONProjectObject(JSONObject, root, projection);
+
+        return AFJSONProjectionByFinishing(projection, root, readingOptions);
+    }
+
+    NSError *projectionError = nil;
+    size_t count = 0;
+    size_t errorOffset = 0;
+    if (!AFJSONIndexStructuralCharacters(bytes, length, indexes, &count, &errorOffset)) {
+        projectionError = AFJSONParsingError(errorOffset < length ? @"Unescaped control character" : @"Unterminated string", errorOffset);
+    } else if (count == 0) {
+        projectionError = AFJSONParsingError(@"No value", 0);
+    } else if (!(readingOptions & NSJSONReadingAllowFragments) && bytes[indexes[0]] != '{' && bytes[indexes[0]] != '[') {
+        projectionError = AFJSONParsingError(@"JSON text did not start with array or object and option to allow fragments not set", indexes[0]);
+    } else {
+        AFJSONByteBuffer scratch = {NULL, 0, 0};
+        AFJSONByteBuffer containers = {NULL, 0, 0};
+        AFJSONObjectBuilder *builder = [[AFJSONObjectBuilder alloc] initWithReadingOptions:readingOptions removesKeysWithNullValues:removesKeysWithNullValues keyTable:keyTable];
+        AFJSONIndexedDocument document = {bytes, length, indexes, count, readingOptions, removesKeysWithNullValues, keyTable, &scratch, builder, &containers};
+        size_t position = 0;
+        if (AFJSONProjectIndexedValue(&document, root, &position, projection, &projectionError) && position != count) {
+            projectionError = AFJSONParsingError(@"Garbage at end", indexes[position]);
+        }
+
+        free(scratch.bytes);
+        free(containers.bytes);
+    }
+
+    free(indexes);
+
+    if (projectionError) {
+        if (error) {
+            *error = projectionError;
+        }
+
+        return nil;
+    }
+
+    return AFJSONProjectionByFinishing(projection, root, readingOptions);
+}
+
+#pragma mark -
+
+@interface AFJSONIncrementalResponseParser : NSObject <AFURLResponseIncrementalParser>
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable;
+
+@end
+
+@implementation AFJSONIncrementalResponseParser {
+    NSJSONReadingOptions _readingOptions;
+    BOOL _removesKeysWithNullValues;
+    AFJSONKeyTable *_keyTable;
+    AFJSONStreamParser *_streamParser;
+    NSMutableData *_bufferedData;
+    BOOL _accumulatesData;
+}
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                              keyTable:(AFJSONKeyTable *)keyTable
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _readingOptions = readingOptions;
+    _removesKeysWithNullValues = removesKeysWithNullValues;
+    _keyTable = keyTable;
+    _bufferedData = [NSMutableData data];
+
+    return self;
+}
+
+- (BOOL)appendDataToStreamParser:(NSData *)data {
+    __block BOOL succeeded = YES;
+    AFJSONStreamParser *streamParser = _streamParser;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        if (![streamParser parseBytes:bytes length:byteRange.length]) {
+            succeeded = NO;
+            *stop = YES;
+        }
+    }];
+
+    return succeeded;
+}
+
+- (BOOL)appendData:(NSData *)data {
+    if (_streamParser) {
+        return [self appendDataToStreamParser:data];
+    }
+
+    [_bufferedData appendData:data];
+    if (_accumulatesData || _bufferedData.length < 4) {
+        return YES;
+    }
+
+    // Only UTF-8 is parsed incrementally; UTF-16 and UTF-32 data is accumulated and parsed with `NSJSONSerialization` when finished.
+    const uint8_t *bytes = _bufferedData.bytes;
+    if (!AFJSONBytesAreUTF8(bytes, _bufferedData.length)) {
+        _accumulatesData = YES;
+
+        return YES;
+    }
+
+    NSUInteger byteOrderMarkLength = (bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) ? 3 : 0;
+    _streamParser = [[AFJSONStreamParser alloc] initWithReadingOptions:_readingOptions removesKeysWithNullValues:_removesKeysWithNullValues keyTable:_keyTable];
+    BOOL succeeded = [_streamParser parseBytes:bytes + byteOrderMarkLength length:_bufferedData.length - byteOrderMarkLength];
+    _bufferedData = nil;
+
+    return succeeded;
+}
+
+- (id)responseObjectByFinishingWithError:(NSError * __autoreleasing *)error {
+    if (_streamParser) {
+        return [_streamParser finishWithError:error];
+    }
+
+    // See `-[AFJSONResponseSerializer responseObjectForResponse:data:error:]`
+    BOOL isSpace = [_bufferedData isEqualToData:[NSData dataWithBytes:" " length:1]];
+    if (_bufferedData.length == 0 || isSpace) {
+        return nil;
+    }
+
+    return AFJSONObjectWithJSONSerialization(_bufferedData, _readingOptions, _removesKeysWithNullValues, error);
+}
+
+@end
+
+#pragma mark -
+
+@interface AFJSONResponseSerializer ()
+@property (readwrite, strong) AFJSONKeyTable *keyTable;
+@end
+
+@implementation AFJSONResponseSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithReadingOptions:(NSJSONReadingOptions)0];
+}
+
++ (instancetype)serializerWithReadingOptions:(NSJSONReadingOptions)readingOptions {
+    AFJSONResponseSerializer *serializer = [[self alloc] init];
+    serializer.readingOptions = readingOptions;
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObjects:@"application/json", @"text/json", @"text/javascript", nil];
+    self.maximumInternedKeyCount = 2048;
+
+    return self;
+}
+
+- (void)setInternsKeys:(BOOL)internsKeys {
+    _internsKeys = internsKeys;
+
+    self.keyTable = internsKeys ? [[AFJSONKeyTable alloc] initWithMaximumKeyCount:self.maximumInternedKeyCount] : nil;
+}
+
+- (void)setMaximumInternedKeyCount:(NSUInteger)maximumInternedKeyCount {
+    _maximumInternedKeyCount = maximumInternedKeyCount;
+
+    self.keyTable = self.internsKeys ? [[AFJSONKeyTable alloc] initWithMaximumKeyCount:maximumInternedKeyCount] : nil;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    // Workaround for behavior of Rails to return a single space for `head :ok` (a workaround for a bug in Safari), which is not interpreted as valid input by NSJSONSerialization.
+    // See https://github.com/rails/rails/issues/1742
+    BOOL isSpace = [data isEqualToData:[NSData dataWithBytes:" " length:1]];
+    
+    if (data.length == 0 || isSpace) {
+        return nil;
+    }
+    
+    NSError *serializationError = nil;
+    
+    id responseObject = nil;
+    if (self.projectedKeyPaths) {
+        responseObject = AFJSONProjectionOfData(data, self.projectedKeyPaths, self.readingOptions, self.removesKeysWithNullValues, self.keyTable, &serializationError);
+    } else if (self.parsesTopLevelArraysConcurrently) {
+        responseObject = AFJSONObjectWithStructuralIndexOfData(data, self.readingOptions, self.removesKeysWithNullValues, self.keyTable, YES, &serializationError);
+    } else {
+        switch (self.parserBackend) {
+            case AFJSONParserBackendVectorized:
+                responseObject = AFJSONObjectWithStructuralIndexOfData(data, self.readingOptions, self.removesKeysWithNullValues, self.keyTable, NO, &serializationError);
+                break;
+            default:
+                responseObject = AFJSONObjectWithJSONSerialization(data, self.readingOptions, self.removesKeysWithNullValues, &serializationError);
+                break;
+        }
+    }
+
+    if (!responseObject)
+    {
+        if (error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+        return nil;
+    }
+
+    return responseObject;
+}
+
+#pragma mark - AFURLResponseIncrementalSerialization
+
+- (id <AFURLResponseIncrementalParser>)incrementalParserForResponse:(NSURLResponse *)response
+                                                               data:(NSData *)data
+{
+    if (!self.parsesIncrementally || self.projectedKeyPaths || ![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFJSONIncrementalResponseParser alloc] initWithReadingOptions:self.readingOptions removesKeysWithNullValues:self.removesKeysWithNullValues keyTable:self.keyTable];
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    self.readingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(readingOptions))] unsignedIntegerValue];
+    self.removesKeysWithNullValues = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))] boolValue];
+    self.parsesIncrementally = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(parsesIncrementally))] boolValue];
+    self.parserBackend = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(parserBackend))] unsignedIntegerValue];
+    NSNumber *maximumInternedKeyCount = [decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(maximumInternedKeyCount))];
+    if (maximumInternedKeyCount) {
+        self.maximumInternedKeyCount = [maximumInternedKeyCount unsignedIntegerValue];
+    }
+    self.internsKeys = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(internsKeys))] boolValue];
+    self.parsesTopLevelArraysConcurrently = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(parsesTopLevelArraysConcurrently))] boolValue];
+    self.projectedKeyPaths = [decoder decodeObjectOfClasses:[NSSet setWithObjects:[NSSet class], [NSString class], nil] forKey:NSStringFromSelector(@selector(projectedKeyPaths))];
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeObject:@(self.readingOptions) forKey:NSStringFromSelector(@selector(readingOptions))];
+    [coder encodeObject:@(self.removesKeysWithNullValues) forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))];
+    [coder encodeObject:@(self.parsesIncrementally) forKey:NSStringFromSelector(@selector(parsesIncrementally))];
+    [coder encodeObject:@(self.parserBackend) forKey:NSStringFromSelector(@selector(parserBackend))];
+    [coder encodeObject:@(self.maximumInternedKeyCount) forKey:NSStringFromSelector(@selector(maximumInternedKeyCount))];
+    [coder encodeObject:@(self.internsKeys) forKey:NSStringFromSelector(@selector(internsKeys))];
+    [coder encodeObject:@(self.parsesTopLevelArraysConcurrently) forKey:NSStringFromSelector(@selector(parsesTopLevelArraysConcurrently))];
+    [coder encodeObject:self.projectedKeyPaths forKey:NSStringFromSelector(@selector(projectedKeyPaths))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFJSONResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.readingOptions = self.readingOptions;
+    serializer.removesKeysWithNullValues = self.removesKeysWithNullValues;
+    serializer.parsesIncrementally = self.parsesIncrementally;
+    serializer.parserBackend = self.parserBackend;
+    serializer.maximumInternedKeyCount = self.maximumInternedKeyCount;
+    serializer.internsKeys = self.internsKeys;
+    serializer.parsesTopLevelArraysConcurrently = self.parsesTopLevelArraysConcurrently;
+    serializer.projectedKeyPaths = self.projectedKeyPaths;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+@interface AFJSONModelProperty () <NSCopying>
+@property (readwrite, nonatomic, copy) NSString *name;
+@property (readwrite, nonatomic, copy) NSString *JSONKeyPath;
+@property (readwrite, nonatomic, assign) AFJSONModelPropertyType type;
+@property (readwrite, nonatomic, strong) Class modelClass;
+@property (readwrite, nonatomic, strong) id defaultValue;
+
+- (void)resolveSetterOfModelClass:(Class)modelClass;
+@end
+
+@implementation AFJSONModelProperty {
+    SEL _setter;
+    char _typeEncoding;
+}
+
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                            type:(AFJSONModelPropertyType)type
+{
+    return [self propertyWithName:name JSONKeyPath:JSONKeyPath type:type defaultValue:nil];
+}
+
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                            type:(AFJSONModelPropertyType)type
+                    defaultValue:(id)defaultValue
+{
+    NSParameterAssert(type != AFJSONModelPropertyTypeModel && type != AFJSONModelPropertyTypeModelArray);
+
+    AFJSONModelProperty *property = [[self alloc] init];
+    property.name = name;
+    property.JSONKeyPath = JSONKeyPath;
+    property.type = type;
+    property.defaultValue = defaultValue;
+
+    return property;
+}
+
++ (instancetype)propertyWithName:(NSString *)name
+                     JSONKeyPath:(NSString *)JSONKeyPath
+                      modelClass:(Class)modelClass
+{
+    AFJSONModelProperty *property = [[self alloc] init];
+    property.name = name;
+    property.JSONKeyPath = JSONKeyPath;
+    property.type = AFJSONModelPropertyTypeModel;
+    property.modelClass = modelClass;
+
+    return property;
+}
+
++ (instancetype)arrayPropertyWithName:(NSString *)name
+                          JSONKeyPath:(NSString *)JSONKeyPath
+                           modelClass:(Class)modelClass
+{
+    AFJSONModelProperty *property = [self propertyWithName:name JSONKeyPath:JSONKeyPath modelClass:modelClass];
+    property.type = AFJSONModelPropertyTypeModelArray;
+
+    return property;
+}
+
+// Properties that are not declared, are read-only, or whose scalar type does not match their JSON value, are set with key-value coding.
+- (void)resolveSetterOfModelClass:(Class)modelClass {
+    _setter = NULL;
+    _typeEncoding = '\0';
+
+    objc_property_t runtimeProperty = class_getProperty(modelClass, [self.name UTF8String]);
+    if (!runtimeProperty) {
+        return;
+    }
+
+    char *readonly = property_copyAttributeValue(runtimeProperty, "R");
+    char *typeEncoding = property_copyAttributeValue(runtimeProperty, "T");
+    char *setterName = property_copyAttributeValue(runtimeProperty, "S");
+
+    BOOL isObject = typeEncoding && typeEncoding[0] == '@';
+    BOOL isNumber = self.type == AFJSONModelPropertyTypeNumber || self.type == AFJSONModelPropertyTypeBoolean;
+    if (!readonly && typeEncoding && (isObject || isNumber)) {
+        SEL setter = setterName ? sel_registerName(setterName) : NSSelectorFromString([NSString stringWithFormat:@"set%@%@:", [[self.name substringToIndex:1] uppercaseString], [self.name substringFromIndex:1]]);
+        if ([modelClass instancesRespondToSelector:setter]) {
+            _setter = setter;
+            _typeEncoding = typeEncoding[0];
+        }
+    }
+
+    free(readonly);
+    free(typeEncoding);
+    free(setterName);
+}
+
+static void AFJSONModelPropertySetValue(AFJSONModelProperty *property, id model, id value) {
+    SEL setter = property->_setter;
+    switch (setter ? property->_typeEncoding : '\0') {
+        case '@':
+            ((void (*)(id, SEL, id))objc_msgSend)(model, setter, value);
+            break;
+        case 'c':
+            ((void (*)(id, SEL, char))objc_msgSend)(model, setter, [value charValue]);
+            break;
+        case 'C':
+            ((void (*)(id, SEL, unsigned char))objc_msgSend)(model, setter, [value unsignedCharValue]);
+            break;
+        case 'B':
+            ((void (*)(id, SEL, bool))objc_msgSend)(model, setter, [value boolValue]);
+            break;
+        case 's':
+            ((void (*)(id, SEL, short))objc_msgSend)(model, setter, [value shortValue]);
+            break;
+        case 'S':
+            ((void (*)(id, SEL, unsigned short))objc_msgSend)(model, setter, [value unsignedShortValue]);
+            break;
+        case 'i':
+            ((void (*)(id, SEL, int))objc_msgSend)(model, setter, [value intValue]);
+            break;
+        case 'I':
+            ((void (*)(id, SEL, unsigned int))objc_msgSend)(model, setter, [value unsignedIntValue]);
+            break;
+        case 'l':
+            ((void (*)(id, SEL, long))objc_msgSend)(model, setter, [value longValue]);
+            break;
+        case 'L':
+            ((void (*)(id, SEL, unsigned long))objc_msgSend)(model, setter, [value unsignedLongValue]);
+            break;
+        case 'q':
+            ((void (*)(id, SEL, long long))objc_msgSend)(model, setter, [value longLongValue]);
+            break;
+        case 'Q':
+            ((void (*)(id, SEL, unsigned long long))objc_msgSend)(model, setter, [value unsignedLongLongValue]);
+            break;
+        case 'f':
+            ((void (*)(id, SEL, float))objc_msgSend)(model, setter, [value floatValue]);
+            break;
+        case 'd':
+            ((void (*)(id, SEL, double))objc_msgSend)(model, setter, [value doubleValue]);
+            break;
+        default:
+            [model setValue:value forKey:property.name];
+            break;
+    }
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFJSONModelProperty *property = [[[self class] allocWithZone:zone] init];
+    property.name = self.name;
+    property.JSONKeyPath = self.JSONKeyPath;
+    property.type = self.type;
+    property.modelClass = self.modelClass;
+    property.defaultValue = self.defaultValue;
+
+    return property;
+}
+
+@end
+
+#pragma mark -
+
+/**
+ `AFJSONModelSchemaNode` is a node of the tree that the key paths of the properties of a schema are compiled into, with each key leading either to a property, or to the node for the keys nested below it.
+ */
+@interface AFJSONModelSchemaNode : NSObject
+@property (nonatomic, strong) NSMutableArray <NSString *> *keys;
+@property (nonatomic, strong) NSMutableArray <NSData *> *keyData;
+@property (nonatomic, strong) NSMutableArray *targets;
+@end
+
+@implementation AFJSONModelSchemaNode
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.keys = [NSMutableArray array];
+    self.keyData = [NSMutableArray array];
+    self.targets = [NSMutableArray array];
+
+    return self;
+}
+
+- (id)targetForKey:(NSString *)key {
+    NSUInteger idx = [self.keys indexOfObject:key];
+
+    return idx != NSNotFound ? self.targets[idx] : nil;
+}
+
+// The first property declared for a key path wins over any later property for the same key path, or one nested below it.
+- (void)addProperty:(AFJSONModelProperty *)property {
+    AFJSONModelSchemaNode *node = self;
+    NSArray *components = [property.JSONKeyPath componentsSeparatedByString:@"."];
+    for (NSUInteger idx = 0; idx < components.count; idx++) {
+        NSString *key = components[idx];
+        id target = [node targetForKey:key];
+        BOOL isLastComponent = idx == components.count - 1;
+        if (!target) {
+            target = isLastComponent ? property : [[AFJSONModelSchemaNode alloc] init];
+            [node.keys addObject:key];
+            [node.keyData addObject:[key dataUsingEncoding:NSUTF8StringEncoding]];
+            [node.targets addObject:target];
+        }
+
+        if (isLastComponent || ![target isKindOfClass:[AFJSONModelSchemaNode class]]) {
+            return;
+        }
+
+        node = target;
+    }
+}
+
+@end
+
+#pragma mark -
+
+@interface AFJSONModelSchema ()
+@property (readwrite, nonatomic, strong) Class modelClass;
+@property (readwrite, nonatomic, copy) NSArray <AFJSONModelProperty *> *properties;
+@property (readwrite, nonatomic, strong) AFJSONModelSchemaNode *rootNode;
+@property (readwrite, nonatomic, copy) NSArray <AFJSONModelProperty *> *defaultedProperties;
+@end
+
+@implementation AFJSONModelSchema
+
++ (instancetype)schemaWithModelClass:(Class)modelClass
+                          properties:(NSArray <AFJSONModelProperty *> *)properties
+{
+    NSParameterAssert(modelClass);
+
+    AFJSONModelSchema *schema = [[self alloc] init];
+    schema.modelClass = modelClass;
+
+    NSMutableArray *mutableProperties = [NSMutableArray arrayWithCapacity:properties.count];
+    NSMutableArray *mutableDefaultedProperties = [NSMutableArray array];
+    schema.rootNode = [[AFJSONModelSchemaNode alloc] init];
+    for (AFJSONModelProperty *property in properties) {
+        AFJSONModelProperty *resolvedProperty = [property copy];
+        [resolvedProperty resolveSetterOfModelClass:modelClass];
+        [schema.rootNode addProperty:resolvedProperty];
+        [mutableProperties addObject:resolvedProperty];
+
+        if (resolvedProperty.defaultValue) {
+            [mutableDefaultedProperties addObject:resolvedProperty];
+        }
+    }
+
+    schema.properties = mutableProperties;
+    schema.defaultedProperties = mutableDefaultedProperties;
+
+    return schema;
+}
+
+static NSMapTable * AFJSONModelSchemaRegistry() {
+    static NSMapTable *_registry = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _registry = [NSMapTable strongToStrongObjectsMapTable];
+    });
+
+    return _registry;
+}
+
+static NSLock * AFJSONModelSchemaRegistryLock() {
+    static NSLock *_lock = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _lock = [[NSLock alloc] init];
+    });
+
+    return _lock;
+}
+
++ (void)registerSchema:(AFJSONModelSchema *)schema {
+    NSParameterAssert(schema);
+
+    [AFJSONModelSchemaRegistryLock() lock];
+    [AFJSONModelSchemaRegistry() setObject:schema forKey:schema.modelClass];
+    [AFJSONModelSchemaRegistryLock() unlock];
+}
+
++ (AFJSONModelSchema *)registeredSchemaForModelClass:(Class)modelClass {
+    if (!modelClass) {
+        return nil;
+    }
+
+    [AFJSONModelSchemaRegistryLock() lock];
+    AFJSONModelSchema *schema = [AFJSONModelSchemaRegistry() objectForKey:modelClass];
+    [AFJSONModelSchemaRegistryLock() unlock];
+
+    return schema;
+}
+
+@end
+
+#pragma mark -
+
+static BOOL AFJSONIndexedDocumentKeyAtIndexIsEqual(const AFJSONIndexedDocument *document, size_t idx, NSData *keyData, NSString *key) {
+    const uint8_t *keyBytes = document->bytes + document->indexes[idx] + 1;
+    size_t keyLength = document->indexes[idx + 1] - document->indexes[idx] - 1;
+    if (!memchr(keyBytes, '\\', keyLength)) {
+        return keyData.length == keyLength && memcmp(keyData.bytes, keyBytes, keyLength) == 0;
+    }
+
+    return [AFJSONStringWithBytes(keyBytes, keyLength, YES, NO, document->scratch) isEqualToString:key];
+}
+
+// Scalars run from their first byte to the next structural character, without any whitespace before it.
+static BOOL AFJSONIndexedDocumentScalarAtIndexIsEqual(const AFJSONIndexedDocument *document, size_t idx, const char *scalar) {
+    size_t start = document->indexes[idx];
+    size_t end = idx + 1 < document->count ? document->indexes[idx + 1] : document->length;
+    while (end > start && AFJSONIsWhitespace(document->bytes[end - 1])) {
+        end--;
+    }
+
+    return end - start == strlen(scalar) && memcmp(document->bytes + start, scalar, end - start) == 0;
+}
+
+// Returns the position of the value at the key path of the object at `position`, or `SIZE_MAX` if there is none.
+static size_t AFJSONIndexedDocumentPositionOfKeyPath(const AFJSONIndexedDocument *document, size_t position, NSString *keyPath) {
+    for (NSString *key in [keyPath componentsSeparatedByString:@"."]) {
+        if (AFJSONIndexedDocumentByteAtIndex(document, position) != '{') {
+            return SIZE_MAX;
+        }
+
+        NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+        size_t idx = position + 1;
+        position = SIZE_MAX;
+        while (AFJSONIndexedDocumentByteAtIndex(document, idx) == '"' && AFJSONIndexedDocumentByteAtIndex(document, idx + 2) == ':') {
+            if (AFJSONIndexedDocumentKeyAtIndexIsEqual(document, idx, keyData, key)) {
+                position = idx + 3;
+                break;
+            }
+
+            idx = AFJSONIndexedDocumentSkipValue(document, idx + 3);
+            if (AFJSONIndexedDocumentByteAtIndex(document, idx) != ',') {
+                break;
+            }
+
+            idx++;
+        }
+
+        if (position == SIZE_MAX) {
+            return SIZE_MAX;
+        }
+    }
+
+    return position;
+}
+
+static NSError * AFJSONModelTypeMismatchError(const AFJSONIndexedDocument *document, size_t idx, NSString *expectedValue, NSString *keyPath) {
+    return AFJSONParsingError([NSString stringWithFormat:@"Expected %@ for key path \"%@\"", expectedValue, keyPath], AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+}
+
+// Models can refer to their own class, so decoding stops at the same depth as `NSJSONSerialization`, before the stack can run out.
+static NSUInteger const AFJSONModelMaximumDepth = 512;
+
+static NSError * AFJSONModelMaximumDepthError(const AFJSONIndexedDocument *document, size_t idx) {
+    return AFJSONParsingError(@"Too many nested arrays or dictionaries", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+}
+
+static id AFJSONModelWithSchema(const AFJSONIndexedDocument *document, AFJSONModelSchema *schema, NSUInteger depth, size_t *position, NSError * __autoreleasing *error);
+
+static NSArray * AFJSONModelsWithSchema(const AFJSONIndexedDocument *document, AFJSONModelSchema *schema, NSString *keyPath, NSUInteger depth, size_t *position, NSError * __autoreleasing *error) {
+    if (depth >= AFJSONModelMaximumDepth) {
+        *error = AFJSONModelMaximumDepthError(document, *position);
+        return nil;
+    }
+
+    NSMutableArray *models = [NSMutableArray array];
+    size_t idx = *position + 1;
+    if (AFJSONIndexedDocumentByteAtIndex(document, idx) != ']') {
+        while (YES) {
+            uint8_t c = AFJSONIndexedDocumentByteAtIndex(document, idx);
+            if (c == '{') {
+                id model = AFJSONModelWithSchema(document, schema, depth + 1, &idx, error);
+                if (!model) {
+                    return nil;
+                }
+
+                [models addObject:model];
+            } else if (c == 'n' && AFJSONIndexedDocumentScalarAtIndexIsEqual(document, idx, "null")) {
+                idx++;
+            } else {
+                *error = AFJSONModelTypeMismatchError(document, idx, @"an array of objects", keyPath);
+                return nil;
+            }
+
+            c = AFJSONIndexedDocumentByteAtIndex(document, idx);
+            if (c == ']') {
+                break;
+            } else if (c != ',') {
+                *error = AFJSONParsingError(@"Badly formed array", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                return nil;
+            }
+
+            idx++;
+        }
+    }
+
+    *position = idx + 1;
+
+    return [NSArray arrayWithArray:models];
+}
+
+static BOOL AFJSONModelPropertyValue(const AFJSONIndexedDocument *document, AFJSONModelProperty *property, NSUInteger depth, size_t *position, id __autoreleasing *value, NSError * __autoreleasing *error) {
+    size_t idx = *position;
+    uint8_t c = AFJSONIndexedDocumentByteAtIndex(document, idx);
+    if (c == 'n' && AFJSONIndexedDocumentScalarAtIndexIsEqual(document, idx, "null")) {
+        *value = nil;
+        *position = idx + 1;
+        return YES;
+    }
+
+    switch (property.type) {
+        case AFJSONModelPropertyTypeString:
+        case AFJSONModelPropertyTypeURL: {
+            if (c != '"') {
+                *error = AFJSONModelTypeMismatchError(document, idx, @"a string", property.JSONKeyPath);
+                return NO;
+            }
+
+            const uint8_t *stringBytes = document->bytes + document->indexes[idx] + 1;
+            size_t stringLength = document->indexes[idx + 1] - document->indexes[idx] - 1;
+            NSString *string = AFJSONStringWithBytes(stringBytes, stringLength, memchr(stringBytes, '\\', stringLength) != NULL, NO, document->scratch);
+            if (!string) {
+                *error = AFJSONParsingError(@"Unable to convert data to string", document->indexes[idx]);
+                return NO;
+            }
+
+            *value = property.type == AFJSONModelPropertyTypeURL ? [NSURL URLWithString:string] : string;
+            *position = idx + 2;
+            return YES;
+        }
+        case AFJSONModelPropertyTypeNumber: {
+            if (c != '-' && (c < '0' || c > '9')) {
+                *error = AFJSONModelTypeMismatchError(document, idx, @"a number", property.JSONKeyPath);
+                return NO;
+            }
+
+            size_t start = document->indexes[idx];
+            size_t end = idx + 1 < document->count ? document->indexes[idx + 1] : document->length;
+            while (end > start && AFJSONIsWhitespace(document->bytes[end - 1])) {
+                end--;
+            }
+
+            NSNumber *number = AFJSONNumberFromBytes(document->bytes + start, end - start);
+            if (!number) {
+                *error = AFJSONParsingError(@"Invalid number", start);
+                return NO;
+            }
+
+            *value = number;
+            *position = idx + 1;
+            return YES;
+        }
+        case AFJSONModelPropertyTypeBoolean:
+            if (c == 't' && AFJSONIndexedDocumentScalarAtIndexIsEqual(document, idx, "true")) {
+                *value = @YES;
+            } else if (c == 'f' && AFJSONIndexedDocumentScalarAtIndexIsEqual(document, idx, "false")) {
+                *value = @NO;
+            } else {
+                *error = AFJSONModelTypeMismatchError(document, idx, @"a boolean", property.JSONKeyPath);
+                return NO;
+            }
+
+            *position = idx + 1;
+            return YES;
+        case AFJSONModelPropertyTypeModel:
+        case AFJSONModelPropertyTypeModelArray: {
+            BOOL isArray = property.type == AFJSONModelPropertyTypeModelArray;
+            if (c != (isArray ? '[' : '{')) {
+                *error = AFJSONModelTypeMismatchError(document, idx, isArray ? @"an array of objects" : @"an object", property.JSONKeyPath);
+                return NO;
+            }
+
+            AFJSONModelSchema *schema = [AFJSONModelSchema registeredSchemaForModelClass:property.modelClass];
+            if (!schema) {
+                *error = AFJSONParsingError([NSString stringWithFormat:@"No schema registered for %@", NSStringFromClass(property.modelClass)], document->indexes[idx]);
+                return NO;
+            }
+
+            *value = isArray ? AFJSONModelsWithSchema(document, schema, property.JSONKeyPath, depth, position, error) : AFJSONModelWithSchema(document, schema, depth, position, error);
+            return *value != nil;
+        }
+    }
+
+    return NO;
+}
+
+static BOOL AFJSONModelSetMembers(const AFJSONIndexedDocument *document, AFJSONModelSchemaNode *node, id model, NSUInteger depth, size_t *position, NSError * __autoreleasing *error) {
+    if (depth >= AFJSONModelMaximumDepth) {
+        *error = AFJSONModelMaximumDepthError(document, *position);
+        return NO;
+    }
+
+    size_t idx = *position + 1;
+    if (AFJSONIndexedDocumentByteAtIndex(document, idx) != '}') {
+        NSArray *keys = node.keys;
+        NSArray *keyData = node.keyData;
+        NSArray *targets = node.targets;
+        NSUInteger keyCount = keys.count;
+
+        while (YES) {
+            if (AFJSONIndexedDocumentByteAtIndex(document, idx) != '"' || AFJSONIndexedDocumentByteAtIndex(document, idx + 2) != ':') {
+                *error = AFJSONParsingError(@"Badly formed object", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                return NO;
+            }
+
+            id target = nil;
+            for (NSUInteger keyIndex = 0; keyIndex < keyCount; keyIndex++) {
+                if (AFJSONIndexedDocumentKeyAtIndexIsEqual(document, idx, keyData[keyIndex], keys[keyIndex])) {
+                    target = targets[keyIndex];
+                    break;
+                }
+            }
+
+            idx += 3;
+
+            if ([target isKindOfClass:[AFJSONModelProperty class]]) {
+                id value = nil;
+                if (!AFJSONModelPropertyValue(document, target, depth + 1, &idx, &value, error)) {
+                    return NO;
+                }
+
+                if (value) {
+                    AFJSONModelPropertySetValue(target, model, value);
+                }
+            } else if (target && AFJSONIndexedDocumentByteAtIndex(document, idx) == '{') {
+                if (!AFJSONModelSetMembers(document, target, model, depth + 1, &idx, error)) {
+                    return NO;
+                }
+            } else {
+                // The document has already been validated as a whole.
+                idx = AFJSONIndexedDocumentSkipValue(document, idx);
+            }
+
+            uint8_t c = AFJSONIndexedDocumentByteAtIndex(document, idx);
+            if (c == '}') {
+                break;
+            } else if (c != ',') {
+                *error = AFJSONParsingError(@"Badly formed object", AFJSONIndexedDocumentOffsetAtIndex(document, idx));
+                return NO;
+            }
+
+            idx++;
+        }
+    }
+
+    *position = idx + 1;
+
+    return YES;
+}
+
+static id AFJSONModelWithSchema(const AFJSONIndexedDocument *document, AFJSONModelSchema *schema, NSUInteger depth, size_t *position, NSError * __autoreleasing *error) {
+    id model = [[schema.modelClass alloc] init];
+    for (AFJSONModelProperty *property in schema.defaultedProperties) {
+        AFJSONModelPropertySetValue(property, model, property.defaultValue);
+    }
+
+    if (!AFJSONModelSetMembers(document, schema.rootNode, model, depth, position, error)) {
+        return nil;
+    }
+
+    return model;
+}
+
+static id AFJSONModelsOfData(NSData *data, AFJSONModelSchema *schema, NSString *rootKeyPath, NSError * __autoreleasing *error) {
+    // Other encodings are converted to UTF-8, so that they can be indexed.
+    if (!AFJSONBytesAreUTF8(data.bytes, data.length)) {
+        id JSONObject = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)0 error:error];
+        data = JSONObject ? [NSJSONSerialization dataWithJSONObject:JSONObject options:(NSJSONWritingOptions)0 error:error] : nil;
+        if (!data) {
+            return nil;
+        }
+    }
+
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        bytes += 3;
+        length -= 3;
+    }
+
+    uint32_t *indexes = length < UINT32_MAX ? malloc(MAX(length, (size_t)1) * sizeof(uint32_t)) : NULL;
+    if (!indexes) {
+        *error = AFJSONParsingError(@"Unable to allocate memory", 0);
+        return nil;
+    }
+
+    NSError *modelError = nil;
+    size_t count = 0;
+    size_t errorOffset = 0;
+    if (!AFJSONIndexStructuralCharacters(bytes, length, indexes, &count, &errorOffset)) {
+        modelError = AFJSONParsingError(errorOffset < length ? @"Unescaped control character" : @"Unterminated string", errorOffset);
+    } else if (count == 0) {
+        modelError = AFJSONParsingError(@"No value", 0);
+    }
+
+    // The whole document is validated up front, so that the values that are skipped while decoding, because no property is mapped to them, are checked as fully as parsing them would.
+    AFJSONByteBuffer scratch = {NULL, 0, 0};
+    AFJSONByteBuffer containers = {NULL, 0, 0};
+    AFJSONIndexedDocument document = {bytes, length, indexes, count, (NSJSONReadingOptions)0, NO, nil, &scratch, nil, &containers};
+    if (!modelError) {
+        size_t end = AFJSONIndexedDocumentValidateValue(&document, 0, &modelError);
+        if (end != SIZE_MAX && end != count) {
+            modelError = AFJSONParsingError(@"Garbage at end", indexes[end]);
+        }
+    }
+
+    size_t position = 0;
+    if (!modelError && rootKeyPath.length > 0) {
+        position = AFJSONIndexedDocumentPositionOfKeyPath(&document, 0, rootKeyPath);
+        if (position == SIZE_MAX) {
+            modelError = AFJSONParsingError([NSString stringWithFormat:@"No value for key path \"%@\"", rootKeyPath], indexes[0]);
+        }
+    }
+
+    id responseObject = nil;
+    if (!modelError) {
+        uint8_t c = AFJSONIndexedDocumentByteAtIndex(&document, position);
+        if (c == '{') {
+            responseObject = AFJSONModelWithSchema(&document, schema, 0, &position, &modelError);
+        } else if (c == '[') {
+            responseObject = AFJSONModelsWithSchema(&document, schema, rootKeyPath ?: @"", 0, &position, &modelError);
+        } else if (!(c == 'n' && AFJSONIndexedDocumentScalarAtIndexIsEqual(&document, position, "null"))) {
+            modelError = AFJSONModelTypeMismatchError(&document, position, @"an object or an array of objects", rootKeyPath ?: @"");
+        }
+    }
+
+    free(scratch.bytes);
+    free(containers.bytes);
+    free(indexes);
+
+    if (modelError) {
+        *error = modelError;
+    }
+
+    return responseObject;
+}
+
+@implementation AFJSONModelResponseSerializer
+
++ (instancetype)serializerWithModelClass:(Class)modelClass
+                             rootKeyPath:(NSString *)rootKeyPath
+{
+    AFJSONModelResponseSerializer *serializer = [[self alloc] init];
+    serializer.modelClass = modelClass;
+    serializer.rootKeyPath = rootKeyPath;
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObjects:@"application/json", @"text/json", @"text/javascript", nil];
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    if (data.length == 0 || [data isEqualToData:[NSData dataWithBytes:" " length:1]]) {
+        return nil;
+    }
+
+    NSError *serializationError = nil;
+    id responseObject = nil;
+
+    AFJSONModelSchema *schema = [AFJSONModelSchema registeredSchemaForModelClass:self.modelClass];
+    if (!schema) {
+        NSDictionary *userInfo = @{
+                                   NSLocalizedDescriptionKey: NSLocalizedStringFromTable(@"Request failed: no model schema", @"AFNetworking", nil),
+                                   NSLocalizedFailureReasonErrorKey: [NSString stringWithFormat:NSLocalizedStringFromTable(@"No schema is registered for the model class %@.", @"AFNetworking", nil), NSStringFromClass(self.modelClass)],
+                                   };
+        serializationError = [NSError errorWithDomain:AFURLResponseSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+    } else {
+        responseObject = AFJSONModelsOfData(data, schema, self.rootKeyPath, &serializationError);
+    }
+
+    if (serializationError) {
+        if (error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+
+        return nil;
+    }
+
+    return responseObject;
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    NSString *modelClassName = [decoder decodeObjectOfClass:[NSString class] forKey:NSStringFromSelector(@selector(modelClass))];
+    self.modelClass = modelClassName ? NSClassFromString(modelClassName) : nil;
+    self.rootKeyPath = [decoder decodeObjectOfClass:[NSString class] forKey:NSStringFromSelector(@selector(rootKeyPath))];
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeObject:self.modelClass ? NSStringFromClass(self.modelClass) : nil forKey:NSStringFromSelector(@selector(modelClass))];
+    [coder encodeObject:self.rootKeyPath forKey:NSStringFromSelector(@selector(rootKeyPath))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFJSONModelResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.modelClass = self.modelClass;
+    serializer.rootKeyPath = self.rootKeyPath;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+static NSUInteger const AFDefaultMaximumLineLength = 16 * 1024 * 1024;
+
+static NSError * AFLineTooLongError(NSUInteger lineNumber, NSUInteger maximumLineLength) {
+    NSDictionary *userInfo = @{
+                               NSLocalizedDescriptionKey: NSLocalizedStringFromTable(@"Request failed: line too long", @"AFNetworking", nil),
+                               NSLocalizedFailureReasonErrorKey: [NSString stringWithFormat:NSLocalizedStringFromTable(@"Line %lu is longer than %lu bytes.", @"AFNetworking", nil), (unsigned long)lineNumber, (unsigned long)maximumLineLength],
+                               };
+
+    return [[NSError alloc] initWithDomain:AFURLResponseSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:userInfo];
+}
+
+// Batches handed to a block are delivered asynchronously, so parsing waits for the block once this many are pending, rather than decoding records faster than they are handled.
+static long const AFJSONLinesMaximumPendingBatchCount = 4;
+
+/**
+ `AFJSONLinesParser` splits newline-delimited JSON into lines as chunks of data are appended, decoding each line in place as soon as it is complete. Only a line that spans chunks is copied, into a buffer that is reused for the next one, and fails the parse once it is longer than the maximum line length. Decoded values are either kept for the response object, or handed to a block in batches, if there is one.
+ */
+@interface AFJSONLinesParser : NSObject <AFURLResponseIncrementalParser>
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                     maximumLineLength:(NSUInteger)maximumLineLength
+                             batchSize:(NSUInteger)batchSize
+                                 queue:(dispatch_queue_t)queue
+                        recordsHandler:(void (^)(NSArray *records))recordsHandler;
+
+@end
+
+@implementation AFJSONLinesParser {
+    NSJSONReadingOptions _readingOptions;
+    BOOL _removesKeysWithNullValues;
+    NSUInteger _maximumLineLength;
+    NSUInteger _batchSize;
+    dispatch_queue_t _queue;
+    void (^_recordsHandler)(NSArray *);
+    dispatch_group_t _deliveryGroup;
+    dispatch_semaphore_t _pendingBatchesSemaphore;
+
+    NSMutableData *_partialLine;
+    NSMutableArray *_records;
+    NSUInteger _numberOfLines;
+    NSError *_error;
+}
+
+- (instancetype)initWithReadingOptions:(NSJSONReadingOptions)readingOptions
+             removesKeysWithNullValues:(BOOL)removesKeysWithNullValues
+                     maximumLineLength:(NSUInteger)maximumLineLength
+                             batchSize:(NSUInteger)batchSize
+                                 queue:(dispatch_queue_t)queue
+                        recordsHandler:(void (^)(NSArray *records))recordsHandler
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _readingOptions = readingOptions | NSJSONReadingAllowFragments;
+    _removesKeysWithNullValues = removesKeysWithNullValues;
+    _maximumLineLength = maximumLineLength;
+    _batchSize = batchSize > 0 ? batchSize : NSUIntegerMax;
+    _queue = queue ?: dispatch_get_main_queue();
+    _recordsHandler = [recordsHandler copy];
+    _deliveryGroup = dispatch_group_create();
+    _pendingBatchesSemaphore = dispatch_semaphore_create(AFJSONLinesMaximumPendingBatchCount);
+    _partialLine = [NSMutableData data];
+    _records = [NSMutableArray array];
+
+    return self;
+}
+
+- (void)deliverRecords {
+    if (!_recordsHandler || [_records count] == 0) {
+        return;
+    }
+
+    NSArray *records = [_records copy];
+    [_records removeAllObjects];
+
+    dispatch_semaphore_t pendingBatchesSemaphore = _pendingBatchesSemaphore;
+    dispatch_semaphore_wait(pendingBatchesSemaphore, DISPATCH_TIME_FOREVER);
+
+    void (^recordsHandler)(NSArray *) = _recordsHandler;
+    dispatch_group_async(_deliveryGroup, _queue, ^{
+        recordsHandler(records);
+        dispatch_semaphore_signal(pendingBatchesSemaphore);
+    });
+}
+
+- (BOOL)parseLineBytes:(const uint8_t *)bytes
+                length:(NSUInteger)length
+{
+    _numberOfLines++;
+
+    if (_numberOfLines == 1 && length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        bytes += 3;
+        length -= 3;
+    }
+
+    if (length > 0 && bytes[length - 1] == '\r') {
+        length--;
+    }
+
+    NSUInteger idx = 0;
+    while (idx < length && (bytes[idx] == ' ' || bytes[idx] == '\t')) {
+        idx++;
+    }
+
+    if (idx == length) {
+        return YES;
+    }
+
+    NSError *serializationError = nil;
+    NSData *line = [NSData dataWithBytesNoCopy:(void *)bytes length:length freeWhenDone:NO];
+    id record = AFJSONObjectWithJSONSerialization(line, _readingOptions, _removesKeysWithNullValues, &serializationError);
+    if (!record) {
+        NSMutableDictionary *mutableUserInfo = [NSMutableDictionary dictionary];
+        mutableUserInfo[NSLocalizedFailureReasonErrorKey] = [NSString stringWithFormat:NSLocalizedStringFromTable(@"Invalid JSON on line %lu.", @"AFNetworking", nil), (unsigned long)_numberOfLines];
+        if (serializationError) {
+            mutableUserInfo[NSUnderlyingErrorKey] = serializationError;
+        }
+        _error = [[NSError alloc] initWithDomain:AFURLResponseSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:mutableUserInfo];
+
+        return NO;
+    }
+
+    [_records addObject:record];
+    if ([_records count] >= _batchSize) {
+        [self deliverRecords];
+    }
+
+    return YES;
+}
+
+- (BOOL)parseBytes:(const uint8_t *)bytes
+            length:(NSUInteger)length
+{
+    const uint8_t *end = bytes + length;
+    while (bytes < end) {
+        const uint8_t *newline = memchr(bytes, '\n', (size_t)(end - bytes));
+        if ([_partialLine length] + (NSUInteger)((newline ?: end) - bytes) > _maximumLineLength) {
+            _error = AFLineTooLongError(_numberOfLines + 1, _maximumLineLength);
+            return NO;
+        }
+
+        if (!newline) {
+            [_partialLine appendBytes:bytes length:(NSUInteger)(end - bytes)];
+            return YES;
+        }
+
+        BOOL succeeded = NO;
+        if ([_partialLine length] > 0) {
+            [_partialLine appendBytes:bytes length:(NSUInteger)(newline - bytes)];
+            succeeded = [self parseLineBytes:[_partialLine bytes] length:[_partialLine length]];
+            [_partialLine setLength:0];
+        } else {
+            succeeded = [self parseLineBytes:bytes length:(NSUInteger)(newline - bytes)];
+        }
+
+        if (!succeeded) {
+            return NO;
+        }
+
+        bytes = newline + 1;
+    }
+
+    return YES;
+}
+
+#pragma mark - AFURLResponseIncrementalParser
+
+- (BOOL)appendData:(NSData *)data {
+    if (_error) {
+        return NO;
+    }
+
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        if (![self parseBytes:bytes length:byteRange.length]) {
+            *stop = YES;
+        }
+    }];
+
+    [self deliverRecords];
+
+    return _error == nil;
+}
+
+- (id)responseObjectByFinishingWithError:(NSError * __autoreleasing *)error {
+    if (!_error && [_partialLine length] > 0) {
+        [self parseLineBytes:[_partialLine bytes] length:[_partialLine length]];
+    }
+    _partialLine = nil;
+
+    [self deliverRecords];
+    dispatch_group_wait(_deliveryGroup, DISPATCH_TIME_FOREVER);
+
+    if (_error) {
+        if (error) {
+            *error = _error;
+        }
+
+        return nil;
+    }
+
+    return _recordsHandler ? nil : [_records copy];
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFJSONLinesResponseSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithReadingOptions:(NSJSONReadingOptions)0];
+}
+
++ (instancetype)serializerWithReadingOptions:(NSJSONReadingOptions)readingOptions {
+    AFJSONLinesResponseSerializer *serializer = [[self alloc] init];
+    serializer.readingOptions = readingOptions;
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObjects:@"application/x-ndjson", @"application/ndjson", @"application/jsonl", @"application/x-jsonlines", nil];
+    self.maximumLineLength = AFDefaultMaximumLineLength;
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    AFJSONLinesParser *parser = [[AFJSONLinesParser alloc] initWithReadingOptions:self.readingOptions removesKeysWithNullValues:self.removesKeysWithNullValues maximumLineLength:self.maximumLineLength batchSize:0 queue:nil recordsHandler:nil];
+    [parser appendData:data ?: [NSData data]];
+
+    NSError *serializationError = nil;
+    id responseObject = [parser responseObjectByFinishingWithError:&serializationError];
+    if (!responseObject) {
+        if (error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+        return nil;
+    }
+
+    return responseObject;
+}
+
+#pragma mark - AFURLResponseIncrementalSerialization
+
+- (id <AFURLResponseIncrementalParser>)incrementalParserForResponse:(NSURLResponse *)response
+                                                               data:(NSData *)data
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFJSONLinesParser alloc] initWithReadingOptions:self.readingOptions removesKeysWithNullValues:self.removesKeysWithNullValues maximumLineLength:self.maximumLineLength batchSize:0 queue:nil recordsHandler:nil];
+}
+
+- (id <AFURLResponseIncrementalParser>)recordParserForResponse:(NSURLResponse *)response
+                                                          data:(NSData *)data
+                                                     batchSize:(NSUInteger)batchSize
+                                                         queue:(dispatch_queue_t)queue
+                                                recordsHandler:(void (^)(NSArray *records))recordsHandler
+{
+    NSParameterAssert(recordsHandler);
+
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFJSONLinesParser alloc] initWithReadingOptions:self.readingOptions removesKeysWithNullValues:self.removesKeysWithNullValues maximumLineLength:self.maximumLineLength batchSize:batchSize queue:queue recordsHandler:recordsHandler];
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    self.readingOptions = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(readingOptions))] unsignedIntegerValue];
+    self.removesKeysWithNullValues = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))] boolValue];
+
+    NSNumber *maximumLineLength = [decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(maximumLineLength))];
+    if (maximumLineLength) {
+        self.maximumLineLength = [maximumLineLength unsignedIntegerValue];
+    }
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeObject:@(self.readingOptions) forKey:NSStringFromSelector(@selector(readingOptions))];
+    [coder encodeObject:@(self.removesKeysWithNullValues) forKey:NSStringFromSelector(@selector(removesKeysWithNullValues))];
+    [coder encodeObject:@(self.maximumLineLength) forKey:NSStringFromSelector(@selector(maximumLineLength))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFJSONLinesResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.readingOptions = self.readingOptions;
+    serializer.removesKeysWithNullValues = self.removesKeysWithNullValues;
+    serializer.maximumLineLength = self.maximumLineLength;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFServerSentEvent
+
+- (instancetype)initWithType:(NSString *)type
+                        data:(NSString *)data
+                  identifier:(NSString *)identifier
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _type = [type copy];
+    _data = [data copy];
+    _identifier = [identifier copy];
+
+    return self;
+}
+
+- (BOOL)isEqual:(id)object {
+    if (self == object) {
+        return YES;
+    }
+
+    if (![object isKindOfClass:[AFServerSentEvent class]]) {
+        return NO;
+    }
+
+    AFServerSentEvent *event = (AFServerSentEvent *)object;
+
+    return [self.type isEqualToString:event.type] && [self.data isEqualToString:event.data] && (self.identifier == event.identifier || [self.identifier isEqualToString:event.identifier]);
+}
+
+- (NSUInteger)hash {
+    return [self.type hash] ^ [self.data hash] ^ [self.identifier hash];
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p, type: %@, identifier: %@, data: %@>", NSStringFromClass([self class]), self, self.type, self.identifier, self.data];
+}
+
+@end
+
+#pragma mark -
+
+static inline BOOL AFServerSentEventsFieldNameEquals(const uint8_t *bytes, NSUInteger length, const char *name) {
+    return length == strlen(name) && memcmp(bytes, name, length) == 0;
+}
+
+// Events handed to a block are delivered asynchronously, so parsing waits for the block once this many are pending, rather than parsing events faster than they are handled.
+static long const AFServerSentEventsMaximumPendingEventCount = 64;
+
+/**
+ `AFServerSentEventsStreamParser` splits an event stream into lines as chunks of data are appended, and processes the field of each line as soon as it is complete. Only a line that spans chunks is copied, into a buffer that is reused for the next one, and fails the parse once it is longer than the maximum line length. Dispatched events are either kept for the response object, or handed to a block, if there is one. A line that is still incomplete once the parser finishes is discarded, along with the event it belongs to.
+ */
+@interface AFServerSentEventsStreamParser : NSObject <AFServerSentEventsParser>
+
+@property (readwrite, nonatomic, copy) NSString *lastEventIdentifier;
+@property (readwrite, nonatomic, assign) NSTimeInterval reconnectionInterval;
+
+- (instancetype)initWithLastEventIdentifier:(NSString *)lastEventIdentifier
+                          maximumLineLength:(NSUInteger)maximumLineLength
+                                      queue:(dispatch_queue_t)queue
+                               eventHandler:(void (^)(AFServerSentEvent *event))eventHandler;
+
+@end
+
+@implementation AFServerSentEventsStreamParser {
+    NSUInteger _maximumLineLength;
+    dispatch_queue_t _queue;
+    void (^_eventHandler)(AFServerSentEvent *);
+    dispatch_group_t _deliveryGroup;
+    dispatch_semaphore_t _pendingEventsSemaphore;
+
+    NSMutableData *_partialLine;
+    NSUInteger _numberOfLines;
+    BOOL _parsedFirstLine;
+    BOOL _skipsLineFeed;
+    NSError *_error;
+
+    NSString *_eventType;
+    NSMutableString *_eventData;
+    NSMutableArray *_events;
+}
+
+- (instancetype)initWithLastEventIdentifier:(NSString *)lastEventIdentifier
+                          maximumLineLength:(NSUInteger)maximumLineLength
+                                      queue:(dispatch_queue_t)queue
+                               eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _lastEventIdentifier = [lastEventIdentifier copy];
+    _reconnectionInterval = -1.0;
+    _maximumLineLength = maximumLineLength;
+    _queue = queue ?: dispatch_get_main_queue();
+    _eventHandler = [eventHandler copy];
+    _deliveryGroup = dispatch_group_create();
+    _pendingEventsSemaphore = dispatch_semaphore_create(AFServerSentEventsMaximumPendingEventCount);
+    _partialLine = [NSMutableData data];
+    _eventData = [NSMutableString string];
+    _events = [NSMutableArray array];
+
+    return self;
+}
+
+- (void)dispatchEvent {
+    if ([_eventData length] == 0) {
+        _eventType = nil;
+        return;
+    }
+
+    [_eventData deleteCharactersInRange:NSMakeRange([_eventData length] - 1, 1)];
+
+    AFServerSentEvent *event = [[AFServerSentEvent alloc] initWithType:([_eventType length] > 0 ? _eventType : @"message") data:_eventData identifier:self.lastEventIdentifier];
+    [_eventData setString:@""];
+    _eventType = nil;
+
+    if (_eventHandler) {
+        dispatch_semaphore_t pendingEventsSemaphore = _pendingEventsSemaphore;
+        dispatch_semaphore_wait(pendingEventsSemaphore, DISPATCH_TIME_FOREVER);
+
+        void (^eventHandler)(AFServerSentEvent *) = _eventHandler;
+        dispatch_group_async(_deliveryGroup, _queue, ^{
+            eventHandler(event);
+            dispatch_semaphore_signal(pendingEventsSemaphore);
+        });
+    } else {
+        [_events addObject:event];
+    }
+}
+
+- (void)parseLineBytes:(const uint8_t *)bytes
+                length:(NSUInteger)length
+{
+    _numberOfLines++;
+
+    if (!_parsedFirstLine) {
+        _parsedFirstLine = YES;
+        if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+            bytes += 3;
+            length -= 3;
+        }
+    }
+
+    if (length == 0) {
+        [self dispatchEvent];
+        return;
+    }
+
+    if (bytes[0] == ':') {
+        return;
+    }
+
+    const uint8_t *colon = memchr(bytes, ':', length);
+    NSUInteger fieldLength = colon ? (NSUInteger)(colon - bytes) : length;
+    const uint8_t *value = colon ? colon + 1 : bytes + length;
+    NSUInteger valueLength = (NSUInteger)(bytes + length - value);
+    if (valueLength > 0 && value[0] == ' ') {
+        value++;
+        valueLength--;
+    }
+
+    if (AFServerSentEventsFieldNameEquals(bytes, fieldLength, "retry")) {
+        if (valueLength == 0) {
+            return;
+        }
+
+        double milliseconds = 0.0;
+        for (NSUInteger idx = 0; idx < valueLength; idx++) {
+            if (value[idx] < '0' || value[idx] > '9') {
+                return;
+            }
+            milliseconds = milliseconds * 10.0 + (value[idx] - '0');
+        }
+
+        self.reconnectionInterval = milliseconds / 1000.0;
+        return;
+    }
+
+    BOOL isData = AFServerSentEventsFieldNameEquals(bytes, fieldLength, "data");
+    BOOL isEvent = !isData && AFServerSentEventsFieldNameEquals(bytes, fieldLength, "event");
+    BOOL isIdentifier = !isData && !isEvent && AFServerSentEventsFieldNameEquals(bytes, fieldLength, "id");
+    if (!isData && !isEvent && !isIdentifier) {
+        return;
+    }
+
+    if (isIdentifier && memchr(value, '\0', valueLength)) {
+        return;
+    }
+
+    NSString *string = [[NSString alloc] initWithBytes:value length:valueLength encoding:NSUTF8StringEncoding];
+    if (!string) {
+        return;
+    }
+
+    if (isData) {
+        [_eventData appendString:string];
+        [_eventData appendString:@"\n"];
+    } else if (isEvent) {
+        _eventType = string;
+    } else {
+        self.lastEventIdentifier = string;
+    }
+}
+
+- (BOOL)parseBytes:(const uint8_t *)bytes
+            length:(NSUInteger)length
+{
+    const uint8_t *end = bytes + length;
+    if (_skipsLineFeed && bytes < end) {
+        _skipsLineFeed = NO;
+        if (*bytes == '\n') {
+            bytes++;
+        }
+    }
+
+    while (bytes < end) {
+        const uint8_t *lineEnd = bytes;
+        while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') {
+            lineEnd++;
+        }
+
+        if ([_partialLine length] + (NSUInteger)(lineEnd - bytes) > _maximumLineLength) {
+            _error = AFLineTooLongError(_numberOfLines + 1, _maximumLineLength);
+            return NO;
+        }
+
+        if (lineEnd == end) {
+            [_partialLine appendBytes:bytes length:(NSUInteger)(end - bytes)];
+            return YES;
+        }
+
+        if ([_partialLine length] > 0) {
+            [_partialLine appendBytes:bytes length:(NSUInteger)(lineEnd - bytes)];
+            [self parseLineBytes:[_partialLine bytes] length:[_partialLine length]];
+            [_partialLine setLength:0];
+        } else {
+            [self parseLineBytes:bytes length:(NSUInteger)(lineEnd - bytes)];
+        }
+
+        if (*lineEnd == '\r') {
+            if (lineEnd + 1 == end) {
+                _skipsLineFeed = YES;
+            } else if (lineEnd[1] == '\n') {
+                lineEnd++;
+            }
+        }
+
+        bytes = lineEnd + 1;
+    }
+
+    return YES;
+}
+
+#pragma mark - AFURLResponseIncrementalParser
+
+- (BOOL)appendData:(NSData *)data {
+    if (_error) {
+        return NO;
+    }
+
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        if (![self parseBytes:bytes length:byteRange.length]) {
+            *stop = YES;
+        }
+    }];
+
+    return _error == nil;
+}
+
+- (id)responseObjectByFinishingWithError:(NSError * __autoreleasing *)error {
+    _partialLine = nil;
+
+    dispatch_group_wait(_deliveryGroup, DISPATCH_TIME_FOREVER);
+
+    if (_error) {
+        if (error) {
+            *error = _error;
+        }
+
+        return nil;
+    }
+
+    return _eventHandler ? nil : [_events copy];
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFServerSentEventsResponseSerializer
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObject:@"text/event-stream"];
+    self.acceptableStatusCodes = [NSIndexSet indexSetWithIndex:200];
+    self.maximumLineLength = AFDefaultMaximumLineLength;
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    AFServerSentEventsStreamParser *parser = [[AFServerSentEventsStreamParser alloc] initWithLastEventIdentifier:nil maximumLineLength:self.maximumLineLength queue:nil eventHandler:nil];
+    [parser appendData:data ?: [NSData data]];
+
+    NSError *serializationError = nil;
+    id responseObject = [parser responseObjectByFinishingWithError:&serializationError];
+    if (!responseObject) {
+        if (error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+        return nil;
+    }
+
+    return responseObject;
+}
+
+#pragma mark - AFURLResponseIncrementalSerialization
+
+- (id <AFURLResponseIncrementalParser>)incrementalParserForResponse:(NSURLResponse *)response
+                                                               data:(NSData *)data
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFServerSentEventsStreamParser alloc] initWithLastEventIdentifier:nil maximumLineLength:self.maximumLineLength queue:nil eventHandler:nil];
+}
+
+- (id <AFServerSentEventsParser>)eventParserForResponse:(NSURLResponse *)response
+                                                   data:(NSData *)data
+                                    lastEventIdentifier:(NSString *)lastEventIdentifier
+                                                  queue:(dispatch_queue_t)queue
+                                           eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+{
+    NSParameterAssert(eventHandler);
+
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFServerSentEventsStreamParser alloc] initWithLastEventIdentifier:lastEventIdentifier maximumLineLength:self.maximumLineLength queue:queue eventHandler:eventHandler];
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    NSNumber *maximumLineLength = [decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(maximumLineLength))];
+    if (maximumLineLength) {
+        self.maximumLineLength = [maximumLineLength unsignedIntegerValue];
+    }
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeObject:@(self.maximumLineLength) forKey:NSStringFromSelector(@selector(maximumLineLength))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFServerSentEventsResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.maximumLineLength = self.maximumLineLength;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFXMLStreamingParser {
+    NSURLResponse *_response;
+    id <AFXMLStreamingParserDelegate> _delegate;
+
+    xmlParserCtxtPtr _context;
+    CFMutableDictionaryRef _stringsByName;
+    NSError *_error;
+    BOOL _finished;
+    BOOL _aborted;
+
+    BOOL _delegateRespondsToDidStartDocument;
+    BOOL _delegateRespondsToDidEndDocument;
+    BOOL _delegateRespondsToDidStartElement;
+    BOOL _delegateRespondsToDidEndElement;
+    BOOL _delegateRespondsToFoundCharacters;
+    BOOL _delegateRespondsToFoundCDATA;
+    BOOL _delegateRespondsToParseErrorOccurred;
+}
+
+// Names are interned by the dictionary of the parser context, so that their strings can be looked up by address.
+static NSString * AFXMLStreamingParserStringForName(AFXMLStreamingParser *parser, const xmlChar *name) {
+    NSString *string = (__bridge NSString *)CFDictionaryGetValue(parser->_stringsByName, name);
+    if (!string) {
+        string = [[NSString alloc] initWithUTF8String:(const char *)name] ?: @"";
+        CFDictionarySetValue(parser->_stringsByName, name, (__bridge const void *)string);
+    }
+
+    return string;
+}
+
+static NSString * AFXMLStreamingParserQualifiedName(AFXMLStreamingParser *parser, const xmlChar *prefix, const xmlChar *localName) {
+    NSString *name = AFXMLStreamingParserStringForName(parser, localName);
+    if (!prefix) {
+        return name;
+    }
+
+    return [NSString stringWithFormat:@"%@:%@", AFXMLStreamingParserStringForName(parser, prefix), name];
+}
+
+static void AFXMLStreamingParserStartDocument(void *context) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (parser->_delegateRespondsToDidStartDocument) {
+        [parser->_delegate streamingParserDidStartDocument:parser];
+    }
+}
+
+static void AFXMLStreamingParserEndDocument(void *context) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (parser->_delegateRespondsToDidEndDocument && parser->_context->wellFormed && !parser->_aborted) {
+        [parser->_delegate streamingParserDidEndDocument:parser];
+    }
+}
+
+static void AFXMLStreamingParserStartElement(void *context, const xmlChar *localName, const xmlChar *prefix, const xmlChar *URI, __unused int numberOfNamespaces, __unused const xmlChar **namespaces, int numberOfAttributes, __unused int numberOfDefaultedAttributes, const xmlChar **attributes) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (!parser->_delegateRespondsToDidStartElement) {
+        return;
+    }
+
+    NSMutableDictionary *mutableAttributes = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)MAX(numberOfAttributes, 0)];
+    for (int idx = 0; idx < numberOfAttributes; idx++) {
+        // Each attribute is described by its local name, prefix, URI, and the start and end of its value.
+        const xmlChar **attribute = attributes + idx * 5;
+        NSString *value = [[NSString alloc] initWithBytes:attribute[3] length:(NSUInteger)(attribute[4] - attribute[3]) encoding:NSUTF8StringEncoding];
+        if (value && memchr(attribute[3], '&', (size_t)(attribute[4] - attribute[3]))) {
+            // Without entity substitution, `&amp;` is the only reference left in attribute values, as a character reference.
+            value = [value stringByReplacingOccurrencesOfString:@"&#38;" withString:@"&"];
+        }
+        mutableAttributes[AFXMLStreamingParserQualifiedName(parser, attribute[1], attribute[0])] = value ?: @"";
+    }
+
+    [parser->_delegate streamingParser:parser didStartElement:AFXMLStreamingParserStringForName(parser, localName) namespaceURI:(URI ? AFXMLStreamingParserStringForName(parser, URI) : nil) qualifiedName:AFXMLStreamingParserQualifiedName(parser, prefix, localName) attributes:mutableAttributes];
+}
+
+static void AFXMLStreamingParserEndElement(void *context, const xmlChar *localName, const xmlChar *prefix, const xmlChar *URI) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (!parser->_delegateRespondsToDidEndElement) {
+        return;
+    }
+
+    [parser->_delegate streamingParser:parser didEndElement:AFXMLStreamingParserStringForName(parser, localName) namespaceURI:(URI ? AFXMLStreamingParserStringForName(parser, URI) : nil) qualifiedName:AFXMLStreamingParserQualifiedName(parser, prefix, localName)];
+}
+
+static void AFXMLStreamingParserCharacters(void *context, const xmlChar *characters, int length) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (!parser->_delegateRespondsToFoundCharacters || length <= 0) {
+        return;
+    }
+
+    NSString *string = [[NSString alloc] initWithBytes:characters length:(NSUInteger)length encoding:NSUTF8StringEncoding];
+    if (string) {
+        [parser->_delegate streamingParser:parser foundCharacters:string];
+    }
+}
+
+static void AFXMLStreamingParserCDATABlock(void *context, const xmlChar *value, int length) {
+    AFXMLStreamingParser *parser = (__bridge AFXMLStreamingParser *)context;
+    if (!parser->_delegateRespondsToFoundCDATA || length < 0) {
+        return;
+    }
+
+    [parser->_delegate streamingParser:parser foundCDATA:[NSData dataWithBytes:value length:(NSUInteger)length]];
+}
+
+// Errors are reported once the chunk that caused them has been parsed, rather than printed.
+static void AFXMLStreamingParserIgnoreMessage(__unused void *context, __unused const char *message, ...) {
+}
+
+- (instancetype)initWithResponse:(NSURLResponse *)response
+                        delegate:(id <AFXMLStreamingParserDelegate>)delegate
+{
+    NSParameterAssert(delegate);
+
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        xmlInitParser();
+    });
+
+    _response = response;
+    _delegate = delegate;
+
+    _delegateRespondsToDidStartDocument = [delegate respondsToSelector:@selector(streamingParserDidStartDocument:)];
+    _delegateRespondsToDidEndDocument = [delegate respondsToSelector:@selector(streamingParserDidEndDocument:)];
+    _delegateRespondsToDidStartElement = [delegate respondsToSelector:@selector(streamingParser:didStartElement:namespaceURI:qualifiedName:attributes:)];
+    _delegateRespondsToDidEndElement = [delegate respondsToSelector:@selector(streamingParser:didEndElement:namespaceURI:qualifiedName:)];
+    _delegateRespondsToFoundCharacters = [delegate respondsToSelector:@selector(streamingParser:foundCharacters:)];
+    _delegateRespondsToFoundCDATA = [delegate respondsToSelector:@selector(streamingParser:foundCDATA:)];
+    _delegateRespondsToParseErrorOccurred = [delegate respondsToSelector:@selector(streamingParser:parseErrorOccurred:)];
+
+    xmlSAXHandler handler;
+    memset(&handler, 0, sizeof(handler));
+    handler.initialized = XML_SAX2_MAGIC;
+    handler.startDocument = AFXMLStreamingParserStartDocument;
+    handler.endDocument = AFXMLStreamingParserEndDocument;
+    handler.startElementNs = AFXMLStreamingParserStartElement;
+    handler.endElementNs = AFXMLStreamingParserEndElement;
+    handler.characters = AFXMLStreamingParserCharacters;
+    handler.ignorableWhitespace = AFXMLStreamingParserCharacters;
+    handler.cdataBlock = AFXMLStreamingParserCDATABlock;
+    handler.warning = AFXMLStreamingParserIgnoreMessage;
+    handler.error = AFXMLStreamingParserIgnoreMessage;
+
+    _context = xmlCreatePushParserCtxt(&handler, (__bridge void *)self, NULL, 0, NULL);
+    if (!_context) {
+        return nil;
+    }
+
+    xmlCtxtUseOptions(_context, XML_PARSE_NONET);
+
+    _stringsByName = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+
+    return self;
+}
+
+- (void)dealloc {
+    if (_context) {
+        xmlFreeParserCtxt(_context);
+    }
+
+    if (_stringsByName) {
+        CFRelease(_stringsByName);
+    }
+}
+
+- (NSInteger)lineNumber {
+    return xmlSAX2GetLineNumber(_context);
+}
+
+- (NSInteger)columnNumber {
+    return xmlSAX2GetColumnNumber(_context);
+}
+
+- (void)abortParsing {
+    if (_finished || _error) {
+        return;
+    }
+
+    _aborted = YES;
+    xmlStopParser(_context);
+}
+
+- (BOOL)checkForError {
+    if (_error) {
+        return NO;
+    }
+
+    if (!_aborted && _context->wellFormed) {
+        return YES;
+    }
+
+    NSError *parseError = nil;
+    if (_aborted) {
+        parseError = [NSError errorWithDomain:NSXMLParserErrorDomain code:NSXMLParserDelegateAbortedParseError userInfo:nil];
+    } else {
+        const xmlError *lastError = xmlCtxtGetLastError(_context);
+        NSMutableDictionary *mutableUserInfo = [NSMutableDictionary dictionary];
+        if (lastError && lastError->message) {
+            mutableUserInfo[NSLocalizedDescriptionKey] = [[NSString stringWithUTF8String:lastError->message] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+        }
+
+        parseError = [NSError errorWithDomain:NSXMLParserErrorDomain code:(lastError ? lastError->code : NSXMLParserInternalError) userInfo:mutableUserInfo];
+
+        if (_delegateRespondsToParseErrorOccurred) {
+            [_delegate streamingParser:self parseErrorOccurred:parseError];
+        }
+    }
+
+    NSMutableDictionary *mutableUserInfo = [NSMutableDictionary dictionary];
+    mutableUserInfo[NSLocalizedFailureReasonErrorKey] = [NSString stringWithFormat:NSLocalizedStringFromTable(@"Invalid XML on line %ld, column %ld.", @"AFNetworking", nil), (long)self.lineNumber, (long)self.columnNumber];
+    mutableUserInfo[NSUnderlyingErrorKey] = parseError;
+    _error = [[NSError alloc] initWithDomain:AFURLResponseSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:mutableUserInfo];
+
+    return NO;
+}
+
+#pragma mark - AFURLResponseIncrementalParser
+
+- (BOOL)appendData:(NSData *)data {
+    if (_error || _finished) {
+        return NO;
+    }
+
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        const char *chunk = bytes;
+        NSUInteger remainingLength = byteRange.length;
+        while (remainingLength > 0) {
+            int length = (int)MIN(remainingLength, (NSUInteger)INT_MAX);
+            xmlParseChunk(self->_context, chunk, length, 0);
+            if (![self checkForError]) {
+                *stop = YES;
+                return;
+            }
+
+            chunk += length;
+            remainingLength -= (NSUInteger)length;
+        }
+    }];
+
+    return _error == nil;
+}
+
+- (id)responseObjectByFinishingWithError:(NSError * __autoreleasing *)error {
+    if (!_error && !_finished) {
+        _finished = YES;
+        xmlParseChunk(_context, NULL, 0, 1);
+        [self checkForError];
+    }
+
+    if (_error && error) {
+        *error = _error;
+    }
+
+    return nil;
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFXMLParserResponseSerializer
+
++ (instancetype)serializer {
+    AFXMLParserResponseSerializer *serializer = [[self alloc] init];
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [[NSSet alloc] initWithObjects:@"application/xml", @"text/xml", nil];
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSHTTPURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    id <AFXMLStreamingParserDelegate> streamingDelegate = self.streamingDelegate;
+    if (streamingDelegate) {
+        AFXMLStreamingParser *parser = [[AFXMLStreamingParser alloc] initWithResponse:response delegate:streamingDelegate];
+        [parser appendData:data ?: [NSData data]];
+
+        NSError *serializationError = nil;
+        [parser responseObjectByFinishingWithError:&serializationError];
+        if (serializationError && error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+
+        return nil;
+    }
+
+    return [[NSXMLParser alloc] initWithData:data];
+}
+
+#pragma mark - AFURLResponseIncrementalSerialization
+
+- (id <AFURLResponseIncrementalParser>)incrementalParserForResponse:(NSURLResponse *)response
+                                                               data:(NSData *)data
+{
+    id <AFXMLStreamingParserDelegate> streamingDelegate = self.streamingDelegate;
+    if (!streamingDelegate || ![self validateResponse:(NSHTTPURLResponse *)response data:data error:NULL]) {
+        return nil;
+    }
+
+    return [[AFXMLStreamingParser alloc] initWithResponse:response delegate:streamingDelegate];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFXMLParserResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.streamingDelegate = self.streamingDelegate;
+
+    return serializer;
+}
+
+@end
+
+#pragma mark -
+
+#ifdef __MAC_OS_X_VERSION_MIN_REQUIRED
+
+@implementation AFXMLDocumentResponseSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithXMLDocumentOptions:0];
+}
+
++ (instancetype)serializerWithXMLDocumentOptions:(NSUInteger)mask {
+    AFXMLDocumentResponseSerializer *serializer = [[self alloc] init];
+    serializer.options = mask;
+
+    return serializer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [[NSSet alloc] initWithObjects:@"application/xml", @"text/xml", nil];
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    if (![self validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    NSError *serializationError = nil;
+    NSXMLDocument *document = [[NSXMLDocument alloc] initWithData:data options:self.options error:&serializationError];
+
+    if (!document)
+    {
+        if (error) {
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+        return nil;
+    }
+    
+    return document;
+}
+
+#pragma mark - NSSecureCoding
+
+- (instancetype)initWithCoder:(NSCoder *)decoder {
+    self = [super initWithCoder:decoder];
+    if (!self) {
+        return nil;
+    }
+
+    self.options = [[decoder decodeObjectOfClass:[NSNumber class] forKey:NSStringFromSelector(@selector(options))] unsignedIntegerValue];
+
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [super encodeWithCoder:coder];
+
+    [coder encodeObject:@(self.options) forKey:NSStringFromSelector(@selector(options))];
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(NSZone *)zone {
+    AFXMLDocumentResponseSerializer *serializer = [super copyWithZone:zone];
+    serializer.options = self.options;
+
+    return serializer;
+}
+
+@end
+
+#endif
+
+#pragma mark -
+
+@implementation AFPropertyListResponseSerializer
+
++ (instancetype)serializer {
+    return [self serializerWithFormat:NSPropertyListXMLFormat_v1_0 readOptions:0];
+}
+
++ (instancetype)serializerWithFormat:(NSPropertyListFormat)format
+                         readOptions:(NSPropertyListReadOptions)readOptions
+{
+    AFPropertyListResponseSerializer *serializer = [[self alloc] init];
+    serializer.format = format;
+    serializer.readOptions = readOptions;
+
+    return serializer;
+}
+
+- (instancetype)init {
     self = [super init];
     if (!self) {
         return nil;
@@ -519,6 +4810,501 @@ static id AFJSONObjectByRemovingKeysWithNullValues(id JSONObject, NSJSONReadingO
 
 #pragma mark -
 
+static NSUInteger const AFBinaryObjectMaximumDepth = 512;
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    size_t offset;
+} AFBinaryObjectReader;
+
+typedef id (*AFBinaryObjectReadFunction)(AFBinaryObjectReader *reader, NSUInteger depth);
+
+static BOOL AFBinaryObjectReaderReadBigEndian(AFBinaryObjectReader *reader, size_t width, uint64_t *value) {
+    if (reader->length - reader->offset < width) {
+        return NO;
+    }
+
+    uint64_t result = 0;
+    for (size_t idx = 0; idx < width; idx++) {
+        result = (result << 8) | reader->bytes[reader->offset + idx];
+    }
+    reader->offset += width;
+    *value = result;
+
+    return YES;
+}
+
+static const uint8_t * AFBinaryObjectReaderReadBytes(AFBinaryObjectReader *reader, uint64_t length) {
+    if (reader->length - reader->offset < length) {
+        return NULL;
+    }
+
+    const uint8_t *bytes = reader->bytes + reader->offset;
+    reader->offset += (size_t)length;
+
+    return bytes;
+}
+
+static NSNumber * AFBinaryObjectNumberFromUnsignedInteger(uint64_t value) {
+    return value <= INT64_MAX ? @((long long)value) : @((unsigned long long)value);
+}
+
+static NSString * AFBinaryObjectReadString(AFBinaryObjectReader *reader, uint64_t length) {
+    const uint8_t *bytes = AFBinaryObjectReaderReadBytes(reader, length);
+    if (!bytes) {
+        return nil;
+    }
+
+    return [[NSString alloc] initWithBytes:bytes length:(NSUInteger)length encoding:NSUTF8StringEncoding];
+}
+
+static NSData * AFBinaryObjectReadData(AFBinaryObjectReader *reader, uint64_t length) {
+    const uint8_t *bytes = AFBinaryObjectReaderReadBytes(reader, length);
+    if (!bytes) {
+        return nil;
+    }
+
+    return [NSData dataWithBytes:bytes length:(NSUInteger)length];
+}
+
+/**
+ Reads `count` objects with `readObject` into an immutable array, or `count` pairs of keys and values into an immutable dictionary when `keyed` is `YES`. Returns `nil` if any of the objects can not be read.
+ */
+static id AFBinaryObjectReadContainer(AFBinaryObjectReader *reader, uint64_t count, BOOL keyed, NSUInteger depth, AFBinaryObjectReadFunction readObject) {
+    // Every object takes at least one byte, which bounds the allocations for malformed counts
+    uint64_t numberOfRemainingBytes = reader->length - reader->offset;
+    if (count > (keyed ? numberOfRemainingBytes / 2 : numberOfRemainingBytes)) {
+        return nil;
+    }
+
+    if (count == 0) {
+        return keyed ? @{} : @[];
+    }
+
+    __strong id *objects = (__strong id *)calloc((size_t)count, sizeof(id));
+    __strong id <NSCopying> *keys = keyed ? (__strong id <NSCopying> *)calloc((size_t)count, sizeof(id)) : NULL;
+
+    id container = nil;
+    if (objects && (!keyed || keys)) {
+        size_t numberOfObjectsRead = 0;
+        while (numberOfObjectsRead < count) {
+            if (keyed && !(keys[numberOfObjectsRead] = readObject(reader, depth + 1))) {
+                break;
+            }
+            if (!(objects[numberOfObjectsRead] = readObject(reader, depth + 1))) {
+                break;
+            }
+            numberOfObjectsRead++;
+        }
+
+        if (numberOfObjectsRead == count) {
+            container = keyed ? [NSDictionary dictionaryWithObjects:objects forKeys:keys count:(NSUInteger)count] : [NSArray arrayWithObjects:objects count:(NSUInteger)count];
+        }
+    }
+
+    // Release the objects before freeing the buffers holding them
+    for (size_t idx = 0; idx < count; idx++) {
+        if (objects) {
+            objects[idx] = nil;
+        }
+        if (keys) {
+            keys[idx] = nil;
+        }
+    }
+    free(objects);
+    free(keys);
+
+    return container;
+}
+
+#pragma mark - MessagePack
+
+static id AFMessagePackReadObject(AFBinaryObjectReader *reader, NSUInteger depth);
+
+static NSDate * AFMessagePackReadExtension(AFBinaryObjectReader *reader, uint64_t length) {
+    uint64_t type = 0;
+    if (!AFBinaryObjectReaderReadBigEndian(reader, 1, &type) || type != 0xff) {
+        return nil;
+    }
+
+    // The timestamp extension type -1, in its 32, 64 and 96-bit formats
+    uint64_t seconds = 0;
+    uint64_t nanoseconds = 0;
+    if (length == 4) {
+        if (!AFBinaryObjectReaderReadBigEndian(reader, 4, &seconds)) {
+            return nil;
+        }
+    } else if (length == 8) {
+        uint64_t value = 0;
+        if (!AFBinaryObjectReaderReadBigEndian(reader, 8, &value)) {
+            return nil;
+        }
+        nanoseconds = value >> 34;
+        seconds = value & 0x3ffffffff;
+    } else if (length == 12) {
+        if (!AFBinaryObjectReaderReadBigEndian(reader, 4, &nanoseconds) || !AFBinaryObjectReaderReadBigEndian(reader, 8, &seconds)) {
+            return nil;
+        }
+    } else {
+        return nil;
+    }
+
+    return [NSDate dateWithTimeIntervalSince1970:(double)(int64_t)seconds + (double)nanoseconds / 1e9];
+}
+
+static id AFMessagePackReadObject(AFBinaryObjectReader *reader, NSUInteger depth) {
+    uint64_t type = 0;
+    if (depth > AFBinaryObjectMaximumDepth || !AFBinaryObjectReaderReadBigEndian(reader, 1, &type)) {
+        return nil;
+    }
+
+    if (type <= 0x7f) {
+        return @((long long)type);
+    } else if (type >= 0xe0) {
+        return @((long long)(int8_t)type);
+    } else if (type >= 0xa0 && type <= 0xbf) {
+        return AFBinaryObjectReadString(reader, type & 0x1f);
+    } else if (type >= 0x90 && type <= 0x9f) {
+        return AFBinaryObjectReadContainer(reader, type & 0x0f, NO, depth, AFMessagePackReadObject);
+    } else if (type >= 0x80 && type <= 0x8f) {
+        return AFBinaryObjectReadContainer(reader, type & 0x0f, YES, depth, AFMessagePackReadObject);
+    }
+
+    uint64_t value = 0;
+    switch (type) {
+        case 0xc0:
+            return [NSNull null];
+        case 0xc2:
+            return @NO;
+        case 0xc3:
+            return @YES;
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (type - 0xc4), &value)) {
+                return nil;
+            }
+            return AFBinaryObjectReadData(reader, value);
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (type - 0xc7), &value)) {
+                return nil;
+            }
+            return AFMessagePackReadExtension(reader, value);
+        case 0xca: {
+            if (!AFBinaryObjectReaderReadBigEndian(reader, 4, &value)) {
+                return nil;
+            }
+            uint32_t bits = (uint32_t)value;
+            float floatValue = 0;
+            memcpy(&floatValue, &bits, sizeof(floatValue));
+            return @(floatValue);
+        }
+        case 0xcb: {
+            if (!AFBinaryObjectReaderReadBigEndian(reader, 8, &value)) {
+                return nil;
+            }
+            double doubleValue = 0;
+            memcpy(&doubleValue, &value, sizeof(doubleValue));
+            return @(doubleValue);
+        }
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (type - 0xcc), &value)) {
+                return nil;
+            }
+            return AFBinaryObjectNumberFromUnsignedInteger(value);
+        case 0xd0:
+            return AFBinaryObjectReaderReadBigEndian(reader, 1, &value) ? @((long long)(int8_t)value) : nil;
+        case 0xd1:
+            return AFBinaryObjectReaderReadBigEndian(reader, 2, &value) ? @((long long)(int16_t)value) : nil;
+        case 0xd2:
+            return AFBinaryObjectReaderReadBigEndian(reader, 4, &value) ? @((long long)(int32_t)value) : nil;
+        case 0xd3:
+            return AFBinaryObjectReaderReadBigEndian(reader, 8, &value) ? @((long long)(int64_t)value) : nil;
+        case 0xd4:
+        case 0xd5:
+        case 0xd6:
+        case 0xd7:
+        case 0xd8:
+            return AFMessagePackReadExtension(reader, (uint64_t)1 << (type - 0xd4));
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (type - 0xd9), &value)) {
+                return nil;
+            }
+            return AFBinaryObjectReadString(reader, value);
+        case 0xdc:
+        case 0xdd:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)2 << (type - 0xdc), &value)) {
+                return nil;
+            }
+            return AFBinaryObjectReadContainer(reader, value, NO, depth, AFMessagePackReadObject);
+        case 0xde:
+        case 0xdf:
+            if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)2 << (type - 0xde), &value)) {
+                return nil;
+            }
+            return AFBinaryObjectReadContainer(reader, value, YES, depth, AFMessagePackReadObject);
+        default:
+            return nil;
+    }
+}
+
+#pragma mark - CBOR
+
+static id AFCBORReadObject(AFBinaryObjectReader *reader, NSUInteger depth);
+
+static BOOL AFCBORReaderReadBreakIfPresent(AFBinaryObjectReader *reader) {
+    if (reader->offset < reader->length && reader->bytes[reader->offset] == 0xff) {
+        reader->offset++;
+        return YES;
+    }
+
+    return NO;
+}
+
+static double AFCBORDoubleFromHalfPrecisionFloat(uint16_t half) {
+    unsigned int exponent = (half >> 10) & 0x1f;
+    unsigned int mantissa = half & 0x3ff;
+
+    double value = 0;
+    if (exponent == 0) {
+        value = ldexp((double)mantissa, -24);
+    } else if (exponent != 31) {
+        value = ldexp((double)(mantissa + 1024), (int)exponent - 25);
+    } else {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+/**
+ Reads a byte or text string split into chunks of definite length, until the break stop code.
+ */
+static NSData * AFCBORReadIndefiniteLengthBytes(AFBinaryObjectReader *reader, uint64_t majorType) {
+    NSMutableData *mutableData = [NSMutableData data];
+    while (!AFCBORReaderReadBreakIfPresent(reader)) {
+        uint64_t initialByte = 0;
+        uint64_t length = 0;
+        if (!AFBinaryObjectReaderReadBigEndian(reader, 1, &initialByte) || (initialByte >> 5) != majorType || (initialByte & 0x1f) > 27) {
+            return nil;
+        }
+
+        uint64_t additionalInformation = initialByte & 0x1f;
+        if (additionalInformation < 24) {
+            length = additionalInformation;
+        } else if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (additionalInformation - 24), &length)) {
+            return nil;
+        }
+
+        const uint8_t *bytes = AFBinaryObjectReaderReadBytes(reader, length);
+        if (!bytes) {
+            return nil;
+        }
+        [mutableData appendBytes:bytes length:(NSUInteger)length];
+    }
+
+    return mutableData;
+}
+
+static id AFCBORReadIndefiniteLengthContainer(AFBinaryObjectReader *reader, BOOL keyed, NSUInteger depth) {
+    NSMutableArray *mutableObjects = [NSMutableArray array];
+    while (!AFCBORReaderReadBreakIfPresent(reader)) {
+        id object = AFCBORReadObject(reader, depth + 1);
+        if (!object) {
+            return nil;
+        }
+        [mutableObjects addObject:object];
+    }
+
+    if (!keyed) {
+        return [mutableObjects copy];
+    } else if (mutableObjects.count % 2 != 0) {
+        return nil;
+    }
+
+    NSMutableDictionary *mutableDictionary = [NSMutableDictionary dictionaryWithCapacity:mutableObjects.count / 2];
+    for (NSUInteger idx = 0; idx < mutableObjects.count; idx += 2) {
+        mutableDictionary[mutableObjects[idx]] = mutableObjects[idx + 1];
+    }
+
+    return [mutableDictionary copy];
+}
+
+static id AFCBORReadObject(AFBinaryObjectReader *reader, NSUInteger depth) {
+    uint64_t initialByte = 0;
+    if (depth > AFBinaryObjectMaximumDepth || !AFBinaryObjectReaderReadBigEndian(reader, 1, &initialByte)) {
+        return nil;
+    }
+
+    uint64_t majorType = initialByte >> 5;
+    uint64_t additionalInformation = initialByte & 0x1f;
+    BOOL indefiniteLength = additionalInformation == 31;
+
+    uint64_t argument = additionalInformation;
+    if (additionalInformation >= 24 && additionalInformation <= 27) {
+        if (!AFBinaryObjectReaderReadBigEndian(reader, (size_t)1 << (additionalInformation - 24), &argument)) {
+            return nil;
+        }
+    } else if (additionalInformation > 27 && !(indefiniteLength && majorType >= 2 && majorType <= 5)) {
+        return nil;
+    }
+
+    switch (majorType) {
+        case 0:
+            return AFBinaryObjectNumberFromUnsignedInteger(argument);
+        case 1:
+            return argument <= INT64_MAX ? @(-1 - (long long)argument) : nil;
+        case 2:
+            return indefiniteLength ? AFCBORReadIndefiniteLengthBytes(reader, majorType) : AFBinaryObjectReadData(reader, argument);
+        case 3:
+            if (indefiniteLength) {
+                NSData *data = AFCBORReadIndefiniteLengthBytes(reader, majorType);
+                return data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+            }
+            return AFBinaryObjectReadString(reader, argument);
+        case 4:
+        case 5:
+            if (indefiniteLength) {
+                return AFCBORReadIndefiniteLengthContainer(reader, majorType == 5, depth);
+            }
+            return AFBinaryObjectReadContainer(reader, argument, majorType == 5, depth, AFCBORReadObject);
+        case 6: {
+            id object = AFCBORReadObject(reader, depth + 1);
+            // Tag 1 marks an epoch-based date, and other tags don't change how the tagged item is decoded
+            if (argument == 1) {
+                if (![object isKindOfClass:[NSNumber class]] || object == (__bridge id)kCFBooleanTrue || object == (__bridge id)kCFBooleanFalse) {
+                    return nil;
+                }
+                return [NSDate dateWithTimeIntervalSince1970:[object doubleValue]];
+            }
+            return object;
+        }
+        default:
+            break;
+    }
+
+    switch (additionalInformation) {
+        case 20:
+            return @NO;
+        case 21:
+            return @YES;
+        case 22:
+        case 23:
+            return [NSNull null];
+        case 25:
+            return @(AFCBORDoubleFromHalfPrecisionFloat((uint16_t)argument));
+        case 26: {
+            uint32_t bits = (uint32_t)argument;
+            float floatValue = 0;
+            memcpy(&floatValue, &bits, sizeof(floatValue));
+            return @(floatValue);
+        }
+        case 27: {
+            double doubleValue = 0;
+            memcpy(&doubleValue, &argument, sizeof(doubleValue));
+            return @(doubleValue);
+        }
+        default:
+            return nil;
+    }
+}
+
+/**
+ Decodes the single MessagePack or CBOR item in `data`, using `readObject`. Returns `nil` if the item is malformed, or followed by trailing bytes.
+ */
+static id AFBinaryObjectFromData(NSData *data, AFBinaryObjectReadFunction readObject) {
+    AFBinaryObjectReader reader = {data.bytes, data.length, 0};
+    id object = readObject(&reader, 0);
+    if (reader.offset != reader.length) {
+        return nil;
+    }
+
+    return object;
+}
+
+static id AFBinaryObjectResponseObject(AFHTTPResponseSerializer *serializer, NSURLResponse *response, NSData *data, AFBinaryObjectReadFunction readObject, NSString *failureReason, NSError * __autoreleasing *error) {
+    if (![serializer validateResponse:(NSHTTPURLResponse *)response data:data error:error]) {
+        if (!error || AFErrorOrUnderlyingErrorHasCodeInDomain(*error, NSURLErrorCannotDecodeContentData, AFURLResponseSerializationErrorDomain)) {
+            return nil;
+        }
+    }
+
+    if (data.length == 0) {
+        return nil;
+    }
+
+    id responseObject = AFBinaryObjectFromData(data, readObject);
+    if (!responseObject) {
+        if (error) {
+            NSError *serializationError = [NSError errorWithDomain:AFURLResponseSerializationErrorDomain code:NSURLErrorCannotDecodeContentData userInfo:@{NSLocalizedFailureReasonErrorKey: failureReason}];
+            *error = AFErrorWithUnderlyingError(serializationError, *error);
+        }
+        return nil;
+    }
+
+    return responseObject;
+}
+
+@implementation AFMessagePackResponseSerializer
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObjects:@"application/msgpack", @"application/x-msgpack", @"application/vnd.msgpack", nil];
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    return AFBinaryObjectResponseObject(self, response, data, AFMessagePackReadObject, NSLocalizedStringFromTable(@"The data is not valid MessagePack.", @"AFNetworking", nil), error);
+}
+
+@end
+
+#pragma mark -
+
+@implementation AFCBORResponseSerializer
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.acceptableContentTypes = [NSSet setWithObjects:@"application/cbor", nil];
+
+    return self;
+}
+
+#pragma mark - AFURLResponseSerialization
+
+- (id)responseObjectForResponse:(NSURLResponse *)response
+                           data:(NSData *)data
+                          error:(NSError *__autoreleasing *)error
+{
+    return AFBinaryObjectResponseObject(self, response, data, AFCBORReadObject, NSLocalizedStringFromTable(@"The data is not valid CBOR.", @"AFNetworking", nil), error);
+}
+
+@end
+
+#pragma mark -
+
 #if TARGET_OS_IOS || TARGET_OS_TV || TARGET_OS_WATCH
 #import <CoreGraphics/CoreGraphics.h>
 #import <UIKit/UIKit.h>
@@ -87,6 +87,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class AFServerSentEventsTask;
+
 @interface AFURLSessionManager : NSObject <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate, NSURLSessionDownloadDelegate, NSSecureCoding, NSCopying>
 
 /**
@@ -223,6 +225,38 @@ NS_ASSUME_NONNULL_BEGIN
                              downloadProgress:(nullable void (^)(NSProgress *downloadProgress))downloadProgressBlock
                             completionHandler:(nullable void (^)(NSURLResponse *response, id _Nullable responseObject,  NSError * _Nullable error))completionHandler;
 
+/**
+ Creates an `NSURLSessionDataTask` with the specified request, whose newline-delimited JSON response is handed to a block in batches of records, as the lines are received, rather than once the whole response has been received.
+
+ Records are decoded by the `responseSerializer` if it is an `AFJSONLinesResponseSerializer`, and by a default `AFJSONLinesResponseSerializer` otherwise. Neither the response data nor the records are kept by the task, so that the memory it needs stays bounded for responses of any length. When `recordsHandler` falls behind, the task is suspended while more than 1 MB of received data waits to be decoded, and resumed once it catches up. Responses that are not valid are accumulated, and their error is reported to `completionHandler`.
+
+ @param request The HTTP request for the request.
+ @param batchSize The maximum number of records handed to `recordsHandler` at once. `0` means no limit. The records of each chunk of data are handed over as soon as it is received, whether the batch is full or not.
+ @param recordQueue The queue on which `recordsHandler` is executed. If `NULL`, the main queue is used.
+ @param recordsHandler A block object to be executed with each batch of records. This block has no return value and takes a single argument: the JSON values of consecutive lines of the response, in order.
+ @param completionHandler A block object to be executed when the task finishes, after every batch of records has been handled. This block has no return value and takes two arguments: the server response, and the error that occurred, if any.
+ */
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                              recordBatchSize:(NSUInteger)batchSize
+                                  recordQueue:(nullable dispatch_queue_t)recordQueue
+                               recordsHandler:(void (^)(NSArray *records))recordsHandler
+                            completionHandler:(nullable void (^)(NSURLResponse *response, NSError * _Nullable error))completionHandler;
+
+/**
+ Creates an `AFServerSentEventsTask` which, once resumed, connects to the server-sent events stream of the specified request, and hands each event to a block as soon as it is dispatched.
+
+ Events are parsed by an `AFServerSentEventsResponseSerializer`, regardless of the `responseSerializer`. When `eventHandler` falls behind, the data task of the stream is suspended while more than 1 MB of received data waits to be parsed, and resumed once it catches up. Whenever the stream is closed by the server, or fails because of a network error, the task reconnects to it after its reconnection interval, sending the last event ID of the stream in the `Last-Event-ID` header field. Each consecutive connection that fails without a response doubles that wait, up to 60 seconds, or the reconnection interval if it is longer. The stream ends once the task is cancelled, once a connection fails with an error that another connection would fail with too, such as an untrusted server certificate or an App Transport Security policy, or once a response is not a `200` `text/event-stream` response, which the stream must not reconnect to.
+
+ @param request The HTTP request of the stream. It is never loaded from the cache, and its `Accept` header field is set to `text/event-stream`.
+ @param eventQueue The queue on which `eventHandler` is executed. If `NULL`, the main queue is used.
+ @param eventHandler A block object to be executed with each event. This block has no return value and takes a single argument: the event.
+ @param completionHandler A block object to be executed once the stream has ended. This block has no return value and takes two arguments: the response of the last connection to the stream, if any, and the error that ended it, which has the `NSURLErrorCancelled` code if the task was cancelled.
+ */
+- (AFServerSentEventsTask *)eventStreamTaskWithRequest:(NSURLRequest *)request
+                                            eventQueue:(nullable dispatch_queue_t)eventQueue
+                                          eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+                                     completionHandler:(nullable void (^)(NSURLResponse * _Nullable response, NSError *error))completionHandler;
+
 ///---------------------------
 /// @name Running Upload Tasks
 ///---------------------------
@@ -443,6 +477,42 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+#pragma mark -
+
+/**
+ `AFServerSentEventsTask` is a connection to a server-sent events stream, created by `AFURLSessionManager`, which reconnects to the stream with a new data task whenever the previous one completes, until the stream ends.
+ */
+@interface AFServerSentEventsTask : NSObject
+
+/**
+ The data task of the current connection to the stream. `nil` until the task is resumed, while it waits to reconnect, and once the stream has ended.
+ */
+@property (readonly, nonatomic, strong, nullable) NSURLSessionDataTask *dataTask;
+
+/**
+ The last event ID of the stream, sent in the `Last-Event-ID` header field when reconnecting to it.
+ */
+@property (readonly, nonatomic, copy, nullable) NSString *lastEventIdentifier;
+
+/**
+ The time to wait before reconnecting to the stream, in seconds, once the previous connection opened it. `3` by default, until the stream sets another one with its `retry` field.
+ */
+@property (readonly, nonatomic, assign) NSTimeInterval reconnectionInterval;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Connects to the stream, unless the task has already been resumed.
+ */
+- (void)resume;
+
+/**
+ Ends the stream, closing the current connection to it, if any.
+ */
+- (void)cancel;
+
+@end
+
 ///--------------------
 /// @name Notifications
 ///--------------------
@@ -473,7 +543,7 @@ FOUNDATION_EXPORT NSString * const AFURLSessionDidInvalidateNotification;
 FOUNDATION_EXPORT NSString * const AFURLSessionDownloadTaskDidFailToMoveFileNotification;
 
 /**
- The raw response data of the task. Included in the userInfo dictionary of the `AFNetworkingTaskDidCompleteNotification` if response data exists for the task.
+ The raw response data of the task. Included in the userInfo dictionary of the `AFNetworkingTaskDidCompleteNotification` if response data exists for the task, and was not parsed incrementally by an `AFURLResponseIncrementalSerialization` response serializer.
  */
 FOUNDATION_EXPORT NSString * const AFNetworkingTaskDidCompleteResponseDataKey;
 
@@ -85,6 +85,8 @@ static NSString * const AFURLSessionManagerLockName = @"com.alamofire.networking
 
 static NSUInteger const AFMaximumNumberOfAttemptsToRecreateBackgroundSessionUploadTask = 3;
 
+static NSUInteger const AFMaximumIncrementallyParsedDataLengthQueued = 1024 * 1024;
+
 typedef void (^AFURLSessionDidBecomeInvalidBlock)(NSURLSession *session, NSError *error);
 typedef NSURLSessionAuthChallengeDisposition (^AFURLSessionDidReceiveAuthenticationChallengeBlock)(NSURLSession *session, NSURLAuthenticationChallenge *challenge, NSURLCredential * __autoreleasing *credential);
 
@@ -107,6 +109,7 @@ typedef void (^AFURLSessionDownloadTaskDidResumeBlock)(NSURLSession *session, NS
 typedef void (^AFURLSessionTaskProgressBlock)(NSProgress *);
 
 typedef void (^AFURLSessionTaskCompletionHandler)(NSURLResponse *response, id responseObject, NSError *error);
+typedef id <AFURLResponseIncrementalParser> (^AFURLSessionTaskIncrementalParserBlock)(NSURLResponse *response, NSData *data);
 
 
 #pragma mark -
@@ -114,7 +117,14 @@ typedef void (^AFURLSessionTaskCompletionHandler)(NSURLResponse *response, id re
 @interface AFURLSessionManagerTaskDelegate : NSObject <NSURLSessionTaskDelegate, NSURLSessionDataDelegate, NSURLSessionDownloadDelegate>
 - (instancetype)initWithTask:(NSURLSessionTask *)task;
 @property (nonatomic, weak) AFURLSessionManager *manager;
+@property (nonatomic, strong) id <AFURLResponseSerialization> responseSerializer;
 @property (nonatomic, strong) NSMutableData *mutableData;
+@property (nonatomic, strong) id <AFURLResponseIncrementalParser> incrementalParser;
+@property (nonatomic, strong) dispatch_queue_t incrementalParsingQueue;
+@property (nonatomic, strong) NSLock *incrementalParsingLock;
+@property (nonatomic, assign) NSUInteger queuedIncrementalDataLength;
+@property (nonatomic, assign) BOOL suspendedForIncrementalParsing;
+@property (nonatomic, assign) BOOL receivedData;
 @property (nonatomic, strong) NSProgress *uploadProgress;
 @property (nonatomic, strong) NSProgress *downloadProgress;
 @property (nonatomic, copy) NSURL *downloadFileURL;
@@ -122,6 +132,7 @@ typedef void (^AFURLSessionTaskCompletionHandler)(NSURLResponse *response, id re
 @property (nonatomic, copy) AFURLSessionTaskProgressBlock uploadProgressBlock;
 @property (nonatomic, copy) AFURLSessionTaskProgressBlock downloadProgressBlock;
 @property (nonatomic, copy) AFURLSessionTaskCompletionHandler completionHandler;
+@property (nonatomic, copy) AFURLSessionTaskIncrementalParserBlock incrementalParserBlock;
 @end
 
 @implementation AFURLSessionManagerTaskDelegate
@@ -194,11 +205,12 @@ typedef void (^AFURLSessionTaskCompletionHandler)(NSURLResponse *response, id re
 didCompleteWithError:(NSError *)error
 {
     __strong AFURLSessionManager *manager = self.manager;
+    id <AFURLResponseSerialization> responseSerializer = self.responseSerializer ?: manager.responseSerializer;
 
     __block id responseObject = nil;
 
     __block NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
-    userInfo[AFNetworkingTaskDidCompleteResponseSerializerKey] = manager.responseSerializer;
+    userInfo[AFNetworkingTaskDidCompleteResponseSerializerKey] = responseSerializer;
 
     //Performance Improvement from #2672
     NSData *data = nil;
@@ -217,19 +229,41 @@ didCompleteWithError:(NSError *)error
     if (error) {
         userInfo[AFNetworkingTaskDidCompleteErrorKey] = error;
 
-        dispatch_group_async(manager.completionGroup ?: url_session_manager_completion_group(), manager.completionQueue ?: dispatch_get_main_queue(), ^{
-            if (self.completionHandler) {
-                self.completionHandler(task.response, responseObject, error);
-            }
+        dispatch_block_t completion = ^{
+            dispatch_group_async(manager.completionGroup ?: url_session_manager_completion_group(), manager.completionQueue ?: dispatch_get_main_queue(), ^{
+                if (self.completionHandler) {
+                    self.completionHandler(task.response, responseObject, error);
+                }
 
-            dispatch_async(dispatch_get_main_queue(), ^{
-                [[NSNotificationCenter defaultCenter] postNotificationName:AFNetworkingTaskDidCompleteNotification object:task userInfo:userInfo];
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    [[NSNotificationCenter defaultCenter] postNotificationName:AFNetworkingTaskDidCompleteNotification object:task userInfo:userInfo];
+                });
             });
-        });
+        };
+
+        // Incrementally parsed responses that fail are still finished, after the data received before the failure, so that their failure is only reported once every value parsed from that data has been delivered.
+        id <AFURLResponseIncrementalParser> incrementalParser = self.incrementalParser;
+        self.incrementalParser = nil;
+        if (self.incrementalParsingQueue) {
+            dispatch_async(self.incrementalParsingQueue, ^{
+                [incrementalParser responseObjectByFinishingWithError:NULL];
+                completion();
+            });
+        } else {
+            completion();
+        }
     } else {
-        dispatch_async(url_session_manager_processing_queue(), ^{
+        // Incrementally parsed responses are finished on the queue their data was appended on, after all of it.
+        id <AFURLResponseIncrementalParser> incrementalParser = self.incrementalParser;
+        self.incrementalParser = nil;
+
+        dispatch_async(self.incrementalParsingQueue ?: url_session_manager_processing_queue(), ^{
             NSError *serializationError = nil;
-            responseObject = [manager.responseSerializer responseObjectForResponse:task.response data:data error:&serializationError];
+            if (incrementalParser) {
+                responseObject = [incrementalParser responseObjectByFinishingWithError:&serializationError];
+            } else {
+                responseObject = [responseSerializer responseObjectForResponse:task.response data:data error:&serializationError];
+            }
 
             if (self.downloadFileURL) {
                 responseObject = self.downloadFileURL;
@@ -259,13 +293,63 @@ didCompleteWithError:(NSError *)error
 #pragma mark - NSURLSessionDataDelegate
 
 - (void)URLSession:(__unused NSURLSession *)session
-          dataTask:(__unused NSURLSessionDataTask *)dataTask
+          dataTask:(NSURLSessionDataTask *)dataTask
     didReceiveData:(NSData *)data
 {
     self.downloadProgress.totalUnitCount = dataTask.countOfBytesExpectedToReceive;
     self.downloadProgress.completedUnitCount = dataTask.countOfBytesReceived;
 
-    [self.mutableData appendData:data];
+    if (!self.receivedData) {
+        self.receivedData = YES;
+
+        id <AFURLResponseSerialization> responseSerializer = self.responseSerializer ?: self.manager.responseSerializer;
+        if (self.incrementalParserBlock) {
+            self.incrementalParser = self.incrementalParserBlock(dataTask.response, data);
+        } else if ([responseSerializer conformsToProtocol:@protocol(AFURLResponseIncrementalSerialization)]) {
+            self.incrementalParser = [(id <AFURLResponseIncrementalSerialization>)responseSerializer incrementalParserForResponse:dataTask.response data:data];
+        }
+
+        if (self.incrementalParser) {
+            self.mutableData = nil;
+            self.incrementalParsingQueue = dispatch_queue_create("com.alamofire.networking.session.manager.incremental-parsing", DISPATCH_QUEUE_SERIAL);
+            self.incrementalParsingLock = [[NSLock alloc] init];
+        }
+    }
+
+    if (self.incrementalParser) {
+        // Parsers wait for the values they deliver to be handled, so the task is suspended while too much data is queued for its parser, and resumed once half of it has been parsed.
+        NSUInteger length = [data length];
+        [self.incrementalParsingLock lock];
+        self.queuedIncrementalDataLength += length;
+        BOOL suspends = !self.suspendedForIncrementalParsing && self.queuedIncrementalDataLength > AFMaximumIncrementallyParsedDataLengthQueued;
+        if (suspends) {
+            self.suspendedForIncrementalParsing = YES;
+        }
+        [self.incrementalParsingLock unlock];
+
+        if (suspends) {
+            [dataTask suspend];
+        }
+
+        id <AFURLResponseIncrementalParser> incrementalParser = self.incrementalParser;
+        dispatch_async(self.incrementalParsingQueue, ^{
+            [incrementalParser appendData:data];
+
+            [self.incrementalParsingLock lock];
+            self.queuedIncrementalDataLength -= length;
+            BOOL resumes = self.suspendedForIncrementalParsing && self.queuedIncrementalDataLength <= AFMaximumIncrementallyParsedDataLengthQueued / 2;
+            if (resumes) {
+                self.suspendedForIncrementalParsing = NO;
+            }
+            [self.incrementalParsingLock unlock];
+
+            if (resumes) {
+                [dataTask resume];
+            }
+        });
+    } else {
+        [self.mutableData appendData:data];
+    }
 }
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
@@ -467,6 +551,19 @@ static NSString * const AFNSURLSessionTaskDidSuspendNotification = @"com.alamofi
 @property (readwrite, nonatomic, copy) AFURLSessionDownloadTaskDidFinishDownloadingBlock downloadTaskDidFinishDownloading;
 @property (readwrite, nonatomic, copy) AFURLSessionDownloadTaskDidWriteDataBlock downloadTaskDidWriteData;
 @property (readwrite, nonatomic, copy) AFURLSessionDownloadTaskDidResumeBlock downloadTaskDidResume;
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                           responseSerializer:(id <AFURLResponseSerialization>)responseSerializer
+                       incrementalParserBlock:(AFURLSessionTaskIncrementalParserBlock)incrementalParserBlock
+                            completionHandler:(AFURLSessionTaskCompletionHandler)completionHandler;
+@end
+
+@interface AFServerSentEventsTask ()
+- (instancetype)initWithManager:(AFURLSessionManager *)manager
+                        request:(NSURLRequest *)request
+                     eventQueue:(dispatch_queue_t)eventQueue
+                   eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+              completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler;
 @end
 
 @implementation AFURLSessionManager
@@ -733,6 +830,53 @@ static NSString * const AFNSURLSessionTaskDidSuspendNotification = @"com.alamofi
     return dataTask;
 }
 
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                           responseSerializer:(id <AFURLResponseSerialization>)responseSerializer
+                       incrementalParserBlock:(AFURLSessionTaskIncrementalParserBlock)incrementalParserBlock
+                            completionHandler:(AFURLSessionTaskCompletionHandler)completionHandler
+{
+    NSURLSessionDataTask *dataTask = [self dataTaskWithRequest:request uploadProgress:nil downloadProgress:nil completionHandler:completionHandler];
+    if (!dataTask) {
+        return nil;
+    }
+
+    AFURLSessionManagerTaskDelegate *delegate = [self delegateForTask:dataTask];
+    delegate.responseSerializer = responseSerializer;
+    delegate.incrementalParserBlock = incrementalParserBlock;
+
+    return dataTask;
+}
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                              recordBatchSize:(NSUInteger)batchSize
+                                  recordQueue:(dispatch_queue_t)recordQueue
+                               recordsHandler:(void (^)(NSArray *records))recordsHandler
+                            completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler
+{
+    NSParameterAssert(recordsHandler);
+
+    AFJSONLinesResponseSerializer *responseSerializer = [self.responseSerializer isKindOfClass:[AFJSONLinesResponseSerializer class]] ? (AFJSONLinesResponseSerializer *)self.responseSerializer : [AFJSONLinesResponseSerializer serializer];
+
+    return [self dataTaskWithRequest:request responseSerializer:responseSerializer incrementalParserBlock:^id <AFURLResponseIncrementalParser>(NSURLResponse *response, NSData *data) {
+        return [responseSerializer recordParserForResponse:response data:data batchSize:batchSize queue:recordQueue recordsHandler:recordsHandler];
+    } completionHandler:^(NSURLResponse *response, id __unused responseObject, NSError *error) {
+        if (completionHandler) {
+            completionHandler(response, error);
+        }
+    }];
+}
+
+- (AFServerSentEventsTask *)eventStreamTaskWithRequest:(NSURLRequest *)request
+                                            eventQueue:(dispatch_queue_t)eventQueue
+                                          eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+                                     completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler
+{
+    NSParameterAssert(request);
+    NSParameterAssert(eventHandler);
+
+    return [[AFServerSentEventsTask alloc] initWithManager:self request:request eventQueue:eventQueue eventHandler:eventHandler completionHandler:completionHandler];
+}
+
 #pragma mark -
 
 - (NSURLSessionUploadTask *)uploadTaskWithRequest:(NSURLRequest *)request
@@ -1229,3 +1373,232 @@ expectedTotalBytes:(int64_t)expectedTotalBytes
 }
 
 @end
+
+#pragma mark -
+
+static NSTimeInterval const AFServerSentEventsDefaultReconnectionInterval = 3.0;
+static NSTimeInterval const AFServerSentEventsMaximumReconnectionDelay = 60.0;
+
+typedef NS_ENUM(NSInteger, AFServerSentEventsTaskState) {
+    AFServerSentEventsTaskStateSuspended,
+    AFServerSentEventsTaskStateConnected,
+    AFServerSentEventsTaskStateWaitingToReconnect,
+    AFServerSentEventsTaskStateEnded,
+};
+
+static BOOL AFServerSentEventsTaskShouldReconnectAfterError(NSError *error) {
+    if (!error) {
+        return YES;
+    }
+
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+
+    // Errors that a new connection would run into again, such as an untrusted certificate or an App Transport Security policy, end the stream.
+    switch (error.code) {
+        case NSURLErrorCancelled:
+        case NSURLErrorBadURL:
+        case NSURLErrorUnsupportedURL:
+        case NSURLErrorUserCancelledAuthentication:
+        case NSURLErrorUserAuthenticationRequired:
+        case NSURLErrorAppTransportSecurityRequiresSecureConnection:
+        case NSURLErrorServerCertificateHasBadDate:
+        case NSURLErrorServerCertificateUntrusted:
+        case NSURLErrorServerCertificateHasUnknownRoot:
+        case NSURLErrorServerCertificateNotYetValid:
+        case NSURLErrorClientCertificateRejected:
+        case NSURLErrorClientCertificateRequired:
+            return NO;
+        default:
+            return YES;
+    }
+}
+
+@implementation AFServerSentEventsTask {
+    __weak AFURLSessionManager *_manager;
+    NSURLRequest *_request;
+    AFServerSentEventsResponseSerializer *_responseSerializer;
+    dispatch_queue_t _eventQueue;
+    void (^_eventHandler)(AFServerSentEvent *);
+    void (^_completionHandler)(NSURLResponse *, NSError *);
+
+    NSLock *_lock;
+    AFServerSentEventsTaskState _state;
+    NSURLSessionDataTask *_dataTask;
+    NSString *_lastEventIdentifier;
+    NSTimeInterval _reconnectionInterval;
+    NSUInteger _numberOfFailedConnections;
+}
+
+- (instancetype)initWithManager:(AFURLSessionManager *)manager
+                        request:(NSURLRequest *)request
+                     eventQueue:(dispatch_queue_t)eventQueue
+                   eventHandler:(void (^)(AFServerSentEvent *event))eventHandler
+              completionHandler:(void (^)(NSURLResponse *response, NSError *error))completionHandler
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _manager = manager;
+    _request = [request copy];
+    _responseSerializer = [AFServerSentEventsResponseSerializer serializer];
+    _eventQueue = eventQueue;
+    _eventHandler = [eventHandler copy];
+    _completionHandler = [completionHandler copy];
+
+    _lock = [[NSLock alloc] init];
+    _state = AFServerSentEventsTaskStateSuspended;
+    _reconnectionInterval = AFServerSentEventsDefaultReconnectionInterval;
+
+    return self;
+}
+
+- (NSURLSessionDataTask *)dataTask {
+    [_lock lock];
+    NSURLSessionDataTask *dataTask = _dataTask;
+    [_lock unlock];
+
+    return dataTask;
+}
+
+- (NSString *)lastEventIdentifier {
+    [_lock lock];
+    NSString *lastEventIdentifier = _lastEventIdentifier;
+    [_lock unlock];
+
+    return lastEventIdentifier;
+}
+
+- (NSTimeInterval)reconnectionInterval {
+    [_lock lock];
+    NSTimeInterval reconnectionInterval = _reconnectionInterval;
+    [_lock unlock];
+
+    return reconnectionInterval;
+}
+
+- (void)connect {
+    AFURLSessionManager *manager = _manager;
+
+    [_lock lock];
+    if (_state != AFServerSentEventsTaskStateSuspended && _state != AFServerSentEventsTaskStateWaitingToReconnect) {
+        [_lock unlock];
+        return;
+    }
+
+    NSString *lastEventIdentifier = _lastEventIdentifier;
+
+    NSMutableURLRequest *mutableRequest = [_request mutableCopy];
+    mutableRequest.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+    [mutableRequest setValue:@"text/event-stream" forHTTPHeaderField:@"Accept"];
+    if ([lastEventIdentifier length] > 0) {
+        [mutableRequest setValue:lastEventIdentifier forHTTPHeaderField:@"Last-Event-ID"];
+    }
+
+    AFServerSentEventsResponseSerializer *responseSerializer = _responseSerializer;
+    dispatch_queue_t eventQueue = _eventQueue;
+    void (^eventHandler)(AFServerSentEvent *) = _eventHandler;
+
+    // The parser is created on the session delegate queue, and only read once the data task has completed.
+    __block id <AFServerSentEventsParser> eventParser = nil;
+    NSURLSessionDataTask *dataTask = [manager dataTaskWithRequest:mutableRequest responseSerializer:responseSerializer incrementalParserBlock:^id <AFURLResponseIncrementalParser>(NSURLResponse *response, NSData *data) {
+        eventParser = [responseSerializer eventParserForResponse:response data:data lastEventIdentifier:lastEventIdentifier queue:eventQueue eventHandler:eventHandler];
+        return eventParser;
+    } completionHandler:^(NSURLResponse *response, __unused id responseObject, NSError *error) {
+        [self dataTaskDidCompleteWithResponse:response parser:eventParser error:error];
+    }];
+
+    _dataTask = dataTask;
+    _state = dataTask ? AFServerSentEventsTaskStateConnected : AFServerSentEventsTaskStateEnded;
+    [_lock unlock];
+
+    if (dataTask) {
+        [dataTask resume];
+    } else {
+        [self finishWithResponse:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    }
+}
+
+- (void)dataTaskDidCompleteWithResponse:(NSURLResponse *)response
+                                 parser:(id <AFServerSentEventsParser>)parser
+                                  error:(NSError *)error
+{
+    [_lock lock];
+    if (parser) {
+        _lastEventIdentifier = [parser.lastEventIdentifier copy];
+        if (parser.reconnectionInterval >= 0.0) {
+            _reconnectionInterval = parser.reconnectionInterval;
+        }
+    }
+
+    _dataTask = nil;
+
+    // Connections that fail before the stream is opened are retried with an exponential backoff, so that an unreachable server is not retried at the same rate forever.
+    if (response) {
+        _numberOfFailedConnections = 0;
+    } else {
+        _numberOfFailedConnections++;
+    }
+
+    BOOL cancelled = _state == AFServerSentEventsTaskStateEnded;
+    BOOL reconnects = !cancelled && _manager && AFServerSentEventsTaskShouldReconnectAfterError(error);
+    _state = reconnects ? AFServerSentEventsTaskStateWaitingToReconnect : AFServerSentEventsTaskStateEnded;
+    NSTimeInterval reconnectionDelay = _reconnectionInterval;
+    for (NSUInteger idx = 0; idx < _numberOfFailedConnections && reconnectionDelay < AFServerSentEventsMaximumReconnectionDelay; idx++) {
+        reconnectionDelay = MIN(reconnectionDelay * 2.0, AFServerSentEventsMaximumReconnectionDelay);
+    }
+    [_lock unlock];
+
+    if (reconnects) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(reconnectionDelay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [self connect];
+        });
+    } else if (cancelled) {
+        [self finishWithResponse:response error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    } else {
+        [self finishWithResponse:response error:error];
+    }
+}
+
+- (void)finishWithResponse:(NSURLResponse *)response
+                     error:(NSError *)error
+{
+    void (^completionHandler)(NSURLResponse *, NSError *) = _completionHandler;
+    _completionHandler = nil;
+    if (!completionHandler) {
+        return;
+    }
+
+    dispatch_async(_manager.completionQueue ?: dispatch_get_main_queue(), ^{
+        completionHandler(response, error);
+    });
+}
+
+#pragma mark -
+
+- (void)resume {
+    [self connect];
+}
+
+- (void)cancel {
+    [_lock lock];
+    AFServerSentEventsTaskState state = _state;
+    NSURLSessionDataTask *dataTask = _dataTask;
+    _state = AFServerSentEventsTaskStateEnded;
+    [_lock unlock];
+
+    if (state == AFServerSentEventsTaskStateConnected) {
+        [dataTask cancel];
+    } else if (state != AFServerSentEventsTaskStateEnded) {
+        [self finishWithResponse:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    }
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p, request: %@, dataTask: %@, lastEventIdentifier: %@>", NSStringFromClass([self class]), self, _request, self.dataTask, self.lastEventIdentifier];
+}
+
+@end
@@ -0,0 +1,240 @@
+// AFBinarySerializationTests.m
+// Copyright (c) 2011–2016 Alamofire Software Foundation ( http://alamofire.org/ )
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "AFTestCase.h"
+
+#import "AFURLRequestSerialization.h"
+#import "AFURLResponseSerialization.h"
+
+static NSData * AFBinaryTestData(const uint8_t *bytes, size_t length) {
+    return [NSData dataWithBytes:bytes length:length];
+}
+
+static id AFBinaryTestObject() {
+    return @{@"string": @"value",
+             @"unicode": @"é漢\U0001F600",
+             @"integers": @[@0, @127, @128, @65536, @(-1), @(-33), @(-129), @(INT64_MIN), @(INT64_MAX), @(UINT64_MAX)],
+             @"float": @(1.5f),
+             @"double": @(3.25),
+             @"booleans": @[@YES, @NO],
+             @"null": [NSNull null],
+             @"data": [@"bytes" dataUsingEncoding:NSUTF8StringEncoding],
+             @"date": [NSDate dateWithTimeIntervalSince1970:1234567890.5],
+             @"nested": @{@"array": @[@{@"key": @"value"}, @[]], @"empty": @{}},
+             @"long": [@"" stringByPaddingToLength:70000 withString:@"a" startingAtIndex:0]};
+}
+
+static NSArray * AFBinaryTestRecords() {
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 20000; idx++) {
+        [records addObject:@{@"id": @(idx), @"name": [NSString stringWithFormat:@"Record %lu", (unsigned long)idx], @"score": @((double)idx * 0.25), @"values": @[@(idx), @(idx * 2), @(idx * 3)], @"active": @(idx % 2 == 0)}];
+    }
+
+    return records;
+}
+
+#pragma mark -
+
+@interface AFBinarySerializationTests : AFTestCase
+@end
+
+@implementation AFBinarySerializationTests
+
+- (NSHTTPURLResponse *)responseWithContentType:(NSString *)contentType {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": contentType}];
+}
+
+- (id)roundTripObject:(id)object requestSerializer:(AFHTTPRequestSerializer *)requestSerializer responseSerializer:(AFHTTPResponseSerializer *)responseSerializer contentType:(NSString *)contentType {
+    NSError *error = nil;
+    NSURLRequest *request = [requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:object error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Type"], contentType);
+
+    id responseObject = [responseSerializer responseObjectForResponse:[self responseWithContentType:contentType] data:request.HTTPBody error:&error];
+    XCTAssertNil(error);
+
+    return responseObject;
+}
+
+#pragma mark - MessagePack
+
+- (void)testThatMessagePackSerializersRoundTripFoundationObjects {
+    id object = AFBinaryTestObject();
+    XCTAssertEqualObjects([self roundTripObject:object requestSerializer:[AFMessagePackRequestSerializer serializer] responseSerializer:[AFMessagePackResponseSerializer serializer] contentType:@"application/msgpack"], object);
+}
+
+- (void)testThatMessagePackRequestSerializerUsesShortestEncodings {
+    NSURLRequest *request = [[AFMessagePackRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"a": @[@1, @(-1), @300, [NSNull null], @YES]} error:nil];
+    const uint8_t expectedBytes[] = {0x81, 0xa1, 'a', 0x95, 0x01, 0xff, 0xcd, 0x01, 0x2c, 0xc0, 0xc3};
+
+    XCTAssertEqualObjects(request.HTTPBody, AFBinaryTestData(expectedBytes, sizeof(expectedBytes)));
+}
+
+- (void)testThatMessagePackResponseSerializerDecodesTimestamps {
+    const uint8_t bytes[] = {0xd6, 0xff, 0x49, 0x96, 0x02, 0xd2};
+    id responseObject = [[AFMessagePackResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/msgpack"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:nil];
+
+    XCTAssertEqualObjects(responseObject, [NSDate dateWithTimeIntervalSince1970:1234567890]);
+}
+
+- (void)testThatMessagePackResponseSerializerReturnsErrorForTruncatedData {
+    const uint8_t bytes[] = {0x92, 0x01};
+    NSError *error = nil;
+    id responseObject = [[AFMessagePackResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/msgpack"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:&error];
+
+    XCTAssertNil(responseObject);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+}
+
+- (void)testThatMessagePackResponseSerializerRejectsTrailingData {
+    const uint8_t bytes[] = {0x01, 0x02};
+    NSError *error = nil;
+
+    XCTAssertNil([[AFMessagePackResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/msgpack"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:&error]);
+    XCTAssertNotNil(error);
+}
+
+- (void)testThatMessagePackResponseSerializerDoesNotAcceptJSONMimeType {
+    NSError *error = nil;
+    [[AFMessagePackResponseSerializer serializer] validateResponse:[self responseWithContentType:@"application/json"] data:[NSData dataWithBytes:"\x01" length:1] error:&error];
+
+    XCTAssertNotNil(error);
+}
+
+- (void)testThatMessagePackRequestSerializerReturnsErrorForUnsupportedObjects {
+    NSError *error = nil;
+    NSURLRequest *request = [[AFMessagePackRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"key": [NSObject new]} error:&error];
+
+    XCTAssertNil(request);
+    XCTAssertEqualObjects(error.domain, AFURLRequestSerializationErrorDomain);
+}
+
+#pragma mark - CBOR
+
+- (void)testThatCBORSerializersRoundTripFoundationObjects {
+    id object = AFBinaryTestObject();
+    XCTAssertEqualObjects([self roundTripObject:object requestSerializer:[AFCBORRequestSerializer serializer] responseSerializer:[AFCBORResponseSerializer serializer] contentType:@"application/cbor"], object);
+}
+
+- (void)testThatCBORRequestSerializerUsesShortestEncodings {
+    NSURLRequest *request = [[AFCBORRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"a": @[@1, @(-1), @300, [NSNull null], @YES]} error:nil];
+    const uint8_t expectedBytes[] = {0xa1, 0x61, 'a', 0x85, 0x01, 0x20, 0x19, 0x01, 0x2c, 0xf6, 0xf5};
+
+    XCTAssertEqualObjects(request.HTTPBody, AFBinaryTestData(expectedBytes, sizeof(expectedBytes)));
+}
+
+- (void)testThatBinaryRequestSerializersOrderMapEntriesByEncodedKey {
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+    NSMutableDictionary *reversedParameters = [NSMutableDictionary dictionary];
+    NSArray *keys = @[@"aa", @"b", @"a", @"ba", @"c", @"ab"];
+    for (NSUInteger idx = 0; idx < keys.count; idx++) {
+        parameters[keys[idx]] = @{@"nested": @(idx), @"key": @(idx)};
+        reversedParameters[keys[keys.count - 1 - idx]] = @{@"key": @(keys.count - 1 - idx), @"nested": @(keys.count - 1 - idx)};
+    }
+
+    for (AFHTTPRequestSerializer *serializer in @[[AFMessagePackRequestSerializer serializer], [AFCBORRequestSerializer serializer]]) {
+        NSData *body = [serializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:nil].HTTPBody;
+        XCTAssertEqualObjects([serializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:reversedParameters error:nil].HTTPBody, body);
+    }
+
+    // Shorter keys have smaller length heads, so they come first
+    NSURLRequest *request = [[AFCBORRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"aa": @3, @"b": @1, @"a": @2} error:nil];
+    const uint8_t expectedBytes[] = {0xa3, 0x61, 'a', 0x02, 0x61, 'b', 0x01, 0x62, 'a', 'a', 0x03};
+
+    XCTAssertEqualObjects(request.HTTPBody, AFBinaryTestData(expectedBytes, sizeof(expectedBytes)));
+}
+
+- (void)testThatCBORResponseSerializerDecodesIndefiniteLengthItemsAndHalfPrecisionFloats {
+    // [_ 1, (_ h'01', h'02'), 1.0, {_ "a": 100(1)}], where the unknown tag 100 is ignored
+    const uint8_t bytes[] = {0x9f, 0x01, 0x5f, 0x41, 0x01, 0x41, 0x02, 0xff, 0xf9, 0x3c, 0x00, 0xbf, 0x61, 'a', 0xd8, 0x64, 0x01, 0xff, 0xff};
+    const uint8_t dataBytes[] = {0x01, 0x02};
+    id responseObject = [[AFCBORResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/cbor"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:nil];
+
+    XCTAssertEqualObjects(responseObject, (@[@1, AFBinaryTestData(dataBytes, sizeof(dataBytes)), @1.0, @{@"a": @1}]));
+}
+
+- (void)testThatCBORResponseSerializerDecodesEpochDates {
+    const uint8_t bytes[] = {0xc1, 0x1a, 0x49, 0x96, 0x02, 0xd2};
+    id responseObject = [[AFCBORResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/cbor"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:nil];
+
+    XCTAssertEqualObjects(responseObject, [NSDate dateWithTimeIntervalSince1970:1234567890]);
+}
+
+- (void)testThatCBORResponseSerializerReturnsErrorForMalformedData {
+    const uint8_t bytes[] = {0x7b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 'a'};
+    NSError *error = nil;
+    id responseObject = [[AFCBORResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/cbor"] data:AFBinaryTestData(bytes, sizeof(bytes)) error:&error];
+
+    XCTAssertNil(responseObject);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+}
+
+- (void)testThatCBORResponseSerializerReturnsNilObjectAndNilErrorForEmptyData {
+    NSError *error = nil;
+
+    XCTAssertNil([[AFCBORResponseSerializer serializer] responseObjectForResponse:[self responseWithContentType:@"application/cbor"] data:[NSData data] error:&error]);
+    XCTAssertNil(error);
+}
+
+#pragma mark - Performance
+
+- (void)measureEncodingWithRequestSerializer:(AFHTTPRequestSerializer *)requestSerializer {
+    NSArray *records = AFBinaryTestRecords();
+    [self measureBlock:^{
+        [requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:records error:nil];
+    }];
+}
+
+- (void)measureDecodingWithRequestSerializer:(AFHTTPRequestSerializer *)requestSerializer responseSerializer:(AFHTTPResponseSerializer *)responseSerializer contentType:(NSString *)contentType {
+    NSData *data = [requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:AFBinaryTestRecords() error:nil].HTTPBody;
+    NSHTTPURLResponse *response = [self responseWithContentType:contentType];
+    [self measureBlock:^{
+        [responseSerializer responseObjectForResponse:response data:data error:nil];
+    }];
+}
+
+- (void)testJSONEncodingPerformance {
+    [self measureEncodingWithRequestSerializer:[AFJSONRequestSerializer serializer]];
+}
+
+- (void)testMessagePackEncodingPerformance {
+    [self measureEncodingWithRequestSerializer:[AFMessagePackRequestSerializer serializer]];
+}
+
+- (void)testCBOREncodingPerformance {
+    [self measureEncodingWithRequestSerializer:[AFCBORRequestSerializer serializer]];
+}
+
+- (void)testJSONDecodingPerformance {
+    [self measureDecodingWithRequestSerializer:[AFJSONRequestSerializer serializer] responseSerializer:[AFJSONResponseSerializer serializer] contentType:@"application/json"];
+}
+
+- (void)testMessagePackDecodingPerformance {
+    [self measureDecodingWithRequestSerializer:[AFMessagePackRequestSerializer serializer] responseSerializer:[AFMessagePackResponseSerializer serializer] contentType:@"application/msgpack"];
+}
+
+- (void)testCBORDecodingPerformance {
+    [self measureDecodingWithRequestSerializer:[AFCBORRequestSerializer serializer] responseSerializer:[AFCBORResponseSerializer serializer] contentType:@"application/cbor"];
+}
+
+@end
@@ -0,0 +1,440 @@
+// AFJSONModelSerializationTests.m
+// Copyright (c) 2011–2016 Alamofire Software Foundation ( http://alamofire.org/ )
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "AFTestCase.h"
+
+#import "AFURLRequestSerialization.h"
+#import "AFURLResponseSerialization.h"
+
+@interface AFTestTimelineUser : NSObject
+@property (nonatomic, assign) NSUInteger userID;
+@property (nonatomic, copy) NSString *username;
+@property (nonatomic, strong) NSURL *avatarImageURL;
+@property (nonatomic, assign, getter=isFollowing) BOOL following;
+
+- (instancetype)initWithAttributes:(NSDictionary *)attributes;
+@end
+
+@implementation AFTestTimelineUser
+
+- (instancetype)initWithAttributes:(NSDictionary *)attributes {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.userID = (NSUInteger)[[attributes valueForKeyPath:@"id"] integerValue];
+    self.username = [attributes valueForKeyPath:@"username"];
+    self.avatarImageURL = [NSURL URLWithString:[attributes valueForKeyPath:@"avatar_image.url"]];
+    self.following = [[attributes valueForKeyPath:@"you_follow"] boolValue];
+
+    return self;
+}
+
+@end
+
+@interface AFTestTimelinePost : NSObject
+@property (nonatomic, assign) NSUInteger postID;
+@property (nonatomic, copy) NSString *text;
+@property (nonatomic, assign) double score;
+@property (nonatomic, copy) NSString *source;
+@property (nonatomic, strong) AFTestTimelineUser *user;
+@property (nonatomic, copy) NSArray <AFTestTimelineUser *> *mentions;
+
+- (instancetype)initWithAttributes:(NSDictionary *)attributes;
+@end
+
+@implementation AFTestTimelinePost
+
+- (instancetype)initWithAttributes:(NSDictionary *)attributes {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    self.postID = (NSUInteger)[[attributes valueForKeyPath:@"id"] integerValue];
+    self.text = [attributes valueForKeyPath:@"text"];
+    self.score = [[attributes valueForKeyPath:@"score"] doubleValue];
+    self.source = [attributes valueForKeyPath:@"source.name"] ?: @"unknown";
+    self.user = [[AFTestTimelineUser alloc] initWithAttributes:[attributes valueForKeyPath:@"user"]];
+
+    NSMutableArray *mentions = [NSMutableArray array];
+    for (NSDictionary *mentionAttributes in [attributes valueForKeyPath:@"mentions"]) {
+        [mentions addObject:[[AFTestTimelineUser alloc] initWithAttributes:mentionAttributes]];
+    }
+    self.mentions = mentions;
+
+    return self;
+}
+
+@end
+
+@interface AFTestSyncRecord : NSObject <AFJSONEncoding>
+@property (nonatomic, assign) NSInteger recordID;
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic, assign) double weight;
+@property (nonatomic, assign, getter=isDeleted) BOOL deleted;
+@property (nonatomic, copy) NSArray <NSString *> *tags;
+@end
+
+@implementation AFTestSyncRecord
+
+- (void)encodeWithJSONEncoder:(AFJSONEncoder *)encoder {
+    [encoder encodeInteger:self.recordID forKey:@"id"];
+    [encoder encodeString:self.name forKey:@"name"];
+    [encoder encodeDouble:self.weight forKey:@"weight"];
+    [encoder encodeBool:self.isDeleted forKey:@"deleted"];
+    [encoder encodeObject:self.tags forKey:@"tags"];
+}
+
+@end
+
+@interface AFTestTreeNode : NSObject
+@property (nonatomic, copy) NSArray <AFTestTreeNode *> *children;
+@end
+
+@implementation AFTestTreeNode
+@end
+
+static NSDictionary * AFTestTimelineUserAttributes(NSUInteger idx) {
+    return @{@"id": @(idx), @"username": [NSString stringWithFormat:@"user%lu", (unsigned long)idx], @"name": @"Ignored Name", @"avatar_image": @{@"url": [NSString stringWithFormat:@"https://example.com/avatars/%lu.png", (unsigned long)idx], @"width": @100, @"height": @100}, @"you_follow": @(idx % 3 == 0), @"counts": @{@"followers": @(idx * 7), @"following": @(idx * 3)}};
+}
+
+static NSDictionary * AFTestTimelineJSONObject(NSUInteger postCount) {
+    NSMutableArray *posts = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < postCount; idx++) {
+        [posts addObject:@{@"id": @(idx), @"text": [NSString stringWithFormat:@"Post %lu caf\u00e9 \"quoted\"", (unsigned long)idx], @"score": @(idx * 0.5), @"source": @{@"name": @"AFNetworking", @"link": @"https://github.com/AFNetworking/AFNetworking"}, @"user": AFTestTimelineUserAttributes(idx % 50), @"mentions": @[AFTestTimelineUserAttributes(idx + 1), AFTestTimelineUserAttributes(idx + 2)], @"entities": @{@"hashtags": @[], @"links": @[@{@"url": @"https://example.com", @"pos": @0}]}}];
+    }
+
+    return @{@"meta": @{@"code": @200, @"max_id": @(postCount)}, @"data": posts};
+}
+
+#pragma mark -
+
+@interface AFJSONModelSerializationTests : AFTestCase
+@property (nonatomic, strong) AFJSONModelResponseSerializer *responseSerializer;
+@end
+
+@implementation AFJSONModelSerializationTests
+
+- (void)setUp {
+    [super setUp];
+
+    [AFJSONModelSchema registerSchema:[AFJSONModelSchema schemaWithModelClass:[AFTestTimelineUser class] properties:@[
+        [AFJSONModelProperty propertyWithName:@"userID" JSONKeyPath:@"id" type:AFJSONModelPropertyTypeNumber],
+        [AFJSONModelProperty propertyWithName:@"username" JSONKeyPath:@"username" type:AFJSONModelPropertyTypeString],
+        [AFJSONModelProperty propertyWithName:@"avatarImageURL" JSONKeyPath:@"avatar_image.url" type:AFJSONModelPropertyTypeURL],
+        [AFJSONModelProperty propertyWithName:@"following" JSONKeyPath:@"you_follow" type:AFJSONModelPropertyTypeBoolean],
+    ]]];
+
+    [AFJSONModelSchema registerSchema:[AFJSONModelSchema schemaWithModelClass:[AFTestTimelinePost class] properties:@[
+        [AFJSONModelProperty propertyWithName:@"postID" JSONKeyPath:@"id" type:AFJSONModelPropertyTypeNumber],
+        [AFJSONModelProperty propertyWithName:@"text" JSONKeyPath:@"text" type:AFJSONModelPropertyTypeString],
+        [AFJSONModelProperty propertyWithName:@"score" JSONKeyPath:@"score" type:AFJSONModelPropertyTypeNumber],
+        [AFJSONModelProperty propertyWithName:@"source" JSONKeyPath:@"source.name" type:AFJSONModelPropertyTypeString defaultValue:@"unknown"],
+        [AFJSONModelProperty propertyWithName:@"user" JSONKeyPath:@"user" modelClass:[AFTestTimelineUser class]],
+        [AFJSONModelProperty arrayPropertyWithName:@"mentions" JSONKeyPath:@"mentions" modelClass:[AFTestTimelineUser class]],
+    ]]];
+
+    self.responseSerializer = [AFJSONModelResponseSerializer serializerWithModelClass:[AFTestTimelinePost class] rootKeyPath:@"data"];
+}
+
+#pragma mark -
+
+- (NSHTTPURLResponse *)JSONResponse {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/json"}];
+}
+
+- (id)responseObjectWithJSONString:(NSString *)string
+                             error:(NSError * __autoreleasing *)error
+{
+    return [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:[string dataUsingEncoding:NSUTF8StringEncoding] error:error];
+}
+
+- (void)assertUser:(AFTestTimelineUser *)user
+   isEqualToUser:(AFTestTimelineUser *)expectedUser
+{
+    XCTAssertEqual(user.userID, expectedUser.userID);
+    XCTAssertEqualObjects(user.username, expectedUser.username);
+    XCTAssertEqualObjects(user.avatarImageURL, expectedUser.avatarImageURL);
+    XCTAssertEqual(user.isFollowing, expectedUser.isFollowing);
+}
+
+- (void)testThatModelsMatchDictionariesMappedToModels {
+    NSDictionary *JSONObject = AFTestTimelineJSONObject(100);
+    NSData *data = [NSJSONSerialization dataWithJSONObject:JSONObject options:NSJSONWritingPrettyPrinted error:nil];
+
+    NSError *error = nil;
+    NSArray <AFTestTimelinePost *> *posts = [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(posts.count, 100U);
+
+    for (NSUInteger idx = 0; idx < posts.count; idx++) {
+        AFTestTimelinePost *expectedPost = [[AFTestTimelinePost alloc] initWithAttributes:JSONObject[@"data"][idx]];
+        AFTestTimelinePost *post = posts[idx];
+        XCTAssertTrue([post isKindOfClass:[AFTestTimelinePost class]]);
+        XCTAssertEqual(post.postID, expectedPost.postID);
+        XCTAssertEqualObjects(post.text, expectedPost.text);
+        XCTAssertEqual(post.score, expectedPost.score);
+        XCTAssertEqualObjects(post.source, expectedPost.source);
+        [self assertUser:post.user isEqualToUser:expectedPost.user];
+        XCTAssertEqual(post.mentions.count, expectedPost.mentions.count);
+        for (NSUInteger mentionIndex = 0; mentionIndex < post.mentions.count; mentionIndex++) {
+            [self assertUser:post.mentions[mentionIndex] isEqualToUser:expectedPost.mentions[mentionIndex]];
+        }
+    }
+}
+
+- (void)testThatSingleObjectIsDecodedWithoutRootKeyPath {
+    self.responseSerializer.modelClass = [AFTestTimelineUser class];
+    self.responseSerializer.rootKeyPath = nil;
+
+    AFTestTimelineUser *user = [self responseObjectWithJSONString:@"{\"id\": 42, \"us\\u0065rname\": \"mattt\", \"avatar_image\": {\"width\": 1, \"url\": \"https://example.com/a.png\"}, \"you_follow\": true, \"extra\": [{\"id\": 1}]}" error:nil];
+    XCTAssertEqual(user.userID, 42U);
+    XCTAssertEqualObjects(user.username, @"mattt");
+    XCTAssertEqualObjects(user.avatarImageURL, [NSURL URLWithString:@"https://example.com/a.png"]);
+    XCTAssertTrue(user.isFollowing);
+}
+
+- (void)testThatMissingAndNullValuesKeepDefaults {
+    NSArray <AFTestTimelinePost *> *posts = [self responseObjectWithJSONString:@"{\"data\": [{\"id\": 1, \"text\": null, \"source\": null, \"user\": null, \"mentions\": [null, {}]}, {\"source\": {\"name\": \"web\"}}, null]}" error:nil];
+    XCTAssertEqual(posts.count, 2U);
+    XCTAssertEqual(posts[0].postID, 1U);
+    XCTAssertNil(posts[0].text);
+    XCTAssertEqualObjects(posts[0].source, @"unknown");
+    XCTAssertNil(posts[0].user);
+    XCTAssertEqual(posts[0].mentions.count, 1U);
+    XCTAssertEqual(posts[0].mentions[0].userID, 0U);
+    XCTAssertEqualObjects(posts[1].source, @"web");
+    XCTAssertNil(posts[1].mentions);
+}
+
+- (void)testThatMismatchedTypesReturnError {
+    NSArray *strings = @[@"{\"data\": [{\"id\": \"1\"}]}", @"{\"data\": [{\"text\": 1}]}", @"{\"data\": [{\"user\": []}]}", @"{\"data\": [{\"mentions\": {}}]}", @"{\"data\": [{\"mentions\": [1]}]}", @"{\"data\": [{\"user\": {\"you_follow\": 1}}]}", @"{\"data\": 1}", @"{\"meta\": {}}", @"[]"];
+    for (NSString *string in strings) {
+        NSError *error = nil;
+        XCTAssertNil([self responseObjectWithJSONString:string error:&error], @"%@", string);
+        XCTAssertNotNil(error, @"%@", string);
+    }
+}
+
+- (void)testThatInvalidJSONReturnsError {
+    NSArray *strings = @[@"{\"data\": [{\"id\": 1,}]}", @"{\"data\": [{\"id\": 01}]}", @"{\"data\": [{\"id\" 1}]}", @"{\"data\": []", @"{\"data\": []} []", @"{\"data\": [{\"text\": \"\\x\"}]}", @"{\"data\": [{\"id\": 1} {\"id\": 2}]}"];
+    for (NSString *string in strings) {
+        NSError *error = nil;
+        XCTAssertNil([self responseObjectWithJSONString:string error:&error], @"%@", string);
+        XCTAssertNotNil(error, @"%@", string);
+    }
+}
+
+- (void)testThatInvalidSkippedValuesReturnError {
+    NSArray *strings = @[@"{\"data\": [{\"x\": tru, \"id\": 1}]}", @"{\"data\": [{\"x\": {]}, \"id\": 1}]}", @"{\"data\": [{\"x\": [1 2], \"id\": 1}]}", @"{\"data\": [{\"x\": {\"a\" 1}, \"id\": 1}]}", @"{\"data\": [{\"x\": \"\\x\", \"id\": 1}]}", @"{\"data\": [{\"x\": 01, \"id\": 1}]}", @"{\"meta\": nul, \"data\": []}", @"{\"meta\": [}], \"data\": []}"];
+    for (NSString *string in strings) {
+        NSError *error = nil;
+        XCTAssertNil([self responseObjectWithJSONString:string error:&error], @"%@", string);
+        XCTAssertNotNil(error, @"%@", string);
+    }
+}
+
+- (void)testThatDeeplyNestedModelsReturnError {
+    [AFJSONModelSchema registerSchema:[AFJSONModelSchema schemaWithModelClass:[AFTestTreeNode class] properties:@[
+        [AFJSONModelProperty arrayPropertyWithName:@"children" JSONKeyPath:@"children" modelClass:[AFTestTreeNode class]],
+    ]]];
+    self.responseSerializer.modelClass = [AFTestTreeNode class];
+    self.responseSerializer.rootKeyPath = nil;
+
+    NSString * (^nestedTreeString)(NSUInteger) = ^(NSUInteger levelCount) {
+        NSMutableString *string = [NSMutableString string];
+        for (NSUInteger idx = 0; idx < levelCount; idx++) {
+            [string appendString:@"{\"children\": ["];
+        }
+
+        [string appendString:@"{}"];
+        for (NSUInteger idx = 0; idx < levelCount; idx++) {
+            [string appendString:@"]}"];
+        }
+
+        return string;
+    };
+
+    NSError *error = nil;
+    AFTestTreeNode *node = [self responseObjectWithJSONString:nestedTreeString(100) error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqual(node.children.count, 1U);
+
+    XCTAssertNil([self responseObjectWithJSONString:nestedTreeString(10000) error:&error]);
+    XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+}
+
+- (void)testThatOtherEncodingsAreDecoded {
+    NSData *data = [@"{\"data\": [{\"id\": 7, \"text\": \"caf\u00e9\"}]}" dataUsingEncoding:NSUTF16StringEncoding];
+    NSArray <AFTestTimelinePost *> *posts = [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:nil];
+    XCTAssertEqual(posts.count, 1U);
+    XCTAssertEqual(posts[0].postID, 7U);
+    XCTAssertEqualObjects(posts[0].text, @"caf\u00e9");
+}
+
+- (void)testThatUnregisteredModelClassReturnsError {
+    self.responseSerializer.modelClass = [NSObject class];
+
+    NSError *error = nil;
+    XCTAssertNil([self responseObjectWithJSONString:@"{\"data\": []}" error:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+}
+
+- (void)testThatModelResponseSerializerCanBeCopiedAndArchived {
+    AFJSONModelResponseSerializer *copiedSerializer = [self.responseSerializer copy];
+    XCTAssertEqual(copiedSerializer.modelClass, [AFTestTimelinePost class]);
+    XCTAssertEqualObjects(copiedSerializer.rootKeyPath, @"data");
+
+    AFJSONModelResponseSerializer *unarchivedSerializer = [NSKeyedUnarchiver unarchiveObjectWithData:[NSKeyedArchiver archivedDataWithRootObject:self.responseSerializer]];
+    XCTAssertEqual(unarchivedSerializer.modelClass, [AFTestTimelinePost class]);
+    XCTAssertEqualObjects(unarchivedSerializer.rootKeyPath, @"data");
+}
+
+#pragma mark - Model Request Serialization
+
+- (id)JSONObjectOfRequestWithParameters:(id)parameters {
+    NSError *error = nil;
+    NSURLRequest *request = [[AFJSONModelRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Type"], @"application/json");
+
+    return [NSJSONSerialization JSONObjectWithData:request.HTTPBody options:(NSJSONReadingOptions)0 error:nil];
+}
+
+- (void)testThatSchemaModelIsEncodedAtItsKeyPaths {
+    AFTestTimelineUser *user = [[AFTestTimelineUser alloc] initWithAttributes:AFTestTimelineUserAttributes(42)];
+
+    NSDictionary *expectedJSONObject = @{@"id": @42, @"username": @"user42", @"avatar_image": @{@"url": @"https://example.com/avatars/42.png"}, @"you_follow": @YES};
+    XCTAssertEqualObjects([self JSONObjectOfRequestWithParameters:user], expectedJSONObject);
+}
+
+- (void)testThatEncodedModelsDecodeToEqualModels {
+    NSArray *attributes = AFTestTimelineJSONObject(100)[@"data"];
+    NSMutableArray <AFTestTimelinePost *> *expectedPosts = [NSMutableArray array];
+    for (NSDictionary *postAttributes in attributes) {
+        [expectedPosts addObject:[[AFTestTimelinePost alloc] initWithAttributes:postAttributes]];
+    }
+
+    NSURLRequest *request = [[AFJSONModelRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"data": expectedPosts} error:nil];
+    NSArray <AFTestTimelinePost *> *posts = [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:request.HTTPBody error:nil];
+    XCTAssertEqual(posts.count, expectedPosts.count);
+
+    for (NSUInteger idx = 0; idx < posts.count; idx++) {
+        XCTAssertEqual(posts[idx].postID, expectedPosts[idx].postID);
+        XCTAssertEqualObjects(posts[idx].text, expectedPosts[idx].text);
+        XCTAssertEqual(posts[idx].score, expectedPosts[idx].score);
+        XCTAssertEqualObjects(posts[idx].source, expectedPosts[idx].source);
+        [self assertUser:posts[idx].user isEqualToUser:expectedPosts[idx].user];
+        XCTAssertEqual(posts[idx].mentions.count, 2U);
+    }
+}
+
+- (void)testThatEncodableModelWritesItsOwnMembers {
+    AFTestSyncRecord *record = [[AFTestSyncRecord alloc] init];
+    record.recordID = -7;
+    record.name = @"a/b \"c\"\n\u00e9";
+    record.weight = 0.1;
+    record.tags = @[@"x", [NSNull null]];
+
+    NSURLRequest *request = [[AFJSONModelRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@[record] error:nil];
+    NSString *string = [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(string, @"[{\"id\":-7,\"name\":\"a\\/b \\\"c\\\"\\n\u00e9\",\"weight\":0.1,\"deleted\":false,\"tags\":[\"x\",null]}]");
+}
+
+- (void)testThatNilMembersAreLeftOut {
+    AFTestSyncRecord *record = [[AFTestSyncRecord alloc] init];
+    AFTestTimelineUser *user = [[AFTestTimelineUser alloc] init];
+
+    XCTAssertEqualObjects([self JSONObjectOfRequestWithParameters:record], (@{@"id": @0, @"weight": @0, @"deleted": @NO}));
+    XCTAssertEqualObjects([self JSONObjectOfRequestWithParameters:user], (@{@"id": @0, @"you_follow": @NO}));
+}
+
+- (void)testThatUnencodableParametersReturnError {
+    AFTestSyncRecord *record = [[AFTestSyncRecord alloc] init];
+    record.weight = NAN;
+
+    NSArray *parametersList = @[@[record], @[[NSObject new]], @{@1: @"a"}, @"string"];
+    for (id parameters in parametersList) {
+        NSError *error = nil;
+        XCTAssertNil([[AFJSONModelRequestSerializer serializer] requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:&error]);
+        XCTAssertEqualObjects(error.domain, AFURLRequestSerializationErrorDomain);
+    }
+}
+
+#pragma mark - Performance
+
+- (void)testDictionaryMappingPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFTestTimelineJSONObject(2000) options:(NSJSONWritingOptions)0 error:nil];
+    AFJSONResponseSerializer *responseSerializer = [AFJSONResponseSerializer serializer];
+
+    [self measureBlock:^{
+        NSDictionary *JSONObject = [responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:nil];
+        NSMutableArray *posts = [NSMutableArray array];
+        for (NSDictionary *attributes in JSONObject[@"data"]) {
+            [posts addObject:[[AFTestTimelinePost alloc] initWithAttributes:attributes]];
+        }
+    }];
+}
+
+- (void)testDictionaryEncodingPerformance {
+    NSMutableArray <AFTestTimelinePost *> *posts = [NSMutableArray array];
+    for (NSDictionary *attributes in AFTestTimelineJSONObject(2000)[@"data"]) {
+        [posts addObject:[[AFTestTimelinePost alloc] initWithAttributes:attributes]];
+    }
+    AFJSONRequestSerializer *requestSerializer = [AFJSONRequestSerializer serializer];
+
+    [self measureBlock:^{
+        NSMutableArray *JSONObject = [NSMutableArray array];
+        for (AFTestTimelinePost *post in posts) {
+            NSMutableArray *mentions = [NSMutableArray array];
+            for (AFTestTimelineUser *mention in post.mentions) {
+                [mentions addObject:@{@"id": @(mention.userID), @"username": mention.username, @"avatar_image": @{@"url": mention.avatarImageURL.absoluteString}, @"you_follow": @(mention.isFollowing)}];
+            }
+            [JSONObject addObject:@{@"id": @(post.postID), @"text": post.text, @"score": @(post.score), @"source": @{@"name": post.source}, @"user": @{@"id": @(post.user.userID), @"username": post.user.username, @"avatar_image": @{@"url": post.user.avatarImageURL.absoluteString}, @"you_follow": @(post.user.isFollowing)}, @"mentions": mentions}];
+        }
+
+        [requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:JSONObject error:nil];
+    }];
+}
+
+- (void)testSchemaBoundEncodingPerformance {
+    NSMutableArray <AFTestTimelinePost *> *posts = [NSMutableArray array];
+    for (NSDictionary *attributes in AFTestTimelineJSONObject(2000)[@"data"]) {
+        [posts addObject:[[AFTestTimelinePost alloc] initWithAttributes:attributes]];
+    }
+    AFJSONModelRequestSerializer *requestSerializer = [AFJSONModelRequestSerializer serializer];
+
+    [self measureBlock:^{
+        [requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:posts error:nil];
+    }];
+}
+
+- (void)testSchemaBoundDecodingPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFTestTimelineJSONObject(2000) options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:nil];
+    }];
+}
+
+@end
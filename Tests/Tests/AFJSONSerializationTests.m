@@ -21,6 +21,8 @@
 
 #import "AFTestCase.h"
 
+#import <malloc/malloc.h>
+
 #import "AFURLRequestSerialization.h"
 #import "AFURLResponseSerialization.h"
 
@@ -28,6 +30,79 @@ static NSData * AFJSONTestData() {
     return [NSJSONSerialization dataWithJSONObject:@{@"foo": @"bar"} options:(NSJSONWritingOptions)0 error:nil];
 }
 
+static NSData * AFJSONParsingTestData() {
+    return [@" {\"name\": \"caf\u00e9 \\\"quoted\\\" \\u00e9\\n\\ud83d\\ude00 \u2603 \\/\", \"numbers\": [0, -0.5, 1e10, 25E-2, 9223372036854775807, -9223372036854775808], \"literals\": [true, false, null], \"empty\": [{}, [], \"\"], \"nested\": {\"a\": {\"b\": [[1], {\"c\": null}]}}, \"\": 1}\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+static NSArray <NSString *> * AFInvalidJSONTestStrings() {
+    return @[@"{invalid}", @"{\"a\": 1,}", @"[1 2]", @"[1,]", @"{\"a\" 1}", @"{\"a\": 1]", @"[tru]", @"[truex]", @"[01]", @"[1.]", @"[-]", @"[1e400]", @"[\"a\"x]", @"[\"\\x\"]", @"[\"\\ud800\"]", @"[\"\t\"]", @"{} x", @"{\"a\": [1", @"[\"abc"];
+}
+
+static NSArray * AFJSONBenchmarkRecords() {
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 20000; idx++) {
+        [records addObject:@{@"id": @(idx), @"name": [NSString stringWithFormat:@"Record %lu", (unsigned long)idx], @"score": @(idx * 0.5), @"active": @(idx % 2 == 0), @"tags": @[@"a", @"b"], @"owner": @{@"id": @(idx % 100), @"login": @"mattt"}}];
+    }
+
+    return records;
+}
+
+static NSArray * AFJSONBenchmarkText() {
+    NSMutableArray *posts = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 5000; idx++) {
+        [posts addObject:@{@"title": [NSString stringWithFormat:@"Post %lu", (unsigned long)idx], @"body": @"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n\t\"Ut enim ad minim veniam\", quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. Caf\u00e9 \u2603"}];
+    }
+
+    return posts;
+}
+
+// Objects with the same 20 keys, which are long enough not to be stored as tagged pointers.
+static NSArray * AFJSONBenchmarkListItems() {
+    NSMutableArray *items = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 50000; idx++) {
+        NSMutableDictionary *item = [NSMutableDictionary dictionary];
+        for (NSUInteger field = 0; field < 20; field++) {
+            item[[NSString stringWithFormat:@"list_item_field_%02lu", (unsigned long)field]] = @(idx + field);
+        }
+
+        [items addObject:item];
+    }
+
+    return items;
+}
+
+static NSArray * AFJSONBenchmarkCoordinates() {
+    NSMutableArray *coordinates = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 50000; idx++) {
+        [coordinates addObject:@[@(37.7749 + idx * 0.0001), @(-122.4194 - idx * 0.0001), @(idx)]];
+    }
+
+    return coordinates;
+}
+
+// The recursive copy that `removesKeysWithNullValues` was originally implemented with, which null removal is expected to match.
+static id AFJSONObjectByCopyingWithoutKeysWithNullValues(id JSONObject, NSJSONReadingOptions readingOptions) {
+    if ([JSONObject isKindOfClass:[NSArray class]]) {
+        NSMutableArray *mutableArray = [NSMutableArray array];
+        for (id value in (NSArray *)JSONObject) {
+            [mutableArray addObject:AFJSONObjectByCopyingWithoutKeysWithNullValues(value, readingOptions)];
+        }
+
+        return (readingOptions & NSJSONReadingMutableContainers) ? mutableArray : [NSArray arrayWithArray:mutableArray];
+    } else if ([JSONObject isKindOfClass:[NSDictionary class]]) {
+        NSMutableDictionary *mutableDictionary = [NSMutableDictionary dictionary];
+        [(NSDictionary *)JSONObject enumerateKeysAndObjectsUsingBlock:^(id key, id value, __unused BOOL *stop) {
+            if (![value isEqual:[NSNull null]]) {
+                mutableDictionary[key] = AFJSONObjectByCopyingWithoutKeysWithNullValues(value, readingOptions);
+            }
+        }];
+
+        return (readingOptions & NSJSONReadingMutableContainers) ? mutableDictionary : [NSDictionary dictionaryWithDictionary:mutableDictionary];
+    }
+
+    return JSONObject;
+}
+
 #pragma mark -
 
 @interface AFJSONRequestSerializationTests : AFTestCase
@@ -89,6 +164,136 @@ static NSData * AFJSONTestData() {
     XCTAssertEqualObjects(error.localizedFailureReason, @"The `parameters` argument is not valid JSON.");
 }
 
+#pragma mark - Streaming
+
+- (NSData *)dataByReadingInputStream:(NSInputStream *)inputStream
+                          bufferSize:(NSUInteger)bufferSize
+{
+    NSMutableData *data = [NSMutableData data];
+    uint8_t *buffer = malloc(bufferSize);
+
+    [inputStream open];
+    NSInteger numberOfBytesRead = 0;
+    while ((numberOfBytesRead = [inputStream read:buffer maxLength:bufferSize]) > 0) {
+        [data appendBytes:buffer length:(NSUInteger)numberOfBytesRead];
+    }
+    [inputStream close];
+
+    free(buffer);
+
+    return numberOfBytesRead < 0 ? nil : data;
+}
+
+- (void)testThatStreamingJSONRequestSerializationMatchesJSONSerialization {
+    self.requestSerializer.streamsHTTPBody = YES;
+
+    NSArray *parameters = @[@{@"string": @"quote \" backslash \\ slash / control \n\t café 👍"},
+                            @{@"integer": @(-42)},
+                            @{@"unsigned": @(ULLONG_MAX)},
+                            @{@"double": @(0.1)},
+                            @{@"booleans": @[@YES, @NO]},
+                            @{@"null": [NSNull null]},
+                            @{@"nested": @[@[], @{}, @[@{@"key": @"value"}]]}];
+
+    NSError *error = nil;
+    NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:&error];
+    XCTAssertNil(error);
+    XCTAssertNil(request.HTTPBody);
+    XCTAssertNotNil(request.HTTPBodyStream);
+
+    NSData *expectedData = [NSJSONSerialization dataWithJSONObject:parameters options:(NSJSONWritingOptions)0 error:nil];
+    NSData *streamedData = [self dataByReadingInputStream:request.HTTPBodyStream bufferSize:7];
+
+    XCTAssertEqualObjects(streamedData, expectedData);
+    XCTAssertNil([request valueForHTTPHeaderField:@"Content-Length"]);
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Type"], @"application/json");
+}
+
+- (void)testThatStreamingJSONRequestSerializationSetsContentLengthWhenComputed {
+    self.requestSerializer.streamsHTTPBody = YES;
+    self.requestSerializer.computesStreamedContentLength = YES;
+
+    NSDictionary *parameters = @{@"key": @"value", @"values": @[@1, @2.5, @"café"]};
+
+    NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:nil];
+    NSData *expectedData = [NSJSONSerialization dataWithJSONObject:parameters options:(NSJSONWritingOptions)0 error:nil];
+
+    XCTAssertEqualObjects([self dataByReadingInputStream:request.HTTPBodyStream bufferSize:5], expectedData);
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"Content-Length"], ([NSString stringWithFormat:@"%lu", (unsigned long)expectedData.length]));
+}
+
+- (void)testThatStreamingJSONRequestSerializationHandlesPrettyPrintedLargeParameters {
+    self.requestSerializer.streamsHTTPBody = YES;
+    self.requestSerializer.writingOptions = NSJSONWritingPrettyPrinted;
+
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 1000; idx++) {
+        [records addObject:@{@"id": @(idx), @"name": [NSString stringWithFormat:@"Record %lu", (unsigned long)idx], @"tags": @[@"a", @"b"], @"score": @(idx / 3.0)}];
+    }
+    NSDictionary *parameters = @{@"records": records, @"description": [@"" stringByPaddingToLength:10000 withString:@"long string " startingAtIndex:0]};
+
+    NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:nil];
+    NSData *streamedData = [self dataByReadingInputStream:request.HTTPBodyStream bufferSize:4096];
+
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:streamedData options:(NSJSONReadingOptions)0 error:nil], parameters);
+
+    NSData *copiedStreamData = [self dataByReadingInputStream:[request.HTTPBodyStream copy] bufferSize:1024];
+    XCTAssertEqualObjects(copiedStreamData, streamedData);
+}
+
+- (void)testThatStreamingJSONRequestSerializationErrorsWithInvalidJSON {
+    self.requestSerializer.streamsHTTPBody = YES;
+    self.requestSerializer.computesStreamedContentLength = YES;
+
+    NSArray *invalidParameters = @[@{@"key": [NSSet setWithObject:@"value"]},
+                                   @{@"key": @(NAN)},
+                                   @{@1: @"value"},
+                                   @{@"key": [[NSString alloc] initWithBytes:"\xd8\x00" length:2 encoding:NSUTF16StringEncoding]}];
+
+    for (NSDictionary *parameters in invalidParameters) {
+        NSError *error = nil;
+        NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:parameters error:&error];
+
+        XCTAssertNil(request);
+        XCTAssertEqualObjects(error.domain, AFURLRequestSerializationErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+        XCTAssertEqualObjects(error.localizedFailureReason, @"The `parameters` argument is not valid JSON.");
+    }
+}
+
+- (void)testThatStreamedJSONBodyFailsWithInvalidJSON {
+    self.requestSerializer.streamsHTTPBody = YES;
+
+    NSError *error = nil;
+    NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@{@"key": @(NAN)} error:&error];
+    XCTAssertNil(error);
+
+    NSInputStream *inputStream = request.HTTPBodyStream;
+    XCTAssertNil([self dataByReadingInputStream:inputStream bufferSize:16]);
+    XCTAssertNotNil(inputStream.streamError);
+
+    XCTAssertNil([self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:@"fragment" error:&error]);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+}
+
+- (void)testStreamingJSONRequestBodyPerformance {
+    self.requestSerializer.streamsHTTPBody = YES;
+
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 50000; idx++) {
+        [records addObject:@{@"id": @(idx), @"name": [NSString stringWithFormat:@"Record %lu", (unsigned long)idx], @"active": @YES}];
+    }
+
+    [self measureBlock:^{
+        NSMutableURLRequest *request = [self.requestSerializer requestWithMethod:@"POST" URLString:self.baseURL.absoluteString parameters:records error:nil];
+        NSInputStream *inputStream = request.HTTPBodyStream;
+        uint8_t buffer[16384];
+        [inputStream open];
+        while ([inputStream read:buffer maxLength:sizeof(buffer)] > 0) {}
+        [inputStream close];
+    }];
+}
+
 @end
 
 #pragma mark -
@@ -196,6 +401,12 @@ static NSData * AFJSONTestData() {
     [self.responseSerializer setAcceptableContentTypes:[NSSet setWithObject:@"test/type"]];
     [self.responseSerializer setReadingOptions:NSJSONReadingMutableLeaves];
     [self.responseSerializer setRemovesKeysWithNullValues:YES];
+    [self.responseSerializer setParsesIncrementally:YES];
+    [self.responseSerializer setParserBackend:AFJSONParserBackendVectorized];
+    [self.responseSerializer setParsesTopLevelArraysConcurrently:YES];
+    [self.responseSerializer setInternsKeys:YES];
+    [self.responseSerializer setMaximumInternedKeyCount:10];
+    [self.responseSerializer setProjectedKeyPaths:[NSSet setWithObject:@"data.items[*].id"]];
 
     AFJSONResponseSerializer *copiedSerializer = [self.responseSerializer copy];
     XCTAssertNotEqual(copiedSerializer, self.responseSerializer);
@@ -203,6 +414,797 @@ static NSData * AFJSONTestData() {
     XCTAssertEqual(copiedSerializer.acceptableContentTypes, self.responseSerializer.acceptableContentTypes);
     XCTAssertEqual(copiedSerializer.readingOptions, self.responseSerializer.readingOptions);
     XCTAssertEqual(copiedSerializer.removesKeysWithNullValues, self.responseSerializer.removesKeysWithNullValues);
+    XCTAssertEqual(copiedSerializer.parsesIncrementally, self.responseSerializer.parsesIncrementally);
+    XCTAssertEqual(copiedSerializer.parserBackend, self.responseSerializer.parserBackend);
+    XCTAssertEqual(copiedSerializer.parsesTopLevelArraysConcurrently, self.responseSerializer.parsesTopLevelArraysConcurrently);
+    XCTAssertEqual(copiedSerializer.internsKeys, self.responseSerializer.internsKeys);
+    XCTAssertEqual(copiedSerializer.maximumInternedKeyCount, self.responseSerializer.maximumInternedKeyCount);
+    XCTAssertEqualObjects(copiedSerializer.projectedKeyPaths, self.responseSerializer.projectedKeyPaths);
+}
+
+#pragma mark - Incremental Parsing
+
+- (NSHTTPURLResponse *)JSONResponse {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/json"}];
+}
+
+- (id)incrementallyParsedResponseObjectWithChunks:(NSArray <NSData *> *)chunks
+                                            error:(NSError * __autoreleasing *)error
+{
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self JSONResponse] data:chunks.firstObject ?: [NSData data]];
+    XCTAssertNotNil(parser);
+
+    for (NSData *chunk in chunks) {
+        [parser appendData:chunk];
+    }
+
+    return [parser responseObjectByFinishingWithError:error];
+}
+
+- (id)incrementallyParsedResponseObjectWithData:(NSData *)data
+                                    chunkLength:(NSUInteger)chunkLength
+                                          error:(NSError * __autoreleasing *)error
+{
+    NSMutableArray *chunks = [NSMutableArray array];
+    for (NSUInteger location = 0; location < data.length; location += chunkLength) {
+        [chunks addObject:[data subdataWithRange:NSMakeRange(location, MIN(chunkLength, data.length - location))]];
+    }
+
+    return [self incrementallyParsedResponseObjectWithChunks:chunks error:error];
+}
+
+- (void)testThatIncrementalParserIsOnlyCreatedWhenEnabledForValidResponses {
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:[self JSONResponse] data:AFJSONTestData()]);
+
+    self.responseSerializer.parsesIncrementally = YES;
+    XCTAssertNotNil([self.responseSerializer incrementalParserForResponse:[self JSONResponse] data:AFJSONTestData()]);
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:500 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/json"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:AFJSONTestData()]);
+
+    response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/html"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:AFJSONTestData()]);
+}
+
+- (void)testThatIncrementalParsingMatchesJSONSerializationAtEverySplitPoint {
+    self.responseSerializer.parsesIncrementally = YES;
+
+    NSData *data = AFJSONParsingTestData();
+    id expectedObject = [NSJSONSerialization JSONObjectWithData:data options:(NSJSONReadingOptions)0 error:nil];
+    XCTAssertNotNil(expectedObject);
+
+    for (NSUInteger idx = 0; idx <= data.length; idx++) {
+        NSArray *chunks = @[[data subdataWithRange:NSMakeRange(0, idx)], [data subdataWithRange:NSMakeRange(idx, data.length - idx)]];
+        NSError *error = nil;
+        id responseObject = [self incrementallyParsedResponseObjectWithChunks:chunks error:&error];
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(responseObject, expectedObject, @"Split at %lu", (unsigned long)idx);
+    }
+
+    NSError *error = nil;
+    XCTAssertEqualObjects([self incrementallyParsedResponseObjectWithData:data chunkLength:1 error:&error], expectedObject);
+    XCTAssertNil(error);
+}
+
+- (void)testThatIncrementalParsingHandlesByteOrderMarksAndOtherEncodings {
+    self.responseSerializer.parsesIncrementally = YES;
+
+    NSMutableData *data = [NSMutableData dataWithBytes:"\xEF\xBB\xBF" length:3];
+    [data appendData:AFJSONTestData()];
+    XCTAssertEqualObjects([self incrementallyParsedResponseObjectWithData:data chunkLength:2 error:nil], @{@"foo": @"bar"});
+
+    data = [[@"{\"foo\": \"bar\"}" dataUsingEncoding:NSUTF16LittleEndianStringEncoding] mutableCopy];
+    XCTAssertEqualObjects([self incrementallyParsedResponseObjectWithData:data chunkLength:3 error:nil], @{@"foo": @"bar"});
+}
+
+- (void)testThatIncrementalParsingHonorsReadingOptions {
+    self.responseSerializer.parsesIncrementally = YES;
+    self.responseSerializer.readingOptions = NSJSONReadingMutableContainers | NSJSONReadingMutableLeaves;
+
+    NSData *data = [@"{\"items\": [1, 2], \"name\": \"foo\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableDictionary *responseObject = [self incrementallyParsedResponseObjectWithData:data chunkLength:4 error:nil];
+
+    XCTAssertNoThrow(responseObject[@"bar"] = @"baz");
+    XCTAssertNoThrow([responseObject[@"items"] addObject:@3]);
+    XCTAssertNoThrow([responseObject[@"name"] appendString:@"bar"]);
+    XCTAssertEqualObjects(responseObject[@"items"], (@[@1, @2, @3]));
+    XCTAssertEqualObjects(responseObject[@"name"], @"foobar");
+}
+
+- (void)testThatIncrementalParsingOnlyAcceptsFragmentsWhenAllowed {
+    self.responseSerializer.parsesIncrementally = YES;
+    NSData *data = [@"12.5" dataUsingEncoding:NSUTF8StringEncoding];
+
+    NSError *error = nil;
+    XCTAssertNil([self incrementallyParsedResponseObjectWithData:data chunkLength:1 error:&error]);
+    XCTAssertNotNil(error);
+
+    self.responseSerializer.readingOptions = NSJSONReadingAllowFragments;
+    error = nil;
+    XCTAssertEqualObjects([self incrementallyParsedResponseObjectWithData:data chunkLength:1 error:&error], @12.5);
+    XCTAssertNil(error);
+}
+
+- (void)testThatIncrementalParsingReturnsErrorForInvalidJSON {
+    self.responseSerializer.parsesIncrementally = YES;
+
+    for (NSString *string in AFInvalidJSONTestStrings()) {
+        NSError *error = nil;
+        id responseObject = [self incrementallyParsedResponseObjectWithData:[string dataUsingEncoding:NSUTF8StringEncoding] chunkLength:3 error:&error];
+
+        XCTAssertNil(responseObject, @"%@", string);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain, @"%@", string);
+        XCTAssertEqual(error.code, NSPropertyListReadCorruptError, @"%@", string);
+    }
+}
+
+- (void)testThatIncrementalParsingReturnsNilObjectAndNilErrorForEmptyDataAndSingleSpace {
+    self.responseSerializer.parsesIncrementally = YES;
+
+    for (NSData *data in @[[NSData data], [@" " dataUsingEncoding:NSUTF8StringEncoding]]) {
+        NSError *error = nil;
+        XCTAssertNil([self incrementallyParsedResponseObjectWithChunks:@[data] error:&error]);
+        XCTAssertNil(error);
+    }
+}
+
+- (void)testThatIncrementalParsingRemovesKeysWithNullValues {
+    self.responseSerializer.parsesIncrementally = YES;
+    self.responseSerializer.removesKeysWithNullValues = YES;
+
+    NSData *data = [@"{\"key\": \"value\", \"nullkey\": null, \"array\": [{\"subnullkey\": null}]}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *responseObject = [self incrementallyParsedResponseObjectWithData:data chunkLength:5 error:nil];
+
+    XCTAssertEqualObjects(responseObject, (@{@"key": @"value", @"array": @[@{}]}));
+}
+
+- (void)testIncrementalJSONParsingPerformance {
+    self.responseSerializer.parsesIncrementally = YES;
+
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger idx = 0; idx < 50000; idx++) {
+        [records addObject:@{@"id": @(idx), @"name": [NSString stringWithFormat:@"Record %lu", (unsigned long)idx], @"score": @(idx * 0.5), @"active": @YES, @"tags": @[@"a", @"b"]}];
+    }
+
+    NSData *data = [NSJSONSerialization dataWithJSONObject:records options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self incrementallyParsedResponseObjectWithData:data chunkLength:16384 error:nil];
+    }];
+}
+
+#pragma mark - Null Removal
+
+- (void)testThatEveryParserRemovesKeysWithNullValuesLikeRecursiveCopy {
+    self.responseSerializer.removesKeysWithNullValues = YES;
+
+    NSArray *strings = @[@"{\"a\": null, \"b\": [null, {\"c\": null, \"d\": 1}], \"e\": {\"f\": {\"g\": null}}, \"h\": \"i\"}",
+                         @"[{\"a\": 1}, {\"b\": null}, [null], null]",
+                         @"{\"a\": 1, \"a\": null, \"b\": null, \"b\": 2, \"c\": null, \"c\": null, \"d\": 3, \"d\": 4}",
+                         @"{\"unchanged\": {\"a\": [1, 2]}, \"changed\": {\"b\": null}}"];
+
+    for (NSNumber *readingOptions in @[@0, @(NSJSONReadingMutableContainers), @(NSJSONReadingMutableContainers | NSJSONReadingMutableLeaves)]) {
+        self.responseSerializer.readingOptions = [readingOptions unsignedIntegerValue];
+
+        for (NSString *string in strings) {
+            NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+            id JSONObject = [NSJSONSerialization JSONObjectWithData:data options:self.responseSerializer.readingOptions error:nil];
+            id expectedObject = AFJSONObjectByCopyingWithoutKeysWithNullValues(JSONObject, self.responseSerializer.readingOptions);
+
+            self.responseSerializer.parsesIncrementally = YES;
+            id incrementallyParsedObject = [self incrementallyParsedResponseObjectWithData:data chunkLength:3 error:nil];
+            self.responseSerializer.parsesIncrementally = NO;
+
+            for (id responseObject in @[[self responseObjectWithData:data parserBackend:AFJSONParserBackendFoundation error:nil], [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil], incrementallyParsedObject]) {
+                XCTAssertEqualObjects(responseObject, expectedObject, @"%@", string);
+
+                if (!(self.responseSerializer.readingOptions & NSJSONReadingMutableContainers)) {
+                    continue;
+                } else if ([responseObject isKindOfClass:[NSDictionary class]]) {
+                    XCTAssertNoThrow(responseObject[@"added"] = @0);
+                } else {
+                    XCTAssertNoThrow([responseObject addObject:@0]);
+                }
+            }
+        }
+    }
+}
+
+- (void)testFoundationParserBackendNullRemovalPerformance {
+    self.responseSerializer.removesKeysWithNullValues = YES;
+
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSDictionary *record in AFJSONBenchmarkRecords()) {
+        NSMutableDictionary *mutableRecord = [record mutableCopy];
+        mutableRecord[@"deleted_at"] = [NSNull null];
+        [records addObject:mutableRecord];
+    }
+
+    [self measureParsingOfObject:records withParserBackend:AFJSONParserBackendFoundation];
+}
+
+- (void)testVectorizedParserBackendNullRemovalPerformance {
+    self.responseSerializer.removesKeysWithNullValues = YES;
+
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSDictionary *record in AFJSONBenchmarkRecords()) {
+        NSMutableDictionary *mutableRecord = [record mutableCopy];
+        mutableRecord[@"deleted_at"] = [NSNull null];
+        [records addObject:mutableRecord];
+    }
+
+    [self measureParsingOfObject:records withParserBackend:AFJSONParserBackendVectorized];
+}
+
+#pragma mark - Parser Backends
+
+- (id)responseObjectWithData:(NSData *)data
+               parserBackend:(AFJSONParserBackend)parserBackend
+                       error:(NSError * __autoreleasing *)error
+{
+    self.responseSerializer.parserBackend = parserBackend;
+
+    return [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:error];
+}
+
+- (void)testThatVectorizedParserBackendMatchesJSONSerialization {
+    NSMutableArray *documents = [NSMutableArray arrayWithObject:AFJSONParsingTestData()];
+    for (id object in @[AFJSONBenchmarkRecords(), AFJSONBenchmarkText(), AFJSONBenchmarkCoordinates(), @[], @{}, @[@[@[@[]]]]]) {
+        [documents addObject:[NSJSONSerialization dataWithJSONObject:object options:NSJSONWritingPrettyPrinted error:nil]];
+    }
+
+    // Move strings, escapes, and scalars across every position of the 64 byte blocks the data is indexed in.
+    for (NSUInteger idx = 0; idx < 130; idx++) {
+        NSString *padding = [@"" stringByPaddingToLength:idx withString:@" " startingAtIndex:0];
+        NSString *backslashes = [@"" stringByPaddingToLength:(idx % 4) * 2 withString:@"\\\\" startingAtIndex:0];
+        NSString *string = [NSString stringWithFormat:@"%@[\"%@\\\"\", \"a%@\", 12345, true, {\"k\\\\\": null}]", padding, padding, backslashes];
+        [documents addObject:[string dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    for (NSData *data in documents) {
+        id expectedObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendFoundation error:nil];
+        NSError *error = nil;
+        id responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:&error];
+
+        XCTAssertNil(error);
+        XCTAssertNotNil(responseObject);
+        XCTAssertEqualObjects(responseObject, expectedObject);
+    }
+}
+
+- (void)testThatVectorizedParserBackendHonorsReadingOptions {
+    self.responseSerializer.readingOptions = NSJSONReadingMutableContainers | NSJSONReadingMutableLeaves;
+
+    NSData *data = [@"{\"items\": [1, 2], \"name\": \"foo\"}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSMutableDictionary *responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+
+    XCTAssertNoThrow(responseObject[@"bar"] = @"baz");
+    XCTAssertNoThrow([responseObject[@"items"] addObject:@3]);
+    XCTAssertNoThrow([responseObject[@"name"] appendString:@"bar"]);
+    XCTAssertEqualObjects(responseObject[@"items"], (@[@1, @2, @3]));
+    XCTAssertEqualObjects(responseObject[@"name"], @"foobar");
+
+    data = [@" \"fragment\" " dataUsingEncoding:NSUTF8StringEncoding];
+    NSError *error = nil;
+    XCTAssertNil([self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:&error]);
+    XCTAssertNotNil(error);
+
+    self.responseSerializer.readingOptions = NSJSONReadingAllowFragments;
+    error = nil;
+    XCTAssertEqualObjects([self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:&error], @"fragment");
+    XCTAssertNil(error);
+}
+
+- (void)testThatVectorizedParserBackendParsesOtherEncodingsWithJSONSerialization {
+    NSData *data = [@"{\"foo\": \"bar\"}" dataUsingEncoding:NSUTF16StringEncoding];
+    XCTAssertEqualObjects([self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil], @{@"foo": @"bar"});
+}
+
+- (void)testThatVectorizedParserBackendReturnsErrorForInvalidJSON {
+    for (NSString *string in AFInvalidJSONTestStrings()) {
+        NSError *error = nil;
+        id responseObject = [self responseObjectWithData:[string dataUsingEncoding:NSUTF8StringEncoding] parserBackend:AFJSONParserBackendVectorized error:&error];
+
+        XCTAssertNil(responseObject, @"%@", string);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain, @"%@", string);
+        XCTAssertEqual(error.code, NSPropertyListReadCorruptError, @"%@", string);
+    }
+}
+
+- (void)measureParsingOfObject:(id)object
+             withParserBackend:(AFJSONParserBackend)parserBackend
+{
+    NSData *data = [NSJSONSerialization dataWithJSONObject:object options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self responseObjectWithData:data parserBackend:parserBackend error:nil];
+    }];
+}
+
+- (void)testFoundationParserBackendRecordsPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkRecords() withParserBackend:AFJSONParserBackendFoundation];
+}
+
+- (void)testVectorizedParserBackendRecordsPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkRecords() withParserBackend:AFJSONParserBackendVectorized];
+}
+
+- (void)testFoundationParserBackendTextPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkText() withParserBackend:AFJSONParserBackendFoundation];
+}
+
+- (void)testVectorizedParserBackendTextPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkText() withParserBackend:AFJSONParserBackendVectorized];
+}
+
+- (void)testFoundationParserBackendCoordinatesPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkCoordinates() withParserBackend:AFJSONParserBackendFoundation];
+}
+
+- (void)testVectorizedParserBackendCoordinatesPerformance {
+    [self measureParsingOfObject:AFJSONBenchmarkCoordinates() withParserBackend:AFJSONParserBackendVectorized];
+}
+
+#pragma mark - Concurrent Parsing
+
+- (id)concurrentlyParsedResponseObjectWithData:(NSData *)data
+                                         error:(NSError * __autoreleasing *)error
+{
+    self.responseSerializer.parsesTopLevelArraysConcurrently = YES;
+    id responseObject = [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:error];
+    self.responseSerializer.parsesTopLevelArraysConcurrently = NO;
+
+    return responseObject;
+}
+
+- (void)testThatConcurrentParsingMatchesJSONSerialization {
+    for (id object in @[AFJSONBenchmarkRecords(), AFJSONBenchmarkText(), AFJSONBenchmarkCoordinates(), @{@"records": AFJSONBenchmarkRecords()}, @[@1, @[@2]]]) {
+        NSData *data = [NSJSONSerialization dataWithJSONObject:object options:NSJSONWritingPrettyPrinted error:nil];
+        NSError *error = nil;
+        id responseObject = [self concurrentlyParsedResponseObjectWithData:data error:&error];
+
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(responseObject, [self responseObjectWithData:data parserBackend:AFJSONParserBackendFoundation error:nil]);
+    }
+}
+
+- (void)testThatConcurrentParsingHonorsReadingOptions {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkRecords() options:(NSJSONWritingOptions)0 error:nil];
+
+    NSArray *responseObject = [self concurrentlyParsedResponseObjectWithData:data error:nil];
+    XCTAssertThrows([(NSMutableArray *)responseObject addObject:@1]);
+
+    self.responseSerializer.readingOptions = NSJSONReadingMutableContainers;
+    NSMutableArray *mutableResponseObject = [self concurrentlyParsedResponseObjectWithData:data error:nil];
+    XCTAssertNoThrow([mutableResponseObject addObject:@1]);
+    XCTAssertNoThrow([(NSMutableDictionary *)mutableResponseObject.firstObject setObject:@1 forKey:@"foo"]);
+}
+
+- (void)testThatConcurrentParsingReturnsErrorForInvalidJSON {
+    NSString *string = [[NSString alloc] initWithData:[NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkCoordinates() options:(NSJSONWritingOptions)0 error:nil] encoding:NSUTF8StringEncoding];
+    NSString *body = [string substringWithRange:NSMakeRange(1, string.length - 2)];
+    NSRange middleRange = [body rangeOfString:@"]," options:(NSStringCompareOptions)0 range:NSMakeRange(body.length / 2, body.length / 2)];
+    NSString *middleError = [body stringByReplacingCharactersInRange:NSMakeRange(middleRange.location + 1, 1) withString:@",,"];
+
+    for (NSString *invalidString in @[[NSString stringWithFormat:@"[%@,]", body], [NSString stringWithFormat:@"[%@] []", body], [NSString stringWithFormat:@"[%@}", body], [NSString stringWithFormat:@"[%@", body], [NSString stringWithFormat:@"[%@]", middleError], [NSString stringWithFormat:@"[%@, tru]", body]]) {
+        NSError *error = nil;
+        id responseObject = [self concurrentlyParsedResponseObjectWithData:[invalidString dataUsingEncoding:NSUTF8StringEncoding] error:&error];
+
+        XCTAssertNil(responseObject);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+        XCTAssertEqual(error.code, NSPropertyListReadCorruptError);
+    }
+}
+
+- (void)testSerialParsingOfRecordsPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[AFJSONBenchmarkRecords() arrayByAddingObjectsFromArray:AFJSONBenchmarkRecords()] options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    }];
+}
+
+- (void)testConcurrentParsingOfRecordsPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[AFJSONBenchmarkRecords() arrayByAddingObjectsFromArray:AFJSONBenchmarkRecords()] options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self concurrentlyParsedResponseObjectWithData:data error:nil];
+    }];
+}
+
+#pragma mark - Key Interning
+
+// Returns the distinct instances of the keys of every dictionary in the specified JSON object.
+static NSHashTable * AFJSONKeyInstancesOfObject(id JSONObject, NSHashTable *keyInstances) {
+    if (!keyInstances) {
+        keyInstances = [[NSHashTable alloc] initWithOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality capacity:0];
+    }
+
+    if ([JSONObject isKindOfClass:[NSDictionary class]]) {
+        [(NSDictionary *)JSONObject enumerateKeysAndObjectsUsingBlock:^(id key, id value, __unused BOOL *stop) {
+            [keyInstances addObject:key];
+            AFJSONKeyInstancesOfObject(value, keyInstances);
+        }];
+    } else if ([JSONObject isKindOfClass:[NSArray class]]) {
+        for (id value in (NSArray *)JSONObject) {
+            AFJSONKeyInstancesOfObject(value, keyInstances);
+        }
+    }
+
+    return keyInstances;
+}
+
+static size_t AFJSONAllocatedSizeOfObjects(NSHashTable *objects) {
+    size_t size = 0;
+    for (id object in objects) {
+        size += malloc_size((__bridge const void *)object);
+    }
+
+    return size;
+}
+
+- (void)testThatInternedKeysAreSharedAcrossParsers {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkListItems() options:(NSJSONWritingOptions)0 error:nil];
+    id expectedObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendFoundation error:nil];
+    self.responseSerializer.internsKeys = YES;
+
+    NSArray *vectorizedObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    XCTAssertEqualObjects(vectorizedObject, expectedObject);
+    XCTAssertEqual(AFJSONKeyInstancesOfObject(vectorizedObject, nil).count, 20U);
+
+    NSArray *concurrentlyParsedObject = [self concurrentlyParsedResponseObjectWithData:data error:nil];
+    XCTAssertEqualObjects(concurrentlyParsedObject, expectedObject);
+
+    self.responseSerializer.parsesIncrementally = YES;
+    NSArray *incrementallyParsedObject = [self incrementallyParsedResponseObjectWithData:data chunkLength:4096 error:nil];
+    XCTAssertEqualObjects(incrementallyParsedObject, expectedObject);
+
+    NSHashTable *keyInstances = AFJSONKeyInstancesOfObject(vectorizedObject, nil);
+    AFJSONKeyInstancesOfObject(concurrentlyParsedObject, keyInstances);
+    AFJSONKeyInstancesOfObject(incrementallyParsedObject, keyInstances);
+    XCTAssertEqual(keyInstances.count, 20U);
+}
+
+- (void)testThatKeyInterningIsBounded {
+    NSData *data = [@"[{\"first_key_of_object\": 1, \"second_key_of_object\": {\"third_key_of_object\": 2, \"key_with_\\u00e9scape\": 3}}, {\"first_key_of_object\": 4, \"second_key_of_object\": {\"third_key_of_object\": 5, \"key_with_\\u00e9scape\": 6}}]" dataUsingEncoding:NSUTF8StringEncoding];
+    id expectedObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendFoundation error:nil];
+    self.responseSerializer.internsKeys = YES;
+    self.responseSerializer.maximumInternedKeyCount = 2;
+
+    id responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    XCTAssertEqualObjects(responseObject, expectedObject);
+    XCTAssertEqual(AFJSONKeyInstancesOfObject(responseObject, nil).count, 6U);
+
+    self.responseSerializer.maximumInternedKeyCount = 4;
+    responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    XCTAssertEqualObjects(responseObject, expectedObject);
+    XCTAssertEqual(AFJSONKeyInstancesOfObject(responseObject, nil).count, 4U);
+
+    self.responseSerializer.maximumInternedKeyCount = NSUIntegerMax;
+    responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    XCTAssertEqualObjects(responseObject, expectedObject);
+    XCTAssertEqual(AFJSONKeyInstancesOfObject(responseObject, nil).count, 4U);
+}
+
+- (void)testKeyInterningMemorySaving {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkListItems() options:(NSJSONWritingOptions)0 error:nil];
+
+    NSHashTable *keyInstances = AFJSONKeyInstancesOfObject([self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil], nil);
+    self.responseSerializer.internsKeys = YES;
+    NSHashTable *internedKeyInstances = AFJSONKeyInstancesOfObject([self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil], nil);
+
+    size_t keySize = AFJSONAllocatedSizeOfObjects(keyInstances);
+    size_t internedKeySize = AFJSONAllocatedSizeOfObjects(internedKeyInstances);
+    NSLog(@"Keys of 50,000 objects with 20 keys each: %lu instances in %lu bytes without interning, %lu instances in %lu bytes with interning.", (unsigned long)keyInstances.count, (unsigned long)keySize, (unsigned long)internedKeyInstances.count, (unsigned long)internedKeySize);
+
+    XCTAssertEqual(keyInstances.count, 1000000U);
+    XCTAssertEqual(internedKeyInstances.count, 20U);
+    XCTAssertLessThan(internedKeySize * 1000, keySize);
+}
+
+- (void)testUninternedKeysPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkListItems() options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    }];
+}
+
+- (void)testInternedKeysPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:AFJSONBenchmarkListItems() options:(NSJSONWritingOptions)0 error:nil];
+    self.responseSerializer.internsKeys = YES;
+
+    [self measureBlock:^{
+        [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+    }];
+}
+
+#pragma mark - Key Path Projection
+
+- (id)projectedResponseObjectWithData:(NSData *)data
+                             keyPaths:(NSSet <NSString *> *)keyPaths
+                                error:(NSError * __autoreleasing *)error
+{
+    self.responseSerializer.projectedKeyPaths = keyPaths;
+
+    return [self.responseSerializer responseObjectForResponse:[self JSONResponse] data:data error:error];
+}
+
+- (void)testThatKeyPathProjectionMatchesFullyParsedResponse {
+    NSDictionary *object = @{@"data": @{@"items": @[@{@"id": @1, @"tags": @[@"a", @"b"]}, @{@"id": @2, @"tags": @[]}, @{@"name": @"no id"}, @{@"id": @{@"nested": @[@3]}}]}, @"meta": @{@"cursor": @"c\u00e9\"\n", @"count": @4, @"empty": [NSNull null]}, @"ke.y": @5, @"a[b]": @6};
+    NSData *data = [NSJSONSerialization dataWithJSONObject:object options:NSJSONWritingPrettyPrinted error:nil];
+    NSSet *keyPaths = [NSSet setWithObjects:@"data.items[*].id", @"data.items[0].tags[1]", @"data.items[*].tags[*]", @"meta.cursor", @"meta", @"meta.empty", @"data.items[9].id", @"missing", @"missing[*]", @"a[b]", nil];
+
+    NSDictionary *expectedProjection = @{@"data.items[*].id": @[@1, @2, @{@"nested": @[@3]}], @"data.items[0].tags[1]": @"b", @"data.items[*].tags[*]": @[@"a", @"b"], @"meta.cursor": @"c\u00e9\"\n", @"meta": object[@"meta"], @"meta.empty": [NSNull null], @"missing[*]": @[], @"a[b]": @6};
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil], expectedProjection);
+
+    NSData *UTF16Data = [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] dataUsingEncoding:NSUTF16StringEncoding];
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:UTF16Data keyPaths:keyPaths error:nil], expectedProjection);
+
+    self.responseSerializer.removesKeysWithNullValues = YES;
+    NSMutableDictionary *expectedProjectionWithoutNullValues = [expectedProjection mutableCopy];
+    [expectedProjectionWithoutNullValues removeObjectForKey:@"meta.empty"];
+    expectedProjectionWithoutNullValues[@"meta"] = @{@"cursor": @"c\u00e9\"\n", @"count": @4};
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil], expectedProjectionWithoutNullValues);
+}
+
+- (void)testThatKeyPathProjectionOfArraysMatchesFullyParsedResponse {
+    NSData *data = [@"[[1, 2], {\"a\": [3]}, \"x\\u00e9\", null]" dataUsingEncoding:NSUTF8StringEncoding];
+    NSSet *keyPaths = [NSSet setWithObjects:@"[0][1]", @"[*]", @"[1].a[0]", @"[2]", nil];
+    NSDictionary *expectedProjection = @{@"[0][1]": @2, @"[*]": @[@[@1, @2], @{@"a": @[@3]}, @"x\u00e9", [NSNull null]], @"[1].a[0]": @3, @"[2]": @"x\u00e9"};
+
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil], expectedProjection);
+}
+
+- (void)testThatKeyPathProjectionHonorsReadingOptions {
+    NSData *data = [@"{\"items\": [{\"name\": \"foo\"}]}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSSet *keyPaths = [NSSet setWithObjects:@"items[*].name", @"items", nil];
+
+    NSDictionary *projection = [self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil];
+    XCTAssertThrows([(NSMutableDictionary *)projection setObject:@"bar" forKey:@"baz"]);
+    XCTAssertThrows([(NSMutableArray *)projection[@"items[*].name"] addObject:@"bar"]);
+
+    self.responseSerializer.readingOptions = NSJSONReadingMutableContainers | NSJSONReadingMutableLeaves;
+    NSMutableDictionary *mutableProjection = [self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil];
+    XCTAssertNoThrow(mutableProjection[@"baz"] = @"bar");
+    XCTAssertNoThrow([mutableProjection[@"items"] addObject:@"bar"]);
+    XCTAssertNoThrow([mutableProjection[@"items[*].name"][0] appendString:@"bar"]);
+
+    data = [@"\"fragment\"" dataUsingEncoding:NSUTF8StringEncoding];
+    NSError *error = nil;
+    XCTAssertNil([self projectedResponseObjectWithData:data keyPaths:keyPaths error:&error]);
+    XCTAssertNotNil(error);
+
+    self.responseSerializer.readingOptions = NSJSONReadingAllowFragments;
+    error = nil;
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:&error], (@{@"items[*].name": @[]}));
+    XCTAssertNil(error);
+}
+
+- (void)testThatKeyPathProjectionReturnsErrorForInvalidJSON {
+    NSSet *keyPaths = [NSSet setWithObjects:@"a", @"[*]", nil];
+    for (NSString *string in [AFInvalidJSONTestStrings() arrayByAddingObjectsFromArray:@[@"{\"b\": [1, 2}", @"{\"b\": {\"c\": 1}} {}", @"{\"a\": tru}", @"{\"a\": 1, \"b\": {\"x\": [1}]}", @"{\"a\": 1, \"b\": [1, tru]}", @"{\"a\": 1, \"b\": 01}", @"{\"a\": 1, \"b\": {\"c\" 1}}", @"{\"a\": 1, \"b\": \"\\x\"}", @"{\"a\": 1e999, \"a\": 1}"]]) {
+        NSError *error = nil;
+        id responseObject = [self projectedResponseObjectWithData:[string dataUsingEncoding:NSUTF8StringEncoding] keyPaths:keyPaths error:&error];
+
+        XCTAssertNil(responseObject, @"%@", string);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain, @"%@", string);
+        XCTAssertEqual(error.code, NSPropertyListReadCorruptError, @"%@", string);
+    }
+}
+
+- (void)testThatKeyPathProjectionKeepsLastValueForDuplicateKeys {
+    NSData *data = [@"{\"items\": [{\"id\": 1, \"id\": 2}, {\"id\": 3}], \"meta\": {\"cursor\": \"a\"}, \"meta\": {\"count\": 4}, \"next\": \"b\", \"next\": null}" dataUsingEncoding:NSUTF8StringEncoding];
+    NSSet *keyPaths = [NSSet setWithObjects:@"items[*].id", @"meta.cursor", @"meta.count", @"next", nil];
+
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil], (@{@"items[*].id": @[@2, @3], @"meta.count": @4, @"next": [NSNull null]}));
+
+    self.responseSerializer.removesKeysWithNullValues = YES;
+    XCTAssertEqualObjects([self projectedResponseObjectWithData:data keyPaths:keyPaths error:nil], (@{@"items[*].id": @[@2, @3], @"meta.count": @4}));
+}
+
+- (void)testThatKeyPathProjectionDisablesIncrementalParsing {
+    self.responseSerializer.parsesIncrementally = YES;
+    self.responseSerializer.projectedKeyPaths = [NSSet setWithObject:@"a"];
+
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:[self JSONResponse] data:[NSData data]]);
+}
+
+- (void)testFullParsingForKeyPathPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"data": AFJSONBenchmarkRecords(), @"cursor": @"next"} options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        NSDictionary *responseObject = [self responseObjectWithData:data parserBackend:AFJSONParserBackendVectorized error:nil];
+        [responseObject valueForKeyPath:@"data.id"];
+    }];
+}
+
+- (void)testKeyPathProjectionPerformance {
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"data": AFJSONBenchmarkRecords(), @"cursor": @"next"} options:(NSJSONWritingOptions)0 error:nil];
+
+    [self measureBlock:^{
+        [self projectedResponseObjectWithData:data keyPaths:[NSSet setWithObject:@"data[*].id"] error:nil];
+    }];
+}
+
+@end
+
+#pragma mark -
+
+static NSData * AFJSONLinesBenchmarkData() {
+    NSMutableData *mutableData = [NSMutableData data];
+    for (NSDictionary *record in AFJSONBenchmarkRecords()) {
+        [mutableData appendData:[NSJSONSerialization dataWithJSONObject:record options:(NSJSONWritingOptions)0 error:nil]];
+        [mutableData appendBytes:"\n" length:1];
+    }
+
+    return mutableData;
+}
+
+@interface AFJSONLinesResponseSerializationTests : AFTestCase
+@property (nonatomic, strong) AFJSONLinesResponseSerializer *responseSerializer;
+@end
+
+@implementation AFJSONLinesResponseSerializationTests
+
+- (void)setUp {
+    [super setUp];
+    self.responseSerializer = [AFJSONLinesResponseSerializer serializer];
+}
+
+- (NSHTTPURLResponse *)JSONLinesResponse {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/x-ndjson"}];
+}
+
+#pragma mark -
+
+- (void)testThatJSONLinesResponseSerializerParsesEveryLine {
+    NSData *data = [@"\uFEFF{\"id\": 1}\r\n\n[1, 2]\n  \n\"fragment\"\n3" dataUsingEncoding:NSUTF8StringEncoding];
+
+    NSError *error = nil;
+    id responseObject = [self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:data error:&error];
+
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(responseObject, (@[@{@"id": @1}, @[@1, @2], @"fragment", @3]));
+}
+
+- (void)testThatJSONLinesResponseSerializerReturnsEmptyArrayForEmptyBody {
+    NSError *error = nil;
+    XCTAssertEqualObjects([self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:[NSData data] error:&error], @[]);
+    XCTAssertNil(error);
+}
+
+- (void)testThatJSONLinesResponseSerializerReturnsErrorWithLineOfInvalidRecord {
+    NSData *data = [@"{\"id\": 1}\n\n{\"id\": 2\n{\"id\": 3}\n" dataUsingEncoding:NSUTF8StringEncoding];
+
+    NSError *error = nil;
+    XCTAssertNil([self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:data error:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+    XCTAssertEqualObjects(error.localizedFailureReason, @"Invalid JSON on line 3.");
+    XCTAssertNotNil(error.userInfo[NSUnderlyingErrorKey]);
+}
+
+- (void)testThatJSONLinesResponseSerializerHonorsReadingOptions {
+    NSData *data = [@"{\"id\": 1, \"name\": null}\n" dataUsingEncoding:NSUTF8StringEncoding];
+
+    self.responseSerializer.readingOptions = NSJSONReadingMutableContainers;
+    self.responseSerializer.removesKeysWithNullValues = YES;
+    NSArray *responseObject = [self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:data error:nil];
+
+    XCTAssertEqualObjects(responseObject, (@[@{@"id": @1}]));
+    XCTAssertNoThrow(((NSMutableDictionary *)responseObject[0])[@"name"] = @"bar");
+}
+
+- (void)testThatJSONLinesResponseSerializerRejectsInvalidResponses {
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/html"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:[NSData data]]);
+    XCTAssertNil([self.responseSerializer recordParserForResponse:response data:[NSData data] batchSize:0 queue:nil recordsHandler:^(__unused NSArray *records) {}]);
+
+    response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:500 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/x-ndjson"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:[NSData data]]);
+}
+
+- (void)testThatIncrementalParsingMatchesWholeBodyAtEverySplitPoint {
+    NSData *data = [@"\uFEFF{\"id\": 1}\r\n\n[1, 2]\n\"fragment\"\n3" dataUsingEncoding:NSUTF8StringEncoding];
+    id expectedObject = [self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:data error:nil];
+
+    for (NSUInteger splitIndex = 0; splitIndex <= data.length; splitIndex++) {
+        id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self JSONLinesResponse] data:data];
+        XCTAssertNotNil(parser);
+
+        XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(0, splitIndex)]]);
+        XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(splitIndex, data.length - splitIndex)]]);
+
+        NSError *error = nil;
+        XCTAssertEqualObjects([parser responseObjectByFinishingWithError:&error], expectedObject, @"%lu", (unsigned long)splitIndex);
+        XCTAssertNil(error);
+    }
+}
+
+- (void)testThatRecordParserDeliversBatchesInOrderOnQueue {
+    NSMutableData *data = [NSMutableData data];
+    for (NSUInteger idx = 0; idx < 10; idx++) {
+        [data appendData:[[NSString stringWithFormat:@"{\"id\": %lu}\n", (unsigned long)idx] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    dispatch_queue_t queue = dispatch_queue_create("com.alamofire.networking.tests.records", DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *batches = [NSMutableArray array];
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer recordParserForResponse:[self JSONLinesResponse] data:data batchSize:3 queue:queue recordsHandler:^(NSArray *batch) {
+        [batches addObject:batch];
+    }];
+    XCTAssertNotNil(parser);
+
+    XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(0, data.length - 4)]]);
+    XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(data.length - 4, 4)]]);
+
+    NSError *error = nil;
+    XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+    XCTAssertNil(error);
+
+    NSMutableArray *batchCounts = [NSMutableArray array];
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSArray *batch in batches) {
+        [batchCounts addObject:@(batch.count)];
+        [records addObjectsFromArray:batch];
+    }
+
+    XCTAssertEqualObjects(batchCounts, (@[@3, @3, @3, @1]));
+    XCTAssertEqualObjects([records valueForKey:@"id"], (@[@0, @1, @2, @3, @4, @5, @6, @7, @8, @9]));
+}
+
+- (void)testThatRecordParserDeliversRecordsPrecedingInvalidLine {
+    dispatch_queue_t queue = dispatch_queue_create("com.alamofire.networking.tests.records", DISPATCH_QUEUE_SERIAL);
+    NSMutableArray *records = [NSMutableArray array];
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer recordParserForResponse:[self JSONLinesResponse] data:[NSData data] batchSize:0 queue:queue recordsHandler:^(NSArray *batch) {
+        [records addObjectsFromArray:batch];
+    }];
+
+    XCTAssertFalse([parser appendData:[@"1\n2\n{\n3\n" dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    NSError *error = nil;
+    XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+    XCTAssertEqualObjects(error.localizedFailureReason, @"Invalid JSON on line 3.");
+    XCTAssertEqualObjects(records, (@[@1, @2]));
+}
+
+- (void)testThatLineLongerThanMaximumLineLengthReturnsError {
+    self.responseSerializer.maximumLineLength = 4;
+
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self JSONLinesResponse] data:[NSData data]];
+    XCTAssertTrue([parser appendData:[@"1234\n[1," dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertFalse([parser appendData:[@"2]\n" dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    NSError *error = nil;
+    XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqualObjects(error.localizedFailureReason, @"Line 2 is longer than 4 bytes.");
+}
+
+- (void)testThatJSONLinesResponseSerializerCanBeCopiedAndArchived {
+    self.responseSerializer.readingOptions = NSJSONReadingMutableLeaves;
+    self.responseSerializer.removesKeysWithNullValues = YES;
+    self.responseSerializer.maximumLineLength = 1024;
+
+    AFJSONLinesResponseSerializer *copiedSerializer = [self.responseSerializer copy];
+    XCTAssertEqual(copiedSerializer.readingOptions, NSJSONReadingMutableLeaves);
+    XCTAssertTrue(copiedSerializer.removesKeysWithNullValues);
+    XCTAssertEqual(copiedSerializer.maximumLineLength, 1024U);
+
+    NSData *archivedData = [NSKeyedArchiver archivedDataWithRootObject:self.responseSerializer];
+    AFJSONLinesResponseSerializer *unarchivedSerializer = [NSKeyedUnarchiver unarchiveObjectWithData:archivedData];
+    XCTAssertEqual(unarchivedSerializer.readingOptions, NSJSONReadingMutableLeaves);
+    XCTAssertTrue(unarchivedSerializer.removesKeysWithNullValues);
+    XCTAssertEqual(unarchivedSerializer.maximumLineLength, 1024U);
+    XCTAssertEqualObjects(unarchivedSerializer.acceptableContentTypes, self.responseSerializer.acceptableContentTypes);
+}
+
+- (void)testJSONLinesParsingPerformance {
+    NSData *data = AFJSONLinesBenchmarkData();
+
+    [self measureBlock:^{
+        [self.responseSerializer responseObjectForResponse:[self JSONLinesResponse] data:data error:nil];
+    }];
 }
 
 @end
@@ -0,0 +1,616 @@
+// AFServerSentEventsTests.m
+// Copyright (c) 2011–2016 Alamofire Software Foundation ( http://alamofire.org/ )
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#import "AFTestCase.h"
+
+#import <arpa/inet.h>
+#import <netinet/in.h>
+#import <sys/socket.h>
+#import <unistd.h>
+
+#import "AFURLSessionManager.h"
+
+static NSString * const AFServerSentEventsTestStream = @"\uFEFF: comment\n"
+                                                       @"data: first\n"
+                                                       @"data:second\n"
+                                                       @"\n"
+                                                       @"event: update\r\n"
+                                                       @"id: 42\r\n"
+                                                       @"data\r\n"
+                                                       @"\r\n"
+                                                       @"id: 43\n"
+                                                       @"\n"
+                                                       @"retry: 1500\n"
+                                                       @"retry: soon\n"
+                                                       @"unknown: field\n"
+                                                       @"data: {\"a\": 1}\r"
+                                                       @"\r"
+                                                       @"data: incomplete\n";
+
+static void * AFServerSentEventsTestQueueKey = &AFServerSentEventsTestQueueKey;
+
+static NSArray <AFServerSentEvent *> * AFServerSentEventsTestStreamEvents() {
+    return @[[[AFServerSentEvent alloc] initWithType:@"message" data:@"first\nsecond" identifier:nil],
+             [[AFServerSentEvent alloc] initWithType:@"update" data:@"" identifier:@"42"],
+             [[AFServerSentEvent alloc] initWithType:@"message" data:@"{\"a\": 1}" identifier:@"43"]];
+}
+
+#pragma mark -
+
+/**
+ `AFLoopbackServerConnection` is a connection accepted by `AFLoopbackServer`, whose request head has been read. Everything written to it is sent as is, in order.
+ */
+@interface AFLoopbackServerConnection : NSObject
+@property (readonly, nonatomic, copy) NSString *requestPath;
+@property (readonly, nonatomic, copy) NSDictionary <NSString *, NSString *> *requestHeaderFields;
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+                                 queue:(dispatch_queue_t)queue;
+- (void)readRequestWithCompletionHandler:(void (^)(void))completionHandler;
+- (void)writeString:(NSString *)string;
+- (void)close;
+- (void)closeOnQueue;
+@end
+
+@implementation AFLoopbackServerConnection {
+    int _fileDescriptor;
+    dispatch_queue_t _queue;
+    dispatch_source_t _readSource;
+    NSMutableData *_requestData;
+    BOOL _closed;
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+                                 queue:(dispatch_queue_t)queue
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    int yes = 1;
+    setsockopt(fileDescriptor, SOL_SOCKET, SO_NOSIGPIPE, &yes, (socklen_t)sizeof(yes));
+
+    _fileDescriptor = fileDescriptor;
+    _queue = queue;
+    _readSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)fileDescriptor, 0, queue);
+    _requestData = [NSMutableData data];
+
+    dispatch_source_set_cancel_handler(_readSource, ^{
+        close(fileDescriptor);
+    });
+
+    return self;
+}
+
+- (void)readRequestWithCompletionHandler:(void (^)(void))completionHandler {
+    __weak __typeof__(self) weakSelf = self;
+    dispatch_source_set_event_handler(_readSource, ^{
+        __strong __typeof__(weakSelf) strongSelf = weakSelf;
+        if (strongSelf) {
+            [strongSelf readAvailableBytesWithCompletionHandler:completionHandler];
+        }
+    });
+    dispatch_resume(_readSource);
+}
+
+- (void)readAvailableBytesWithCompletionHandler:(void (^)(void))completionHandler {
+    uint8_t buffer[4096];
+    ssize_t length = read(_fileDescriptor, buffer, sizeof(buffer));
+    if (length <= 0) {
+        [self closeOnQueue];
+        return;
+    }
+
+    if (self.requestPath) {
+        return;
+    }
+
+    [_requestData appendBytes:buffer length:(NSUInteger)length];
+
+    NSRange headEndRange = [_requestData rangeOfData:[@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding] options:(NSDataSearchOptions)0 range:NSMakeRange(0, _requestData.length)];
+    if (headEndRange.location == NSNotFound) {
+        return;
+    }
+
+    NSString *head = [[NSString alloc] initWithData:[_requestData subdataWithRange:NSMakeRange(0, headEndRange.location)] encoding:NSUTF8StringEncoding];
+    NSArray <NSString *> *lines = [head componentsSeparatedByString:@"\r\n"];
+    NSArray <NSString *> *requestLineComponents = [lines.firstObject componentsSeparatedByString:@" "];
+
+    NSMutableDictionary *mutableHeaderFields = [NSMutableDictionary dictionary];
+    for (NSString *line in [lines subarrayWithRange:NSMakeRange(1, lines.count - 1)]) {
+        NSRange colonRange = [line rangeOfString:@":"];
+        if (colonRange.location != NSNotFound) {
+            NSString *value = [[line substringFromIndex:NSMaxRange(colonRange)] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+            mutableHeaderFields[[line substringToIndex:colonRange.location]] = value;
+        }
+    }
+
+    _requestHeaderFields = [mutableHeaderFields copy];
+    _requestPath = requestLineComponents.count > 1 ? requestLineComponents[1] : @"/";
+
+    completionHandler();
+}
+
+- (void)closeOnQueue {
+    if (_closed) {
+        return;
+    }
+
+    _closed = YES;
+    dispatch_source_cancel(_readSource);
+}
+
+- (void)writeString:(NSString *)string {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    dispatch_async(_queue, ^{
+        const uint8_t *bytes = data.bytes;
+        NSUInteger length = data.length;
+        while (!self->_closed && length > 0) {
+            ssize_t written = write(self->_fileDescriptor, bytes, length);
+            if (written <= 0) {
+                [self closeOnQueue];
+                return;
+            }
+
+            bytes += written;
+            length -= (NSUInteger)written;
+        }
+    });
+}
+
+- (void)close {
+    dispatch_async(_queue, ^{
+        [self closeOnQueue];
+    });
+}
+
+@end
+
+#pragma mark -
+
+/**
+ `AFLoopbackServer` accepts HTTP connections on an ephemeral port of the loopback interface, and hands each of them to a block once its request head has been read, on a serial queue. The block writes the response, and closes the connection whenever it sees fit, so that responses can be streamed without the network.
+ */
+@interface AFLoopbackServer : NSObject
+@property (readonly, nonatomic, strong) NSURL *baseURL;
+@property (readonly, nonatomic, copy) NSArray <AFLoopbackServerConnection *> *connections;
+
+- (instancetype)initWithConnectionHandler:(void (^)(AFLoopbackServerConnection *connection, NSUInteger connectionIndex))connectionHandler;
+- (void)invalidate;
+@end
+
+@implementation AFLoopbackServer {
+    dispatch_queue_t _queue;
+    dispatch_source_t _acceptSource;
+    NSMutableArray <AFLoopbackServerConnection *> *_mutableConnections;
+}
+
+- (instancetype)initWithConnectionHandler:(void (^)(AFLoopbackServerConnection *connection, NSUInteger connectionIndex))connectionHandler {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    int fileDescriptor = socket(AF_INET, SOCK_STREAM, 0);
+    if (fileDescriptor < 0) {
+        return nil;
+    }
+
+    int yes = 1;
+    setsockopt(fileDescriptor, SOL_SOCKET, SO_REUSEADDR, &yes, (socklen_t)sizeof(yes));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = (__uint8_t)sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = 0;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    socklen_t addressLength = (socklen_t)sizeof(address);
+    if (bind(fileDescriptor, (struct sockaddr *)&address, (socklen_t)sizeof(address)) != 0 || listen(fileDescriptor, 16) != 0 || getsockname(fileDescriptor, (struct sockaddr *)&address, &addressLength) != 0) {
+        close(fileDescriptor);
+        return nil;
+    }
+
+    _baseURL = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%u", (unsigned int)ntohs(address.sin_port)]];
+    _queue = dispatch_queue_create("com.alamofire.networking.tests.loopback-server", DISPATCH_QUEUE_SERIAL);
+    _mutableConnections = [NSMutableArray array];
+
+    _acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, (uintptr_t)fileDescriptor, 0, _queue);
+    dispatch_source_set_cancel_handler(_acceptSource, ^{
+        close(fileDescriptor);
+    });
+
+    __weak __typeof__(self) weakSelf = self;
+    dispatch_queue_t queue = _queue;
+    dispatch_source_set_event_handler(_acceptSource, ^{
+        __strong __typeof__(weakSelf) strongSelf = weakSelf;
+        int connectionFileDescriptor = accept(fileDescriptor, NULL, NULL);
+        if (!strongSelf || connectionFileDescriptor < 0) {
+            if (connectionFileDescriptor >= 0) {
+                close(connectionFileDescriptor);
+            }
+            return;
+        }
+
+        AFLoopbackServerConnection *connection = [[AFLoopbackServerConnection alloc] initWithFileDescriptor:connectionFileDescriptor queue:queue];
+        NSUInteger connectionIndex = strongSelf->_mutableConnections.count;
+        [strongSelf->_mutableConnections addObject:connection];
+
+        __weak AFLoopbackServerConnection *weakConnection = connection;
+        [connection readRequestWithCompletionHandler:^{
+            AFLoopbackServerConnection *strongConnection = weakConnection;
+            if (strongConnection) {
+                connectionHandler(strongConnection, connectionIndex);
+            }
+        }];
+    });
+    dispatch_resume(_acceptSource);
+
+    return self;
+}
+
+- (NSArray <AFLoopbackServerConnection *> *)connections {
+    __block NSArray *connections = nil;
+    dispatch_sync(_queue, ^{
+        connections = [self->_mutableConnections copy];
+    });
+
+    return connections;
+}
+
+- (void)invalidate {
+    dispatch_sync(_queue, ^{
+        dispatch_source_cancel(self->_acceptSource);
+        for (AFLoopbackServerConnection *connection in self->_mutableConnections) {
+            [connection closeOnQueue];
+        }
+    });
+}
+
+@end
+
+#pragma mark -
+
+@interface AFServerSentEventsTests : AFTestCase
+@property (nonatomic, strong) AFServerSentEventsResponseSerializer *responseSerializer;
+@property (nonatomic, strong) AFURLSessionManager *manager;
+@property (nonatomic, strong) AFLoopbackServer *server;
+@end
+
+@implementation AFServerSentEventsTests
+
+- (void)setUp {
+    [super setUp];
+    self.responseSerializer = [AFServerSentEventsResponseSerializer serializer];
+    self.manager = [[AFURLSessionManager alloc] initWithSessionConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+}
+
+- (void)tearDown {
+    [self.manager invalidateSessionCancelingTasks:YES];
+    self.manager = nil;
+    [self.server invalidate];
+    self.server = nil;
+    [super tearDown];
+}
+
+- (NSHTTPURLResponse *)eventStreamResponse {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/event-stream"}];
+}
+
+- (void)writeEventStreamResponseHeadToConnection:(AFLoopbackServerConnection *)connection {
+    [connection writeString:@"HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nX-Content-Type-Options: nosniff\r\nConnection: close\r\n\r\n"];
+}
+
+#pragma mark - Parsing
+
+- (void)testThatEventsAreDispatchedByBlankLines {
+    NSData *data = [AFServerSentEventsTestStream dataUsingEncoding:NSUTF8StringEncoding];
+
+    NSError *error = nil;
+    NSArray *events = [self.responseSerializer responseObjectForResponse:[self eventStreamResponse] data:data error:&error];
+
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(events, AFServerSentEventsTestStreamEvents());
+}
+
+- (void)testThatIncrementalParsingMatchesWholeStreamAtEverySplitPoint {
+    NSData *data = [AFServerSentEventsTestStream dataUsingEncoding:NSUTF8StringEncoding];
+
+    for (NSUInteger splitIndex = 0; splitIndex <= data.length; splitIndex++) {
+        id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self eventStreamResponse] data:data];
+        XCTAssertNotNil(parser);
+
+        [parser appendData:[data subdataWithRange:NSMakeRange(0, splitIndex)]];
+        [parser appendData:[data subdataWithRange:NSMakeRange(splitIndex, data.length - splitIndex)]];
+
+        XCTAssertEqualObjects([parser responseObjectByFinishingWithError:nil], AFServerSentEventsTestStreamEvents(), @"%lu", (unsigned long)splitIndex);
+    }
+}
+
+- (void)testThatEventParserKeepsTrackOfStreamStateAndDeliversEventsOnQueue {
+    dispatch_queue_t queue = dispatch_queue_create("com.alamofire.networking.tests.events", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(queue, AFServerSentEventsTestQueueKey, AFServerSentEventsTestQueueKey, NULL);
+
+    NSMutableArray *events = [NSMutableArray array];
+    id <AFServerSentEventsParser> parser = [self.responseSerializer eventParserForResponse:[self eventStreamResponse] data:[NSData data] lastEventIdentifier:@"41" queue:queue eventHandler:^(AFServerSentEvent *event) {
+        XCTAssertTrue(dispatch_get_specific(AFServerSentEventsTestQueueKey) == AFServerSentEventsTestQueueKey);
+        [events addObject:event];
+    }];
+    XCTAssertNotNil(parser);
+    XCTAssertEqualObjects(parser.lastEventIdentifier, @"41");
+    XCTAssertLessThan(parser.reconnectionInterval, 0.0);
+
+    [parser appendData:[@"data: before\n\nid: 43\nretry: 1500\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [parser appendData:[@"data: after\n\nid: 44\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertNil([parser responseObjectByFinishingWithError:nil]);
+
+    XCTAssertEqualObjects(events, (@[[[AFServerSentEvent alloc] initWithType:@"message" data:@"before" identifier:@"41"],
+                                     [[AFServerSentEvent alloc] initWithType:@"message" data:@"after" identifier:@"43"]]));
+    XCTAssertEqualObjects(parser.lastEventIdentifier, @"44");
+    XCTAssertEqualWithAccuracy(parser.reconnectionInterval, 1.5, DBL_EPSILON);
+}
+
+- (void)testThatEventStreamSerializerRejectsInvalidResponses {
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/plain"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:[NSData data]]);
+
+    response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:204 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/event-stream"}];
+    XCTAssertNil([self.responseSerializer eventParserForResponse:response data:[NSData data] lastEventIdentifier:nil queue:nil eventHandler:^(__unused AFServerSentEvent *event) {}]);
+
+    NSError *error = nil;
+    XCTAssertNil([self.responseSerializer responseObjectForResponse:response data:[NSData data] error:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+}
+
+- (void)testThatLineLongerThanMaximumLineLengthReturnsError {
+    self.responseSerializer.maximumLineLength = 8;
+
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self eventStreamResponse] data:[NSData data]];
+    XCTAssertTrue([parser appendData:[@"data: ab\n\ndata: " dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertFalse([parser appendData:[@"abc" dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    NSError *error = nil;
+    XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqualObjects(error.localizedFailureReason, @"Line 3 is longer than 8 bytes.");
+
+    error = nil;
+    XCTAssertNil([self.responseSerializer responseObjectForResponse:[self eventStreamResponse] data:[@"data: abc\n\n" dataUsingEncoding:NSUTF8StringEncoding] error:&error]);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+}
+
+- (void)testEventStreamParsingPerformance {
+    NSMutableString *mutableStream = [NSMutableString string];
+    for (NSUInteger idx = 0; idx < 10000; idx++) {
+        [mutableStream appendFormat:@"event: update\nid: %lu\ndata: {\"id\": %lu, \"name\": \"Record %lu\"}\n\n", (unsigned long)idx, (unsigned long)idx, (unsigned long)idx];
+    }
+    NSData *data = [mutableStream dataUsingEncoding:NSUTF8StringEncoding];
+
+    [self measureBlock:^{
+        [self.responseSerializer responseObjectForResponse:[self eventStreamResponse] data:data error:nil];
+    }];
+}
+
+#pragma mark - Streaming
+
+- (void)testThatTaskReconnectsWithLastEventIdentifier {
+    __block NSString *lastEventIdentifierHeaderField = nil;
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, NSUInteger connectionIndex) {
+        [self writeEventStreamResponseHeadToConnection:connection];
+        if (connectionIndex == 0) {
+            [connection writeString:@"retry: 50\nid: 1\ndata: one\n\n"];
+            [connection close];
+        } else {
+            lastEventIdentifierHeaderField = connection.requestHeaderFields[@"Last-Event-ID"];
+            [connection writeString:@"id: 2\ndata: two\n\n"];
+        }
+    }];
+    XCTAssertNotNil(self.server);
+
+    dispatch_queue_t eventQueue = dispatch_queue_create("com.alamofire.networking.tests.events", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(eventQueue, AFServerSentEventsTestQueueKey, AFServerSentEventsTestQueueKey, NULL);
+
+    NSMutableArray *events = [NSMutableArray array];
+    XCTestExpectation *eventsExpectation = [self expectationWithDescription:@"Events of both connections should be delivered"];
+    XCTestExpectation *completionExpectation = [self expectationWithDescription:@"Stream should end once cancelled"];
+    AFServerSentEventsTask *task = [self.manager eventStreamTaskWithRequest:[NSURLRequest requestWithURL:[self.server.baseURL URLByAppendingPathComponent:@"events"]] eventQueue:eventQueue eventHandler:^(AFServerSentEvent *event) {
+        XCTAssertTrue(dispatch_get_specific(AFServerSentEventsTestQueueKey) == AFServerSentEventsTestQueueKey);
+        [events addObject:event];
+        if (events.count == 2) {
+            [eventsExpectation fulfill];
+        }
+    } completionHandler:^(__unused NSURLResponse *response, NSError *error) {
+        XCTAssertEqualObjects(error.domain, NSURLErrorDomain);
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [completionExpectation fulfill];
+    }];
+
+    [task resume];
+    [self waitForExpectations:@[eventsExpectation] timeout:self.networkTimeout];
+
+    XCTAssertEqualObjects(lastEventIdentifierHeaderField, @"1");
+    XCTAssertEqualObjects(task.lastEventIdentifier, @"1");
+    XCTAssertEqualWithAccuracy(task.reconnectionInterval, 0.05, DBL_EPSILON);
+    XCTAssertEqualObjects(events, (@[[[AFServerSentEvent alloc] initWithType:@"message" data:@"one" identifier:@"1"],
+                                     [[AFServerSentEvent alloc] initWithType:@"message" data:@"two" identifier:@"2"]]));
+
+    [task cancel];
+    [self waitForExpectationsWithCommonTimeout];
+
+    XCTAssertNil(task.dataTask);
+    XCTAssertEqual(self.server.connections.count, 2U);
+}
+
+- (void)testThatTaskIsSuspendedWhileEventHandlerFallsBehind {
+    NSUInteger numberOfEvents = 200000;
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, NSUInteger connectionIndex) {
+        [self writeEventStreamResponseHeadToConnection:connection];
+        if (connectionIndex == 0) {
+            NSMutableString *mutableStream = [NSMutableString string];
+            for (NSUInteger idx = 0; idx < numberOfEvents; idx++) {
+                [mutableStream appendFormat:@"id: %lu\ndata: %@\n\n", (unsigned long)idx, [@"" stringByPaddingToLength:100 withString:@"x" startingAtIndex:0]];
+            }
+            [connection writeString:mutableStream];
+        }
+    }];
+    XCTAssertNotNil(self.server);
+
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    dispatch_queue_t eventQueue = dispatch_queue_create("com.alamofire.networking.tests.events", DISPATCH_QUEUE_SERIAL);
+    __block NSUInteger numberOfEventsHandled = 0;
+    XCTestExpectation *eventsExpectation = [self expectationWithDescription:@"Every event should be delivered"];
+    AFServerSentEventsTask *task = [self.manager eventStreamTaskWithRequest:[NSURLRequest requestWithURL:self.server.baseURL] eventQueue:eventQueue eventHandler:^(__unused AFServerSentEvent *event) {
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(semaphore);
+        if (++numberOfEventsHandled == numberOfEvents) {
+            [eventsExpectation fulfill];
+        }
+    } completionHandler:^(__unused NSURLResponse *response, __unused NSError *error) {}];
+
+    [task resume];
+    NSURLSessionDataTask *dataTask = task.dataTask;
+    XCTestExpectation *suspensionExpectation = [self expectationForPredicate:[NSPredicate predicateWithFormat:@"state == %ld", (long)NSURLSessionTaskStateSuspended] evaluatedWithObject:dataTask handler:nil];
+    [self waitForExpectations:@[suspensionExpectation] timeout:self.networkTimeout];
+
+    // The stream is about 23 MB, of which the task only takes in the data queued for the parser, and the events held by the blocked handler
+    XCTAssertLessThan(dataTask.countOfBytesReceived, 8 * 1024 * 1024);
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertEqual(dataTask.state, NSURLSessionTaskStateSuspended);
+    XCTAssertLessThan(dataTask.countOfBytesReceived, 8 * 1024 * 1024);
+
+    dispatch_semaphore_signal(semaphore);
+    [self waitForExpectations:@[eventsExpectation] timeout:self.networkTimeout];
+
+    [task cancel];
+}
+
+- (void)testThatTaskDoesNotReconnectToInvalidResponse {
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, __unused NSUInteger connectionIndex) {
+        [connection writeString:@"HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n"];
+        [connection close];
+    }];
+    XCTAssertNotNil(self.server);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Stream should end"];
+    AFServerSentEventsTask *task = [self.manager eventStreamTaskWithRequest:[NSURLRequest requestWithURL:self.server.baseURL] eventQueue:nil eventHandler:^(__unused AFServerSentEvent *event) {
+        XCTFail(@"No event should be delivered");
+    } completionHandler:^(NSURLResponse *response, NSError *error) {
+        XCTAssertEqual([(NSHTTPURLResponse *)response statusCode], 204);
+        XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+        [expectation fulfill];
+    }];
+
+    [task resume];
+    [self waitForExpectationsWithCommonTimeout];
+
+    XCTAssertNil(task.dataTask);
+    XCTAssertEqual(self.server.connections.count, 1U);
+}
+
+- (void)testThatFailedRecordStreamCompletesAfterRecordsReceivedBeforeFailure {
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, __unused NSUInteger connectionIndex) {
+        [connection writeString:@"HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nContent-Length: 1000\r\nConnection: close\r\n\r\n1\n2\n"];
+        [connection close];
+    }];
+    XCTAssertNotNil(self.server);
+
+    NSMutableArray *records = [NSMutableArray array];
+    __block NSUInteger numberOfRecordsAtCompletion = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Record stream should fail"];
+    NSURLSessionDataTask *dataTask = [self.manager dataTaskWithRequest:[NSURLRequest requestWithURL:self.server.baseURL] recordBatchSize:0 recordQueue:nil recordsHandler:^(NSArray *batch) {
+        [records addObjectsFromArray:batch];
+    } completionHandler:^(__unused NSURLResponse *response, NSError *error) {
+        XCTAssertNotNil(error);
+        numberOfRecordsAtCompletion = records.count;
+        [expectation fulfill];
+    }];
+
+    [dataTask resume];
+    [self waitForExpectationsWithCommonTimeout];
+
+    XCTAssertEqual(numberOfRecordsAtCompletion, 2U);
+}
+
+- (void)testThatRecordStreamIsSuspendedWhileRecordsHandlerFallsBehind {
+    NSUInteger numberOfRecords = 200000;
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, __unused NSUInteger connectionIndex) {
+        NSMutableString *mutableBody = [NSMutableString stringWithString:@"HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nConnection: close\r\n\r\n"];
+        for (NSUInteger idx = 0; idx < numberOfRecords; idx++) {
+            [mutableBody appendFormat:@"{\"id\": %lu, \"padding\": \"%@\"}\n", (unsigned long)idx, [@"" stringByPaddingToLength:100 withString:@"x" startingAtIndex:0]];
+        }
+        [connection writeString:mutableBody];
+        [connection close];
+    }];
+    XCTAssertNotNil(self.server);
+
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    dispatch_queue_t recordQueue = dispatch_queue_create("com.alamofire.networking.tests.records", DISPATCH_QUEUE_SERIAL);
+    __block NSUInteger numberOfRecordsHandled = 0;
+    XCTestExpectation *completionExpectation = [self expectationWithDescription:@"Record stream should complete"];
+    NSURLSessionDataTask *dataTask = [self.manager dataTaskWithRequest:[NSURLRequest requestWithURL:self.server.baseURL] recordBatchSize:100 recordQueue:recordQueue recordsHandler:^(NSArray *batch) {
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+        dispatch_semaphore_signal(semaphore);
+        numberOfRecordsHandled += batch.count;
+    } completionHandler:^(__unused NSURLResponse *response, NSError *error) {
+        XCTAssertNil(error);
+        [completionExpectation fulfill];
+    }];
+
+    XCTestExpectation *suspensionExpectation = [self expectationForPredicate:[NSPredicate predicateWithFormat:@"state == %ld", (long)NSURLSessionTaskStateSuspended] evaluatedWithObject:dataTask handler:nil];
+    [dataTask resume];
+    [self waitForExpectations:@[suspensionExpectation] timeout:self.networkTimeout];
+
+    // The response is about 25 MB, of which the task only takes in the data queued for the parser, and the records held by the blocked handler
+    XCTAssertLessThan(dataTask.countOfBytesReceived, 8 * 1024 * 1024);
+    [NSThread sleepForTimeInterval:0.5];
+    XCTAssertEqual(dataTask.state, NSURLSessionTaskStateSuspended);
+    XCTAssertLessThan(dataTask.countOfBytesReceived, 8 * 1024 * 1024);
+
+    dispatch_semaphore_signal(semaphore);
+    [self waitForExpectationsWithCommonTimeout];
+
+    dispatch_sync(recordQueue, ^{
+        XCTAssertEqual(numberOfRecordsHandled, numberOfRecords);
+    });
+}
+
+- (void)testThatTaskCancelledBeforeResumingEndsWithoutConnecting {
+    self.server = [[AFLoopbackServer alloc] initWithConnectionHandler:^(AFLoopbackServerConnection *connection, __unused NSUInteger connectionIndex) {
+        [connection close];
+    }];
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Stream should end"];
+    AFServerSentEventsTask *task = [self.manager eventStreamTaskWithRequest:[NSURLRequest requestWithURL:self.server.baseURL] eventQueue:nil eventHandler:^(__unused AFServerSentEvent *event) {} completionHandler:^(__unused NSURLResponse *response, NSError *error) {
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        [expectation fulfill];
+    }];
+
+    [task cancel];
+    [task resume];
+    [self waitForExpectationsWithCommonTimeout];
+
+    XCTAssertNil(task.dataTask);
+    XCTAssertEqual(self.server.connections.count, 0U);
+}
+
+@end
@@ -445,6 +445,35 @@
     }
 }
 
+#pragma mark - Record Streaming
+
+- (void)testRecordsHandlerReceivesEveryStreamedRecordBeforeCompletion {
+    AFJSONLinesResponseSerializer *responseSerializer = [AFJSONLinesResponseSerializer serializer];
+    responseSerializer.acceptableContentTypes = [NSSet setWithObject:@"application/json"];
+    self.localManager.responseSerializer = responseSerializer;
+
+    NSMutableArray *records = [NSMutableArray array];
+    __block NSUInteger numberOfRecordsAtCompletion = 0;
+    XCTestExpectation *expectation = [self expectationWithDescription:@"Streamed records should be delivered"];
+    NSURLRequest *request = [NSURLRequest requestWithURL:[self.baseURL URLByAppendingPathComponent:@"stream/20"]];
+    NSURLSessionDataTask *task = [self.localManager dataTaskWithRequest:request recordBatchSize:5 recordQueue:nil recordsHandler:^(NSArray *batch) {
+        XCTAssertTrue([NSThread isMainThread]);
+        XCTAssertLessThanOrEqual(batch.count, 5U);
+        [records addObjectsFromArray:batch];
+    } completionHandler:^(__unused NSURLResponse *response, NSError *error) {
+        XCTAssertNil(error);
+        numberOfRecordsAtCompletion = records.count;
+        [expectation fulfill];
+    }];
+
+    [task resume];
+    [self waitForExpectationsWithCommonTimeout];
+
+    XCTAssertEqual(numberOfRecordsAtCompletion, 20U);
+    XCTAssertEqualObjects(records.firstObject[@"id"], @0);
+    XCTAssertEqualObjects(records.lastObject[@"id"], @19);
+}
+
 #pragma mark - private
 
 - (void)_testResumeNotificationForTask:(NSURLSessionTask *)task {
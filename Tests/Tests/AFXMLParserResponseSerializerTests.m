@@ -28,6 +28,157 @@ static NSData * AFXMLTestData() {
     return [@"<?xml version=\"1.0\" encoding=\"UTF-8\"?><foo attr1=\"1\" attr2=\"2\"><bar>someValue</bar></foo>" dataUsingEncoding:NSUTF8StringEncoding];
 }
 
+static NSData * AFXMLStreamingTestData() {
+    return [@"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            @"<feed xmlns=\"http://www.w3.org/2005/Atom\" xmlns:media=\"http://search.yahoo.com/mrss/\">\n"
+            @"<entry id=\"1\" media:type=\"a &amp; b\">&lt;Title&gt; &#233;<![CDATA[<b>raw</b>]]></entry>\n"
+            @"<media:content url=\"a.png\"/>\n"
+            @"</feed>" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+static NSArray * AFXMLStreamingTestEvents() {
+    NSString *atomNamespaceURI = @"http://www.w3.org/2005/Atom";
+    NSString *mediaNamespaceURI = @"http://search.yahoo.com/mrss/";
+
+    return @[@[@"startDocument"],
+             @[@"startElement", @"feed", atomNamespaceURI, @"feed", @{}],
+             @[@"characters", @"\n"],
+             @[@"startElement", @"entry", atomNamespaceURI, @"entry", @{@"id": @"1", @"media:type": @"a & b"}],
+             @[@"characters", @"<Title> \u00E9"],
+             @[@"CDATA", [@"<b>raw</b>" dataUsingEncoding:NSUTF8StringEncoding]],
+             @[@"endElement", @"entry", atomNamespaceURI, @"entry"],
+             @[@"characters", @"\n"],
+             @[@"startElement", @"content", mediaNamespaceURI, @"media:content", @{@"url": @"a.png"}],
+             @[@"endElement", @"content", mediaNamespaceURI, @"media:content"],
+             @[@"characters", @"\n"],
+             @[@"endElement", @"feed", atomNamespaceURI, @"feed"],
+             @[@"endDocument"]];
+}
+
+static NSData * AFXMLBenchmarkData() {
+    NSMutableString *mutableString = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"UTF-8\"?><feed xmlns=\"http://www.w3.org/2005/Atom\">"];
+    for (NSUInteger idx = 0; idx < 20000; idx++) {
+        [mutableString appendFormat:@"<entry id=\"%lu\"><title>Entry %lu</title><updated>2016-10-%02lu</updated><summary>Summary of entry %lu</summary></entry>", (unsigned long)idx, (unsigned long)idx, (unsigned long)(idx % 28 + 1), (unsigned long)idx];
+    }
+    [mutableString appendString:@"</feed>"];
+
+    return [mutableString dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+#pragma mark -
+
+/**
+ `AFTestXMLStreamingDelegate` records the SAX events it is sent, joining consecutive character data and CDATA blocks, which parsers may split differently.
+ */
+@interface AFTestXMLStreamingDelegate : NSObject <AFXMLStreamingParserDelegate>
+@property (nonatomic, strong) NSMutableArray *events;
+@property (nonatomic, strong) NSError *parseError;
+@property (nonatomic, copy) NSString *abortedElementName;
+@end
+
+@implementation AFTestXMLStreamingDelegate
+
+- (instancetype)init {
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+
+    _events = [NSMutableArray array];
+
+    return self;
+}
+
+- (void)streamingParserDidStartDocument:(__unused AFXMLStreamingParser *)parser {
+    [self.events addObject:@[@"startDocument"]];
+}
+
+- (void)streamingParserDidEndDocument:(__unused AFXMLStreamingParser *)parser {
+    [self.events addObject:@[@"endDocument"]];
+}
+
+- (void)streamingParser:(AFXMLStreamingParser *)parser
+        didStartElement:(NSString *)elementName
+           namespaceURI:(NSString *)namespaceURI
+          qualifiedName:(NSString *)qualifiedName
+             attributes:(NSDictionary<NSString *,NSString *> *)attributes
+{
+    [self.events addObject:@[@"startElement", elementName, namespaceURI ?: [NSNull null], qualifiedName, attributes]];
+
+    if ([elementName isEqualToString:self.abortedElementName]) {
+        [parser abortParsing];
+    }
+}
+
+- (void)streamingParser:(__unused AFXMLStreamingParser *)parser
+          didEndElement:(NSString *)elementName
+           namespaceURI:(NSString *)namespaceURI
+          qualifiedName:(NSString *)qualifiedName
+{
+    [self.events addObject:@[@"endElement", elementName, namespaceURI ?: [NSNull null], qualifiedName]];
+}
+
+- (void)streamingParser:(__unused AFXMLStreamingParser *)parser
+        foundCharacters:(NSString *)string
+{
+    NSArray *lastEvent = self.events.lastObject;
+    if ([lastEvent.firstObject isEqual:@"characters"]) {
+        [self.events replaceObjectAtIndex:self.events.count - 1 withObject:@[@"characters", [lastEvent[1] stringByAppendingString:string]]];
+    } else {
+        [self.events addObject:@[@"characters", string]];
+    }
+}
+
+- (void)streamingParser:(__unused AFXMLStreamingParser *)parser
+             foundCDATA:(NSData *)CDATABlock
+{
+    NSArray *lastEvent = self.events.lastObject;
+    if ([lastEvent.firstObject isEqual:@"CDATA"]) {
+        NSMutableData *mutableData = [lastEvent[1] mutableCopy];
+        [mutableData appendData:CDATABlock];
+        [self.events replaceObjectAtIndex:self.events.count - 1 withObject:@[@"CDATA", mutableData]];
+    } else {
+        [self.events addObject:@[@"CDATA", CDATABlock]];
+    }
+}
+
+- (void)streamingParser:(__unused AFXMLStreamingParser *)parser
+     parseErrorOccurred:(NSError *)parseError
+{
+    self.parseError = parseError;
+}
+
+@end
+
+/**
+ `AFTestXMLElementCountingDelegate` counts the elements of documents parsed by either `NSXMLParser` or `AFXMLStreamingParser`.
+ */
+@interface AFTestXMLElementCountingDelegate : NSObject <AFXMLStreamingParserDelegate, NSXMLParserDelegate>
+@property (nonatomic, assign) NSUInteger numberOfElements;
+@end
+
+@implementation AFTestXMLElementCountingDelegate
+
+- (void)parser:(__unused NSXMLParser *)parser
+didStartElement:(__unused NSString *)elementName
+  namespaceURI:(__unused NSString *)namespaceURI
+ qualifiedName:(__unused NSString *)qName
+    attributes:(__unused NSDictionary<NSString *,NSString *> *)attributeDict
+{
+    self.numberOfElements++;
+}
+
+- (void)streamingParser:(__unused AFXMLStreamingParser *)parser
+        didStartElement:(__unused NSString *)elementName
+           namespaceURI:(__unused NSString *)namespaceURI
+          qualifiedName:(__unused NSString *)qualifiedName
+             attributes:(__unused NSDictionary<NSString *,NSString *> *)attributes
+{
+    self.numberOfElements++;
+}
+
+@end
+
 #pragma mark -
 
 @interface AFXMLParserResponseSerializerTests : AFTestCase
@@ -86,4 +237,117 @@ static NSData * AFXMLTestData() {
     XCTAssertEqual(copiedSerializer.acceptableContentTypes, self.responseSerializer.acceptableContentTypes);
 }
 
+#pragma mark - Streaming
+
+- (NSHTTPURLResponse *)XMLResponse {
+    return [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"application/xml"}];
+}
+
+- (void)testThatIncrementalParserIsOnlyCreatedWithStreamingDelegateForValidResponses {
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:[self XMLResponse] data:AFXMLTestData()]);
+
+    AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+    self.responseSerializer.streamingDelegate = delegate;
+    XCTAssertNotNil([self.responseSerializer incrementalParserForResponse:[self XMLResponse] data:AFXMLTestData()]);
+
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.baseURL statusCode:200 HTTPVersion:@"1.1" headerFields:@{@"Content-Type": @"text/html"}];
+    XCTAssertNil([self.responseSerializer incrementalParserForResponse:response data:AFXMLTestData()]);
+}
+
+- (void)testThatStreamingDelegateReceivesEventsInDocumentOrder {
+    AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+    self.responseSerializer.streamingDelegate = delegate;
+
+    NSError *error = nil;
+    XCTAssertNil([self.responseSerializer responseObjectForResponse:[self XMLResponse] data:AFXMLStreamingTestData() error:&error]);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(delegate.events, AFXMLStreamingTestEvents());
+}
+
+- (void)testThatStreamingDelegateReceivesSameEventsAtEverySplitPoint {
+    NSData *data = AFXMLStreamingTestData();
+
+    for (NSUInteger splitIndex = 0; splitIndex <= data.length; splitIndex++) {
+        AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+        self.responseSerializer.streamingDelegate = delegate;
+
+        id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self XMLResponse] data:data];
+        XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(0, splitIndex)]]);
+        XCTAssertTrue([parser appendData:[data subdataWithRange:NSMakeRange(splitIndex, data.length - splitIndex)]]);
+
+        NSError *error = nil;
+        XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+        XCTAssertNil(error, @"%lu", (unsigned long)splitIndex);
+        XCTAssertEqualObjects(delegate.events, AFXMLStreamingTestEvents(), @"%lu", (unsigned long)splitIndex);
+    }
+}
+
+- (void)testThatStreamingParserReturnsErrorForMalformedXML {
+    AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+    self.responseSerializer.streamingDelegate = delegate;
+
+    id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self XMLResponse] data:[NSData data]];
+    XCTAssertTrue([parser appendData:[@"<feed><entry>" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertFalse([parser appendData:[@"</feed><entry>" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertFalse([parser appendData:[@"</entry>" dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    NSError *error = nil;
+    XCTAssertNil([parser responseObjectByFinishingWithError:&error]);
+    XCTAssertEqualObjects(error.domain, AFURLResponseSerializationErrorDomain);
+    XCTAssertEqual(error.code, NSURLErrorCannotDecodeContentData);
+    XCTAssertEqualObjects([error.userInfo[NSUnderlyingErrorKey] domain], NSXMLParserErrorDomain);
+    XCTAssertEqualObjects(delegate.parseError, error.userInfo[NSUnderlyingErrorKey]);
+
+    NSArray *expectedEvents = @[@[@"startDocument"],
+                                @[@"startElement", @"feed", [NSNull null], @"feed", @{}],
+                                @[@"startElement", @"entry", [NSNull null], @"entry", @{}]];
+    XCTAssertEqualObjects(delegate.events, expectedEvents);
+}
+
+- (void)testThatStreamingParserCanBeAbortedByDelegate {
+    AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+    delegate.abortedElementName = @"entry";
+    self.responseSerializer.streamingDelegate = delegate;
+
+    NSError *error = nil;
+    XCTAssertNil([self.responseSerializer responseObjectForResponse:[self XMLResponse] data:AFXMLStreamingTestData() error:&error]);
+    XCTAssertEqual([error.userInfo[NSUnderlyingErrorKey] code], NSXMLParserDelegateAbortedParseError);
+    XCTAssertNil(delegate.parseError);
+    XCTAssertEqualObjects([delegate.events.lastObject firstObject], @"startElement");
+    XCTAssertEqualObjects(delegate.events.lastObject[1], @"entry");
+}
+
+- (void)testThatStreamingDelegateIsCopied {
+    AFTestXMLStreamingDelegate *delegate = [[AFTestXMLStreamingDelegate alloc] init];
+    self.responseSerializer.streamingDelegate = delegate;
+
+    AFXMLParserResponseSerializer *copiedSerializer = [self.responseSerializer copy];
+    XCTAssertEqual(copiedSerializer.streamingDelegate, delegate);
+}
+
+- (void)testBufferedXMLParserPerformance {
+    NSData *data = AFXMLBenchmarkData();
+    AFTestXMLElementCountingDelegate *delegate = [[AFTestXMLElementCountingDelegate alloc] init];
+
+    [self measureBlock:^{
+        NSXMLParser *parser = [self.responseSerializer responseObjectForResponse:[self XMLResponse] data:data error:nil];
+        parser.delegate = delegate;
+        [parser parse];
+    }];
+}
+
+- (void)testStreamingXMLParserPerformance {
+    NSData *data = AFXMLBenchmarkData();
+    AFTestXMLElementCountingDelegate *delegate = [[AFTestXMLElementCountingDelegate alloc] init];
+    self.responseSerializer.streamingDelegate = delegate;
+
+    [self measureBlock:^{
+        id <AFURLResponseIncrementalParser> parser = [self.responseSerializer incrementalParserForResponse:[self XMLResponse] data:data];
+        for (NSUInteger location = 0; location < data.length; location += 16384) {
+            [parser appendData:[data subdataWithRange:NSMakeRange(location, MIN((NSUInteger)16384, data.length - location))]];
+        }
+        [parser responseObjectByFinishingWithError:nil];
+    }];
+}
+
 @end